@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+# SPDX-FileCopyrightText: 2026 Tokodon Contributors
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Compares the results of two tokodon-benchmarks runs, written with -o results.xml,xml
+# Exits with 1 if a benchmark got slower by more than the threshold.
+
+import argparse
+import sys
+import xml.etree.ElementTree as ElementTree
+
+
+def read_results(path: str) -> dict:
+    results = {}
+    for function in ElementTree.parse(path).getroot().iter("TestFunction"):
+        for result in function.iter("BenchmarkResult"):
+            name = function.get("name")
+            if result.get("tag"):
+                name += ":" + result.get("tag")
+            # The value is per iteration, and lower is better for every metric
+            results[(name, result.get("metric"))] = float(result.get("value"))
+    return results
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Flags the benchmarks that got slower than a baseline.")
+    parser.add_argument("baseline", help="QtTest XML output of the baseline run")
+    parser.add_argument("current", help="QtTest XML output of the run to check")
+    parser.add_argument("--threshold", type=float, default=10.0, help="how much slower in percent is a regression, 10 by default")
+    args = parser.parse_args()
+
+    baseline = read_results(args.baseline)
+    current = read_results(args.current)
+
+    regressions = 0
+    width = max((len(name) for name, _ in current), default=0)
+    for (name, metric), value in sorted(current.items()):
+        if (name, metric) not in baseline:
+            print(f"{name:<{width}}  {value:>14.4f}  new")
+            continue
+
+        baseline_value = baseline[(name, metric)]
+        change = (value - baseline_value) / baseline_value * 100 if baseline_value else 0.0
+        verdict = ""
+        if change > args.threshold:
+            verdict = "REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            verdict = "improvement"
+        print(f"{name:<{width}}  {baseline_value:>14.4f} -> {value:>14.4f} {metric}  {change:+7.1f}%  {verdict}")
+
+    for name, metric in sorted(baseline.keys() - current.keys()):
+        print(f"{name:<{width}}  missing from {args.current}")
+
+    if regressions:
+        print(f"\n{regressions} benchmark(s) got more than {args.threshold:g}% slower")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
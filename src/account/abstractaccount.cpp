@@ -5,12 +5,21 @@
 #include "account/abstractaccount.h"
 
 #include "account/accountmanager.h"
+#include "account/filterengine.h"
+#include "account/markersync.h"
+#include "account/poststore.h"
+#include "account/profileloader.h"
 #include "account/relationship.h"
+#include "account/streamingmanager.h"
+#include "config.h"
 #include "network/networkcontroller.h"
+#include "utils/metrics.h"
 #include "utils/messagefiltercontainer.h"
 #include "utils/navigation.h"
 
 #include <KLocalizedString>
+#include <QHostAddress>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QMimeDatabase>
 #include <QNetworkReply>
@@ -18,6 +27,12 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+// Refreshing identities happens in the background, so don't let it compete with what the user is waiting for
+static constexpr qsizetype maxIdentityRevalidations = 4;
+
+// The most posts that can be fetched at once from /api/v1/statuses
+static constexpr qsizetype maxStatusesPerRequest = 20;
+
 AbstractAccount::AbstractAccount(const QString &instanceUri, QObject *parent)
     : QObject(parent)
     , m_instance_uri(instanceUri)
@@ -45,6 +60,9 @@ AbstractAccount::AbstractAccount(const QString &instanceUri, QObject *parent)
                                  i18n("All files (*)")})
     , m_maxCharactersPerOption(50)
     , m_mediaAttachmentDescriptionLimit(500)
+    , m_imageSizeLimit(16 * 1024 * 1024)
+    , m_imageMatrixLimit(33177600)
+    , m_videoSizeLimit(99 * 1024 * 1024)
     , m_maxDisplayNameLength(500)
     , m_maxNoteLength(500)
     , m_maxAvatarDescriptionLength(500)
@@ -150,7 +168,11 @@ void AbstractAccount::setIndexable(bool indexable)
 QUrl AbstractAccount::apiUrl(const QString &path) const
 {
     QUrl url = QUrl::fromUserInput(m_instance_uri);
-    url.setScheme(QStringLiteral("https"));
+    // Plain HTTP is only used when asked for explicitly, and for servers on this device like the fake server the tests run against
+    const bool isLoopback = url.host() == "localhost"_L1 || QHostAddress(url.host()).isLoopback();
+    if (!m_instance_uri.startsWith("http://"_L1) || !isLoopback) {
+        url.setScheme(QStringLiteral("https"));
+    }
     url.setPath(path);
 
     return url;
@@ -276,11 +298,28 @@ Identity *AbstractAccount::identity()
 
 std::shared_ptr<Identity> AbstractAccount::identityLookup(const QString &accountId, const QJsonObject &doc)
 {
+    auto &metrics = Metrics::instance();
+    metrics.increment(u"identities.lookups"_s);
+
     if (m_identity && m_identity->id() == accountId) {
+        metrics.increment(u"identities.hits"_s);
         return m_identity;
     }
     auto id = m_identityCache[accountId];
     if (id && id->id() == accountId) {
+        metrics.increment(u"identities.hits"_s);
+        // Embedded accounts are at least as recent as what we have, and cheap to apply if nothing changed
+        if (!doc.isEmpty()) {
+            id->fromSourceData(doc);
+        } else if (id->isStale()) {
+            revalidateIdentity(id);
+        }
+        return id;
+    }
+
+    // Fill in placeholders created without any data, so everyone already holding on to them is updated too
+    if (id && !doc.isEmpty()) {
+        id->fromSourceData(doc);
         return id;
     }
 
@@ -292,6 +331,108 @@ std::shared_ptr<Identity> AbstractAccount::identityLookup(const QString &account
     return m_identityCache[accountId];
 }
 
+void AbstractAccount::revalidateIdentity(const std::shared_ptr<Identity> &identity)
+{
+    const QString accountId = identity->id();
+    if (m_revalidatingIdentities.contains(accountId) || m_revalidatingIdentities.size() >= maxIdentityRevalidations) {
+        return;
+    }
+    m_revalidatingIdentities.insert(accountId);
+
+    // The stale identity keeps being used in the meantime, and is updated in place once the response arrives
+    std::weak_ptr<Identity> weakIdentity = identity;
+    get(
+        apiUrl(QStringLiteral("/api/v1/accounts/%1").arg(accountId)),
+        true,
+        this,
+        [this, accountId, weakIdentity](QNetworkReply *reply) {
+            m_revalidatingIdentities.remove(accountId);
+
+            // This request is fallible, so we get to see errors here too
+            const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            if (statusCode < 200 || statusCode >= 300) {
+                return;
+            }
+
+            const auto doc = QJsonDocument::fromJson(reply->readAll());
+            if (const auto identity = weakIdentity.lock(); identity && doc.isObject()) {
+                identity->fromSourceData(doc.object());
+            }
+        },
+        [this, accountId](QNetworkReply *) {
+            m_revalidatingIdentities.remove(accountId);
+        },
+        true);
+}
+
+ProfileLoader *AbstractAccount::profileLoader()
+{
+    if (m_profileLoader == nullptr) {
+        m_profileLoader = new ProfileLoader(this);
+    }
+    return m_profileLoader;
+}
+
+StreamingManager *AbstractAccount::streaming()
+{
+    if (m_streaming == nullptr) {
+        m_streaming = new StreamingManager(this);
+
+        // The user stream drives the home timeline and notifications, other streams are picked up by their models
+        connect(m_streaming,
+                &StreamingManager::streamEvent,
+                this,
+                [this](const QString &stream, const StreamingEventType eventType, const QByteArray &payload) {
+                    // Edits are applied to the post wherever it's shown, no matter which stream they came from
+                    if (eventType == StatusUpdatedEvent) {
+                        Q_EMIT statusesUpdated(QJsonArray{QJsonDocument::fromJson(payload).object()});
+                    }
+
+                    if (stream != QStringLiteral("user")) {
+                        return;
+                    }
+
+                    if (eventType == FiltersChangedEvent) {
+                        filterEngine()->refresh();
+                    }
+
+                    if (Config::autoUpdate()) {
+                        Q_EMIT streamingEvent(eventType, payload);
+                    }
+
+                    if (eventType == NotificationEvent) {
+                        handleNotification(QJsonDocument::fromJson(payload));
+                    }
+                });
+    }
+    return m_streaming;
+}
+
+PostStore *AbstractAccount::postStore()
+{
+    if (m_postStore == nullptr) {
+        m_postStore = new PostStore(this);
+        connect(this, &AbstractAccount::statusesUpdated, m_postStore, &PostStore::update);
+    }
+    return m_postStore;
+}
+
+FilterEngine *AbstractAccount::filterEngine()
+{
+    if (m_filterEngine == nullptr) {
+        m_filterEngine = new FilterEngine(this);
+    }
+    return m_filterEngine;
+}
+
+MarkerSync *AbstractAccount::markerSync()
+{
+    if (m_markerSync == nullptr) {
+        m_markerSync = new MarkerSync(this);
+    }
+    return m_markerSync;
+}
+
 std::shared_ptr<AdminAccountInfo> AbstractAccount::adminIdentityLookup(const QString &accountId, const QJsonObject &doc)
 {
     if (m_adminIdentity && m_adminIdentity->userLevelIdentity()->id() == accountId) {
@@ -348,6 +489,13 @@ bool AbstractAccount::identityCached(const QString &accountId) const
     return id && id->id() == accountId;
 }
 
+qsizetype AbstractAccount::identityCacheSize() const
+{
+    return std::count_if(m_identityCache.cbegin(), m_identityCache.cend(), [](const auto &identity) {
+        return identity != nullptr;
+    });
+}
+
 QUrl AbstractAccount::getAuthorizeUrl() const
 {
     QUrl url = apiUrl(QStringLiteral("/oauth/authorize"));
@@ -537,6 +685,9 @@ void AbstractAccount::fetchInstanceMetadata()
                         m_attachmentFilterStrings.push_back(i18n("All files (*)"));
                     }
                     m_mediaAttachmentDescriptionLimit = mediaAttachmentsConfigObj["description_limit"_L1].toInt();
+                    m_imageSizeLimit = mediaAttachmentsConfigObj["image_size_limit"_L1].toInteger(m_imageSizeLimit);
+                    m_imageMatrixLimit = mediaAttachmentsConfigObj["image_matrix_limit"_L1].toInteger(m_imageMatrixLimit);
+                    m_videoSizeLimit = mediaAttachmentsConfigObj["video_size_limit"_L1].toInteger(m_videoSizeLimit);
                 }
 
                 if (configObj.contains("vapid"_L1)) {
@@ -627,23 +778,45 @@ void AbstractAccount::fetchInstanceMetadata()
 
 void AbstractAccount::saveTimelinePosition(const QString &timeline, const QString &lastReadId)
 {
-    QUrl uri = apiUrl(QStringLiteral("/api/v1/markers"));
+    markerSync()->setLastReadId(timeline, lastReadId);
+}
 
-    QUrlQuery urlQuery(uri);
-    urlQuery.addQueryItem(QStringLiteral("%1[last_read_id]").arg(timeline), lastReadId);
-    uri.setQuery(urlQuery);
+void AbstractAccount::refreshStatuses(const QStringList &postIds)
+{
+    for (qsizetype i = 0; i < postIds.size(); i += maxStatusesPerRequest) {
+        QUrlQuery query;
+        for (const auto &postId : postIds.mid(i, maxStatusesPerRequest)) {
+            query.addQueryItem(QStringLiteral("id[]"), postId);
+        }
+
+        QUrl url = apiUrl(QStringLiteral("/api/v1/statuses"));
+        url.setQuery(query);
 
-    post(uri, urlQuery, true, this, {});
+        // Servers before Mastodon 4.3 don't have this endpoint, in which case the posts simply aren't refreshed
+        get(
+            url,
+            true,
+            this,
+            [this](QNetworkReply *reply) {
+                const auto statuses = QJsonDocument::fromJson(reply->readAll()).array();
+                if (!statuses.isEmpty()) {
+                    Q_EMIT statusesUpdated(statuses);
+                }
+            },
+            nullptr,
+            true);
+    }
 }
 
 QUrl AbstractAccount::streamingUrl(const QString &stream)
 {
     QUrl url = QUrl(m_streamingUri);
     url.setPath(QStringLiteral("/api/v1/streaming"));
-    url.setQuery(QUrlQuery{
-        {QStringLiteral("access_token"), m_token},
-        {QStringLiteral("stream"), stream},
-    });
+    QUrlQuery query{{QStringLiteral("access_token"), m_token}};
+    if (!stream.isEmpty()) {
+        query.addQueryItem(QStringLiteral("stream"), stream);
+    }
+    url.setQuery(query);
 
     return url;
 }
@@ -983,6 +1156,21 @@ int AbstractAccount::mediaAttachmentDescriptionLimit() const
     return m_mediaAttachmentDescriptionLimit;
 }
 
+qint64 AbstractAccount::imageSizeLimit() const
+{
+    return m_imageSizeLimit;
+}
+
+qint64 AbstractAccount::imageMatrixLimit() const
+{
+    return m_imageMatrixLimit;
+}
+
+qint64 AbstractAccount::videoSizeLimit() const
+{
+    return m_videoSizeLimit;
+}
+
 int AbstractAccount::maxDisplayNameLength() const
 {
     return m_maxDisplayNameLength;
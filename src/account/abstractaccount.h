@@ -12,10 +12,17 @@
 #include "utils/customemoji.h"
 
 #include <QCoroTask>
+#include <QJsonArray>
 #include <QJsonObject>
+#include <QSet>
 #include <QtQml/qqmlregistration.h>
 
+class FilterEngine;
 class Notification;
+class MarkerSync;
+class PostStore;
+class ProfileLoader;
+class StreamingManager;
 class QNetworkReply;
 class QHttpMultiPart;
 
@@ -206,6 +213,9 @@ public:
     /**
      * @brief Looks up an identity specific to this account (like relationships) using an accountId and optionally a JSON document containing identity
      * information.
+     *
+     * A cached identity is updated in place with @p doc. If no document is given and the cached identity is stale, it is
+     * returned as is and refreshed from the server in the background.
      * @param accountId The account ID.
      * @param doc Optionally provide an existing account JSON, if you were already given some in another request.
      * @return The requested identity.
@@ -219,6 +229,36 @@ public:
      */
     [[nodiscard]] bool identityCached(const QString &accountId) const;
 
+    /**
+     * @return How many identities are in the account's identity cache.
+     */
+    [[nodiscard]] qsizetype identityCacheSize() const;
+
+    /**
+     * @return The loader for profile pages, shared by every model showing a part of a profile.
+     */
+    [[nodiscard]] ProfileLoader *profileLoader();
+
+    /**
+     * @return The streaming connection of this account, shared by every model that streams.
+     */
+    [[nodiscard]] StreamingManager *streaming();
+
+    /**
+     * @return The posts of this account, shared by every model that shows them.
+     */
+    [[nodiscard]] PostStore *postStore();
+
+    /**
+     * @return The keyword and status filters of this account, applied to every post.
+     */
+    [[nodiscard]] FilterEngine *filterEngine();
+
+    /**
+     * @return The read markers of this account, which are sent to the server a few at a time.
+     */
+    [[nodiscard]] MarkerSync *markerSync();
+
     /**
      * Get identity of the admin::account.
      * @param accountId The account ID to look up.
@@ -238,12 +278,19 @@ public:
     std::shared_ptr<ReportInfo> reportInfoLookup(const QString &reportId, const QJsonObject &doc);
 
     /**
-     * @brief Saves the timeline position.
+     * @brief Saves the timeline position. It's sent to the server later, together with the other timeline.
      * @param timeline Which timeline to save, right now can only be "home" or "notifications"
      * @param lastReadId The last read post id.
+     * @see MarkerSync
      */
     Q_INVOKABLE void saveTimelinePosition(const QString &timeline, const QString &lastReadId);
 
+    /**
+     * @brief Fetches the latest version of the posts in @p postIds, for example to update their interaction counts.
+     * @see statusesUpdated()
+     */
+    void refreshStatuses(const QStringList &postIds);
+
     /**
      * @brief Favorite a post.
      * @param p The post object to mutate.
@@ -316,7 +363,7 @@ public:
 
     /**
      * @brief Returns a streaming url for @p stream.
-     * @param stream The requested stream (e.g. user).
+     * @param stream The requested stream (e.g. user), or an empty string to subscribe to streams later on.
      */
     QUrl streamingUrl(const QString &stream);
 
@@ -430,7 +477,8 @@ public:
      * @brief Upload a file to the server.
      * @param filename The name of the file to upload.
      * @param callback The callback that should be executed if the request is successful.
-     * @return
+     * @note The server may answer with 202 Accepted if the media is still being processed, see MediaUploadJob.
+     * @return The reply for the upload request, to track its progress.
      */
     virtual QNetworkReply *upload(const QUrl &filename, std::function<void(QNetworkReply *)> callback) = 0;
 
@@ -641,6 +689,21 @@ public:
      */
     int mediaAttachmentDescriptionLimit() const;
 
+    /**
+     * @return The maximum size of an image attachment, in bytes.
+     */
+    qint64 imageSizeLimit() const;
+
+    /**
+     * @return The maximum number of pixels (width times height) of an image attachment.
+     */
+    qint64 imageMatrixLimit() const;
+
+    /**
+     * @return The maximum size of a video attachment, in bytes.
+     */
+    qint64 videoSizeLimit() const;
+
     /**
      * @return The maximum length allowed for an account’s display name.
      */
@@ -750,6 +813,13 @@ Q_SIGNALS:
      */
     void streamingEvent(AbstractAccount::StreamingEventType eventType, const QByteArray &payload);
 
+    /**
+     * @brief Emitted when newer versions of posts are known, either because they were edited or refreshed.
+     * @param statuses The updated statuses, as returned by the API.
+     * @see refreshStatuses()
+     */
+    void statusesUpdated(const QJsonArray &statuses);
+
     /**
      * @brief Emitted when the number of follow requests was changed.
      */
@@ -825,6 +895,11 @@ protected:
     std::shared_ptr<ReportInfo> m_reportInfo;
     Preferences *m_preferences = nullptr;
     NotificationFilteringPolicy *m_notificationFilteringPolicy = nullptr;
+    ProfileLoader *m_profileLoader = nullptr;
+    StreamingManager *m_streaming = nullptr;
+    PostStore *m_postStore = nullptr;
+    FilterEngine *m_filterEngine = nullptr;
+    MarkerSync *m_markerSync = nullptr;
     QList<CustomEmoji> m_customEmojis;
     QString m_additionalScopes;
     AccountConfig *m_config = nullptr;
@@ -841,6 +916,9 @@ protected:
     QHash<QString, int> m_supportedApiVersions;
     bool m_indexable = false;
     int m_mediaAttachmentDescriptionLimit;
+    qint64 m_imageSizeLimit;
+    qint64 m_imageMatrixLimit;
+    qint64 m_videoSizeLimit;
     int m_maxDisplayNameLength;
     int m_maxNoteLength;
     int m_maxAvatarDescriptionLength;
@@ -856,6 +934,13 @@ protected:
 
     void mutatePost(const QString &id, const QString &verb, bool deliver_home = false);
     QMap<QString, std::shared_ptr<Identity>> m_identityCache;
+    QSet<QString> m_revalidatingIdentities;
+
+    /**
+     * @brief Fetches @p identity again in the background, and updates it in place.
+     */
+    void revalidateIdentity(const std::shared_ptr<Identity> &identity);
+
     QMap<QString, std::shared_ptr<AdminAccountInfo>> m_adminIdentityCache;
     QMap<QString, AdminAccountInfo *> m_adminIdentityCacheWithVanillaPointer;
     QMap<QString, std::shared_ptr<ReportInfo>> m_reportInfoCache;
@@ -4,9 +4,15 @@
 
 #include "account/account.h"
 
+#include "account/filterengine.h"
 #include "account/notificationhandler.h"
+#include "account/streamingmanager.h"
 #include "network/networkcontroller.h"
+#include "network/networkrecorder.h"
 #include "tokodon_http_debug.h"
+#include "utils/metrics.h"
+#include "utils/startuptrace.h"
+#include "utils/tracing.h"
 
 #ifdef HAVE_KUNIFIEDPUSH
 #include "tokodon_debug.h"
@@ -17,6 +23,7 @@
 
 #include <KLocalizedString>
 #include <QCoroSignal>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QHttpMultiPart>
 #include <QJsonDocument>
@@ -26,6 +33,8 @@
 #include <config.h>
 #include <qt6keychain/keychain.h>
 
+#include <algorithm>
+
 using namespace Qt::Literals::StringLiterals;
 
 Account::Account(const QString &instanceUri, QNetworkAccessManager *nam, QObject *parent)
@@ -222,11 +231,157 @@ QNetworkRequest Account::makeRequest(const QUrl &url, bool authenticated) const
     return request;
 }
 
+// The routes the latency is measured for. Segments starting with a colon stand for any value, and the first route that fits wins,
+// so the fixed ones go before the ones with a placeholder in the same place.
+static const auto routes = [] {
+    const std::initializer_list<QStringView> templates{
+        u"/api/v1/accounts",
+        u"/api/v1/accounts/familiar_followers",
+        u"/api/v1/accounts/relationships",
+        u"/api/v1/accounts/update_credentials",
+        u"/api/v1/accounts/verify_credentials",
+        u"/api/v1/accounts/:id",
+        u"/api/v1/accounts/:id/collections",
+        u"/api/v1/accounts/:id/endorsements",
+        u"/api/v1/accounts/:id/featured_tags",
+        u"/api/v1/accounts/:id/followers",
+        u"/api/v1/accounts/:id/following",
+        u"/api/v1/accounts/:id/statuses",
+        u"/api/v1/accounts/:id/:action",
+        u"/api/v1/admin/accounts/:id",
+        u"/api/v1/admin/accounts/:id/:action",
+        u"/api/v1/admin/domain_allows",
+        u"/api/v1/admin/domain_allows/:id",
+        u"/api/v1/admin/domain_blocks",
+        u"/api/v1/admin/domain_blocks/:id",
+        u"/api/v1/admin/email_domain_blocks",
+        u"/api/v1/admin/email_domain_blocks/:id",
+        u"/api/v1/admin/ip_blocks",
+        u"/api/v1/admin/ip_blocks/:id",
+        u"/api/v1/admin/reports",
+        u"/api/v1/admin/reports/:id",
+        u"/api/v1/admin/reports/:id/:action",
+        u"/api/v1/announcements",
+        u"/api/v1/announcements/:id/reactions/:name",
+        u"/api/v1/annual_reports",
+        u"/api/v1/apps",
+        u"/api/v1/blocks",
+        u"/api/v1/bookmarks",
+        u"/api/v1/collections",
+        u"/api/v1/collections/:id",
+        u"/api/v1/collections/:id/items",
+        u"/api/v1/collections/:id/items/:id",
+        u"/api/v1/conversations",
+        u"/api/v1/conversations/:id/read",
+        u"/api/v1/custom_emojis",
+        u"/api/v1/domain_blocks",
+        u"/api/v1/favourites",
+        u"/api/v1/follow_requests",
+        u"/api/v1/follow_requests/:id/:action",
+        u"/api/v1/instance",
+        u"/api/v1/instance/:kind",
+        u"/api/v1/lists",
+        u"/api/v1/lists/:id",
+        u"/api/v1/lists/:id/accounts",
+        u"/api/v1/markers",
+        u"/api/v1/media/:id",
+        u"/api/v1/mutes",
+        u"/api/v1/notifications",
+        u"/api/v1/notifications/unread_count",
+        u"/api/v1/notifications/:id",
+        u"/api/v1/notifications/:id/:action",
+        u"/api/v1/polls/:id/votes",
+        u"/api/v1/preferences",
+        u"/api/v1/push/subscription",
+        u"/api/v1/reports",
+        u"/api/v1/scheduled_statuses",
+        u"/api/v1/scheduled_statuses/:id",
+        u"/api/v1/statuses",
+        u"/api/v1/statuses/:id",
+        u"/api/v1/statuses/:id/context",
+        u"/api/v1/statuses/:id/favourited_by",
+        u"/api/v1/statuses/:id/reblogged_by",
+        u"/api/v1/statuses/:id/source",
+        u"/api/v1/statuses/:id/:action",
+        u"/api/v1/streaming",
+        u"/api/v1/tags/:name",
+        u"/api/v1/tags/:name/:action",
+        u"/api/v1/timelines/home",
+        u"/api/v1/timelines/link",
+        u"/api/v1/timelines/public",
+        u"/api/v1/timelines/list/:id",
+        u"/api/v1/timelines/tag/:name",
+        u"/api/v1/trends/links",
+        u"/api/v1/trends/statuses",
+        u"/api/v1/trends/tags",
+        u"/api/v2/admin/accounts",
+        u"/api/v2/filters",
+        u"/api/v2/filters/:id",
+        u"/api/v2/instance",
+        u"/api/v2/media",
+        u"/api/v2/notifications/policy",
+        u"/api/v2/search",
+        u"/api/v2/suggestions",
+        u"/oauth/token",
+    };
+
+    QList<std::pair<QString, QStringList>> parsed;
+    for (const auto route : templates) {
+        parsed.append({route.toString(), route.toString().split(u'/', Qt::SkipEmptyParts)});
+    }
+    return parsed;
+}();
+
+// The route of @p url, so the latency of e.g. all the posts adds up to the same one. Anything else, like media or remote objects,
+// counts as "/other", so there's a fixed number of them.
+static QString endpointName(const QUrl &url)
+{
+    const auto path = url.path();
+    const auto segments = QStringView(path).split(u'/', Qt::SkipEmptyParts);
+    for (const auto &[name, routeSegments] : routes) {
+        if (routeSegments.size() != segments.size()) {
+            continue;
+        }
+        const bool matches = std::ranges::equal(routeSegments, segments, [](const QString &routeSegment, const QStringView segment) {
+            return routeSegment.startsWith(u':') || routeSegment == segment;
+        });
+        if (matches) {
+            return name;
+        }
+    }
+    return u"/other"_s;
+}
+
 void Account::handleReply(QNetworkReply *reply, std::function<void(QNetworkReply *)> reply_cb, std::function<void(QNetworkReply *)> errorCallback) const
 {
-    connect(reply, &QNetworkReply::finished, [reply, reply_cb, errorCallback]() {
+    const qint64 traceStart = Tracing::now();
+    QElapsedTimer requestTimer;
+    requestTimer.start();
+    const qint64 recordingStart = NetworkRecorder::instance().elapsed();
+
+    connect(reply, &QNetworkReply::uploadProgress, reply, [](const qint64 bytesSent, const qint64 bytesTotal) {
+        if (bytesTotal > 0 && bytesSent == bytesTotal) {
+            Metrics::instance().increment(u"network.bytesSent"_s, bytesTotal);
+        }
+    });
+    connect(reply, &QNetworkReply::finished, [reply, reply_cb, errorCallback, traceStart, requestTimer, recordingStart]() {
         reply->deleteLater();
 
+        if (auto &recorder = NetworkRecorder::instance(); recorder.isRecording()) {
+            recorder.recordReply(reply, recordingStart);
+        }
+
+        const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (Tracing::isRecording()) {
+            Tracing::async("network", reply->url().path(), traceStart, u"HTTP %1"_s.arg(statusCode));
+        }
+        const Tracing::Scope trace("network", "Account::handleReply");
+
+        auto &metrics = Metrics::instance();
+        metrics.increment(u"network.requests"_s);
+        metrics.increment(u"network.bytesReceived"_s, reply->bytesAvailable());
+        metrics.observe(u"network.latency"_s + endpointName(reply->url()), requestTimer.elapsed());
+
         if (reply->hasRawHeader(QByteArrayLiteral("Mastodon-Async-Refresh"))) {
             qCWarning(TOKODON_HTTP)
                 << "We got a Mastodon-Async-Refresh but we don't implement those yet! This is meant as a warning for the developers of Tokodon:"
@@ -235,7 +390,9 @@ void Account::handleReply(QNetworkReply *reply, std::function<void(QNetworkReply
 
         // these are usually (sometimes meant to be) fallible and end up spamming user logs with these errors
         const auto fallible = reply->request().attribute(QNetworkRequest::Attribute::User).toBool();
-        if (200 != reply->attribute(QNetworkRequest::HttpStatusCodeAttribute) && !fallible) {
+        // Some endpoints answer with other successful codes, like 202 Accepted for media that is still being processed
+        if ((statusCode < 200 || statusCode >= 300) && !fallible) {
+            metrics.increment(u"network.errors"_s);
             NetworkController::instance().logError(reply->url().toString(), reply->errorString());
             if (errorCallback) {
                 errorCallback(reply);
@@ -265,7 +422,8 @@ QNetworkReply *Account::upload(const QUrl &filename, std::function<void(QNetwork
 
     mp->append(filePart);
 
-    const auto uploadUrl = apiUrl(QStringLiteral("/api/v1/media"));
+    // The v2 endpoint returns as soon as the file is received, larger media is then processed asynchronously
+    const auto uploadUrl = apiUrl(QStringLiteral("/api/v2/media"));
     qCDebug(TOKODON_HTTP) << "POST" << uploadUrl << "(upload)";
 
     return post(uploadUrl, mp, true, this, callback);
@@ -282,62 +440,6 @@ void Account::requestRemoteObject(const QUrl &remoteUrl, QObject *parent, std::f
     get(url, true, parent, std::move(callback));
 }
 
-static QMap<QString, AbstractAccount::StreamingEventType> stringToStreamingEventType = {
-    {QStringLiteral("update"), AbstractAccount::StreamingEventType::UpdateEvent},
-    {QStringLiteral("delete"), AbstractAccount::StreamingEventType::DeleteEvent},
-    {QStringLiteral("notification"), AbstractAccount::StreamingEventType::NotificationEvent},
-    {QStringLiteral("filters_changed"), AbstractAccount::StreamingEventType::FiltersChangedEvent},
-    {QStringLiteral("conversation"), AbstractAccount::StreamingEventType::ConversationEvent},
-    {QStringLiteral("announcement"), AbstractAccount::StreamingEventType::AnnouncementEvent},
-    {QStringLiteral("announcement.reaction"), AbstractAccount::StreamingEventType::AnnouncementRedactedEvent},
-    {QStringLiteral("announcement.delete"), AbstractAccount::StreamingEventType::AnnouncementDeletedEvent},
-    {QStringLiteral("status.update"), AbstractAccount::StreamingEventType::StatusUpdatedEvent},
-    {QStringLiteral("encrypted_message"), AbstractAccount::StreamingEventType::EncryptedMessageChangedEvent},
-};
-
-QWebSocket *Account::streamingSocket(const QString &stream)
-{
-    if (m_token.isEmpty()) {
-        return nullptr;
-    }
-
-    if (m_websockets.contains(stream)) {
-        return m_websockets[stream];
-    }
-
-    auto socket = new QWebSocket();
-    socket->setParent(this);
-
-    const auto url = streamingUrl(stream);
-
-    connect(socket, &QWebSocket::textMessageReceived, this, [this](const QString &message) {
-        const auto env = QJsonDocument::fromJson(message.toLocal8Bit());
-        if (env.isObject() && env.object().contains("event"_L1)) {
-            const auto event = stringToStreamingEventType[env.object()["event"_L1].toString()];
-            if (Config::autoUpdate()) {
-                Q_EMIT streamingEvent(event, env.object()["payload"_L1].toString().toLocal8Bit());
-            }
-
-            if (event == NotificationEvent) {
-                const auto doc = QJsonDocument::fromJson(env.object()["payload"_L1].toString().toLocal8Bit());
-                handleNotification(doc);
-                return;
-            }
-        }
-    });
-    connect(socket, &QWebSocket::errorOccurred, this, [=](QAbstractSocket::SocketError) {
-        NetworkController::instance().logError(url.toString(), socket->errorString());
-    });
-
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::UserAgentHeader,
-                      QStringLiteral("%1/%2").arg(QCoreApplication::applicationName(), QCoreApplication::applicationVersion()));
-    socket->open(request);
-
-    m_websockets[stream] = socket;
-    return socket;
-}
-
 void Account::validateToken()
 {
     const QUrl verify_credentials = apiUrl(QStringLiteral("/api/v1/accounts/verify_credentials"));
@@ -376,6 +478,8 @@ void Account::validateToken()
             m_authenticated = true;
             Q_EMIT authenticated(true, {});
 
+            filterEngine()->refresh();
+
 #ifdef HAVE_KUNIFIEDPUSH
             // Query whether or not we have a valid push subscription from the server.
             get(
@@ -430,17 +534,34 @@ void Account::validateToken()
         this,
         [this] {
             // set up streaming for notifications once we have the streaming URI
-            streamingSocket(QStringLiteral("user"));
+            if (!streaming()->isSubscribed(QStringLiteral("user"))) {
+                streaming()->subscribe(QStringLiteral("user"));
+            }
+            streaming()->start();
         },
         Qt::SingleShotConnection);
 }
 
-void Account::setConfig(AccountConfig *config)
+void Account::setConfig(AccountConfig *config, const bool deferValidation)
 {
     m_config = config;
+    m_deferValidation = deferValidation;
     buildFromSettings();
 }
 
+void Account::validateDeferred()
+{
+    if (!m_deferValidation) {
+        return;
+    }
+
+    // If the credentials are still being read, it's validated once they are
+    m_deferValidation = false;
+    if (m_credentialsLoaded) {
+        validateToken();
+    }
+}
+
 void Account::writeToSettings()
 {
     if (!m_onlineAccountId.isEmpty()) {
@@ -483,22 +604,29 @@ QCoro::Task<> Account::buildFromSettings()
     accessTokenJob->setKey(accessTokenKey());
     accessTokenJob->setAutoDelete(false);
 
-    accessTokenJob->start();
-    co_await qCoro(accessTokenJob, &QKeychain::ReadPasswordJob::finished);
-
     auto clientSecretJob = new QKeychain::ReadPasswordJob{QStringLiteral("Tokodon"), this};
 #ifdef SAILFISHOS
     clientSecretJob->setInsecureFallback(true);
 #endif
     clientSecretJob->setKey(clientSecretKey());
     clientSecretJob->setAutoDelete(false);
+
+    // Both are read at the same time. The signals are connected before starting, so neither is missed while waiting for the other.
+    auto accessTokenRead = qCoro(accessTokenJob, &QKeychain::ReadPasswordJob::finished);
+    auto clientSecretRead = qCoro(clientSecretJob, &QKeychain::ReadPasswordJob::finished);
+    accessTokenJob->start();
     clientSecretJob->start();
-    co_await qCoro(clientSecretJob, &QKeychain::ReadPasswordJob::finished);
+    co_await accessTokenRead;
+    co_await clientSecretRead;
 
     setAccessToken(accessTokenJob->textData());
     m_client_secret = clientSecretJob->textData();
+    StartupTrace::mark(QStringLiteral("credentials loaded"), settingsGroupName());
 
-    validateToken();
+    m_credentialsLoaded = true;
+    if (!m_deferValidation) {
+        validateToken();
+    }
 
     accessTokenJob->deleteLater();
     clientSecretJob->deleteLater();
@@ -7,7 +7,7 @@
 #include "account/abstractaccount.h"
 #include "account/relationship.h"
 
-#include <QWebSocket>
+#include <QNetworkRequest>
 
 class AccountConfig;
 
@@ -58,7 +58,6 @@ public:
     QNetworkReply *upload(const QUrl &filename, std::function<void(QNetworkReply *)> callback) override;
     void requestRemoteObject(const QUrl &url, QObject *parent, std::function<void(QNetworkReply *)> callback) override;
 
-    QWebSocket *streamingSocket(const QString &stream);
     QNetworkAccessManager *qnam()
     {
         return m_qnam;
@@ -70,7 +69,17 @@ public:
 
     void validateToken() override;
 
-    void setConfig(AccountConfig *config);
+    /**
+     * @brief Loads the account from @p config, reading its credentials from the keychain.
+     * @param deferValidation Whether to wait for validateDeferred() before validating the token and connecting, instead of doing so
+     * as soon as the credentials are read.
+     */
+    void setConfig(AccountConfig *config, bool deferValidation = false);
+
+    /**
+     * @brief Validates the token of an account that was loaded with deferred validation, once its credentials are read.
+     */
+    void validateDeferred();
 
     Q_INVOKABLE void checkForFollowRequests() override;
 
@@ -90,9 +99,10 @@ private:
     QUrlQuery buildNotificationFormData();
 
     QNetworkAccessManager *m_qnam;
-    QMap<QString, QWebSocket *> m_websockets;
     bool m_hasPushSubscription = false;
     bool m_authenticated = false;
+    bool m_credentialsLoaded = false;
+    bool m_deferValidation = false;
 
     QString m_onlineAccountId;
 
@@ -24,19 +24,45 @@
 #endif
 
 #include "account/account.h"
+#include "account/poststore.h"
 #include "config.h"
 #include "network/networkaccessmanagerfactory.h"
 #include "tokodon_debug.h"
+#include "utils/metrics.h"
+#include "utils/startuptrace.h"
+#include "utils/tracing.h"
 
 #include <qt6keychain/keychain.h>
 
 using namespace Qt::Literals::StringLiterals;
 
+static constexpr std::chrono::seconds backgroundValidationInterval{2};
+
 AccountManager::AccountManager(QObject *parent)
     : QAbstractListModel(parent)
     , m_qnam(NetworkAccessManagerFactory().create(this))
     , m_notificationHandler(new NotificationHandler(m_qnam, this))
 {
+    // The accounts that aren't shown at startup are validated one after another, so they don't compete with the one that is
+    m_backgroundValidationTimer.setSingleShot(true);
+    m_backgroundValidationTimer.setInterval(backgroundValidationInterval);
+    connect(&m_backgroundValidationTimer, &QTimer::timeout, this, [this] {
+        if (!m_validationQueue.isEmpty()) {
+            m_validationQueue.takeFirst()->validateDeferred();
+        }
+        if (!m_validationQueue.isEmpty()) {
+            m_backgroundValidationTimer.start();
+        }
+    });
+
+    Metrics::instance().setSampler(u"identities.cached"_s, [this] {
+        qint64 size = 0;
+        for (const auto account : std::as_const(m_accounts)) {
+            size += account->identityCacheSize();
+        }
+        return size;
+    });
+
 #ifdef HAVE_DBUS
     if (QDBusConnection::sessionBus().interface()->isServiceRegistered(u"org.kde.KOnlineAccounts"_s)) {
         initOnlineAccounts();
@@ -233,6 +259,9 @@ void AccountManager::addAccount(AbstractAccount *account)
     }
     endInsertRows();
 
+    // Accounts validated in the background don't hold up the startup, which is already done by then
+    const bool validatesInBackground = std::ranges::find(m_validationQueue, account) != m_validationQueue.cend();
+
     Q_EMIT accountAdded(account);
     Q_EMIT accountsChanged();
     connect(account, &Account::identityChanged, this, [this, account]() {
@@ -240,16 +269,22 @@ void AccountManager::addAccount(AbstractAccount *account)
         account->writeToSettings();
     });
     if (!account->successfullyAuthenticated()) {
-        connect(account, &Account::authenticated, this, [this, acctIndex](const bool authenticated, const QString &errorMessage) {
-            if (authenticated) {
-                m_accountStatus[acctIndex] = AccountStatus::Loaded;
-            } else {
-                m_accountStatus[acctIndex] = AccountStatus::InvalidCredentials;
-                m_accountStatusStrings[acctIndex] = errorMessage;
-            }
-            Q_EMIT dataChanged(index(acctIndex, 0), index(acctIndex, 0));
-            checkIfLoadingFinished();
-        });
+        connect(account,
+                &Account::authenticated,
+                this,
+                [this, account, acctIndex, validatesInBackground](const bool authenticated, const QString &errorMessage) {
+                    if (authenticated) {
+                        m_accountStatus[acctIndex] = AccountStatus::Loaded;
+                        StartupTrace::mark(QStringLiteral("account authenticated"), account->settingsGroupName());
+                    } else {
+                        m_accountStatus[acctIndex] = AccountStatus::InvalidCredentials;
+                        m_accountStatusStrings[acctIndex] = errorMessage;
+                    }
+                    Q_EMIT dataChanged(index(acctIndex, 0), index(acctIndex, 0));
+                    if (!validatesInBackground || account == m_startupAccount) {
+                        checkIfLoadingFinished();
+                    }
+                });
     }
     connect(account, &Account::fetchedInstanceMetadata, this, [this, acctIndex]() {
         Q_EMIT dataChanged(index(acctIndex, 0), index(acctIndex, 0));
@@ -257,6 +292,10 @@ void AccountManager::addAccount(AbstractAccount *account)
     connect(account, &Account::notification, this, [this, account](std::shared_ptr<Notification> n) {
         notificationHandler()->handle(std::move(n), account);
     });
+    connect(account->postStore(), &PostStore::postUpdated, this, &AccountManager::postUpdated);
+    connect(account->postStore(), &PostStore::filtersApplied, this, [this, account] {
+        Q_EMIT filtersApplied(account);
+    });
 
     if (m_selected_account == nullptr) {
         m_selected_account = account;
@@ -307,9 +346,13 @@ void AccountManager::removeAccount(AbstractAccount *account)
     beginRemoveRows(QModelIndex(), index, index);
     m_accounts.removeOne(account);
     endRemoveRows();
+    m_validationQueue.removeIf([account](const Account *queuedAccount) {
+        return queuedAccount == account;
+    });
 
     if (hasAccounts()) {
         m_selected_account = m_accounts.first();
+        validateDeferred(m_selected_account);
     } else {
         m_selected_account = nullptr;
     }
@@ -379,6 +422,7 @@ void AccountManager::selectAccount(AbstractAccount *account, bool explicitUserAc
     }
 
     m_selected_account = account;
+    validateDeferred(account);
 
     if (explicitUserAction && !testMode()) {
         auto config = Config::self();
@@ -415,8 +459,11 @@ void AccountManager::loadFromSettings()
     }
 
     qCDebug(TOKODON_LOG) << "Loading accounts from settings.";
+    const Tracing::Scope trace("startup", "AccountManager::loadFromSettings");
+    StartupTrace::mark(QStringLiteral("loading accounts"));
 
     auto config = KSharedConfig::openStateConfig();
+    const auto lastUsedAccount = Config::self()->lastUsedAccount();
     for (const auto &id : config->groupList()) {
         if (id.contains('@'_L1)) {
             // The id is normally made up of two parts. <username>@<instance>
@@ -435,12 +482,28 @@ void AccountManager::loadFromSettings()
                 continue;
             }
 
+            // Only the account shown first is validated and connected right away, the others can wait until it's loaded.
+            // Old values of LastUsedAccount are only the username.
+            const bool isLastUsed = lastUsedAccount.contains(u'@') ? id == lastUsedAccount : idParts.first() == lastUsedAccount;
+            const bool isStartupAccount = m_startupAccount == nullptr && (isLastUsed || lastUsedAccount.isEmpty() || lastUsedAccount == "@"_L1);
+
             const auto account = new Account(accountConfig->instanceUri(), m_qnam, this);
-            account->setConfig(accountConfig);
+            account->setConfig(accountConfig, !isStartupAccount);
+            if (isStartupAccount) {
+                m_startupAccount = account;
+            } else {
+                m_validationQueue.append(account);
+            }
             addAccount(account);
         }
     }
 
+    // The last used account is gone, so show the first one instead
+    if (m_startupAccount == nullptr && !m_validationQueue.isEmpty()) {
+        m_startupAccount = m_validationQueue.takeFirst();
+        m_startupAccount->validateDeferred();
+    }
+
     checkIfLoadingFinished();
 }
 
@@ -453,15 +516,24 @@ void AccountManager::checkIfLoadingFinished()
         return;
     }
 
-    // ensure every account is loaded, or has an error
-    const bool finished = std::ranges::none_of(std::as_const(m_accountStatus), [](const auto status) {
-        return status == AccountStatus::NotLoaded;
-    });
+    // ensure every account is loaded, or has an error, except the ones validated in the background
+    bool finished = true;
+    for (qsizetype i = 0; i < m_accountStatus.size() && i < m_accounts.size(); i++) {
+        const bool validatesInBackground = m_startupAccount != nullptr && m_accounts[i] != m_startupAccount.data();
+        if (m_accountStatus[i] == AccountStatus::NotLoaded && !validatesInBackground) {
+            finished = false;
+        }
+    }
     if (!finished) {
         return;
     }
 
     qCDebug(TOKODON_LOG) << "Accounts have finished loading.";
+    StartupTrace::mark(QStringLiteral("accounts ready"));
+
+    if (!m_validationQueue.isEmpty() && !m_backgroundValidationTimer.isActive()) {
+        m_backgroundValidationTimer.start();
+    }
 
     auto config = Config::self();
 
@@ -487,6 +559,17 @@ void AccountManager::checkIfLoadingFinished()
     Q_EMIT accountsReady();
 }
 
+void AccountManager::validateDeferred(AbstractAccount *account)
+{
+    // Shown before its turn came, so it can't wait any longer
+    const auto it = std::ranges::find(m_validationQueue, account);
+    if (it != m_validationQueue.cend()) {
+        const auto queuedAccount = *it;
+        m_validationQueue.erase(it);
+        queuedAccount->validateDeferred();
+    }
+}
+
 bool AccountManager::isReady() const
 {
     return m_ready;
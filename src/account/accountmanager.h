@@ -12,9 +12,12 @@
 
 #include <QAbstractListModel>
 #include <QJSEngine>
+#include <QPointer>
+#include <QTimer>
 #include <QWindow>
 
 class AbstractAccount;
+class Account;
 class QNetworkAccessManager;
 
 class QDBusObjectPath;
@@ -218,6 +221,16 @@ Q_SIGNALS:
 
     void identityChanged(AbstractAccount *account);
 
+    /**
+     * @brief Forwards PostStore::postUpdated() of every account, so models don't have to follow account switches.
+     */
+    void postUpdated(Post *post, Post::Changes changes);
+
+    /**
+     * @brief Forwards PostStore::filtersApplied() of every account.
+     */
+    void filtersApplied(AbstractAccount *account);
+
 public Q_SLOTS:
 
     void childIdentityChanged(AbstractAccount *account);
@@ -251,5 +264,10 @@ private:
     bool m_hasAnyAccounts = false;
     bool m_testMode = false;
 
+    QPointer<Account> m_startupAccount; ///< The account shown at startup, which is loaded before the others
+    QList<Account *> m_validationQueue; ///< Accounts whose validation waits until the startup account is loaded
+    QTimer m_backgroundValidationTimer;
+
     void checkIfLoadingFinished();
+    void validateDeferred(AbstractAccount *account);
 };
@@ -4,9 +4,9 @@
 #include "account/featuredtagsmodel.h"
 
 #include <QJsonDocument>
-#include <QNetworkReply>
 
 #include "account/accountmanager.h"
+#include "account/profileloader.h"
 #include "account/relationship.h"
 
 using namespace Qt::StringLiterals;
@@ -60,14 +60,17 @@ QHash<int, QByteArray> FeaturedTagsModel::roleNames() const
 
 void FeaturedTagsModel::fill()
 {
-    const auto account = AccountManager::instance().selectedAccount();
-
-    account->get(
-        account->apiUrl(QStringLiteral("/api/v1/accounts/%1/featured_tags").arg(m_accountId)),
-        true,
-        this,
-        [this](QNetworkReply *reply) {
-            const auto doc = QJsonDocument::fromJson(reply->readAll());
+    const auto loader = AccountManager::instance().selectedAccount()->profileLoader();
+
+    disconnect(m_profileLoaderConnection);
+    m_profileLoaderConnection =
+        connect(loader, &ProfileLoader::partLoaded, this, [this](const QString &accountId, ProfileLoader::Part part, const ProfileLoader::Response &response) {
+            if (accountId != m_accountId || part != ProfileLoader::FeaturedTagsPart) {
+                return;
+            }
+            disconnect(m_profileLoaderConnection);
+
+            const auto doc = QJsonDocument::fromJson(response.data);
             auto tags = doc.array().toVariantList();
 
             if (!tags.isEmpty()) {
@@ -81,6 +84,9 @@ void FeaturedTagsModel::fill()
                 endInsertRows();
             }
         });
+
+    // Usually this was already fetched (or is being fetched) together with the rest of the profile
+    loader->request(m_accountId, ProfileLoader::FeaturedTagsPart);
 }
 
 #include "moc_featuredtagsmodel.cpp"
@@ -41,4 +41,5 @@ private:
 
     QString m_accountId;
     QVector<QString> m_tags;
+    QMetaObject::Connection m_profileLoaderConnection;
 };
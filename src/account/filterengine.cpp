@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "account/filterengine.h"
+
+#include "account/abstractaccount.h"
+#include "datatypes/post.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+
+using namespace Qt::Literals::StringLiterals;
+
+static bool isWordCharacter(const QChar character)
+{
+    return character.isLetterOrNumber() || character.isMark() || character == u'_';
+}
+
+FilterEngine::FilterEngine(AbstractAccount *account)
+    : QObject(account)
+    , m_account(account)
+{
+    m_expiryTimer.setSingleShot(true);
+    connect(&m_expiryTimer, &QTimer::timeout, this, [this] {
+        setFilters(m_source);
+    });
+}
+
+void FilterEngine::refresh()
+{
+    m_account->get(
+        m_account->apiUrl(QStringLiteral("/api/v2/filters")),
+        true,
+        this,
+        [this](QNetworkReply *reply) {
+            const auto doc = QJsonDocument::fromJson(reply->readAll());
+            if (doc.isArray()) {
+                setFilters(doc.array());
+            }
+        },
+        [](QNetworkReply *reply) {
+            // Not fatal, like on servers without v2 filters. Until they could be fetched, the filters the server marks posts
+            // with are applied instead.
+            Q_UNUSED(reply)
+        });
+}
+
+void FilterEngine::setFilters(const QJsonArray &filters)
+{
+    m_source = filters;
+    m_filters.clear();
+    m_keywords.clear();
+    m_nodes = {Node{}};
+    m_transitions.clear();
+    m_statusFilters.clear();
+
+    const auto now = QDateTime::currentDateTimeUtc();
+    QDateTime nextExpiry;
+
+    for (const auto &value : filters) {
+        const auto filter = value.toObject();
+
+        const auto expiresAtValue = filter["expires_at"_L1];
+        if (expiresAtValue.isString()) {
+            const auto expiresAt = QDateTime::fromString(expiresAtValue.toString(), Qt::ISODate);
+            if (expiresAt <= now) {
+                continue;
+            }
+            if (!nextExpiry.isValid() || expiresAt < nextExpiry) {
+                nextExpiry = expiresAt;
+            }
+        }
+
+        const int index = static_cast<int>(m_filters.size());
+        m_filters.append(Filter{
+            .title = filter["title"_L1].toString(),
+            .contexts = contextsFromJson(filter["context"_L1].toArray()),
+            .hide = filter["filter_action"_L1].toString() == "hide"_L1,
+        });
+
+        const auto keywords = filter["keywords"_L1].toArray();
+        for (const auto &keywordValue : keywords) {
+            const auto keywordObj = keywordValue.toObject();
+            const auto keyword = keywordObj["keyword"_L1].toString().toCaseFolded();
+            if (keyword.isEmpty()) {
+                continue;
+            }
+
+            // Like the server, only look for word boundaries on the sides of the keyword that are part of a word
+            const bool wholeWord = keywordObj["whole_word"_L1].toBool();
+            addKeyword(keyword,
+                       Keyword{
+                           .filter = index,
+                           .length = keyword.size(),
+                           .boundaryBefore = wholeWord && isWordCharacter(keyword.front()),
+                           .boundaryAfter = wholeWord && isWordCharacter(keyword.back()),
+                       });
+        }
+
+        const auto statuses = filter["statuses"_L1].toArray();
+        for (const auto &statusValue : statuses) {
+            m_statusFilters.insert(StatusId(statusValue.toObject()["status_id"_L1].toString()), index);
+        }
+    }
+
+    buildFailureLinks();
+
+    if (nextExpiry.isValid()) {
+        m_expiryTimer.start(std::chrono::milliseconds(std::max<qint64>(now.msecsTo(nextExpiry), 0)));
+    } else {
+        m_expiryTimer.stop();
+    }
+
+    m_loaded = true;
+    Q_EMIT changed();
+}
+
+bool FilterEngine::isLoaded() const
+{
+    return m_loaded;
+}
+
+QList<FilterEngine::Match> FilterEngine::match(const Post &post) const
+{
+    if (m_filters.isEmpty()) {
+        return {};
+    }
+
+    // Searches the same text as the server does
+    QStringList text;
+    if (!post.spoilerText().isEmpty()) {
+        text.append(post.spoilerText());
+    }
+    text.append(post.contentText());
+    if (const auto poll = post.poll()) {
+        const auto options = poll->options();
+        for (const auto &option : options) {
+            text.append(option.value(u"title"_s).toString());
+        }
+    }
+    const auto attachments = post.attachments();
+    for (const auto attachment : attachments) {
+        if (!attachment->description().isEmpty()) {
+            text.append(attachment->description());
+        }
+    }
+
+    return match(text.join("\n\n"_L1), post.statusId());
+}
+
+QList<FilterEngine::Match> FilterEngine::match(const QString &text, const StatusId &statusId) const
+{
+    if (m_filters.isEmpty()) {
+        return {};
+    }
+
+    QList<bool> matched(m_filters.size(), false);
+    if (!statusId.isEmpty()) {
+        const auto statusFilters = m_statusFilters.values(statusId);
+        for (const int filter : statusFilters) {
+            matched[filter] = true;
+        }
+    }
+
+    if (!m_keywords.isEmpty()) {
+        const QString folded = text.toCaseFolded();
+
+        int node = 0;
+        for (qsizetype i = 0; i < folded.size(); i++) {
+            const char16_t character = folded[i].unicode();
+
+            int next = transition(node, character);
+            while (next == -1 && node != 0) {
+                node = m_nodes[node].fail;
+                next = transition(node, character);
+            }
+            node = next == -1 ? 0 : next;
+
+            for (const int keywordIndex : m_nodes[node].keywords) {
+                const auto &keyword = m_keywords[keywordIndex];
+                if (matched[keyword.filter]) {
+                    continue;
+                }
+
+                const qsizetype start = i - keyword.length + 1;
+                if (keyword.boundaryBefore && start > 0 && isWordCharacter(folded[start - 1])) {
+                    continue;
+                }
+                if (keyword.boundaryAfter && i + 1 < folded.size() && isWordCharacter(folded[i + 1])) {
+                    continue;
+                }
+                matched[keyword.filter] = true;
+            }
+        }
+    }
+
+    QList<Match> matches;
+    for (qsizetype i = 0; i < m_filters.size(); i++) {
+        if (matched[i]) {
+            const auto &filter = m_filters[i];
+            matches.append(Match{.title = filter.title, .contexts = filter.contexts, .hide = filter.hide});
+        }
+    }
+    return matches;
+}
+
+QList<FilterEngine::Match> FilterEngine::fromServer(const QJsonArray &filtered)
+{
+    QList<Match> matches;
+    for (const auto &value : filtered) {
+        const auto filter = value.toObject()["filter"_L1].toObject();
+
+        // The server only marks a status with the filters that apply where it was requested from, so without contexts assume it applies everywhere
+        auto contexts = contextsFromJson(filter["context"_L1].toArray());
+        if (!contexts) {
+            contexts = ~Contexts();
+        }
+
+        matches.append(Match{
+            .title = filter["title"_L1].toString(),
+            .contexts = contexts,
+            .hide = filter["filter_action"_L1].toString() == "hide"_L1,
+        });
+    }
+    return matches;
+}
+
+FilterEngine::Contexts FilterEngine::contextsFromJson(const QJsonArray &contexts)
+{
+    static const QHash<QString, Context> names = {
+        {QStringLiteral("home"), HomeContext},
+        {QStringLiteral("notifications"), NotificationsContext},
+        {QStringLiteral("public"), PublicContext},
+        {QStringLiteral("thread"), ThreadContext},
+        {QStringLiteral("account"), AccountContext},
+    };
+
+    Contexts result;
+    for (const auto &context : contexts) {
+        if (const auto it = names.constFind(context.toString()); it != names.cend()) {
+            result |= *it;
+        }
+    }
+    return result;
+}
+
+void FilterEngine::addKeyword(const QString &keyword, const Keyword &info)
+{
+    int node = 0;
+    for (const QChar character : keyword) {
+        int next = transition(node, character.unicode());
+        if (next == -1) {
+            next = static_cast<int>(m_nodes.size());
+            m_nodes.append(Node{});
+            m_nodes[node].children.append({character.unicode(), next});
+            m_transitions.insert((quint64(node) << 16) | character.unicode(), next);
+        }
+        node = next;
+    }
+
+    m_nodes[node].keywords.append(static_cast<int>(m_keywords.size()));
+    m_keywords.append(info);
+}
+
+void FilterEngine::buildFailureLinks()
+{
+    // Breadth first, so the failure links of the shorter suffixes are known already
+    QList<int> queue;
+    for (const auto &[character, child] : std::as_const(m_nodes[0].children)) {
+        m_nodes[child].fail = 0;
+        queue.append(child);
+    }
+
+    for (qsizetype i = 0; i < queue.size(); i++) {
+        const int node = queue[i];
+        const auto children = m_nodes[node].children;
+        for (const auto &[character, child] : children) {
+            int fail = m_nodes[node].fail;
+            int next = transition(fail, character);
+            while (next == -1 && fail != 0) {
+                fail = m_nodes[fail].fail;
+                next = transition(fail, character);
+            }
+            m_nodes[child].fail = next == -1 ? 0 : next;
+
+            // Whatever ends at the suffix ends here as well
+            m_nodes[child].keywords += m_nodes[m_nodes[child].fail].keywords;
+            queue.append(child);
+        }
+    }
+}
+
+int FilterEngine::transition(const int node, const char16_t character) const
+{
+    return m_transitions.value((quint64(node) << 16) | character, -1);
+}
+
+#include "moc_filterengine.cpp"
@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QMultiHash>
+#include <QObject>
+#include <QTimer>
+
+#include "datatypes/statusid.h"
+
+class AbstractAccount;
+class Post;
+
+/**
+ * @brief Applies the keyword and status filters of an account to posts locally.
+ *
+ * The server only marks the posts it sends in reply to a request as filtered, so streamed posts and posts resolved from
+ * other servers wouldn't be, and changing a filter needed the timelines to be fetched again. Instead, the filters are fetched
+ * once and compiled into an Aho-Corasick automaton of all their keywords. Matching a post then takes a single pass over its
+ * text, no matter how many keywords there are.
+ *
+ * The text searched is the same as the server's: the content warning, the content, the poll options and the media
+ * descriptions. Keywords match case-insensitively, and whole word keywords only match where they aren't part of a longer word.
+ *
+ * When the filters change, for example because they were edited on another device, they are fetched again and changed() is
+ * emitted so the posts already shown can be filtered again.
+ */
+class FilterEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Where a filter applies.
+     */
+    enum Context : quint8 {
+        HomeContext = 1 << 0, /**< The home timeline and lists. */
+        NotificationsContext = 1 << 1, /**< Notifications. */
+        PublicContext = 1 << 2, /**< Public timelines, hashtags and everything else. */
+        ThreadContext = 1 << 3, /**< Conversations and threads. */
+        AccountContext = 1 << 4, /**< Profiles. */
+    };
+    Q_DECLARE_FLAGS(Contexts, Context)
+
+    /**
+     * @brief A filter that applies to a post.
+     */
+    struct Match {
+        QString title;
+        Contexts contexts;
+        bool hide = false; ///< Whether the post is hidden, instead of shown behind a warning
+
+        bool operator==(const Match &other) const = default;
+    };
+
+    explicit FilterEngine(AbstractAccount *account);
+
+    /**
+     * @brief Fetches the filters of the account, and applies them from then on.
+     */
+    void refresh();
+
+    /**
+     * @brief Compiles @p filters, a list of v2 filters. Expired filters are skipped.
+     */
+    void setFilters(const QJsonArray &filters);
+
+    /**
+     * @return Whether the filters were fetched. Until then, the filters the server marked posts with are used instead.
+     */
+    [[nodiscard]] bool isLoaded() const;
+
+    /**
+     * @return The filters that apply to @p post.
+     */
+    [[nodiscard]] QList<Match> match(const Post &post) const;
+
+    /**
+     * @return The filters that match @p text, or the status with @p statusId.
+     */
+    [[nodiscard]] QList<Match> match(const QString &text, const StatusId &statusId = {}) const;
+
+    /**
+     * @return The filters the server marked a status with, from its @c filtered array.
+     */
+    [[nodiscard]] static QList<Match> fromServer(const QJsonArray &filtered);
+
+    /**
+     * @return The contexts of a filter, from its @c context array.
+     */
+    [[nodiscard]] static Contexts contextsFromJson(const QJsonArray &contexts);
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when the filters changed, and posts should be filtered again.
+     */
+    void changed();
+
+private:
+    struct Filter {
+        QString title;
+        Contexts contexts;
+        bool hide = false;
+    };
+
+    struct Keyword {
+        int filter = 0;
+        qsizetype length = 0;
+        bool boundaryBefore = false; ///< Whether the keyword can't be preceded by a word character
+        bool boundaryAfter = false; ///< Whether the keyword can't be followed by a word character
+    };
+
+    struct Node {
+        int fail = 0; ///< The node of the longest proper suffix that is in the trie as well
+        QList<int> keywords; ///< Keywords ending here, including the ones of the suffixes
+        QList<std::pair<char16_t, int>> children;
+    };
+
+    void addKeyword(const QString &keyword, const Keyword &info);
+    void buildFailureLinks();
+    [[nodiscard]] int transition(int node, char16_t character) const;
+
+    AbstractAccount *const m_account;
+    bool m_loaded = false;
+    QList<Filter> m_filters;
+    QList<Keyword> m_keywords;
+    QList<Node> m_nodes;
+    QHash<quint64, int> m_transitions; ///< By the node, shifted left by 16 bits, and the character
+    QMultiHash<StatusId, int> m_statusFilters;
+    QJsonArray m_source; ///< Compiled again once the next filter expires
+    QTimer m_expiryTimer;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(FilterEngine::Contexts)
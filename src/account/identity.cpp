@@ -9,6 +9,9 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+// Counts and avatars change often enough that a profile shouldn't be older than this
+static constexpr int staleAfter = 5 * 60;
+
 QString Identity::displayName() const
 {
     return !m_displayName.isEmpty() ? m_displayName : m_username;
@@ -154,6 +157,16 @@ void Identity::reparentIdentity(AbstractAccount *parent)
 
 void Identity::fromSourceData(const QJsonObject &doc)
 {
+    if (!doc.isEmpty()) {
+        m_updatedAt = QDateTime::currentDateTimeUtc();
+    }
+
+    // The same accounts are embedded in lots of posts and notifications, so skip the parsing below when nothing changed
+    if (!m_source.isEmpty() && doc == m_source) {
+        return;
+    }
+    m_source = doc;
+
     m_id = doc["id"_L1].toString();
     m_displayName = doc["display_name"_L1].toString();
     m_username = doc["username"_L1].toString();
@@ -219,8 +232,10 @@ void Identity::fromSourceData(const QJsonObject &doc)
     }
 
     if (doc.contains("moved"_L1)) {
-        m_movedIdentity = new Identity();
-        m_movedIdentity->setParent(m_parent);
+        if (m_movedIdentity == nullptr) {
+            m_movedIdentity = new Identity();
+            m_movedIdentity->setParent(m_parent);
+        }
         m_movedIdentity->fromSourceData(doc["moved"_L1].toObject());
     }
 
@@ -242,6 +257,11 @@ void Identity::fromSourceData(const QJsonObject &doc)
     Q_EMIT identityUpdated();
 }
 
+bool Identity::isStale() const
+{
+    return m_updatedAt.isValid() && m_updatedAt.secsTo(QDateTime::currentDateTimeUtc()) >= staleAfter;
+}
+
 QString Identity::id() const
 {
     return m_id;
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QJsonArray>
+#include <QJsonObject>
 #include <qqmlregistration.h>
 
 class AbstractAccount;
@@ -145,10 +147,18 @@ public:
 
     /**
      * @brief Fills in identity data from JSON.
+     *
+     * Does nothing (except marking the identity as fresh) if @p doc is the same as the data already loaded.
      * @param doc The JSON data to load from.
      */
     void fromSourceData(const QJsonObject &doc);
 
+    /**
+     * @return Whether the identity hasn't been updated from the server in a while, and should be refreshed.
+     * Identities that were never filled in are not considered stale.
+     */
+    [[nodiscard]] bool isStale() const;
+
     /**
      * @brief Sets the parent account for this identity.
      * @param parent The account to reparent to.
@@ -253,4 +263,7 @@ private:
     bool m_memorial;
     bool m_suspended;
     QJsonArray m_roles;
+
+    QJsonObject m_source;
+    QDateTime m_updatedAt;
 };
@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "account/markersync.h"
+
+#include "account/abstractaccount.h"
+#include "datatypes/statusid.h"
+
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QNetworkReply>
+#include <QUrlQuery>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+// Long enough to cover a reading session's worth of scrolling, short enough for other devices to catch up soon
+static constexpr std::chrono::seconds flushInterval{10};
+
+// Failed requests are tried again after twice as long each time, up to this
+static constexpr std::chrono::seconds maxRetryInterval{std::chrono::minutes{10}};
+
+static const QString homeTimeline = QStringLiteral("home");
+static const QString notificationsTimeline = QStringLiteral("notifications");
+
+MarkerSync::MarkerSync(AbstractAccount *account)
+    : QObject(account)
+    , m_account(account)
+    , m_retryInterval(flushInterval)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(flushInterval);
+    connect(&m_flushTimer, &QTimer::timeout, this, &MarkerSync::flush);
+
+    if (const auto app = qobject_cast<QGuiApplication *>(QCoreApplication::instance())) {
+        connect(app, &QGuiApplication::applicationStateChanged, this, [this](const Qt::ApplicationState state) {
+            if (state == Qt::ApplicationSuspended || state == Qt::ApplicationHidden) {
+                flush();
+            }
+        });
+    }
+    if (const auto app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, &MarkerSync::flush);
+    }
+
+    // Send what couldn't be sent the last time
+    if (const auto config = m_account->config()) {
+        if (!config->pendingHomeMarker().isEmpty()) {
+            m_pending.insert(homeTimeline, config->pendingHomeMarker());
+        }
+        if (!config->pendingNotificationsMarker().isEmpty()) {
+            m_pending.insert(notificationsTimeline, config->pendingNotificationsMarker());
+        }
+        if (!m_pending.isEmpty()) {
+            m_flushTimer.start();
+        }
+    }
+}
+
+void MarkerSync::setLastReadId(const QString &timeline, const QString &lastReadId)
+{
+    if (lastReadId.isEmpty() || StatusId(lastReadId) <= StatusId(this->lastReadId(timeline))) {
+        return;
+    }
+
+    // Saved once they're about to be sent, instead of on every move
+    m_pending.insert(timeline, lastReadId);
+
+    if (!m_unsupported && !m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+QString MarkerSync::lastReadId(const QString &timeline) const
+{
+    const auto pending = m_pending.value(timeline);
+    const auto server = m_server.value(timeline).lastReadId;
+    return StatusId(pending) > StatusId(server) ? pending : server;
+}
+
+void MarkerSync::setServerMarkers(const QJsonObject &markers)
+{
+    const auto pendingCount = m_pending.size();
+    for (const auto &timeline : {homeTimeline, notificationsTimeline}) {
+        const auto markerObj = markers[timeline].toObject();
+        if (markerObj.isEmpty()) {
+            continue;
+        }
+
+        // Replies can arrive out of order, and an older version shouldn't undo a newer one
+        const Marker marker{
+            .lastReadId = markerObj["last_read_id"_L1].toString(),
+            .version = markerObj["version"_L1].toInt(),
+        };
+        if (const auto it = m_server.constFind(timeline); it != m_server.cend() && it->version > marker.version) {
+            continue;
+        }
+        m_server.insert(timeline, marker);
+
+        // Already there, or moved further on another device
+        if (m_pending.contains(timeline) && StatusId(m_pending[timeline]) <= StatusId(marker.lastReadId)) {
+            m_pending.remove(timeline);
+        }
+    }
+
+    if (m_pending.size() != pendingCount) {
+        save();
+    }
+}
+
+bool MarkerSync::hasPendingMarkers() const
+{
+    return !m_pending.isEmpty();
+}
+
+std::chrono::milliseconds MarkerSync::nextFlush() const
+{
+    return m_flushTimer.remainingTimeAsDuration();
+}
+
+void MarkerSync::flush()
+{
+    m_flushTimer.stop();
+    if (m_unsupported || m_pending.isEmpty()) {
+        return;
+    }
+
+    // In case the request doesn't make it, like when quitting
+    save();
+    sendPendingMarkers(true);
+}
+
+void MarkerSync::sendPendingMarkers(const bool retryOnConflict)
+{
+    if (m_sending || m_pending.isEmpty()) {
+        return;
+    }
+
+    QJsonObject markers;
+    for (const auto &[timeline, lastReadId] : m_pending.asKeyValueRange()) {
+        markers[timeline] = QJsonObject{{u"last_read_id"_s, lastReadId}};
+    }
+
+    m_sending = true;
+    m_account->post(
+        m_account->apiUrl(QStringLiteral("/api/v1/markers")),
+        QJsonDocument(markers),
+        true,
+        this,
+        [this](QNetworkReply *reply) {
+            m_sending = false;
+            m_retryInterval = flushInterval;
+            m_flushTimer.setInterval(flushInterval);
+            setServerMarkers(QJsonDocument::fromJson(reply->readAll()).object());
+
+            // Markers that moved while these were being sent
+            if (!m_pending.isEmpty() && !m_flushTimer.isActive()) {
+                m_flushTimer.start();
+            }
+        },
+        [this, retryOnConflict](QNetworkReply *reply) {
+            m_sending = false;
+
+            // Another device saved its markers at the same time, so see where they are now before trying again
+            if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 409 && retryOnConflict) {
+                fetchServerMarkers();
+            } else {
+                handleError(reply);
+            }
+        });
+}
+
+void MarkerSync::fetchServerMarkers()
+{
+    QUrl url = m_account->apiUrl(QStringLiteral("/api/v1/markers"));
+    url.setQuery(QUrlQuery{{QStringLiteral("timeline[]"), homeTimeline}, {QStringLiteral("timeline[]"), notificationsTimeline}});
+
+    m_account->get(
+        url,
+        true,
+        this,
+        [this](QNetworkReply *reply) {
+            setServerMarkers(QJsonDocument::fromJson(reply->readAll()).object());
+            sendPendingMarkers(false);
+        },
+        [this](QNetworkReply *reply) {
+            handleError(reply);
+        });
+}
+
+void MarkerSync::handleError(QNetworkReply *reply)
+{
+    switch (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()) {
+    case 404:
+        // Not a Mastodon-compatible server, or one without markers. They're still kept here, but not sent anymore.
+        m_unsupported = true;
+        m_flushTimer.stop();
+        break;
+    case 422:
+        // The server won't take these markers no matter how often they are sent, so only newer ones are sent
+        m_pending.clear();
+        save();
+        m_retryInterval = flushInterval;
+        m_flushTimer.setInterval(flushInterval);
+        break;
+    default:
+        retryLater();
+        break;
+    }
+}
+
+void MarkerSync::retryLater()
+{
+    m_flushTimer.start(m_retryInterval);
+    m_retryInterval = std::min(m_retryInterval * 2, maxRetryInterval);
+}
+
+void MarkerSync::save()
+{
+    if (const auto config = m_account->config()) {
+        config->setPendingHomeMarker(m_pending.value(homeTimeline));
+        config->setPendingNotificationsMarker(m_pending.value(notificationsTimeline));
+        config->save();
+    }
+}
+
+#include "moc_markersync.cpp"
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QTimer>
+
+class AbstractAccount;
+class QNetworkReply;
+
+/**
+ * @brief Sends the read markers of an account to the server, a few at a time.
+ *
+ * Scrolling moves the read marker of a timeline many times, and sending each one would be a request per post. Instead only the
+ * newest marker of each timeline is kept, and all of them are sent in one request once a while passed, or when the application
+ * is suspended or quits.
+ *
+ * Until they are sent the markers are saved in the account settings, so they are sent the next time if the application quit before
+ * that. Markers never move back: one the server has that is newer, for example because it was moved on another device, wins over
+ * ours. The version of the markers tells apart the replies that were sent before ours from the newer ones.
+ *
+ * Failed requests are tried again with a growing delay. Servers without the markers API are not asked again.
+ */
+class MarkerSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MarkerSync(AbstractAccount *account);
+
+    /**
+     * @brief Moves the read marker of @p timeline, either "home" or "notifications", to @p lastReadId. It's sent later.
+     *
+     * Markers only move forward, so nothing happens if @p lastReadId isn't newer than the current one.
+     */
+    void setLastReadId(const QString &timeline, const QString &lastReadId);
+
+    /**
+     * @return The last read id of @p timeline, including the one that wasn't sent yet.
+     */
+    [[nodiscard]] QString lastReadId(const QString &timeline) const;
+
+    /**
+     * @brief Remembers the markers of the server, as in a reply from the markers API.
+     */
+    void setServerMarkers(const QJsonObject &markers);
+
+    /**
+     * @return Whether there are markers that weren't sent yet.
+     */
+    [[nodiscard]] bool hasPendingMarkers() const;
+
+    /**
+     * @return How long until the pending markers are sent, or a negative duration if nothing is scheduled.
+     */
+    [[nodiscard]] std::chrono::milliseconds nextFlush() const;
+
+public Q_SLOTS:
+    /**
+     * @brief Sends the markers that weren't sent yet right away.
+     */
+    void flush();
+
+private:
+    struct Marker {
+        QString lastReadId;
+        int version = 0;
+    };
+
+    void sendPendingMarkers(bool retryOnConflict);
+    void fetchServerMarkers();
+    void handleError(QNetworkReply *reply);
+    void retryLater();
+    void save();
+
+    AbstractAccount *const m_account;
+    QHash<QString, QString> m_pending; ///< By timeline
+    QHash<QString, Marker> m_server; ///< By timeline, as far as we know
+    QTimer m_flushTimer;
+    std::chrono::seconds m_retryInterval;
+    bool m_sending = false;
+    bool m_unsupported = false; ///< The server has no markers API
+};
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "account/poststore.h"
+
+#include "account/abstractaccount.h"
+#include "account/filterengine.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+PostStore::PostStore(AbstractAccount *account)
+    : QObject(account)
+    , m_account(account)
+{
+    connect(account->filterEngine(), &FilterEngine::changed, this, &PostStore::applyFilters);
+}
+
+Post *PostStore::acquire(const QJsonObject &status, QObject *holder)
+{
+    const StatusId postId(status["id"_L1].toString());
+
+    Post *post = m_posts.value(postId);
+    if (post != nullptr) {
+        // For boosts it's the boosted status that may have changed
+        const auto reblog = status["reblog"_L1].toObject();
+        post->update(post->boosted() && !reblog.isEmpty() ? reblog : status);
+    } else {
+        post = new Post(m_account, status, this);
+        if (!postId.isEmpty()) {
+            m_posts.insert(postId, post);
+        }
+        m_statuses.insert(post->statusId(), post);
+
+        connect(post, &Post::updated, this, [this, post](const Post::Changes changes) {
+            Q_EMIT postUpdated(post, changes);
+
+            // Keep the boosts of a status in sync with it, and the other way around. Posts that are already in sync don't emit updated(),
+            // so this stops after one round.
+            if (changes.testAnyFlags(Post::CountsChange | Post::InteractionsChange)) {
+                const auto siblings = m_statuses.values(post->statusId());
+                for (const auto sibling : siblings) {
+                    if (sibling != post) {
+                        sibling->syncInteractions(*post);
+                    }
+                }
+            }
+        });
+    }
+
+    if (!m_holders.contains(holder)) {
+        m_holders.insert(holder);
+        connect(holder, &QObject::destroyed, this, [this, holder] {
+            releaseHolder(holder);
+        });
+    }
+    m_holds[post].append(holder);
+
+    return post;
+}
+
+void PostStore::release(Post *post, const QObject *holder)
+{
+    if (post == nullptr) {
+        return;
+    }
+
+    if (const auto store = qobject_cast<PostStore *>(post->parent())) {
+        store->releaseHold(post, holder);
+    }
+}
+
+void PostStore::release(const QList<Post *> &posts, const QObject *holder)
+{
+    for (const auto post : posts) {
+        release(post, holder);
+    }
+}
+
+Post *PostStore::find(const QString &postId) const
+{
+    return m_posts.value(StatusId(postId));
+}
+
+qsizetype PostStore::size() const
+{
+    return m_holds.size();
+}
+
+void PostStore::update(const QJsonArray &statuses)
+{
+    for (const auto &value : statuses) {
+        const auto status = value.toObject();
+        const auto posts = m_statuses.values(StatusId(status["id"_L1].toString()));
+        for (const auto post : posts) {
+            post->update(status);
+        }
+    }
+}
+
+void PostStore::applyFilters()
+{
+    // Models may let go of posts while this runs
+    m_applyingFilters = true;
+    const auto posts = m_holds.keys();
+    for (const auto post : posts) {
+        if (m_holds.contains(post)) {
+            post->applyFilters();
+        }
+    }
+    m_applyingFilters = false;
+
+    Q_EMIT filtersApplied();
+}
+
+bool PostStore::isApplyingFilters() const
+{
+    return m_applyingFilters;
+}
+
+void PostStore::releaseHold(Post *post, const QObject *holder)
+{
+    const auto it = m_holds.find(post);
+    if (it == m_holds.end()) {
+        return;
+    }
+
+    it->removeOne(holder);
+    if (it->isEmpty()) {
+        m_holds.erase(it);
+        forget(post);
+    }
+}
+
+void PostStore::releaseHolder(const QObject *holder)
+{
+    m_holders.remove(holder);
+
+    QList<Post *> unheld;
+    for (auto it = m_holds.begin(); it != m_holds.end();) {
+        it->removeAll(holder);
+        if (it->isEmpty()) {
+            unheld.append(it.key());
+            it = m_holds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto post : std::as_const(unheld)) {
+        forget(post);
+    }
+}
+
+void PostStore::forget(Post *post)
+{
+    if (m_posts.value(post->originalStatusId()) == post) {
+        m_posts.remove(post->originalStatusId());
+    }
+    m_statuses.remove(post->statusId(), post);
+
+    // QML may still look at it while the rows showing it go away
+    disconnect(post, nullptr, this, nullptr);
+    post->deleteLater();
+}
+
+#include "moc_poststore.cpp"
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMultiHash>
+#include <QObject>
+#include <QSet>
+
+#include "datatypes/post.h"
+
+class AbstractAccount;
+
+/**
+ * @brief Keeps a single Post per status of an account, shared by every model that shows it.
+ *
+ * Models acquire the posts they show instead of creating their own, and release them once they don't show them anymore.
+ * A post is deleted later once the last model holding it releases it, or is destroyed. Because there is only one copy of a post,
+ * favoriting it or receiving an edit updates it everywhere at once, and postUpdated() tells the models which rows to refresh.
+ * The same goes for the filters of the account, which are applied to every post again when they change.
+ *
+ * Boosts are separate posts, as they have their own id and booster. They are linked to the boosted status by its id, so
+ * updates to the status and our own interactions with it are applied to the boosts as well.
+ */
+class PostStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PostStore(AbstractAccount *account);
+
+    /**
+     * @brief Returns the post for @p status, held by @p holder until it's released.
+     *
+     * If the post is already known it's shared, and updated with @p status as that is the most recent version of it.
+     */
+    Post *acquire(const QJsonObject &status, QObject *holder);
+
+    /**
+     * @brief Releases @p post, that was acquired by @p holder. It's deleted later once nobody holds it anymore.
+     * @note Works with posts of any account, so it's still right after a model switched accounts.
+     */
+    static void release(Post *post, const QObject *holder);
+
+    /**
+     * @brief Releases all of @p posts, that were acquired by @p holder.
+     */
+    static void release(const QList<Post *> &posts, const QObject *holder);
+
+    /**
+     * @return The post with @p postId, or nullptr if nobody holds it.
+     */
+    [[nodiscard]] Post *find(const QString &postId) const;
+
+    /**
+     * @return The number of posts held.
+     */
+    [[nodiscard]] qsizetype size() const;
+
+    /**
+     * @brief Applies the newer versions of @p statuses to their posts, and the boosts of them.
+     * @see AbstractAccount::statusesUpdated()
+     */
+    void update(const QJsonArray &statuses);
+
+    /**
+     * @return Whether the filters are being applied to every post, after they changed.
+     * @see filtersApplied()
+     */
+    [[nodiscard]] bool isApplyingFilters() const;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when @p post changed, for the models showing it to refresh its row.
+     */
+    void postUpdated(Post *post, Post::Changes changes);
+
+    /**
+     * @brief Emitted once the changed filters were applied to every post, after postUpdated() was emitted for each post they changed.
+     */
+    void filtersApplied();
+
+private:
+    void applyFilters();
+    void releaseHold(Post *post, const QObject *holder);
+    void releaseHolder(const QObject *holder);
+    void forget(Post *post);
+
+    AbstractAccount *const m_account;
+    QHash<StatusId, Post *> m_posts; ///< By the id of the post, which is the id of the boost for boosts
+    QMultiHash<StatusId, Post *> m_statuses; ///< By the id of the status, which is the boosted status for boosts
+    QHash<Post *, QList<const QObject *>> m_holds; ///< Holders are listed once per time they acquired the post
+    QSet<const QObject *> m_holders;
+    bool m_applyingFilters = false;
+};
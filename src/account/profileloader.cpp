@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "account/profileloader.h"
+
+#include <QNetworkReply>
+#include <QUrlQuery>
+
+#include "account/abstractaccount.h"
+
+// Long enough to make going back and forth between profiles instant, short enough to not show stale counts for long
+static constexpr int maxAge = 60;
+
+static constexpr qsizetype maxProfiles = 16;
+
+ProfileLoader::ProfileLoader(AbstractAccount *account)
+    : QObject(account)
+    , m_account(account)
+{
+}
+
+void ProfileLoader::load(const QString &accountId, const QUrl &statusesUrl, const QUrl &pinnedUrl)
+{
+    if (accountId.isEmpty()) {
+        return;
+    }
+
+    QList<std::pair<Part, QUrl>> parts;
+
+    // Like before, known identities are not fetched again
+    if (!m_account->identityCached(accountId)) {
+        parts.append({IdentityPart, {}});
+    }
+    if (!statusesUrl.isEmpty()) {
+        parts.append({StatusesPart, statusesUrl});
+    }
+    if (!pinnedUrl.isEmpty()) {
+        parts.append({PinnedPart, pinnedUrl});
+    }
+    parts.append({FeaturedTagsPart, {}});
+
+    const bool isSelf = m_account->identity() != nullptr && m_account->identity()->id() == accountId;
+    if (!isSelf) {
+        parts.append({RelationshipPart, {}});
+        parts.append({FamiliarFollowersPart, {}});
+    }
+
+    // Mark everything as waiting first, cached parts are emitted (and finished) synchronously
+    auto &profile = m_profiles[accountId];
+    profile.waiting.clear();
+    for (const auto &[part, url] : std::as_const(parts)) {
+        profile.waiting.insert(part);
+    }
+
+    for (const auto &[part, url] : std::as_const(parts)) {
+        request(accountId, part, url);
+    }
+}
+
+void ProfileLoader::request(const QString &accountId, const Part part, const QUrl &url)
+{
+    const QUrl partUrl = url.isEmpty() ? defaultUrl(accountId, part) : url;
+    if (accountId.isEmpty() || partUrl.isEmpty()) {
+        return;
+    }
+
+    auto &profile = m_profiles[accountId];
+    profile.lastUsed = QDateTime::currentDateTimeUtc();
+
+    if (const auto response = cached(accountId, part); response && response->url == partUrl) {
+        Q_EMIT partLoaded(accountId, part, *response);
+        finish(accountId, part);
+        return;
+    }
+
+    if (profile.pending.value(part) == partUrl) {
+        return;
+    }
+
+    // A request for a different URL (e.g. the filters of the page changed) supersedes the one in flight
+    profile.pending.insert(part, partUrl);
+    evict();
+
+    const auto isCurrent = [this, accountId, part, partUrl] {
+        const auto it = m_profiles.find(accountId);
+        return it != m_profiles.end() && it->pending.value(part) == partUrl;
+    };
+
+    m_account->get(
+        partUrl,
+        true,
+        this,
+        [this, accountId, part, partUrl, isCurrent](QNetworkReply *reply) {
+            if (!isCurrent()) {
+                return;
+            }
+
+            const Response response{partUrl, reply->readAll(), QString::fromUtf8(reply->rawHeader(QByteArrayLiteral("Link")))};
+
+            auto &profile = m_profiles[accountId];
+            profile.pending.remove(part);
+            // Relationships change as soon as we interact with the account, and so do the posts we favorite or boost. Those are
+            // never served from the cache, as the posts are shared with every timeline showing them and would be put back as they were.
+            if (part != RelationshipPart && part != StatusesPart && part != PinnedPart) {
+                profile.parts.insert(part, {response, QDateTime::currentDateTimeUtc()});
+            }
+
+            Q_EMIT partLoaded(accountId, part, response);
+            finish(accountId, part);
+        },
+        [this, accountId, part, isCurrent](QNetworkReply *reply) {
+            if (!isCurrent()) {
+                return;
+            }
+
+            m_profiles[accountId].pending.remove(part);
+
+            Q_EMIT partFailed(accountId, part, reply->errorString());
+            finish(accountId, part);
+        });
+}
+
+std::optional<ProfileLoader::Response> ProfileLoader::cached(const QString &accountId, const Part part) const
+{
+    const auto profile = m_profiles.constFind(accountId);
+    if (profile == m_profiles.cend()) {
+        return std::nullopt;
+    }
+
+    const auto it = profile->parts.constFind(part);
+    if (it == profile->parts.cend() || !isFresh(*it)) {
+        return std::nullopt;
+    }
+
+    return it->response;
+}
+
+QUrl ProfileLoader::defaultUrl(const QString &accountId, const Part part) const
+{
+    switch (part) {
+    case IdentityPart:
+        return m_account->apiUrl(QStringLiteral("/api/v1/accounts/%1").arg(accountId));
+    case RelationshipPart: {
+        QUrl url = m_account->apiUrl(QStringLiteral("/api/v1/accounts/relationships"));
+        url.setQuery(QUrlQuery{{QStringLiteral("id[]"), accountId}});
+        return url;
+    }
+    case FeaturedTagsPart:
+        return m_account->apiUrl(QStringLiteral("/api/v1/accounts/%1/featured_tags").arg(accountId));
+    case FamiliarFollowersPart: {
+        QUrl url = m_account->apiUrl(QStringLiteral("/api/v1/accounts/familiar_followers"));
+        url.setQuery(QUrlQuery{{QStringLiteral("id"), accountId}});
+        return url;
+    }
+    case StatusesPart:
+    case PinnedPart:
+        // These depend on the filters of the page
+        return {};
+    }
+    return {};
+}
+
+bool ProfileLoader::isFresh(const CachedPart &part) const
+{
+    return part.fetchedAt.secsTo(QDateTime::currentDateTimeUtc()) < maxAge;
+}
+
+void ProfileLoader::finish(const QString &accountId, const Part part)
+{
+    const auto it = m_profiles.find(accountId);
+    if (it == m_profiles.end()) {
+        return;
+    }
+
+    if (it->waiting.remove(part) && it->waiting.isEmpty()) {
+        Q_EMIT loaded(accountId);
+    }
+}
+
+void ProfileLoader::evict()
+{
+    while (m_profiles.size() > maxProfiles) {
+        auto oldest = m_profiles.end();
+        for (auto it = m_profiles.begin(); it != m_profiles.end(); ++it) {
+            if (it->pending.isEmpty() && (oldest == m_profiles.end() || it->lastUsed < oldest->lastUsed)) {
+                oldest = it;
+            }
+        }
+
+        // Everything is still loading, try again later
+        if (oldest == m_profiles.end()) {
+            return;
+        }
+        m_profiles.erase(oldest);
+    }
+}
+
+#include "moc_profileloader.cpp"
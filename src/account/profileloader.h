@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QUrl>
+
+#include <optional>
+
+class AbstractAccount;
+
+/**
+ * @brief Fetches everything shown on a profile page at once, and keeps it around for a short while.
+ *
+ * Opening a profile used to chain its requests (identity, then relationship; statuses, then pinned posts), with the
+ * featured tags and familiar followers fetched separately by their own models. The loader issues all of them
+ * concurrently, so the page fills in as each response arrives, and emits loaded() once all of them finished.
+ *
+ * Responses are cached per account for a minute, so going back and forth between profiles doesn't hit the network
+ * again. The relationship and the posts are always fetched again, as they change whenever we interact with them. Models that only need a single part (like FeaturedTagsModel) can request it too, which either reuses the
+ * cached response or joins the request that is already in flight.
+ */
+class ProfileLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProfileLoader(AbstractAccount *account);
+
+    enum Part {
+        IdentityPart, /**< The account itself. */
+        RelationshipPart, /**< Our relationship with the account, skipped for our own profile. */
+        StatusesPart, /**< The first page of posts. */
+        PinnedPart, /**< The pinned posts. */
+        FeaturedTagsPart, /**< The featured hashtags. */
+        FamiliarFollowersPart, /**< Followers of the account that we follow, skipped for our own profile. */
+    };
+    Q_ENUM(Part)
+
+    struct Response {
+        QUrl url;
+        QByteArray data;
+        QString linkHeader;
+    };
+
+    /**
+     * @brief Fetches every part of the profile of @p accountId concurrently.
+     * @param statusesUrl The URL of the first page of posts, which depends on the filters of the page, or an empty URL to skip them.
+     * @param pinnedUrl The URL of the pinned posts, or an empty URL to skip them.
+     */
+    void load(const QString &accountId, const QUrl &statusesUrl, const QUrl &pinnedUrl);
+
+    /**
+     * @brief Fetches a single part of the profile of @p accountId.
+     *
+     * If the part is cached, partLoaded() is emitted right away. If it's already being fetched, nothing happens and
+     * partLoaded() is emitted once it finishes.
+     * @param url The URL to fetch, only needed for StatusesPart and PinnedPart.
+     */
+    void request(const QString &accountId, Part part, const QUrl &url = {});
+
+    /**
+     * @return The cached response for @p part, if it's still fresh.
+     */
+    [[nodiscard]] std::optional<Response> cached(const QString &accountId, Part part) const;
+
+Q_SIGNALS:
+    void partLoaded(const QString &accountId, ProfileLoader::Part part, const ProfileLoader::Response &response);
+    void partFailed(const QString &accountId, ProfileLoader::Part part, const QString &errorString);
+
+    /**
+     * @brief Emitted once every part requested by load() has either finished or failed.
+     */
+    void loaded(const QString &accountId);
+
+private:
+    struct CachedPart {
+        Response response;
+        QDateTime fetchedAt;
+    };
+
+    struct Profile {
+        QHash<Part, CachedPart> parts;
+        QHash<Part, QUrl> pending;
+        QSet<Part> waiting; ///< Parts the last load() is still waiting for
+        QDateTime lastUsed;
+    };
+
+    [[nodiscard]] QUrl defaultUrl(const QString &accountId, Part part) const;
+    [[nodiscard]] bool isFresh(const CachedPart &part) const;
+    void finish(const QString &accountId, Part part);
+    void evict();
+
+    AbstractAccount *const m_account;
+    QHash<QString, Profile> m_profiles;
+};
@@ -5,9 +5,11 @@
 
 #include "account/abstractaccount.h"
 #include "account/accountmanager.h"
+#include "account/profileloader.h"
 #include "account/relationship.h"
 #include "networkcontroller.h"
 #include "texthandler.h"
+#include "utils/relativetimeclock.h"
 
 #include <KLocalizedString>
 #include <QJsonDocument>
@@ -19,6 +21,14 @@ using namespace Qt::Literals::StringLiterals;
 SocialGraphModel::SocialGraphModel(QObject *parent)
     : QAbstractListModel(parent)
 {
+    RelativeTimeClock::instance().track(
+        this,
+        RelativeTimeRole,
+        [this](const QModelIndex &index) {
+            const QDate lastStatusAt = m_accounts[index.row()]->lastStatusAt();
+            return lastStatusAt.isValid() ? lastStatusAt.startOfDay() : QDateTime();
+        },
+        RelativeTimeClock::Date);
 }
 
 QString SocialGraphModel::name() const
@@ -556,6 +566,40 @@ void SocialGraphModel::fillTimeline()
         uri = QStringLiteral("/api/v1/collections/%1").arg(m_collectionId);
     }
 
+    // The first page of familiar followers is fetched together with the rest of the profile
+    if (m_followListName == QStringLiteral("familiar_followers") && !m_next) {
+        const auto loader = account->profileLoader();
+
+        disconnect(m_partLoadedConnection);
+        disconnect(m_partFailedConnection);
+        m_partLoadedConnection = connect(loader,
+                                         &ProfileLoader::partLoaded,
+                                         this,
+                                         [this](const QString &accountId, ProfileLoader::Part part, const ProfileLoader::Response &response) {
+                                             if (accountId != m_accountId || part != ProfileLoader::FamiliarFollowersPart) {
+                                                 return;
+                                             }
+                                             disconnect(m_partLoadedConnection);
+                                             disconnect(m_partFailedConnection);
+                                             fetchedAccounts(response.data, response.linkHeader);
+                                         });
+        m_partFailedConnection = connect(loader,
+                                         &ProfileLoader::partFailed,
+                                         this,
+                                         [this](const QString &accountId, ProfileLoader::Part part, const QString &errorString) {
+                                             if (accountId != m_accountId || part != ProfileLoader::FamiliarFollowersPart) {
+                                                 return;
+                                             }
+                                             disconnect(m_partLoadedConnection);
+                                             disconnect(m_partFailedConnection);
+                                             setLoading(false);
+                                             Q_EMIT networkErrorOccurred(errorString);
+                                         });
+
+        loader->request(m_accountId, ProfileLoader::FamiliarFollowersPart);
+        return;
+    }
+
     QUrl url;
     if (!m_next) {
         url = account->apiUrl(uri);
@@ -563,72 +607,72 @@ void SocialGraphModel::fillTimeline()
         url = m_next.value();
     }
 
-    if (m_followListName == QStringLiteral("familiar_followers")) {
-        QUrlQuery query;
-        query.addQueryItem(QStringLiteral("id"), m_accountId);
-        url.setQuery(query);
-    }
-
     account->get(
         url,
         true,
         this,
-        [this, account](QNetworkReply *reply) {
-            const auto followRequestResult = QJsonDocument::fromJson(reply->readAll());
-            auto accounts = followRequestResult.array();
+        [this](QNetworkReply *reply) {
+            fetchedAccounts(reply->readAll(), QString::fromUtf8(reply->rawHeader(QByteArrayLiteral("Link"))));
+        },
+        [this](QNetworkReply *reply) {
+            setLoading(false);
+            Q_EMIT networkErrorOccurred(reply->errorString());
+        });
+}
 
-            if (m_followListName == QStringLiteral("collection")) {
-                accounts = followRequestResult.object()["accounts"_L1].toArray();
-                accounts.pop_front(); // Remove first account which is the creator
-            }
+void SocialGraphModel::fetchedAccounts(const QByteArray &data, const QString &linkHeader)
+{
+    const auto account = AccountManager::instance().selectedAccount();
 
-            if (!accounts.isEmpty()) {
-                const auto linkHeader = QString::fromUtf8(reply->rawHeader(QByteArrayLiteral("Link")));
-                m_next = TextHandler::getNextLink(linkHeader);
+    const auto followRequestResult = QJsonDocument::fromJson(data);
+    auto accounts = followRequestResult.array();
 
-                QList<std::shared_ptr<Identity>> fetchedAccounts;
-                QJsonArray value = accounts;
+    if (m_followListName == QStringLiteral("collection")) {
+        accounts = followRequestResult.object()["accounts"_L1].toArray();
+        accounts.pop_front(); // Remove first account which is the creator
+    }
+
+    if (!accounts.isEmpty()) {
+        m_next = TextHandler::getNextLink(linkHeader);
+
+        QList<std::shared_ptr<Identity>> fetchedAccounts;
+        QJsonArray value = accounts;
 
-                // This is a list of FamiliarFollower, not Account. So we need to transform it first.
-                if (m_followListName == QStringLiteral("familiar_followers")) {
-                    value = accounts.first()["accounts"_L1].toArray();
+        // This is a list of FamiliarFollower, not Account. So we need to transform it first.
+        if (m_followListName == QStringLiteral("familiar_followers")) {
+            value = accounts.first()["accounts"_L1].toArray();
+        }
+
+        std::ranges::transform(std::as_const(value), std::back_inserter(fetchedAccounts), [account](const QJsonValue &value) -> auto {
+            const auto identityJson = value.toObject();
+            return account->identityLookup(identityJson["id"_L1].toString(), identityJson);
+        });
+
+        size_t i = m_accounts.size();
+        for (auto &identity : fetchedAccounts) {
+            connect(identity.get(), &Identity::relationshipChanged, this, [this, i, identity] {
+                bool shouldRemove = false;
+                if (isFollowing()) {
+                    shouldRemove = identity->relationship() != nullptr ? !identity->relationship()->following() : true;
+                } else if (isFollower()) {
+                    shouldRemove = identity->relationship() != nullptr ? identity->relationship()->following() : true;
                 }
 
-                std::ranges::transform(std::as_const(value), std::back_inserter(fetchedAccounts), [account](const QJsonValue &value) -> auto {
-                    const auto identityJson = value.toObject();
-                    return account->identityLookup(identityJson["id"_L1].toString(), identityJson);
-                });
-
-                size_t i = m_accounts.size();
-                for (auto &identity : fetchedAccounts) {
-                    connect(identity.get(), &Identity::relationshipChanged, this, [this, i, identity] {
-                        bool shouldRemove = false;
-                        if (isFollowing()) {
-                            shouldRemove = identity->relationship() != nullptr ? !identity->relationship()->following() : true;
-                        } else if (isFollower()) {
-                            shouldRemove = identity->relationship() != nullptr ? identity->relationship()->following() : true;
-                        }
-
-                        if (shouldRemove) {
-                            beginRemoveRows({}, i, i);
-                            m_accounts.removeAt(i);
-                            endRemoveRows();
-                        }
-                    });
-                    i++;
+                if (shouldRemove) {
+                    beginRemoveRows({}, i, i);
+                    m_accounts.removeAt(i);
+                    endRemoveRows();
                 }
+            });
+            i++;
+        }
 
-                beginInsertRows({}, m_accounts.size(), m_accounts.size() + fetchedAccounts.size() - 1);
-                m_accounts += fetchedAccounts;
-                endInsertRows();
-            }
+        beginInsertRows({}, m_accounts.size(), m_accounts.size() + fetchedAccounts.size() - 1);
+        m_accounts += fetchedAccounts;
+        endInsertRows();
+    }
 
-            setLoading(false);
-        },
-        [this](QNetworkReply *reply) {
-            setLoading(false);
-            Q_EMIT networkErrorOccurred(reply->errorString());
-        });
+    setLoading(false);
 }
 
 void SocialGraphModel::reset()
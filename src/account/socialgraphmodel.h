@@ -98,11 +98,14 @@ protected:
 
 private:
     void fillTimeline();
+    void fetchedAccounts(const QByteArray &data, const QString &linkHeader);
     void reset();
 
     QList<std::shared_ptr<Identity>> m_accounts;
     bool m_loading = false;
     std::optional<QUrl> m_next;
+    QMetaObject::Connection m_partLoadedConnection;
+    QMetaObject::Connection m_partFailedConnection;
 
     QString m_followListName;
     QString m_accountId;
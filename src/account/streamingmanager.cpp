@@ -0,0 +1,387 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "account/streamingmanager.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QNetworkReply>
+#include <QRandomGenerator>
+#include <QUrlQuery>
+#include <QWebSocket>
+
+#include "datatypes/statusid.h"
+#include "network/networkcontroller.h"
+#include "network/networkrecorder.h"
+#include "tokodon_http_debug.h"
+#include "utils/metrics.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+static constexpr int initialReconnectDelay = 1000;
+static constexpr int maxReconnectDelay = 60 * 1000;
+
+// The connection is considered dead if a ping goes unanswered for this long
+static constexpr int heartbeatInterval = 30 * 1000;
+
+// Same as the page size of the timelines
+static constexpr int backfillLimit = 40;
+
+// Catching up after a long outage on a busy stream would never end, so it stops after this many pages
+static constexpr int maxBackfillPages = 25;
+
+static const QHash<QString, AbstractAccount::StreamingEventType> stringToStreamingEventType = {
+    {QStringLiteral("update"), AbstractAccount::StreamingEventType::UpdateEvent},
+    {QStringLiteral("delete"), AbstractAccount::StreamingEventType::DeleteEvent},
+    {QStringLiteral("notification"), AbstractAccount::StreamingEventType::NotificationEvent},
+    {QStringLiteral("filters_changed"), AbstractAccount::StreamingEventType::FiltersChangedEvent},
+    {QStringLiteral("conversation"), AbstractAccount::StreamingEventType::ConversationEvent},
+    {QStringLiteral("announcement"), AbstractAccount::StreamingEventType::AnnouncementEvent},
+    {QStringLiteral("announcement.reaction"), AbstractAccount::StreamingEventType::AnnouncementRedactedEvent},
+    {QStringLiteral("announcement.delete"), AbstractAccount::StreamingEventType::AnnouncementDeletedEvent},
+    {QStringLiteral("status.update"), AbstractAccount::StreamingEventType::StatusUpdatedEvent},
+    {QStringLiteral("encrypted_message"), AbstractAccount::StreamingEventType::EncryptedMessageChangedEvent},
+};
+
+StreamingManager::StreamingManager(AbstractAccount *account)
+    : QObject(account)
+    , m_account(account)
+{
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &StreamingManager::open);
+
+    m_heartbeatTimer.setInterval(heartbeatInterval);
+    connect(&m_heartbeatTimer, &QTimer::timeout, this, &StreamingManager::checkHeartbeat);
+
+    connect(this, &StreamingManager::connectedChanged, this, [this] {
+        const bool connected = isConnected();
+        if (connected != m_countedAsConnected) {
+            Metrics::instance().addToGauge(u"streaming.connections"_s, connected ? 1 : -1);
+            m_countedAsConnected = connected;
+        }
+    });
+}
+
+StreamingManager::~StreamingManager()
+{
+    if (m_countedAsConnected) {
+        Metrics::instance().addToGauge(u"streaming.connections"_s, -1);
+    }
+}
+
+void StreamingManager::start()
+{
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    open();
+}
+
+void StreamingManager::stop()
+{
+    m_running = false;
+    m_reconnectTimer.stop();
+    m_heartbeatTimer.stop();
+
+    if (m_socket != nullptr) {
+        m_socket->close();
+    }
+}
+
+void StreamingManager::subscribe(const QString &stream, const QString &parameter)
+{
+    auto &subscription = m_subscriptions[streamKey(stream, parameter)];
+    subscription.count++;
+    if (subscription.count > 1) {
+        return;
+    }
+
+    subscription.stream = stream;
+    subscription.parameter = parameter;
+    if (isConnected()) {
+        sendSubscription(subscription, true);
+    }
+}
+
+void StreamingManager::unsubscribe(const QString &stream, const QString &parameter)
+{
+    const auto it = m_subscriptions.find(streamKey(stream, parameter));
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+
+    it->count--;
+    if (it->count > 0) {
+        return;
+    }
+
+    if (isConnected()) {
+        sendSubscription(*it, false);
+    }
+    m_subscriptions.erase(it);
+}
+
+bool StreamingManager::isSubscribed(const QString &stream, const QString &parameter) const
+{
+    return m_subscriptions.contains(streamKey(stream, parameter));
+}
+
+bool StreamingManager::isConnected() const
+{
+    return m_socket != nullptr && m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+QString StreamingManager::streamKey(const QString &stream, const QString &parameter)
+{
+    if (parameter.isEmpty()) {
+        return stream;
+    }
+
+    // Hashtags are case-insensitive, and the server doesn't always use the same case as we do
+    return stream + u':' + (stream.startsWith("hashtag"_L1) ? parameter.toLower() : parameter);
+}
+
+void StreamingManager::open()
+{
+    if (!m_running) {
+        return;
+    }
+
+    const QUrl url = m_account->streamingUrl({});
+    if (url.host().isEmpty()) {
+        return;
+    }
+
+    if (m_socket == nullptr) {
+        m_socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+
+        connect(m_socket, &QWebSocket::connected, this, [this] {
+            m_attempt = 0;
+            m_awaitingPong = false;
+            m_heartbeatTimer.start();
+
+            for (const auto &subscription : std::as_const(m_subscriptions)) {
+                sendSubscription(subscription, true);
+            }
+
+            // Catch up with what we missed while the connection was down
+            if (m_connectedBefore) {
+                const auto streams = m_subscriptions.keys();
+                for (const auto &stream : streams) {
+                    backfill(stream);
+                }
+            }
+            m_connectedBefore = true;
+
+            Q_EMIT connectedChanged();
+        });
+        connect(m_socket, &QWebSocket::disconnected, this, [this] {
+            m_heartbeatTimer.stop();
+            Q_EMIT connectedChanged();
+            scheduleReconnect();
+        });
+        connect(m_socket, &QWebSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+            NetworkController::instance().logError(m_account->streamingUrl({}).toString(QUrl::RemoveQuery), m_socket->errorString());
+            scheduleReconnect();
+        });
+        connect(m_socket, &QWebSocket::textMessageReceived, this, &StreamingManager::handleMessage);
+        connect(m_socket, &QWebSocket::pong, this, [this] {
+            m_awaitingPong = false;
+        });
+    }
+
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+
+    qCDebug(TOKODON_HTTP) << "Opening streaming connection to" << url.host();
+
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::UserAgentHeader,
+                      QStringLiteral("%1/%2").arg(QCoreApplication::applicationName(), QCoreApplication::applicationVersion()));
+    m_socket->open(request);
+}
+
+void StreamingManager::scheduleReconnect()
+{
+    if (!m_running || m_reconnectTimer.isActive()) {
+        return;
+    }
+
+    // Jitter the delay, so all accounts (and all clients of a restarted instance) don't reconnect at the same time
+    const int delay = std::min(initialReconnectDelay << std::min(m_attempt, 16), maxReconnectDelay);
+    m_reconnectTimer.start(delay / 2 + QRandomGenerator::global()->bounded(delay / 2 + 1));
+    m_attempt++;
+}
+
+void StreamingManager::sendSubscription(const Subscription &subscription, const bool subscribe)
+{
+    QJsonObject message{
+        {u"type"_s, subscribe ? u"subscribe"_s : u"unsubscribe"_s},
+        {u"stream"_s, subscription.stream},
+    };
+    if (subscription.stream == "list"_L1) {
+        message[u"list"_s] = subscription.parameter;
+    } else if (subscription.stream.startsWith("hashtag"_L1)) {
+        message[u"tag"_s] = subscription.parameter;
+    }
+
+    m_socket->sendTextMessage(QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact)));
+}
+
+void StreamingManager::handleMessage(const QString &message)
+{
+    m_awaitingPong = false;
+
+    if (auto &recorder = NetworkRecorder::instance(); recorder.isRecording()) {
+        recorder.recordStreamingMessage(message);
+    }
+
+    const auto env = QJsonDocument::fromJson(message.toUtf8()).object();
+    if (!env.contains("event"_L1)) {
+        return;
+    }
+
+    const auto streamName = env["stream"_L1].toArray();
+    if (streamName.isEmpty()) {
+        return;
+    }
+
+    const QString stream = streamKey(streamName.at(0).toString(), streamName.at(1).toString());
+    const auto eventType = stringToStreamingEventType.value(env["event"_L1].toString(), AbstractAccount::InvalidEvent);
+    dispatch(stream, eventType, env["payload"_L1].toString().toUtf8());
+}
+
+void StreamingManager::dispatch(const QString &stream, const AbstractAccount::StreamingEventType eventType, const QByteArray &payload)
+{
+    if (eventType == AbstractAccount::UpdateEvent || eventType == AbstractAccount::NotificationEvent) {
+        const auto id = QJsonDocument::fromJson(payload)["id"_L1].toString();
+        // Live events can arrive while older ones are still being caught up with
+        if (eventType == AbstractAccount::NotificationEvent) {
+            if (StatusId(id) > StatusId(m_lastNotificationId)) {
+                m_lastNotificationId = id;
+            }
+        } else if (const auto it = m_subscriptions.find(stream); it != m_subscriptions.end() && StatusId(id) > StatusId(it->lastStatusId)) {
+            it->lastStatusId = id;
+        }
+    }
+
+    Q_EMIT streamEvent(stream, eventType, payload);
+}
+
+void StreamingManager::checkHeartbeat()
+{
+    if (!isConnected()) {
+        return;
+    }
+
+    // Nothing came back since the last ping, the connection is most likely dead (e.g. after suspend) without us noticing
+    if (m_awaitingPong) {
+        qCDebug(TOKODON_HTTP) << "Streaming connection stalled, reconnecting";
+        m_socket->abort();
+        return;
+    }
+
+    m_awaitingPong = true;
+    m_socket->ping();
+}
+
+void StreamingManager::backfill(const QString &stream)
+{
+    const auto it = m_subscriptions.constFind(stream);
+    if (it == m_subscriptions.cend()) {
+        return;
+    }
+
+    const QUrl statusesUrl = backfillUrl(*it);
+    if (!statusesUrl.isEmpty()) {
+        backfillPage(stream, statusesUrl, AbstractAccount::UpdateEvent, 1);
+    }
+
+    if (stream == "user"_L1 && !m_lastNotificationId.isEmpty()) {
+        QUrl url = m_account->apiUrl(QStringLiteral("/api/v1/notifications"));
+        url.setQuery(QUrlQuery{
+            {QStringLiteral("min_id"), m_lastNotificationId},
+            {QStringLiteral("limit"), QString::number(backfillLimit)},
+        });
+        backfillPage(stream, url, AbstractAccount::NotificationEvent, 1);
+    }
+}
+
+void StreamingManager::backfillPage(const QString &stream, const QUrl &url, const AbstractAccount::StreamingEventType eventType, const int page)
+{
+    m_account->get(url, true, this, [this, stream, url, eventType, page](QNetworkReply *reply) {
+        // The page right after min_id, newest first. It's emitted oldest first, the same order it would have been streamed in.
+        const auto items = QJsonDocument::fromJson(reply->readAll()).array();
+        for (auto item = items.crbegin(); item != items.crend(); ++item) {
+            if (!m_subscriptions.contains(stream)) {
+                return;
+            }
+            dispatch(stream, eventType, QJsonDocument(item->toObject()).toJson(QJsonDocument::Compact));
+        }
+
+        // A full page means there's more after it
+        if (items.size() < backfillLimit) {
+            return;
+        }
+        if (page >= maxBackfillPages) {
+            qCDebug(TOKODON_HTTP) << "Stopped catching up with" << stream << "after" << page << "pages";
+            return;
+        }
+
+        auto queryItems = QUrlQuery(url).queryItems();
+        for (auto &[key, value] : queryItems) {
+            if (key == "min_id"_L1) {
+                value = items.first()["id"_L1].toString();
+            }
+        }
+        QUrlQuery query;
+        query.setQueryItems(queryItems);
+        QUrl nextUrl = url;
+        nextUrl.setQuery(query);
+        backfillPage(stream, nextUrl, eventType, page + 1);
+    });
+}
+
+QUrl StreamingManager::backfillUrl(const Subscription &subscription) const
+{
+    // Without a post to start from, there's nothing to catch up with
+    if (subscription.lastStatusId.isEmpty()) {
+        return {};
+    }
+
+    QString path;
+    QUrlQuery query;
+    if (subscription.stream == "user"_L1) {
+        path = QStringLiteral("/api/v1/timelines/home");
+    } else if (subscription.stream == "list"_L1) {
+        path = QStringLiteral("/api/v1/timelines/list/%1").arg(subscription.parameter);
+    } else if (subscription.stream == "hashtag"_L1 || subscription.stream == "hashtag:local"_L1) {
+        path = QStringLiteral("/api/v1/timelines/tag/%1").arg(subscription.parameter);
+        if (subscription.stream == "hashtag:local"_L1) {
+            query.addQueryItem(QStringLiteral("local"), QStringLiteral("true"));
+        }
+    } else if (subscription.stream == "public"_L1) {
+        path = QStringLiteral("/api/v1/timelines/public");
+    } else if (subscription.stream == "public:local"_L1) {
+        path = QStringLiteral("/api/v1/timelines/public");
+        query.addQueryItem(QStringLiteral("local"), QStringLiteral("true"));
+    } else if (subscription.stream == "public:remote"_L1) {
+        path = QStringLiteral("/api/v1/timelines/public");
+        query.addQueryItem(QStringLiteral("remote"), QStringLiteral("true"));
+    } else {
+        return {};
+    }
+
+    query.addQueryItem(QStringLiteral("min_id"), subscription.lastStatusId);
+    query.addQueryItem(QStringLiteral("limit"), QString::number(backfillLimit));
+
+    QUrl url = m_account->apiUrl(path);
+    url.setQuery(query);
+    return url;
+}
+
+#include "moc_streamingmanager.cpp"
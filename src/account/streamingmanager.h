@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+
+#include "account/abstractaccount.h"
+
+class QWebSocket;
+
+/**
+ * @brief Streams events for every subscribed stream of an account over a single connection.
+ *
+ * Instead of opening a WebSocket per stream, streams are (un)subscribed on one connection using the subscribe and
+ * unsubscribe messages of the Mastodon streaming API. Subscriptions are reference counted, so models showing the same
+ * stream share it, and it's only unsubscribed once nobody needs it anymore.
+ *
+ * Dropped connections are reopened with a jittered exponential backoff, and a connection that stops answering pings is
+ * considered dead and reopened as well. Once reconnected, whatever was posted to the subscribed streams in the meantime is
+ * fetched page by page from the oldest with min_id, and emitted as if it was streamed, so the timelines don't end up with a
+ * hole in them.
+ */
+class StreamingManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StreamingManager(AbstractAccount *account);
+    ~StreamingManager() override;
+
+    /**
+     * @brief Opens the connection, needs the streaming URL of the instance.
+     */
+    void start();
+
+    /**
+     * @brief Closes the connection, and stops reconnecting.
+     */
+    void stop();
+
+    /**
+     * @brief Subscribes to @p stream, for example "user", "public:local" or "hashtag".
+     * @param parameter The list id for "list" streams, and the tag for "hashtag" streams.
+     */
+    void subscribe(const QString &stream, const QString &parameter = {});
+
+    /**
+     * @brief Releases a subscription made with subscribe().
+     */
+    void unsubscribe(const QString &stream, const QString &parameter = {});
+
+    [[nodiscard]] bool isSubscribed(const QString &stream, const QString &parameter = {}) const;
+
+    [[nodiscard]] bool isConnected() const;
+
+    /**
+     * @return The key streamEvent() uses for @p stream, for example "list:42" or "hashtag:kde".
+     */
+    [[nodiscard]] static QString streamKey(const QString &stream, const QString &parameter = {});
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted for every event received on a subscribed stream, including the ones fetched after reconnecting.
+     * @param stream The key of the stream, see streamKey().
+     */
+    void streamEvent(const QString &stream, AbstractAccount::StreamingEventType eventType, const QByteArray &payload);
+
+    void connectedChanged();
+
+private:
+    struct Subscription {
+        QString stream;
+        QString parameter;
+        int count = 0;
+        QString lastStatusId; ///< The last post seen on this stream, to fetch what we missed from
+    };
+
+    void open();
+    void scheduleReconnect();
+    void sendSubscription(const Subscription &subscription, bool subscribe);
+    void handleMessage(const QString &message);
+    void dispatch(const QString &stream, AbstractAccount::StreamingEventType eventType, const QByteArray &payload);
+    void checkHeartbeat();
+    void backfill(const QString &stream);
+    void backfillPage(const QString &stream, const QUrl &url, AbstractAccount::StreamingEventType eventType, int page);
+    [[nodiscard]] QUrl backfillUrl(const Subscription &subscription) const;
+
+    AbstractAccount *const m_account;
+    QWebSocket *m_socket = nullptr;
+    QHash<QString, Subscription> m_subscriptions;
+    QString m_lastNotificationId;
+    QTimer m_reconnectTimer;
+    QTimer m_heartbeatTimer;
+    int m_attempt = 0;
+    bool m_running = false;
+    bool m_connectedBefore = false;
+    bool m_awaitingPong = false;
+    bool m_countedAsConnected = false; ///< Whether this connection is counted in the streaming.connections metric
+
+    friend class StreamingManagerTest;
+    friend class ReplayAccount;
+};
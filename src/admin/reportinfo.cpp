@@ -6,6 +6,7 @@
 
 #include "account/abstractaccount.h"
 #include "account/accountmanager.h"
+#include "account/poststore.h"
 
 using namespace Qt::StringLiterals;
 
@@ -170,7 +171,7 @@ void ReportInfo::fromSourceData(const QJsonObject &doc)
     // creating status array with the Post class
     const auto reportStatuses = doc[QStringLiteral("statuses")].toArray();
     std::ranges::transform(std::as_const(reportStatuses), std::back_inserter(m_reportStatus), [this, account](const QJsonValue &value) -> auto {
-        return new Post(account, value.toObject(), this);
+        return account->postStore()->acquire(value.toObject(), this);
     });
 
     m_rules = doc["rules"_L1].toArray();
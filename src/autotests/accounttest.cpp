@@ -8,6 +8,8 @@
 
 #include <QtTest/QtTest>
 
+using namespace Qt::Literals::StringLiterals;
+
 class AccountTest : public QObject
 {
     Q_OBJECT
@@ -67,6 +69,33 @@ private Q_SLOTS:
         QCOMPARE(account->supportsLocalVisibility(), false);
     }
 
+    // Make sure cached identities are updated in place by newer account data
+    void testIdentityRefresh()
+    {
+        QFile file(QLatin1String(DATA_DIR "/verify_credentials.json"));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        auto doc = QJsonDocument::fromJson(file.readAll()).object();
+
+        const auto identity = account->identityLookup(QStringLiteral("14715"), doc);
+        QCOMPARE(identity->followersCount(), doc["followers_count"_L1].toInt());
+        QVERIFY(!identity->isStale());
+
+        const QSignalSpy spy(identity.get(), &Identity::identityUpdated);
+
+        // Nothing changed, so nothing should be updated
+        QCOMPARE(account->identityLookup(QStringLiteral("14715"), doc), identity);
+        QCOMPARE(spy.count(), 0);
+
+        doc["followers_count"_L1] = 1000;
+        QCOMPARE(account->identityLookup(QStringLiteral("14715"), doc), identity);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(identity->followersCount(), 1000);
+
+        // Without any data, the cached identity is returned as is
+        QCOMPARE(account->identityLookup(QStringLiteral("14715"), {}), identity);
+        QCOMPARE(spy.count(), 1);
+    }
+
 private:
     MockAccount *account;
 };
@@ -0,0 +1,390 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "account/accountmanager.h"
+#include "account/identity.h"
+#include "autotests/fakemastodonserver.h"
+#include "autotests/replayaccount.h"
+#include "datatypes/post.h"
+#include "notification/notificationgroupingmodel.h"
+#include "notification/notificationmodel.h"
+#include "timeline/maintimelinemodel.h"
+#include "utils/blurhash.h"
+#include "utils/customemoji.h"
+#include "utils/emojimodel.h"
+#include "utils/texthandler.h"
+
+#include <atomic>
+
+using namespace Qt::Literals::StringLiterals;
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SANITIZE_ADDRESS
+#endif
+#elif defined(__SANITIZE_ADDRESS__)
+#define SANITIZE_ADDRESS
+#endif
+
+// Allocations are counted by wrapping malloc, which Qt uses for its containers instead of operator new. This only affects this
+// executable, which isn't run by ctest.
+#if defined(__GLIBC__) && !defined(SANITIZE_ADDRESS)
+#define COUNT_ALLOCATIONS
+
+static std::atomic_bool s_countAllocations = false;
+static std::atomic<qsizetype> s_allocations = 0;
+static std::atomic<qsizetype> s_allocatedBytes = 0;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) noexcept
+{
+    if (s_countAllocations.load(std::memory_order_relaxed)) {
+        s_allocations++;
+        s_allocatedBytes += size;
+    }
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+    if (s_countAllocations.load(std::memory_order_relaxed)) {
+        s_allocations++;
+        s_allocatedBytes += count * size;
+    }
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+    if (s_countAllocations.load(std::memory_order_relaxed)) {
+        s_allocations++;
+        s_allocatedBytes += size;
+    }
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+static QByteArray readData(const QString &fileName)
+{
+    QFile file(QLatin1String(DATA_DIR "/") + fileName);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+// Gives access to the pages being appended, the way they are once fetched
+class BenchmarkTimelineModel : public MainTimelineModel
+{
+public:
+    using TimelineModel::fetchedTimeline;
+};
+
+/**
+ * Measures what parsing and showing a busy timeline spends its time on, over the test data and generated pages as big as the API gives.
+ *
+ * Not run by ctest, the timings only mean something compared to a baseline, see scripts/compare-benchmarks.py.
+ */
+class Benchmarks : public QObject
+{
+    Q_OBJECT
+
+private:
+    // A page of posts like the timelines are fetched in, newest first
+    QByteArray statusPage(const qint64 newestId, const qint64 count) const
+    {
+        QJsonArray page;
+        for (qint64 id = newestId; id > newestId - count; id--) {
+            page.append(generator.status(id));
+        }
+        return QJsonDocument(page).toJson(QJsonDocument::Compact);
+    }
+
+    QByteArray notificationPage(const qint64 newestId, const qint64 count) const
+    {
+        QJsonArray page;
+        for (qint64 id = newestId; id > newestId - count; id--) {
+            page.append(generator.notification(id));
+        }
+        return QJsonDocument(page).toJson(QJsonDocument::Compact);
+    }
+
+    // As many as a big instance has
+    static QJsonArray customEmojis(const int count)
+    {
+        QJsonArray emojis;
+        for (int i = 0; i < count; i++) {
+            const QString url = u"https://example.social/emojis/%1.png"_s.arg(i);
+            emojis.append(QJsonObject{
+                {u"shortcode"_s, u"custom%1"_s.arg(i)},
+                {u"url"_s, url},
+                {u"static_url"_s, url},
+                {u"visible_in_picker"_s, true},
+            });
+        }
+        return emojis;
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        AccountManager::instance().setTestMode(true);
+
+        const auto exchange = [](const QString &url, const QByteArray &body, const QList<std::pair<QByteArray, QByteArray>> &headers = {}) {
+            return NetworkRecording::Exchange{
+                .operation = QByteArrayLiteral("GET"),
+                .url = QUrl(url),
+                .statusCode = 200,
+                .headers = headers,
+                .body = body,
+            };
+        };
+
+        auto emojis = customEmojis(500);
+        for (const auto &emoji : QJsonDocument::fromJson(readData(u"emoji.json"_s)).array()) {
+            emojis.append(emoji);
+        }
+
+        NetworkRecording recording;
+        recording.exchanges = {
+            exchange(u"https://example.social/api/v2/instance"_s, readData(u"api_v2_instance.json"_s)),
+            exchange(u"https://example.social/api/v1/custom_emojis"_s, QJsonDocument(emojis).toJson(QJsonDocument::Compact)),
+            exchange(u"https://example.social/api/v1/markers"_s, QByteArrayLiteral("{}")),
+            exchange(u"https://example.social/api/v1/notifications"_s,
+                     notificationPage(200, 40),
+                     {{QByteArrayLiteral("Link"), QByteArrayLiteral("<https://example.social/api/v1/notifications?max_id=161>; rel=\"next\"")}}),
+            exchange(u"https://example.social/api/v1/notifications?max_id=161"_s, notificationPage(160, 40)),
+        };
+
+        account = new ReplayAccount(recording, this);
+        account->setTimeScale(0);
+        AccountManager::instance().addAccount(account);
+        AccountManager::instance().selectAccount(account, false);
+
+        account->fetchInstanceMetadata();
+        QCOMPARE(account->customEmojis().size(), 502);
+    }
+
+    void postFromJson_data()
+    {
+        QTest::addColumn<QJsonObject>("status");
+
+        for (const auto &fileName : {u"status.json"_s, u"status-poll.json"_s, u"status-mentions.json"_s, u"status-tags.json"_s}) {
+            QTest::newRow(qPrintable(fileName)) << QJsonDocument::fromJson(readData(fileName)).object();
+        }
+        QTest::newRow("generated") << generator.status(42);
+    }
+
+    void postFromJson()
+    {
+        QFETCH(QJsonObject, status);
+
+        QBENCHMARK {
+            Post post(account, status);
+        }
+    }
+
+    // The memory a post takes, over the statuses of the test data
+    void postAllocations()
+    {
+#ifdef COUNT_ALLOCATIONS
+        const auto statuses = QJsonDocument::fromJson(readData(u"statuses.json"_s)).array();
+        QVERIFY(!statuses.isEmpty());
+
+        // Authors are cached by the account, so make sure they are before measuring the posts themselves
+        for (const auto &status : statuses) {
+            Post post(account, status.toObject());
+        }
+
+        std::vector<std::unique_ptr<Post>> posts;
+        posts.reserve(statuses.size());
+        s_allocations = 0;
+        s_allocatedBytes = 0;
+        s_countAllocations = true;
+        for (const auto &status : statuses) {
+            posts.push_back(std::make_unique<Post>(account, status.toObject()));
+        }
+        s_countAllocations = false;
+
+        qInfo().nospace() << "sizeof(Post): " << sizeof(Post) << " bytes, per post: " << s_allocations / statuses.size() << " allocations";
+        QTest::setBenchmarkResult(qreal(s_allocatedBytes) / statuses.size(), QTest::BytesAllocated);
+#else
+        QSKIP("Allocations are only counted with glibc, without AddressSanitizer");
+#endif
+    }
+
+    void removeStandaloneTags_data()
+    {
+        QTest::addColumn<QString>("content");
+
+        QTest::newRow("status-tags.json") << QJsonDocument::fromJson(readData(u"status-tags.json"_s))["content"_L1].toString();
+        QTest::newRow("generated") << generator.status(42)["content"_L1].toString();
+
+        // A long post ending with a wall of hashtags
+        QString longContent;
+        for (int i = 0; i < 20; i++) {
+            longContent += generator.status(i + 1)["content"_L1].toString();
+        }
+        longContent += u"<p>"_s;
+        for (int i = 0; i < 30; i++) {
+            longContent += u"<a href=\"https://example.social/tags/tag%1\" class=\"mention hashtag\" rel=\"tag\">#<span>tag%1</span></a> "_s.arg(i);
+        }
+        longContent += u"</p>"_s;
+        QTest::newRow("long") << longContent;
+    }
+
+    void removeStandaloneTags()
+    {
+        QFETCH(QString, content);
+
+        QBENCHMARK {
+            const auto result = TextHandler::removeStandaloneTags(content);
+            Q_UNUSED(result)
+        }
+    }
+
+    void replaceCustomEmojis_data()
+    {
+        QTest::addColumn<QJsonArray>("emojis");
+        QTest::addColumn<QString>("content");
+
+        const auto fileEmojis = QJsonDocument::fromJson(readData(u"emoji.json"_s)).array();
+        QTest::newRow("emoji.json") << fileEmojis << u"Eugen :artaww: :meowybara:"_s;
+
+        QString content;
+        for (int i = 0; i < 40; i++) {
+            content += u"word :custom%1: "_s.arg(i * 10);
+        }
+        QTest::newRow("500 emojis") << customEmojis(500) << content;
+    }
+
+    void replaceCustomEmojis()
+    {
+        QFETCH(QJsonArray, emojis);
+        QFETCH(QString, content);
+
+        const auto customEmojis = CustomEmoji::parseCustomEmojis(emojis);
+        QBENCHMARK {
+            const auto result = TextHandler::replaceCustomEmojis(customEmojis, content);
+            Q_UNUSED(result)
+        }
+    }
+
+    void identityFromSourceData_data()
+    {
+        QTest::addColumn<QJsonObject>("source");
+
+        QTest::newRow("verify_credentials.json") << QJsonDocument::fromJson(readData(u"verify_credentials.json"_s)).object();
+        QTest::newRow("status.json") << QJsonDocument::fromJson(readData(u"status.json"_s))["account"_L1].toObject();
+        QTest::newRow("generated") << generator.account(42);
+    }
+
+    void identityFromSourceData()
+    {
+        QFETCH(QJsonObject, source);
+
+        QBENCHMARK {
+            // A new identity each time, updating one with the same data is skipped
+            Identity identity;
+            identity.fromSourceData(source);
+        }
+    }
+
+    // Groups the first page, then the second page as it's appended
+    void notificationGroupingInserts()
+    {
+        const auto load = [] {
+            NotificationModel notifications;
+            NotificationGroupingModel grouping;
+            grouping.setSourceModel(&notifications);
+            static_cast<QAbstractItemModel &>(notifications).fetchMore({});
+            return notifications.rowCount({});
+        };
+        QCOMPARE(load(), 80);
+
+        QBENCHMARK {
+            load();
+        }
+    }
+
+    void emojiFilterModel_data()
+    {
+        QTest::addColumn<QString>("filter");
+
+        QTest::newRow("empty") << QString();
+        QTest::newRow("a") << u"a"_s;
+        QTest::newRow("smile") << u"smile"_s;
+        QTest::newRow("custom") << u"custom42"_s;
+    }
+
+    void emojiFilterModel()
+    {
+        QFETCH(QString, filter);
+
+        QBENCHMARK {
+            const auto result = EmojiModel::filterModel(account, filter);
+            Q_UNUSED(result)
+        }
+    }
+
+    void blurHashDecode_data()
+    {
+        QTest::addColumn<QString>("blurHash");
+        QTest::addColumn<QSize>("size");
+
+        // The size images are decoded at by default, and one for big previews
+        const auto blurHash = QJsonDocument::fromJson(readData(u"status-tags.json"_s))["media_attachments"_L1][0]["blurhash"_L1].toString();
+        QTest::newRow("64x64") << blurHash << QSize(64, 64);
+        QTest::newRow("256x256") << blurHash << QSize(256, 256);
+        QTest::newRow("9x9 components") << u"eBB4=;054UK$=402%s%|r^O%06#?*7RijMxGpYMzniVNT@rFN3#=Kt"_s << QSize(64, 64);
+    }
+
+    void blurHashDecode()
+    {
+        QFETCH(QString, blurHash);
+        QFETCH(QSize, size);
+
+        QBENCHMARK {
+            const auto image = BlurHash::decode(blurHash, size);
+            Q_UNUSED(image)
+        }
+    }
+
+    void timelineFetchedTimeline_data()
+    {
+        QTest::addColumn<QByteArrayList>("pages");
+
+        QTest::newRow("statuses.json") << QByteArrayList{readData(u"statuses.json"_s)};
+        QTest::newRow("40 posts") << QByteArrayList{statusPage(400, 40)};
+
+        QByteArrayList pages;
+        for (qint64 newestId = 400; newestId > 0; newestId -= 40) {
+            pages.append(statusPage(newestId, 40));
+        }
+        QTest::newRow("10 pages of 40 posts") << pages;
+    }
+
+    void timelineFetchedTimeline()
+    {
+        QFETCH(QByteArrayList, pages);
+
+        QBENCHMARK {
+            BenchmarkTimelineModel model;
+            for (const auto &page : std::as_const(pages)) {
+                model.fetchedTimeline(page, true);
+            }
+        }
+    }
+
+private:
+    FakeMastodonServer generator;
+    ReplayAccount *account = nullptr;
+};
+
+QTEST_MAIN(Benchmarks)
+#include "benchmarks.moc"
@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "utils/contenttransformer.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class ContentTransformerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QFile emojiFile(QLatin1String(DATA_DIR "/emoji.json"));
+        emojiFile.open(QFile::ReadOnly);
+        emojis = CustomEmoji::parseCustomEmojis(QJsonDocument::fromJson(emojiFile.readAll()).array());
+    }
+
+    void testTransform_data()
+    {
+        QTest::addColumn<QString>("html");
+        QTest::addColumn<QJsonArray>("tags");
+        QTest::addColumn<QJsonArray>("mentions");
+        QTest::addColumn<QString>("expected");
+        QTest::addColumn<QList<QString>>("standaloneTags");
+
+        const QString artaww = u"<img height=\"16\" align=\"middle\" width=\"16\" src=\"%1\">"_s.arg(emojis[0].url);
+        const QString meowybara = u"<img height=\"16\" align=\"middle\" width=\"16\" src=\"%1\">"_s.arg(emojis[1].url);
+
+        QTest::addRow("plain") << u"<p>Hello world</p>"_s << QJsonArray{} << QJsonArray{} << u"<p>Hello world</p>"_s << QList<QString>{};
+
+        QTest::addRow("emojis") << u"<p>:artaww: hi :nope: :meowybara:</p>"_s << QJsonArray{} << QJsonArray{}
+                                << u"<p>%1 hi :nope: %2</p>"_s.arg(artaww, meowybara) << QList<QString>{};
+
+        QTest::addRow("emoji in attribute") << u"<p><a href=\"https://kde.org/:artaww:\">link</a></p>"_s << QJsonArray{} << QJsonArray{}
+                                            << u"<p><a href=\"https://kde.org/:artaww:\">link</a></p>"_s << QList<QString>{};
+
+        QTest::addRow("hashtag link") << u"<p>Hi <a href=\"https://mastodon.art/tags/inktober\" class=\"mention hashtag\" rel=\"tag\">#<span>Inktober</span></a> there</p>"_s
+                                      << QJsonArray{QJsonObject{{u"name"_s, u"Inktober"_s}}} << QJsonArray{}
+                                      << u"<p>Hi <a href=\"hashtag:/Inktober\" class=\"mention hashtag\" rel=\"tag\">#<span>Inktober</span></a> there</p>"_s
+                                      << QList<QString>{};
+
+        QTest::addRow("mention link")
+            << u"<p><span class=\"h-card\"><a href=\"https://kde.org/@alice\" class=\"u-url mention\">@<span>alice</span></a></span> hello</p>"_s
+            << QJsonArray{} << QJsonArray{QJsonObject{{u"url"_s, u"https://kde.org/@alice"_s}, {u"id"_s, u"42"_s}}}
+            << u"<p><span class=\"h-card\"><a href=\"account:/42\" class=\"u-url mention\">@<span>alice</span></a></span> hello</p>"_s << QList<QString>{};
+
+        QTest::addRow("trailing break") << u"<p>Yosemite<br />    </p>"_s << QJsonArray{} << QJsonArray{} << u"<p>Yosemite</p>"_s << QList<QString>{};
+
+        QTest::addRow("empty paragraph") << u"<p>Imhotep</p><p>  <br></p>"_s << QJsonArray{} << QJsonArray{} << u"<p>Imhotep</p>"_s << QList<QString>{};
+
+        QTest::addRow("standalone paragraph")
+            << u"<p>Imhotep</p><p><a href=\"/tags/a\" rel=\"tag\">#<span>a</span></a> <a href=\"/tags/b\" rel=\"tag\">#<span>b</span></a></p>"_s << QJsonArray{}
+            << QJsonArray{} << u"<p>Imhotep</p>"_s << QList<QString>{u"a"_s, u"b"_s};
+
+        QTest::addRow("standalone after break") << u"<p>Imhotep<br /><a href=\"/tags/a\" rel=\"tag\">#<span>a</span></a></p>"_s << QJsonArray{}
+                                                << QJsonArray{} << u"<p>Imhotep</p>"_s << QList<QString>{u"a"_s};
+
+        QTest::addRow("tags with text") << u"<p>Imhotep</p><p><a href=\"/tags/a\" rel=\"tag\">#<span>a</span></a> is great</p>"_s << QJsonArray{}
+                                        << QJsonArray{} << u"<p>Imhotep</p><p><a href=\"/tags/a\" rel=\"tag\">#<span>a</span></a> is great</p>"_s
+                                        << QList<QString>{};
+
+        QTest::addRow("tags before the end") << u"<p><a href=\"/tags/a\" rel=\"tag\">#<span>a</span></a></p><p>Imhotep</p>"_s << QJsonArray{} << QJsonArray{}
+                                             << u"<p><a href=\"/tags/a\" rel=\"tag\">#<span>a</span></a></p><p>Imhotep</p>"_s << QList<QString>{};
+    }
+
+    void testTransform()
+    {
+        QFETCH(QString, html);
+        QFETCH(QJsonArray, tags);
+        QFETCH(QJsonArray, mentions);
+        QFETCH(QString, expected);
+        QFETCH(QList<QString>, standaloneTags);
+
+        const auto [content, resultTags, plainText] = ContentTransformer(emojis, u"https://mastodon.art"_s, tags, mentions).transform(html);
+        Q_UNUSED(plainText)
+
+        QCOMPARE(content, expected);
+        QCOMPARE(resultTags, standaloneTags);
+    }
+
+    void testPlainText_data()
+    {
+        QTest::addColumn<QString>("html");
+        QTest::addColumn<QString>("expected");
+
+        QTest::addRow("plain") << u"<p>Hello world</p>"_s << u"Hello world"_s;
+        QTest::addRow("paragraphs") << u"<p>Hello</p><p>world</p>"_s << u"Hello\n\nworld"_s;
+        QTest::addRow("line break") << u"<p>Hello<br>world</p>"_s << u"Hello\nworld"_s;
+        QTest::addRow("entities") << u"<p>Tom &amp; Jerry &lt;3 &quot;cheese&quot; &#39;n&#x27; &#128512; &nope;</p>"_s
+                                  << u"Tom & Jerry <3 \"cheese\" 'n' \U0001F600 &nope;"_s;
+        QTest::addRow("links") << u"<p><a href=\"https://kde.org\"><span class=\"invisible\">https://</span><span>kde.org</span></a></p>"_s
+                               << u"https://kde.org"_s;
+        QTest::addRow("emojis") << u"<p>:artaww: hi</p>"_s << u":artaww: hi"_s;
+        QTest::addRow("standalone tags") << u"<p>Imhotep</p><p><a href=\"https://mastodon.art/tags/a\" rel=\"tag\">#<span>a</span></a></p>"_s
+                                         << u"Imhotep\n\n#a"_s;
+    }
+
+    void testPlainText()
+    {
+        QFETCH(QString, html);
+        QFETCH(QString, expected);
+
+        const QJsonArray tags{QJsonObject{{u"name"_s, u"a"_s}}};
+        QCOMPARE(ContentTransformer(emojis, u"https://mastodon.art"_s, tags, {}).transform(html).plainText, expected);
+    }
+
+    void benchmarkTransform()
+    {
+        QFile statusesFile(QLatin1String(DATA_DIR "/statuses.json"));
+        statusesFile.open(QFile::ReadOnly);
+        const auto statuses = QJsonDocument::fromJson(statusesFile.readAll()).array();
+        QVERIFY(!statuses.isEmpty());
+
+        std::vector<std::pair<ContentTransformer, QString>> posts;
+        for (const auto &status : statuses) {
+            const auto obj = status.toObject();
+            posts.emplace_back(ContentTransformer(CustomEmoji::parseCustomEmojis(obj["emojis"_L1].toArray()),
+                                                  u"https://mastodon.art"_s,
+                                                  obj["tags"_L1].toArray(),
+                                                  obj["mentions"_L1].toArray()),
+                               obj["content"_L1].toString());
+        }
+
+        // Time the passes as well, to report the throughput in posts per second next to the time per pass
+        qint64 transformed = 0;
+        qint64 elapsed = 0;
+        QElapsedTimer timer;
+        QBENCHMARK {
+            timer.start();
+            for (const auto &[transformer, content] : std::as_const(posts)) {
+                const auto result = transformer.transform(content);
+                Q_UNUSED(result)
+            }
+            elapsed += timer.nsecsElapsed();
+            transformed += qint64(posts.size());
+        }
+
+        QVERIFY(elapsed > 0);
+        qInfo().nospace() << "ContentTransformer: " << qint64(transformed * 1'000'000'000.0 / elapsed) << " posts per second, over " << transformed
+                          << " posts";
+    }
+
+private:
+    QList<CustomEmoji> emojis;
+};
+
+QTEST_MAIN(ContentTransformerTest)
+#include "contenttransformertest.moc"
@@ -0,0 +1,738 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "autotests/fakemastodonserver.h"
+
+#include "account/streamingmanager.h"
+
+#include <QJsonArray>
+#include <QTcpSocket>
+#include <QTimeZone>
+#include <QUrlQuery>
+#include <QWebSocket>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+// The replies in a thread get ids above this, so they never collide with the posts of the timelines
+static constexpr qint64 threadIdBase = 1'000'000'000'000;
+
+// What Mastodon uses when the client doesn't ask for a limit, and the most it allows
+static constexpr qint64 defaultPageSize = 20;
+static constexpr qint64 maxPageSize = 40;
+
+// Endpoints that need an access token
+static const QStringList privatePaths = {
+    u"/api/v1/accounts/verify_credentials"_s,
+    u"/api/v1/timelines/home"_s,
+    u"/api/v1/timelines/list"_s,
+    u"/api/v1/notifications"_s,
+    u"/api/v1/follow_requests"_s,
+    u"/api/v1/markers"_s,
+    u"/api/v1/preferences"_s,
+    u"/api/v1/lists"_s,
+    u"/api/v2/filters"_s,
+};
+
+// Endpoints that always answer with an empty list
+static const QStringList emptyListPaths = {
+    u"/api/v1/follow_requests"_s,
+    u"/api/v1/lists"_s,
+    u"/api/v1/custom_emojis"_s,
+    u"/api/v1/announcements"_s,
+    u"/api/v2/filters"_s,
+};
+
+static const QList<QString> notificationTypes = {
+    u"mention"_s,
+    u"favourite"_s,
+    u"reblog"_s,
+    u"follow"_s,
+    u"status"_s,
+};
+
+static QByteArray reasonPhrase(const int statusCode)
+{
+    switch (statusCode) {
+    case 200:
+        return QByteArrayLiteral("OK");
+    case 206:
+        return QByteArrayLiteral("Partial Content");
+    case 401:
+        return QByteArrayLiteral("Unauthorized");
+    case 404:
+        return QByteArrayLiteral("Not Found");
+    case 416:
+        return QByteArrayLiteral("Range Not Satisfiable");
+    case 429:
+        return QByteArrayLiteral("Too Many Requests");
+    default:
+        return QByteArrayLiteral("Unknown");
+    }
+}
+
+static QString timestamp(const qint64 secondsSinceEpoch)
+{
+    static const QDateTime epoch(QDate(2026, 1, 1), QTime(0, 0), QTimeZone::UTC);
+    return epoch.addSecs(secondsSinceEpoch).toString(Qt::ISODateWithMs);
+}
+
+FakeMastodonServer::FakeMastodonServer(QObject *parent)
+    : QObject(parent)
+    , m_streamingServer(u"Fake Mastodon"_s, QWebSocketServer::NonSecureMode)
+{
+    connect(&m_httpServer, &QTcpServer::pendingConnectionAvailable, this, &FakeMastodonServer::acceptConnection);
+    connect(&m_streamingServer, &QWebSocketServer::newConnection, this, &FakeMastodonServer::acceptStreamingConnection);
+
+    m_streamingTimer.setInterval(5);
+    m_streamingTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_streamingTimer, &QTimer::timeout, this, &FakeMastodonServer::sendDueEvents);
+}
+
+FakeMastodonServer::~FakeMastodonServer()
+{
+    // Otherwise the sockets would be deleted with the servers, after the hashes their signals update
+    const auto httpSockets = m_httpServer.findChildren<QTcpSocket *>();
+    for (const auto socket : httpSockets) {
+        socket->disconnect(this);
+    }
+    const auto streamingSockets = m_subscriptions.keys();
+    for (const auto socket : streamingSockets) {
+        socket->disconnect(this);
+    }
+    qDeleteAll(streamingSockets);
+}
+
+bool FakeMastodonServer::listen()
+{
+    return m_httpServer.listen(QHostAddress::LocalHost) && m_streamingServer.listen(QHostAddress::LocalHost);
+}
+
+QString FakeMastodonServer::instanceUri() const
+{
+    return u"http://127.0.0.1:%1"_s.arg(m_httpServer.serverPort());
+}
+
+QString FakeMastodonServer::accessToken() const
+{
+    return u"fake-access-token"_s;
+}
+
+void FakeMastodonServer::setStatusCount(const qint64 count)
+{
+    m_newestStatusId = count;
+}
+
+void FakeMastodonServer::setNotificationCount(const qint64 count)
+{
+    m_newestNotificationId = count;
+}
+
+void FakeMastodonServer::setThreadLength(const qint64 length)
+{
+    m_threadLength = length;
+}
+
+void FakeMastodonServer::setAccountCount(const qint64 count)
+{
+    m_accountCount = std::max<qint64>(count, 1);
+}
+
+void FakeMastodonServer::setLatency(const int milliseconds)
+{
+    m_latency = milliseconds;
+}
+
+void FakeMastodonServer::setRateLimit(const int limit, const int window)
+{
+    m_rateLimit = limit;
+    m_rateLimitWindow = window;
+    m_rateLimitReset = {};
+}
+
+void FakeMastodonServer::streamStatuses(const QString &stream, const QString &parameter, const qint64 count, const int eventsPerSecond)
+{
+    startBurst({.stream = stream, .parameter = parameter, .count = count, .eventsPerSecond = eventsPerSecond});
+}
+
+void FakeMastodonServer::streamNotifications(const qint64 count, const int eventsPerSecond)
+{
+    startBurst({.stream = u"user"_s, .notifications = true, .count = count, .eventsPerSecond = eventsPerSecond});
+}
+
+void FakeMastodonServer::serveFile(const QString &path, const QByteArray &data, const QByteArray &etag)
+{
+    m_files.insert(path, {.data = data, .etag = etag});
+}
+
+void FakeMastodonServer::interruptNextDownload(const qint64 bytes)
+{
+    m_interruptNextDownload = bytes;
+}
+
+void FakeMastodonServer::misalignNextRange(const qint64 bytes)
+{
+    m_misalignNextRange = bytes;
+}
+
+qint64 FakeMastodonServer::bytesServed(const QString &path) const
+{
+    return m_bytesServed.value(path);
+}
+
+qint64 FakeMastodonServer::requestCount(const QString &path) const
+{
+    return path.isEmpty() ? m_requestTotal : m_requestCounts.value(path);
+}
+
+qint64 FakeMastodonServer::subscriberCount(const QString &stream, const QString &parameter) const
+{
+    const QString key = StreamingManager::streamKey(stream, parameter);
+    return std::count_if(m_subscriptions.cbegin(), m_subscriptions.cend(), [&key](const QSet<QString> &subscriptions) {
+        return subscriptions.contains(key);
+    });
+}
+
+void FakeMastodonServer::acceptConnection()
+{
+    while (m_httpServer.hasPendingConnections()) {
+        const auto socket = m_httpServer.nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+            readRequests(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void FakeMastodonServer::readRequests(QTcpSocket *socket)
+{
+    auto &buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    // The connections are kept alive, so there may be more than one request in there, or only part of one
+    while (true) {
+        const qsizetype headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd == -1) {
+            return;
+        }
+
+        const auto lines = buffer.left(headerEnd).split('\n');
+        const auto requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() < 2) {
+            socket->disconnectFromHost();
+            return;
+        }
+
+        Request request{
+            .method = requestLine[0],
+            .url = QUrl::fromEncoded(instanceUri().toLatin1() + requestLine[1]),
+        };
+        for (const auto &line : lines.sliced(1)) {
+            const qsizetype colon = line.indexOf(':');
+            if (colon != -1) {
+                request.headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+            }
+        }
+
+        const qsizetype bodyLength = request.headers.value(QByteArrayLiteral("content-length")).toLongLong();
+        if (buffer.size() < headerEnd + 4 + bodyLength) {
+            return;
+        }
+        request.body = buffer.mid(headerEnd + 4, bodyLength);
+        buffer.remove(0, headerEnd + 4 + bodyLength);
+
+        const Reply reply = handle(request);
+        if (m_latency > 0) {
+            // Every reply is delayed the same, so they still go out in the order they were asked for
+            QTimer::singleShot(m_latency, socket, [this, socket, reply] {
+                respond(socket, reply);
+            });
+        } else {
+            respond(socket, reply);
+        }
+    }
+}
+
+FakeMastodonServer::Reply FakeMastodonServer::errorReply(const int statusCode, const QString &message)
+{
+    return {.statusCode = statusCode, .body = QJsonDocument(QJsonObject{{u"error"_s, message}})};
+}
+
+FakeMastodonServer::Reply FakeMastodonServer::handle(const Request &request)
+{
+    m_requestTotal++;
+    m_requestCounts[request.url.path()]++;
+
+    const auto now = QDateTime::currentDateTimeUtc();
+    if (!m_rateLimitReset.isValid() || now >= m_rateLimitReset) {
+        m_rateLimitRemaining = m_rateLimit;
+        m_rateLimitReset = now.addSecs(m_rateLimitWindow);
+    }
+
+    Reply reply;
+    if (m_rateLimitRemaining > 0) {
+        m_rateLimitRemaining--;
+        reply = route(request);
+    } else {
+        reply = errorReply(429, u"Too many requests"_s);
+    }
+
+    reply.headers.append({QByteArrayLiteral("X-RateLimit-Limit"), QByteArray::number(m_rateLimit)});
+    reply.headers.append({QByteArrayLiteral("X-RateLimit-Remaining"), QByteArray::number(m_rateLimitRemaining)});
+    reply.headers.append({QByteArrayLiteral("X-RateLimit-Reset"), m_rateLimitReset.toString(Qt::ISODateWithMs).toLatin1()});
+    return reply;
+}
+
+FakeMastodonServer::Reply FakeMastodonServer::route(const Request &request)
+{
+    const QString path = request.url.path();
+
+    if (m_files.contains(path) && (request.method == "GET" || request.method == "HEAD")) {
+        return file(request);
+    }
+
+    const QByteArray authorization = request.headers.value(QByteArrayLiteral("authorization"));
+    if (!authorization.isEmpty() && authorization != "Bearer " + accessToken().toLatin1()) {
+        return errorReply(401, u"The access token is invalid"_s);
+    }
+    const bool isPrivate = request.method != "GET" || std::ranges::any_of(privatePaths, [&path](const QString &privatePath) {
+                               return path.startsWith(privatePath);
+                           });
+    if (isPrivate && authorization.isEmpty()) {
+        return errorReply(401, u"This method requires an authenticated user"_s);
+    }
+
+    if (request.method == "POST" && path == "/api/v1/statuses"_L1) {
+        const auto body = QJsonDocument::fromJson(request.body).object();
+
+        auto post = status(++m_newestStatusId);
+        post[u"content"_s] = u"<p>%1</p>"_s.arg(body["status"_L1].toString().toHtmlEscaped());
+        post[u"account"_s] = account(1);
+
+        broadcast(u"user"_s, {}, u"update"_s, post);
+        broadcast(u"public"_s, {}, u"update"_s, post);
+        return {.body = QJsonDocument(post)};
+    }
+
+    if (request.method != "GET") {
+        return errorReply(404, u"Record not found"_s);
+    }
+
+    if (path == "/api/v2/instance"_L1) {
+        return {.body = QJsonDocument(instance())};
+    }
+    if (path == "/api/v1/accounts/verify_credentials"_L1) {
+        auto credentials = account(1);
+        credentials[u"source"_s] = QJsonObject{
+            {u"privacy"_s, u"public"_s},
+            {u"sensitive"_s, false},
+            {u"language"_s, u"en"_s},
+            {u"note"_s, QString()},
+            {u"fields"_s, QJsonArray()},
+        };
+        return {.body = QJsonDocument(credentials)};
+    }
+    if (path.startsWith("/api/v1/timelines/"_L1)) {
+        return page(request, m_newestStatusId, [this](const qint64 id) {
+            return status(id);
+        });
+    }
+    if (path == "/api/v1/notifications"_L1) {
+        return page(request, m_newestNotificationId, [this](const qint64 id) {
+            return notification(id);
+        });
+    }
+    if (path == "/api/v1/notifications/unread_count"_L1) {
+        return {.body = QJsonDocument(QJsonObject{{u"count"_s, 0}})};
+    }
+    if (path == "/api/v1/markers"_L1 || path == "/api/v1/preferences"_L1) {
+        return {.body = QJsonDocument(QJsonObject())};
+    }
+    if (emptyListPaths.contains(path)) {
+        return {.body = QJsonDocument(QJsonArray())};
+    }
+
+    // /api/v1/statuses/:id(/context) and /api/v1/accounts/:id(/statuses)
+    const auto segments = path.split(u'/', Qt::SkipEmptyParts);
+    if (segments.size() < 4 || segments[0] != "api"_L1 || segments[1] != "v1"_L1) {
+        return errorReply(404, u"Record not found"_s);
+    }
+
+    bool isNumber = false;
+    const qint64 id = segments[3].toLongLong(&isNumber);
+    const bool isThreadReply = id > threadIdBase && id <= threadIdBase + m_newestStatusId * m_threadLength;
+    if (segments[2] == "statuses"_L1 && isNumber && ((id >= 1 && id <= m_newestStatusId) || isThreadReply)) {
+        if (segments.size() == 4) {
+            return {.body = QJsonDocument(status(id))};
+        }
+        if (segments.size() == 5 && segments[4] == "context"_L1) {
+            const qint64 root = isThreadReply ? (id - threadIdBase - 1) / m_threadLength + 1 : id;
+            const qint64 firstReply = threadIdBase + (root - 1) * m_threadLength + 1;
+
+            QJsonArray ancestors;
+            QJsonArray descendants;
+            if (root != id) {
+                ancestors.append(status(root));
+            }
+            for (qint64 reply = firstReply; reply < firstReply + m_threadLength; reply++) {
+                if (reply < id) {
+                    ancestors.append(status(reply));
+                } else if (reply > id) {
+                    descendants.append(status(reply));
+                }
+            }
+            return {.body = QJsonDocument(QJsonObject{{u"ancestors"_s, ancestors}, {u"descendants"_s, descendants}})};
+        }
+    }
+    if (segments[2] == "accounts"_L1 && isNumber && id >= 1 && id <= m_accountCount + 1) {
+        if (segments.size() == 4) {
+            return {.body = QJsonDocument(account(id))};
+        }
+        if (segments.size() == 5 && segments[4] == "statuses"_L1) {
+            return page(request, m_newestStatusId, [this](const qint64 statusId) {
+                return status(statusId);
+            });
+        }
+    }
+
+    return errorReply(404, u"Record not found"_s);
+}
+
+FakeMastodonServer::Reply FakeMastodonServer::file(const Request &request)
+{
+    const QString path = request.url.path();
+    const File &file = m_files[path];
+    const qint64 size = file.data.size();
+
+    Reply reply{.contentType = QByteArrayLiteral("application/octet-stream"), .data = file.data};
+    reply.headers.append({QByteArrayLiteral("Accept-Ranges"), QByteArrayLiteral("bytes")});
+    reply.headers.append({QByteArrayLiteral("ETag"), file.etag});
+
+    // Like servers do, the range is ignored and the whole file sent if it changed since the client started
+    const QByteArray range = request.headers.value(QByteArrayLiteral("range"));
+    const QByteArray ifRange = request.headers.value(QByteArrayLiteral("if-range"));
+    if (range.startsWith("bytes=") && (ifRange.isEmpty() || ifRange == file.etag)) {
+        const auto bounds = range.sliced(6).split('-');
+        const qint64 requestedStart = bounds[0].toLongLong();
+        const qint64 start = request.method == "GET" ? std::max<qint64>(0, requestedStart - std::exchange(m_misalignNextRange, 0)) : requestedStart;
+        const qint64 end = bounds.value(1).isEmpty() ? size - 1 : std::min(bounds[1].toLongLong(), size - 1);
+        if (start >= size || start > end) {
+            reply.statusCode = 416;
+            reply.data.clear();
+            reply.headers.append({QByteArrayLiteral("Content-Range"), "bytes */" + QByteArray::number(size)});
+            return reply;
+        }
+
+        reply.statusCode = 206;
+        reply.data = file.data.sliced(start, end - start + 1);
+        reply.headers.append({QByteArrayLiteral("Content-Range"),
+                              "bytes " + QByteArray::number(start) + '-' + QByteArray::number(end) + '/' + QByteArray::number(size)});
+    }
+
+    if (request.method == "HEAD") {
+        reply.contentLength = reply.data.size();
+        reply.data.clear();
+        return reply;
+    }
+
+    reply.interruptAfter = std::exchange(m_interruptNextDownload, -1);
+    m_bytesServed[path] += reply.interruptAfter != -1 ? std::min<qint64>(reply.interruptAfter, reply.data.size()) : reply.data.size();
+    return reply;
+}
+
+void FakeMastodonServer::respond(QTcpSocket *socket, const Reply &reply)
+{
+    const QByteArray body = reply.contentType.isEmpty() ? reply.body.toJson(QJsonDocument::Compact) : reply.data;
+    const qint64 contentLength = reply.contentLength != -1 ? reply.contentLength : body.size();
+
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(reply.statusCode) + ' ' + reasonPhrase(reply.statusCode) + "\r\n";
+    response += "Content-Type: " + (reply.contentType.isEmpty() ? QByteArrayLiteral("application/json; charset=utf-8") : reply.contentType) + "\r\n";
+    response += "Content-Length: " + QByteArray::number(contentLength) + "\r\n";
+    for (const auto &[name, value] : reply.headers) {
+        response += name + ": " + value + "\r\n";
+    }
+
+    if (reply.interruptAfter != -1) {
+        socket->write(response + "\r\n" + body.left(reply.interruptAfter));
+        socket->disconnectFromHost();
+        return;
+    }
+
+    response += "\r\n" + body;
+    socket->write(response);
+}
+
+FakeMastodonServer::Reply FakeMastodonServer::page(const Request &request, const qint64 newestId, const std::function<QJsonObject(qint64)> &generate) const
+{
+    const QUrlQuery query(request.url);
+    const auto idParameter = [&query](const QString &name, const qint64 fallback) {
+        bool isNumber = false;
+        const qint64 id = query.queryItemValue(name).toLongLong(&isNumber);
+        return isNumber ? id : fallback;
+    };
+
+    const qint64 limit = std::clamp(idParameter(u"limit"_s, defaultPageSize), qint64(1), maxPageSize);
+    const qint64 upper = std::min(idParameter(u"max_id"_s, newestId + 1) - 1, newestId);
+    const qint64 lower = std::max(idParameter(u"min_id"_s, 0), idParameter(u"since_id"_s, 0)) + 1;
+
+    // A page after min_id starts right after it, the others start from the newest item
+    const qint64 top = query.hasQueryItem(u"min_id"_s) ? std::min(upper, lower + limit - 1) : upper;
+    const qint64 bottom = std::max(lower, top - limit + 1);
+
+    QJsonArray items;
+    for (qint64 id = top; id >= bottom; id--) {
+        items.append(generate(id));
+    }
+
+    Reply reply{.body = QJsonDocument(items)};
+    if (!items.isEmpty()) {
+        // Like Mastodon, the links keep the other parameters of the request, like the limit
+        const auto link = [&request, &query](const QString &name, const qint64 id) {
+            QUrlQuery linkQuery;
+            for (const auto &[key, value] : query.queryItems()) {
+                if (key != "max_id"_L1 && key != "min_id"_L1 && key != "since_id"_L1) {
+                    linkQuery.addQueryItem(key, value);
+                }
+            }
+            linkQuery.addQueryItem(name, QString::number(id));
+
+            QUrl url = request.url;
+            url.setQuery(linkQuery);
+            return url.toEncoded();
+        };
+        reply.headers.append({QByteArrayLiteral("Link"), '<' + link(u"max_id"_s, bottom) + ">; rel=\"next\", <" + link(u"min_id"_s, top) + ">; rel=\"prev\""});
+    }
+    return reply;
+}
+
+void FakeMastodonServer::acceptStreamingConnection()
+{
+    while (m_streamingServer.hasPendingConnections()) {
+        const auto socket = m_streamingServer.nextPendingConnection();
+
+        const QUrlQuery query(socket->requestUrl());
+        if (query.queryItemValue(u"access_token"_s) != accessToken()) {
+            socket->close(QWebSocketProtocol::CloseCodePolicyViolated, u"Invalid access token"_s);
+            socket->deleteLater();
+            continue;
+        }
+
+        auto &subscriptions = m_subscriptions[socket];
+        if (const QString stream = query.queryItemValue(u"stream"_s); !stream.isEmpty()) {
+            const QString parameter = stream == "list"_L1 ? query.queryItemValue(u"list"_s) : query.queryItemValue(u"tag"_s);
+            subscriptions.insert(StreamingManager::streamKey(stream, parameter));
+        }
+
+        connect(socket, &QWebSocket::textMessageReceived, this, [this, socket](const QString &message) {
+            handleStreamingMessage(socket, message);
+        });
+        connect(socket, &QWebSocket::disconnected, this, [this, socket] {
+            m_subscriptions.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void FakeMastodonServer::handleStreamingMessage(QWebSocket *socket, const QString &message)
+{
+    const auto object = QJsonDocument::fromJson(message.toUtf8()).object();
+    const QString stream = object["stream"_L1].toString();
+    const QString parameter = stream == "list"_L1 ? object["list"_L1].toString() : object["tag"_L1].toString();
+    const QString key = StreamingManager::streamKey(stream, parameter);
+
+    const QString type = object["type"_L1].toString();
+    if (type == "subscribe"_L1) {
+        m_subscriptions[socket].insert(key);
+        Q_EMIT subscribed(key);
+    } else if (type == "unsubscribe"_L1) {
+        m_subscriptions[socket].remove(key);
+    }
+}
+
+void FakeMastodonServer::startBurst(Burst burst)
+{
+    burst.timer.start();
+    m_bursts.append(burst);
+
+    if (!m_streamingTimer.isActive()) {
+        m_streamingTimer.start();
+    }
+    sendDueEvents();
+}
+
+void FakeMastodonServer::sendDueEvents()
+{
+    bool finishedBurst = false;
+    for (auto burst = m_bursts.begin(); burst != m_bursts.end();) {
+        // Catches up with the rate, even if the timer fired late
+        const qint64 due = burst->eventsPerSecond > 0 ? std::min(burst->count, burst->timer.elapsed() * burst->eventsPerSecond / 1000 + 1) : burst->count;
+        for (; burst->sent < due; burst->sent++) {
+            if (burst->notifications) {
+                broadcast(u"user"_s, {}, u"notification"_s, notification(++m_newestNotificationId));
+            } else {
+                broadcast(burst->stream, burst->parameter, u"update"_s, status(++m_newestStatusId));
+            }
+        }
+
+        if (burst->sent >= burst->count) {
+            burst = m_bursts.erase(burst);
+            finishedBurst = true;
+        } else {
+            ++burst;
+        }
+    }
+
+    if (m_bursts.isEmpty()) {
+        m_streamingTimer.stop();
+        if (finishedBurst) {
+            Q_EMIT streamingFinished();
+        }
+    }
+}
+
+void FakeMastodonServer::broadcast(const QString &stream, const QString &parameter, const QString &event, const QJsonObject &payload)
+{
+    QJsonArray streamName{stream};
+    if (!parameter.isEmpty()) {
+        streamName.append(parameter);
+    }
+
+    const QJsonObject envelope{
+        {u"stream"_s, streamName},
+        {u"event"_s, event},
+        {u"payload"_s, QString::fromUtf8(QJsonDocument(payload).toJson(QJsonDocument::Compact))},
+    };
+    const QString message = QString::fromUtf8(QJsonDocument(envelope).toJson(QJsonDocument::Compact));
+
+    const QString key = StreamingManager::streamKey(stream, parameter);
+    for (const auto &[socket, subscriptions] : m_subscriptions.asKeyValueRange()) {
+        if (subscriptions.contains(key)) {
+            socket->sendTextMessage(message);
+        }
+    }
+}
+
+QJsonObject FakeMastodonServer::instance() const
+{
+    return {
+        {u"domain"_s, u"127.0.0.1"_s},
+        {u"title"_s, u"Fake Mastodon"_s},
+        {u"version"_s, u"4.3.0"_s},
+        {u"api_versions"_s, QJsonObject{{u"mastodon"_s, 2}}},
+        {u"configuration"_s,
+         QJsonObject{
+             {u"urls"_s, QJsonObject{{u"streaming"_s, u"ws://127.0.0.1:%1"_s.arg(m_streamingServer.serverPort())}}},
+             {u"statuses"_s, QJsonObject{{u"max_characters"_s, 500}, {u"max_media_attachments"_s, 4}, {u"characters_reserved_per_url"_s, 23}}},
+             {u"polls"_s, QJsonObject{{u"max_options"_s, 4}, {u"max_characters_per_option"_s, 50}}},
+         }},
+        {u"registrations"_s, QJsonObject{{u"enabled"_s, false}, {u"message"_s, QJsonValue::Null}}},
+    };
+}
+
+QJsonObject FakeMastodonServer::account(const qint64 id) const
+{
+    const QString username = id == 1 ? u"tester"_s : u"user%1"_s.arg(id);
+    const QString url = instanceUri() + u"/@"_s + username;
+
+    return {
+        {u"id"_s, QString::number(id)},
+        {u"username"_s, username},
+        {u"acct"_s, username},
+        {u"display_name"_s, id == 1 ? u"Tester"_s : u"User %1"_s.arg(id)},
+        {u"locked"_s, false},
+        {u"bot"_s, false},
+        {u"discoverable"_s, true},
+        {u"group"_s, false},
+        {u"created_at"_s, timestamp(0)},
+        {u"note"_s, u"<p>Generated account %1</p>"_s.arg(id)},
+        {u"url"_s, url},
+        {u"avatar"_s, instanceUri() + u"/avatars/%1.png"_s.arg(id)},
+        {u"avatar_static"_s, instanceUri() + u"/avatars/%1.png"_s.arg(id)},
+        {u"header"_s, instanceUri() + u"/headers/%1.png"_s.arg(id)},
+        {u"header_static"_s, instanceUri() + u"/headers/%1.png"_s.arg(id)},
+        {u"followers_count"_s, id * 10},
+        {u"following_count"_s, id},
+        {u"statuses_count"_s, m_newestStatusId / m_accountCount},
+        {u"emojis"_s, QJsonArray()},
+        {u"fields"_s, QJsonArray()},
+    };
+}
+
+QJsonObject FakeMastodonServer::status(const qint64 id) const
+{
+    const bool isThreadReply = id > threadIdBase && m_threadLength > 0;
+    const qint64 root = isThreadReply ? (id - threadIdBase - 1) / m_threadLength + 1 : id;
+    const qint64 firstReply = threadIdBase + (root - 1) * m_threadLength + 1;
+    const qint64 inReplyToId = !isThreadReply ? 0 : (id == firstReply ? root : id - 1);
+
+    const qint64 authorId = id % m_accountCount + 2;
+    const qint64 mentionedId = (id + 1) % m_accountCount + 2;
+    const auto author = account(authorId);
+    const auto mentioned = account(mentionedId);
+    const QString url = u"%1/@%2/%3"_s.arg(instanceUri(), author["username"_L1].toString()).arg(id);
+
+    const QString content = u"<p>Post %1 for <span class=\"h-card\"><a href=\"%2\" class=\"u-url mention\">@<span>%3</span></a></span>, "
+                            "see <a href=\"%4/tags/tokodon\" class=\"mention hashtag\" rel=\"tag\">#<span>tokodon</span></a></p>"_s
+                                .arg(QString::number(id), mentioned["url"_L1].toString(), mentioned["username"_L1].toString(), instanceUri());
+
+    return {
+        {u"id"_s, QString::number(id)},
+        // Replies come after the post they reply to, and newer posts have higher ids
+        {u"created_at"_s, timestamp(isThreadReply ? root + (id - firstReply + 1) : id)},
+        {u"in_reply_to_id"_s, inReplyToId != 0 ? QJsonValue(QString::number(inReplyToId)) : QJsonValue::Null},
+        {u"in_reply_to_account_id"_s, inReplyToId != 0 ? QJsonValue(QString::number(inReplyToId % m_accountCount + 2)) : QJsonValue::Null},
+        {u"sensitive"_s, false},
+        {u"spoiler_text"_s, QString()},
+        {u"visibility"_s, u"public"_s},
+        {u"language"_s, u"en"_s},
+        {u"uri"_s, url},
+        {u"url"_s, url},
+        {u"replies_count"_s, isThreadReply ? 1 : m_threadLength},
+        {u"reblogs_count"_s, id % 7},
+        {u"favourites_count"_s, id % 13},
+        {u"favourited"_s, false},
+        {u"reblogged"_s, false},
+        {u"muted"_s, false},
+        {u"bookmarked"_s, false},
+        {u"content"_s, content},
+        {u"reblog"_s, QJsonValue::Null},
+        {u"account"_s, author},
+        {u"media_attachments"_s, QJsonArray()},
+        {u"mentions"_s,
+         QJsonArray{QJsonObject{
+             {u"id"_s, mentioned["id"_L1]},
+             {u"username"_s, mentioned["username"_L1]},
+             {u"acct"_s, mentioned["acct"_L1]},
+             {u"url"_s, mentioned["url"_L1]},
+         }}},
+        {u"tags"_s, QJsonArray{QJsonObject{{u"name"_s, u"tokodon"_s}, {u"url"_s, instanceUri() + u"/tags/tokodon"_s}}}},
+        {u"emojis"_s, QJsonArray()},
+        {u"card"_s, QJsonValue::Null},
+        {u"poll"_s, QJsonValue::Null},
+    };
+}
+
+QJsonObject FakeMastodonServer::notification(const qint64 id) const
+{
+    const QString type = notificationTypes[id % notificationTypes.size()];
+
+    QJsonObject object{
+        {u"id"_s, QString::number(id)},
+        {u"type"_s, type},
+        {u"created_at"_s, timestamp(id)},
+        {u"account"_s, account(id % m_accountCount + 2)},
+    };
+    if (type == "favourite"_L1 || type == "reblog"_L1) {
+        // Like in a real flood, they pile up on a few posts and end up grouped
+        object[u"status"_s] = status(std::max<qint64>(m_newestStatusId - id % 5, 1));
+    } else if (type != "follow"_L1) {
+        object[u"status"_s] = status(std::max<qint64>(std::min(id, m_newestStatusId), 1));
+    }
+    return object;
+}
+
+#include "moc_fakemastodonserver.cpp"
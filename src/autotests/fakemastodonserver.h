@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QSet>
+#include <QTcpServer>
+#include <QTimer>
+#include <QUrl>
+#include <QWebSocketServer>
+
+#include <functional>
+
+class QTcpSocket;
+class QWebSocket;
+
+/**
+ * @brief A Mastodon server on the loopback interface, made up of generated posts, accounts and notifications.
+ *
+ * Unlike MockAccount, it lets real Account instances be tested and benchmarked with their networking code: the REST API is served over
+ * plain HTTP/1.1 and the streaming API over a WebSocket. Timelines and notifications are paginated with Link headers, every reply has the
+ * rate limit headers, and new posts and notifications can be streamed at a given rate to load the client. Files can be served too, to
+ * test downloads.
+ *
+ * Nothing is stored, posts are generated from their id so timelines can be as long as needed. Every post is tagged #tokodon, and the
+ * account the server is logged into has the id 1.
+ */
+class FakeMastodonServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakeMastodonServer(QObject *parent = nullptr);
+    ~FakeMastodonServer() override;
+
+    /**
+     * @brief Starts serving on free ports.
+     * @return Whether it could.
+     */
+    bool listen();
+
+    /**
+     * @return The instance URI to give Account, like http://127.0.0.1:1234.
+     */
+    [[nodiscard]] QString instanceUri() const;
+
+    /**
+     * @return The access token the requests have to be made with.
+     */
+    [[nodiscard]] QString accessToken() const;
+
+    /**
+     * @brief How many posts the timelines start with, 400 by default.
+     */
+    void setStatusCount(qint64 count);
+
+    /**
+     * @brief How many notifications there are to start with, 200 by default.
+     */
+    void setNotificationCount(qint64 count);
+
+    /**
+     * @brief How many replies each post has in its thread, none by default.
+     */
+    void setThreadLength(qint64 length);
+
+    /**
+     * @brief How many different accounts write the posts, 50 by default.
+     */
+    void setAccountCount(qint64 count);
+
+    /**
+     * @brief Delays every reply by @p milliseconds, to simulate a slow network or server.
+     */
+    void setLatency(int milliseconds);
+
+    /**
+     * @brief How many requests are allowed every @p window seconds, after which they're answered with 429 Too Many Requests.
+     *
+     * Like Mastodon, 300 requests every 5 minutes by default.
+     */
+    void setRateLimit(int limit, int window = 300);
+
+    /**
+     * @brief Streams @p count new posts to the clients subscribed to @p stream, @p eventsPerSecond of them a second or all at once with 0.
+     * @param parameter The list id for "list" streams, and the tag for "hashtag" streams.
+     */
+    void streamStatuses(const QString &stream, const QString &parameter, qint64 count, int eventsPerSecond);
+
+    /**
+     * @brief Streams @p count new notifications to the clients subscribed to the user stream, @p eventsPerSecond of them a second or all at once with 0.
+     */
+    void streamNotifications(qint64 count, int eventsPerSecond);
+
+    /**
+     * @brief Serves @p data at @p path to GET and HEAD requests, with Range requests supported like a media server does.
+     */
+    void serveFile(const QString &path, const QByteArray &data, const QByteArray &etag = QByteArrayLiteral("\"1\""));
+
+    /**
+     * @brief Closes the connection of the next file download after @p bytes of it were sent, like when the network drops.
+     */
+    void interruptNextDownload(qint64 bytes);
+
+    /**
+     * @brief Starts the next partial file download @p bytes before the requested range, like a proxy rounding it to its blocks.
+     */
+    void misalignNextRange(qint64 bytes);
+
+    /**
+     * @return How many bytes of the file at @p path were sent, which tells a resumed download from one that started over.
+     */
+    [[nodiscard]] qint64 bytesServed(const QString &path) const;
+
+    /**
+     * @return How many requests were made to @p path, or in total if it's empty.
+     */
+    [[nodiscard]] qint64 requestCount(const QString &path = {}) const;
+
+    /**
+     * @return How many streaming clients are subscribed to @p stream.
+     */
+    [[nodiscard]] qint64 subscriberCount(const QString &stream, const QString &parameter = {}) const;
+
+    /**
+     * @return The account with @p id, 1 being the one the server is logged into. Also useful to generate data without serving it.
+     */
+    [[nodiscard]] QJsonObject account(qint64 id) const;
+
+    /**
+     * @return The post with @p id, as it's served in timelines.
+     */
+    [[nodiscard]] QJsonObject status(qint64 id) const;
+
+    /**
+     * @return The notification with @p id, as it's served.
+     */
+    [[nodiscard]] QJsonObject notification(qint64 id) const;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when a streaming client subscribed to @p stream, with the key StreamingManager::streamKey() gives it.
+     */
+    void subscribed(const QString &stream);
+
+    /**
+     * @brief Emitted once everything asked for with streamStatuses() or streamNotifications() was sent.
+     */
+    void streamingFinished();
+
+private:
+    struct Request {
+        QByteArray method;
+        QUrl url;
+        QHash<QByteArray, QByteArray> headers; ///< With lowercase names
+        QByteArray body;
+    };
+
+    struct Reply {
+        int statusCode = 200;
+        QJsonDocument body;
+        QList<std::pair<QByteArray, QByteArray>> headers;
+        QByteArray contentType; ///< Set for files, which are sent as data instead of body
+        QByteArray data;
+        qint64 contentLength = -1; ///< When it's not the size of what is sent, like for HEAD requests
+        qint64 interruptAfter = -1;
+    };
+
+    struct File {
+        QByteArray data;
+        QByteArray etag;
+    };
+
+    struct Burst {
+        QString stream;
+        QString parameter;
+        bool notifications = false;
+        qint64 count = 0;
+        int eventsPerSecond = 0;
+        qint64 sent = 0;
+        QElapsedTimer timer;
+    };
+
+    [[nodiscard]] static Reply errorReply(int statusCode, const QString &message);
+
+    void acceptConnection();
+    void readRequests(QTcpSocket *socket);
+    [[nodiscard]] Reply handle(const Request &request);
+    [[nodiscard]] Reply route(const Request &request);
+    void respond(QTcpSocket *socket, const Reply &reply);
+    [[nodiscard]] Reply file(const Request &request);
+    [[nodiscard]] Reply page(const Request &request, qint64 newestId, const std::function<QJsonObject(qint64)> &generate) const;
+
+    void acceptStreamingConnection();
+    void handleStreamingMessage(QWebSocket *socket, const QString &message);
+    void startBurst(Burst burst);
+    void sendDueEvents();
+    void broadcast(const QString &stream, const QString &parameter, const QString &event, const QJsonObject &payload);
+
+    [[nodiscard]] QJsonObject instance() const;
+
+    QTcpServer m_httpServer;
+    QWebSocketServer m_streamingServer;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QHash<QWebSocket *, QSet<QString>> m_subscriptions;
+
+    QList<Burst> m_bursts;
+    QTimer m_streamingTimer;
+
+    QHash<QString, File> m_files;
+    QHash<QString, qint64> m_bytesServed;
+    qint64 m_interruptNextDownload = -1;
+    qint64 m_misalignNextRange = 0;
+
+    QHash<QString, qint64> m_requestCounts;
+    qint64 m_requestTotal = 0;
+
+    qint64 m_newestStatusId = 400;
+    qint64 m_newestNotificationId = 200;
+    qint64 m_threadLength = 0;
+    qint64 m_accountCount = 50;
+    int m_latency = 0;
+
+    int m_rateLimit = 300;
+    int m_rateLimitWindow = 300;
+    int m_rateLimitRemaining = 0;
+    QDateTime m_rateLimitReset;
+};
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "account/account.h"
+#include "account/accountmanager.h"
+#include "account/streamingmanager.h"
+#include "autotests/fakemastodonserver.h"
+#include "timeline/tagstimelinemodel.h"
+#include "utils/metrics.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+#include <memory>
+
+using namespace Qt::Literals::StringLiterals;
+
+class FakeServerTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    // Logs in like a saved account is loaded, without waiting for it
+    Account *login(const QString &accessToken)
+    {
+        return new Account(u"fake"_s, server.instanceUri(), u"tester"_s, {}, {}, accessToken, &nam);
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        AccountManager::instance().setTestMode(true);
+        QVERIFY(server.listen());
+
+        account = login(server.accessToken());
+        AccountManager::instance().addAccount(account);
+
+        QSignalSpy authenticatedSpy(account, &AbstractAccount::authenticated);
+        QVERIFY(authenticatedSpy.wait());
+        QCOMPARE(authenticatedSpy.first().at(0).toBool(), true);
+
+        // The user stream is subscribed once the instance said where to stream from
+        QTRY_COMPARE(server.subscriberCount(u"user"_s), qint64(1));
+    }
+
+    void testAuthentication()
+    {
+        QVERIFY(account->successfullyAuthenticated());
+        QCOMPARE(account->identity()->username(), u"tester"_s);
+        QCOMPARE(account->apiUrl(u"/api/v1/statuses"_s).scheme(), u"http"_s);
+        QCOMPARE(server.requestCount(u"/api/v1/accounts/verify_credentials"_s), qint64(1));
+    }
+
+    void testInvalidToken()
+    {
+        const auto invalidAccount = login(u"wrong-token"_s);
+        QSignalSpy authenticatedSpy(invalidAccount, &AbstractAccount::authenticated);
+        QVERIFY(authenticatedSpy.wait());
+        QCOMPARE(authenticatedSpy.first().at(0).toBool(), false);
+        QCOMPARE(authenticatedSpy.first().at(1).toString(), u"The access token is invalid"_s);
+        delete invalidAccount;
+    }
+
+    // Pages are followed with the Link headers, newest posts first
+    void testTimelinePaging()
+    {
+        TagsTimelineModel model;
+        model.setHashtag(u"tokodon"_s);
+        QTRY_COMPARE(model.rowCount({}), 20);
+        QCOMPARE(model.data(model.index(0, 0), AbstractTimelineModel::IdRole).toString(), u"400"_s);
+
+        model.fetchMore({});
+        QTRY_COMPARE(model.rowCount({}), 40);
+        QCOMPARE(model.data(model.index(39, 0), AbstractTimelineModel::IdRole).toString(), u"361"_s);
+        QCOMPARE(server.requestCount(u"/api/v1/timelines/tag/tokodon"_s), qint64(2));
+    }
+
+    void testLongThread()
+    {
+        server.setThreadLength(500);
+
+        QJsonObject context;
+        account->get(account->apiUrl(u"/api/v1/statuses/7/context"_s), true, this, [&context](QNetworkReply *reply) {
+            context = QJsonDocument::fromJson(reply->readAll()).object();
+        });
+        QTRY_VERIFY(!context.isEmpty());
+
+        const auto descendants = context["descendants"_L1].toArray();
+        QCOMPARE(descendants.size(), 500);
+        QCOMPARE(descendants.first()["in_reply_to_id"_L1].toString(), u"7"_s);
+        QCOMPARE(descendants.last()["in_reply_to_id"_L1].toString(), descendants[498]["id"_L1].toString());
+
+        server.setThreadLength(0);
+    }
+
+    void testRateLimit()
+    {
+        server.setRateLimit(3, 60);
+
+        QList<int> statusCodes;
+        QList<QByteArray> remaining;
+        for (int i = 0; i < 5; i++) {
+            account->get(
+                account->apiUrl(u"/api/v1/timelines/public"_s),
+                true,
+                this,
+                [&statusCodes, &remaining](QNetworkReply *reply) {
+                    statusCodes.append(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+                    remaining.append(reply->rawHeader(QByteArrayLiteral("X-RateLimit-Remaining")));
+                },
+                nullptr,
+                true);
+        }
+        QTRY_COMPARE(statusCodes.size(), 5);
+
+        std::ranges::sort(statusCodes);
+        QCOMPARE(statusCodes, (QList<int>{200, 200, 200, 429, 429}));
+        std::ranges::sort(remaining);
+        QCOMPARE(remaining, (QList<QByteArray>{"0", "0", "0", "1", "2"}));
+
+        server.setRateLimit(300);
+    }
+
+    // Thousands of posts a minute on a hashtag, sped up
+    void testStreamingThroughput()
+    {
+        const auto alivePosts = Metrics::instance().gauge(u"posts.alive"_s);
+
+        QSignalSpy subscribedSpy(&server, &FakeMastodonServer::subscribed);
+        auto model = std::make_unique<TagsTimelineModel>();
+        model->setHashtag(u"tokodon"_s);
+        QVERIFY(subscribedSpy.wait());
+        QTRY_COMPARE(model->rowCount({}), 20);
+
+        // They're sent over two seconds. How long it takes to keep up depends on the machine, so it's only reported.
+        QBENCHMARK_ONCE {
+            server.streamStatuses(u"hashtag"_s, u"tokodon"_s, 1000, 500);
+            QTRY_COMPARE_WITH_TIMEOUT(model->rowCount({}), 1020, 30000);
+        }
+
+        // Only the posts that are shown are kept, and they're all gone with the timeline
+        QCOMPARE(Metrics::instance().gauge(u"posts.alive"_s) - alivePosts, qint64(model->rowCount({})));
+        model.reset();
+        QTRY_COMPARE(Metrics::instance().gauge(u"posts.alive"_s), alivePosts);
+    }
+
+    void testNotificationFlood()
+    {
+        // Flood an account AccountManager doesn't know about, so nothing shows the notifications
+        const auto floodedAccount = login(server.accessToken());
+        QSignalSpy authenticatedSpy(floodedAccount, &AbstractAccount::authenticated);
+        QVERIFY(authenticatedSpy.wait());
+        QTRY_COMPARE(server.subscriberCount(u"user"_s), qint64(2));
+        account->streaming()->unsubscribe(u"user"_s);
+        QTRY_COMPARE(server.subscriberCount(u"user"_s), qint64(1));
+
+        int received = 0;
+        connect(floodedAccount, &AbstractAccount::notification, this, [&received] {
+            received++;
+        });
+        server.streamNotifications(300, 0);
+        QTRY_COMPARE(received, 300);
+
+        delete floodedAccount;
+        account->streaming()->subscribe(u"user"_s);
+    }
+
+private:
+    FakeMastodonServer server;
+    QNetworkAccessManager nam;
+    Account *account = nullptr;
+};
+
+QTEST_MAIN(FakeServerTest)
+#include "fakeservertest.moc"
@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "account/account.h"
+#include "autotests/fakemastodonserver.h"
+#include "utils/filetransferjob.h"
+
+#include <QNetworkAccessManager>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+using namespace Qt::Literals::StringLiterals;
+
+class FileTransferJobTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    // Not the same bytes over and over, so a range written at the wrong place shows
+    static QByteArray randomData(const qsizetype size)
+    {
+        QRandomGenerator generator(static_cast<quint32>(size));
+        QByteArray data(size, Qt::Uninitialized);
+        for (auto &byte : data) {
+            byte = static_cast<char>(generator.bounded(256));
+        }
+        return data;
+    }
+
+    static QByteArray readFile(const QString &path)
+    {
+        QFile file(path);
+        file.open(QIODevice::ReadOnly);
+        return file.readAll();
+    }
+
+    FileTransferJob *download(const QString &path, const QString &destination)
+    {
+        const auto job = new FileTransferJob(account.get(), server.instanceUri() + path, destination);
+        job->setAutoDelete(false);
+        return job;
+    }
+
+    // Where the partial files and their journals are kept
+    static bool partialDataLeft()
+    {
+        return !QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + u"/downloads"_s).isEmpty();
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + u"/downloads"_s).removeRecursively();
+
+        QVERIFY(destinationDir.isValid());
+        QVERIFY(server.listen());
+        account = std::make_unique<Account>(server.instanceUri(), &nam);
+    }
+
+    void testDownload()
+    {
+        const auto data = randomData(300 * 1024);
+        server.serveFile(u"/media/download.bin"_s, data);
+        const QString destination = destinationDir.filePath(u"download.bin"_s);
+
+        const std::unique_ptr<FileTransferJob> job(download(u"/media/download.bin"_s, destination));
+        QSignalSpy resultSpy(job.get(), &KJob::result);
+        job->start();
+        QVERIFY(resultSpy.wait());
+
+        QCOMPARE(job->error(), int(KJob::NoError));
+        QCOMPARE(readFile(destination), data);
+        QVERIFY(!partialDataLeft());
+    }
+
+    // The connection drops in the middle, and the job asks for the rest only
+    void testResume()
+    {
+        const auto data = randomData(400 * 1024);
+        server.serveFile(u"/media/resume.bin"_s, data);
+        server.interruptNextDownload(150 * 1024);
+        const QString destination = destinationDir.filePath(u"resume.bin"_s);
+
+        const std::unique_ptr<FileTransferJob> job(download(u"/media/resume.bin"_s, destination));
+        QSignalSpy resultSpy(job.get(), &KJob::result);
+        job->start();
+        QVERIFY(resultSpy.wait());
+
+        QCOMPARE(job->error(), int(KJob::NoError));
+        QCOMPARE(readFile(destination), data);
+        // The HEAD request, the one that was interrupted and the one for the rest of the file
+        QCOMPARE(server.requestCount(u"/media/resume.bin"_s), qint64(3));
+        QCOMPARE(server.bytesServed(u"/media/resume.bin"_s), qint64(data.size()));
+        QVERIFY(!partialDataLeft());
+    }
+
+    // The rest of the file comes back from another offset than asked for, which must not end up in the file
+    void testMisalignedRange()
+    {
+        const auto data = randomData(400 * 1024);
+        server.serveFile(u"/media/misaligned.bin"_s, data);
+        server.interruptNextDownload(150 * 1024);
+        server.misalignNextRange(50 * 1024);
+        const QString destination = destinationDir.filePath(u"misaligned.bin"_s);
+
+        const std::unique_ptr<FileTransferJob> job(download(u"/media/misaligned.bin"_s, destination));
+        QSignalSpy resultSpy(job.get(), &KJob::result);
+        job->start();
+        QVERIFY(resultSpy.wait());
+
+        QCOMPARE(job->error(), int(KJob::NoError));
+        QCOMPARE(readFile(destination), data);
+        // The HEAD request, the interrupted one, the misaligned one, then another HEAD request and the whole file
+        QCOMPARE(server.requestCount(u"/media/misaligned.bin"_s), qint64(5));
+        QVERIFY(!partialDataLeft());
+    }
+
+    // Like when the app is closed in the middle of a download, and it's downloaded again later
+    void testResumeInNewJob()
+    {
+        const auto data = randomData(400 * 1024);
+        server.serveFile(u"/media/later.bin"_s, data);
+        server.interruptNextDownload(150 * 1024);
+        const QString destination = destinationDir.filePath(u"later.bin"_s);
+
+        const std::unique_ptr<FileTransferJob> interruptedJob(download(u"/media/later.bin"_s, destination));
+        interruptedJob->start();
+        // Stopped before it retries by itself
+        QTRY_COMPARE(interruptedJob->processedAmount(KJob::Bytes), qulonglong(150 * 1024));
+        QTRY_COMPARE(server.requestCount(u"/media/later.bin"_s), qint64(2));
+        QVERIFY(interruptedJob->kill(KJob::Quietly));
+        QVERIFY(partialDataLeft());
+        QVERIFY(!QFile::exists(destination));
+
+        const std::unique_ptr<FileTransferJob> job(download(u"/media/later.bin"_s, destination));
+        QSignalSpy resultSpy(job.get(), &KJob::result);
+        job->start();
+        QVERIFY(resultSpy.wait());
+
+        QCOMPARE(job->error(), int(KJob::NoError));
+        QCOMPARE(readFile(destination), data);
+        // No HEAD request this time, the size and ETag are in the journal
+        QCOMPARE(server.requestCount(u"/media/later.bin"_s), qint64(3));
+        QCOMPARE(server.bytesServed(u"/media/later.bin"_s), qint64(data.size()));
+        QVERIFY(!partialDataLeft());
+    }
+
+    void testConcurrentJobs()
+    {
+        const auto data = randomData(300 * 1024);
+        server.serveFile(u"/media/shared.bin"_s, data);
+
+        // The same file saved to two places at once
+        const std::unique_ptr<FileTransferJob> first(download(u"/media/shared.bin"_s, destinationDir.filePath(u"first.bin"_s)));
+        const std::unique_ptr<FileTransferJob> second(download(u"/media/shared.bin"_s, destinationDir.filePath(u"second.bin"_s)));
+        QSignalSpy firstSpy(first.get(), &KJob::result);
+        QSignalSpy secondSpy(second.get(), &KJob::result);
+        first->start();
+        second->start();
+        QTRY_COMPARE(firstSpy.size(), 1);
+        QTRY_COMPARE(secondSpy.size(), 1);
+
+        QCOMPARE(first->error(), int(KJob::NoError));
+        QCOMPARE(second->error(), int(KJob::NoError));
+        QCOMPARE(readFile(destinationDir.filePath(u"first.bin"_s)), data);
+        QCOMPARE(readFile(destinationDir.filePath(u"second.bin"_s)), data);
+
+        // Saving to the same place twice at once is refused, without disturbing the download already going on
+        const std::unique_ptr<FileTransferJob> third(download(u"/media/shared.bin"_s, destinationDir.filePath(u"third.bin"_s)));
+        const std::unique_ptr<FileTransferJob> duplicate(download(u"/media/shared.bin"_s, destinationDir.filePath(u"third.bin"_s)));
+        QSignalSpy thirdSpy(third.get(), &KJob::result);
+        third->start();
+        duplicate->start();
+        QCOMPARE(duplicate->error(), int(FileTransferJob::FileError));
+
+        QVERIFY(thirdSpy.wait());
+        QCOMPARE(third->error(), int(KJob::NoError));
+        QCOMPARE(readFile(destinationDir.filePath(u"third.bin"_s)), data);
+        QVERIFY(!partialDataLeft());
+    }
+
+private:
+    FakeMastodonServer server;
+    QNetworkAccessManager nam;
+    std::unique_ptr<Account> account;
+    QTemporaryDir destinationDir;
+};
+
+QTEST_MAIN(FileTransferJobTest)
+#include "filetransferjobtest.moc"
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "accountmanager.h"
+
+#include <QtTest/QtTest>
+
+#include "account/filterengine.h"
+#include "account/streamingmanager.h"
+#include "autotests/helperreply.h"
+#include "autotests/mockaccount.h"
+#include "timeline/maintimelinemodel.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class FilterEngineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        AccountManager::instance().setTestMode(true);
+        account = new MockAccount();
+        AccountManager::instance().addAccount(account);
+    }
+
+    void init()
+    {
+        account->filterEngine()->setFilters({});
+    }
+
+    void testMatching()
+    {
+        FilterEngine engine(account);
+        QVERIFY(!engine.isLoaded());
+        engine.setFilters(filters());
+        QVERIFY(engine.isLoaded());
+
+        QCOMPARE(titles(engine.match(u"Lorem ipsum"_s)), QStringList{u"Latin"_s});
+        QCOMPARE(titles(engine.match(u"<b>LOREM</b>"_s)), QStringList{u"Latin"_s});
+
+        // Whole words don't match as a part of another word, other keywords do
+        QVERIFY(engine.match(u"Loremipsum"_s).isEmpty());
+        QCOMPARE(titles(engine.match(u"Two quoted postsss"_s)), QStringList{u"Quotes"_s});
+
+        // Keywords overlapping each other are all found in one pass
+        QCOMPARE(titles(engine.match(u"ushers"_s)), (QStringList{u"She"_s, u"Hers"_s}));
+
+        // Filters can be about a status instead of keywords
+        QCOMPARE(titles(engine.match(QString(), StatusId(u"103270115826048976"_s))), QStringList{u"She"_s});
+
+        const auto matches = engine.match(u"lorem and quoted posts"_s);
+        QCOMPARE(matches.size(), 2);
+        QCOMPARE(matches[0].contexts, FilterEngine::HomeContext | FilterEngine::PublicContext);
+        QVERIFY(!matches[0].hide);
+        QCOMPARE(matches[1].contexts, FilterEngine::HomeContext);
+        QVERIFY(matches[1].hide);
+    }
+
+    void testApplyToTimeline()
+    {
+        QUrl markersUrl = account->apiUrl(u"/api/v1/markers"_s);
+        markersUrl.setQuery(u"timeline[]=home"_s);
+        account->registerGet(markersUrl, new TestReply(u"markers.json"_s, account));
+        account->registerGet(account->apiUrl(u"/api/v1/timelines/home"_s), new TestReply(u"statuses.json"_s, account));
+
+        MainTimelineModel timelineModel;
+        timelineModel.setName(u"home"_s);
+        QCOMPARE(timelineModel.rowCount({}), 7);
+        QVERIFY(timelineModel.index(2, 0).data(AbstractTimelineModel::FiltersRole).toStringList().isEmpty());
+
+        // Changed filters apply to the rows that are already there
+        QSignalSpy removedSpy(&timelineModel, &QAbstractItemModel::rowsRemoved);
+        QSignalSpy changedSpy(&timelineModel, &QAbstractItemModel::dataChanged);
+        account->filterEngine()->setFilters(filters());
+
+        QCOMPARE(removedSpy.size(), 2);
+        QCOMPARE(timelineModel.rowCount({}), 5);
+        QVERIFY(!changedSpy.isEmpty());
+        QVERIFY(changedSpy.first().at(2).value<QList<int>>().contains(AbstractTimelineModel::FiltersRole));
+        QCOMPARE(timelineModel.index(0, 0).data(AbstractTimelineModel::FiltersRole).toStringList(), QStringList{u"Latin"_s});
+
+        // Thread filters don't apply to the home timeline
+        const auto post = timelineModel.index(0, 0).data(AbstractTimelineModel::PostRole).value<Post *>();
+        QVERIFY(post->filtered(FilterEngine::HomeContext));
+        QVERIFY(!post->filtered(FilterEngine::ThreadContext));
+        QVERIFY(!post->hidden(FilterEngine::HomeContext));
+    }
+
+    void testFiltersChanged()
+    {
+        account->registerGet(account->apiUrl(u"/api/v2/filters"_s), new TestReply(u"filters.json"_s, account));
+
+        QSignalSpy spy(account->filterEngine(), &FilterEngine::changed);
+        Q_EMIT account->streaming()->streamEvent(u"user"_s, AbstractAccount::FiltersChangedEvent, {});
+        QCOMPARE(spy.size(), 1);
+        QCOMPARE(titles(account->filterEngine()->match(u"Lorem"_s)), QStringList{u"Latin"_s});
+    }
+
+    void testFetchFailed()
+    {
+        const auto notFound = new TestReply(u"error.json"_s, account);
+        notFound->setHttpStatusCode(404);
+        account->registerGet(account->apiUrl(u"/api/v2/filters"_s), notFound);
+
+        // Servers without v2 filters still mark the posts they send as filtered
+        FilterEngine engine(account);
+        engine.refresh();
+        QVERIFY(!engine.isLoaded());
+
+        // The filters that were fetched before are kept
+        account->filterEngine()->setFilters(filters());
+        account->filterEngine()->refresh();
+        QVERIFY(account->filterEngine()->isLoaded());
+        QCOMPARE(titles(account->filterEngine()->match(u"Lorem"_s)), QStringList{u"Latin"_s});
+    }
+
+private:
+    QJsonArray filters() const
+    {
+        QFile file(QLatin1String(DATA_DIR "/filters.json"));
+        file.open(QIODevice::ReadOnly);
+        return QJsonDocument::fromJson(file.readAll()).array();
+    }
+
+    static QStringList titles(const QList<FilterEngine::Match> &matches)
+    {
+        QStringList titles;
+        for (const auto &match : matches) {
+            titles.append(match.title);
+        }
+        return titles;
+    }
+
+    MockAccount *account = nullptr;
+};
+
+QTEST_MAIN(FilterEngineTest)
+#include "filterenginetest.moc"
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <QBuffer>
 #include <QFile>
 #include <QNetworkReply>
 
@@ -38,5 +39,46 @@ public:
         QNetworkReply::setRawHeader(headerName, value);
     }
 
+    void setHttpStatusCode(const int statusCode)
+    {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, statusCode);
+        if (statusCode >= 400) {
+            setError(NetworkError::UnknownServerError, QString());
+        }
+    }
+
     QFile apiResult;
 };
+
+/**
+ * A reply with @p data, for replies that are easier to build in the test than to keep in a file.
+ */
+class DataReply : public QNetworkReply
+{
+public:
+    DataReply(const QByteArray &data, QObject *parent)
+        : QNetworkReply(parent)
+    {
+        setError(NetworkError::NoError, QString());
+        setFinished(true);
+
+        apiResult.setData(data);
+        apiResult.open(QIODevice::ReadOnly);
+    }
+
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        return apiResult.read(data, maxSize);
+    }
+
+    bool seek(const qint64 pos) override
+    {
+        return apiResult.seek(pos);
+    }
+
+    void abort() override
+    {
+    }
+
+    QBuffer apiResult;
+};
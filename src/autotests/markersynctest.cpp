@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "accountmanager.h"
+
+#include <QtTest/QtTest>
+
+#include "account/markersync.h"
+#include "autotests/helperreply.h"
+#include "autotests/mockaccount.h"
+
+using namespace Qt::Literals::StringLiterals;
+using namespace std::chrono_literals;
+
+class MarkerSyncTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        AccountManager::instance().setTestMode(true);
+        account = new MockAccount();
+        AccountManager::instance().addAccount(account);
+    }
+
+    void testCoalescing()
+    {
+        MarkerSync sync(account);
+        sync.setServerMarkers(markers(QString(), QString(), 1));
+
+        QSignalSpy spy(account, &MockAccount::jsonPosted);
+
+        // Only the newest marker of each timeline is kept, and nothing is sent yet
+        sync.setLastReadId(u"home"_s, u"103270115826048975"_s);
+        sync.setLastReadId(u"home"_s, u"103270115826048976"_s);
+        sync.setLastReadId(u"home"_s, u"103270115826048970"_s);
+        sync.setLastReadId(u"notifications"_s, u"5"_s);
+        QVERIFY(spy.isEmpty());
+        QVERIFY(sync.hasPendingMarkers());
+        QCOMPARE(sync.lastReadId(u"home"_s), u"103270115826048976"_s);
+
+        // Both timelines go in one request
+        account->registerPost(u"/api/v1/markers"_s, new TestReply(u"markers_saved.json"_s, account));
+        sync.flush();
+        QCOMPARE(spy.size(), 1);
+        const auto sent = spy.first().at(1).value<QJsonDocument>().object();
+        QCOMPARE(sent["home"_L1]["last_read_id"_L1].toString(), u"103270115826048976"_s);
+        QCOMPARE(sent["notifications"_L1]["last_read_id"_L1].toString(), u"5"_s);
+        QVERIFY(!sync.hasPendingMarkers());
+
+        sync.flush();
+        QCOMPARE(spy.size(), 1);
+    }
+
+    void testConflicts()
+    {
+        MarkerSync sync(account);
+        sync.setServerMarkers(markers(u"103270115826048975"_s, u"5"_s, 2));
+
+        QSignalSpy spy(account, &MockAccount::jsonPosted);
+        sync.setLastReadId(u"home"_s, u"103270115826048976"_s);
+
+        // Another device read further in the meantime, so our marker isn't sent
+        sync.setServerMarkers(markers(u"103270115826048977"_s, u"5"_s, 3));
+        QVERIFY(!sync.hasPendingMarkers());
+        QCOMPARE(sync.lastReadId(u"home"_s), u"103270115826048977"_s);
+
+        // A reply from before that doesn't move it back
+        sync.setServerMarkers(markers(u"103270115826048975"_s, u"5"_s, 2));
+        QCOMPARE(sync.lastReadId(u"home"_s), u"103270115826048977"_s);
+
+        sync.setLastReadId(u"home"_s, u"103270115826048976"_s);
+        sync.flush();
+        QVERIFY(spy.isEmpty());
+    }
+
+    void testRetries()
+    {
+        MarkerSync sync(account);
+        sync.setServerMarkers(markers(QString(), QString(), 1));
+
+        const auto unavailable = new TestReply(u"error.json"_s, account);
+        unavailable->setHttpStatusCode(503);
+        account->registerPost(u"/api/v1/markers"_s, unavailable);
+
+        QSignalSpy spy(account, &MockAccount::jsonPosted);
+        sync.setLastReadId(u"home"_s, u"103270115826048975"_s);
+
+        // Each failure waits twice as long as the one before, up to a limit
+        sync.flush();
+        QCOMPARE(spy.size(), 1);
+        QVERIFY(sync.nextFlush() > 9s && sync.nextFlush() <= 10s);
+        sync.flush();
+        QVERIFY(sync.nextFlush() > 19s && sync.nextFlush() <= 20s);
+        for (int i = 0; i < 10; ++i) {
+            sync.flush();
+        }
+        QCOMPARE(spy.size(), 12);
+        QVERIFY(sync.nextFlush() > 9min && sync.nextFlush() <= 10min);
+        QVERIFY(sync.hasPendingMarkers());
+
+        // Moving the marker in the meantime doesn't bring the request forward
+        sync.setLastReadId(u"home"_s, u"103270115826048976"_s);
+        QVERIFY(sync.nextFlush() > 9min);
+
+        // Once it works again, the usual delay is back
+        account->registerPost(u"/api/v1/markers"_s, new TestReply(u"markers_saved.json"_s, account));
+        sync.flush();
+        QVERIFY(!sync.hasPendingMarkers());
+        sync.setLastReadId(u"home"_s, u"103270115826048977"_s);
+        QVERIFY(sync.nextFlush() > 9s && sync.nextFlush() <= 10s);
+    }
+
+    void testUnsupported()
+    {
+        MarkerSync sync(account);
+        sync.setServerMarkers(markers(QString(), QString(), 1));
+
+        const auto notFound = new TestReply(u"error.json"_s, account);
+        notFound->setHttpStatusCode(404);
+        account->registerPost(u"/api/v1/markers"_s, notFound);
+
+        QSignalSpy spy(account, &MockAccount::jsonPosted);
+        sync.setLastReadId(u"home"_s, u"103270115826048975"_s);
+        sync.flush();
+        QCOMPARE(spy.size(), 1);
+
+        // A server without markers isn't asked again
+        QVERIFY(sync.nextFlush() < 0ms);
+        sync.setLastReadId(u"home"_s, u"103270115826048976"_s);
+        QVERIFY(sync.nextFlush() < 0ms);
+        sync.flush();
+        QCOMPARE(spy.size(), 1);
+
+        // The markers are still known here
+        QCOMPARE(sync.lastReadId(u"home"_s), u"103270115826048976"_s);
+    }
+
+    void testRejected()
+    {
+        MarkerSync sync(account);
+        sync.setServerMarkers(markers(QString(), QString(), 1));
+
+        const auto rejected = new TestReply(u"error.json"_s, account);
+        rejected->setHttpStatusCode(422);
+        account->registerPost(u"/api/v1/markers"_s, rejected);
+
+        QSignalSpy spy(account, &MockAccount::jsonPosted);
+        sync.setLastReadId(u"home"_s, u"103270115826048975"_s);
+        sync.flush();
+        QCOMPARE(spy.size(), 1);
+
+        // Markers the server refuses are dropped instead of being sent again
+        QVERIFY(!sync.hasPendingMarkers());
+        QVERIFY(sync.nextFlush() < 0ms);
+
+        // Newer ones are still sent
+        sync.setLastReadId(u"home"_s, u"103270115826048976"_s);
+        QVERIFY(sync.nextFlush() > 9s && sync.nextFlush() <= 10s);
+    }
+
+private:
+    static QJsonObject markers(const QString &home, const QString &notifications, const int version)
+    {
+        return {
+            {u"home"_s, QJsonObject{{u"last_read_id"_s, home}, {u"version"_s, version}}},
+            {u"notifications"_s, QJsonObject{{u"last_read_id"_s, notifications}, {u"version"_s, version}}},
+        };
+    }
+
+    MockAccount *account = nullptr;
+};
+
+QTEST_MAIN(MarkerSyncTest)
+#include "markersynctest.moc"
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "autotests/replayaccount.h"
+#include "editor/mediauploadjob.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class MediaUploadJobTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static NetworkRecording::Exchange exchange(const QByteArray &operation, const QString &path, const int statusCode, const QJsonObject &body)
+    {
+        return {
+            .operation = operation,
+            .url = QUrl(u"https://example.social"_s + path),
+            .statusCode = statusCode,
+            .body = QJsonDocument(body).toJson(QJsonDocument::Compact),
+        };
+    }
+
+    static QJsonObject attachment(const QString &id, const bool processed)
+    {
+        const QJsonValue url = processed ? QJsonValue(u"https://example.social/media/%1.png"_s.arg(id)) : QJsonValue(QJsonValue::Null);
+        return {
+            {u"id"_s, id},
+            {u"type"_s, u"image"_s},
+            {u"url"_s, url},
+            {u"preview_url"_s, url},
+        };
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // Errors are logged to the state config
+        QStandardPaths::setTestModeEnabled(true);
+        QVERIFY(workingDirectory.isValid());
+    }
+
+    // The server is still processing the image after the upload, and the job waits until it's done
+    void testProcessing()
+    {
+        NetworkRecording recording;
+        recording.exchanges = {
+            exchange("POST", u"/api/v2/media"_s, 202, attachment(u"7"_s, false)),
+            exchange("GET", u"/api/v1/media/7"_s, 206, attachment(u"7"_s, false)),
+            exchange("GET", u"/api/v1/media/7"_s, 200, attachment(u"7"_s, true)),
+        };
+        ReplayAccount account(recording);
+        account.setTimeScale(0);
+
+        MediaUploadJob job(&account, QLatin1String(DATA_DIR "/test.png"), workingDirectory.path());
+        job.setPolling(1, 1, 5);
+        QSignalSpy uploadedSpy(&job, &MediaUploadJob::uploaded);
+        QSignalSpy processedSpy(&job, &MediaUploadJob::processed);
+        QSignalSpy failedSpy(&job, &MediaUploadJob::failed);
+        job.start();
+
+        QVERIFY(processedSpy.wait());
+        QCOMPARE(uploadedSpy.size(), 1);
+        QVERIFY(uploadedSpy.first().first().toJsonObject()["url"_L1].isNull());
+        QCOMPARE(processedSpy.first().first().toJsonObject()["url"_L1].toString(), u"https://example.social/media/7.png"_s);
+        QCOMPARE(failedSpy.size(), 0);
+        QCOMPARE(account.unservedCount(), 0);
+    }
+
+    // It doesn't wait forever for a server that never finishes
+    void testProcessingGivesUp()
+    {
+        NetworkRecording recording;
+        recording.exchanges = {
+            exchange("POST", u"/api/v2/media"_s, 202, attachment(u"8"_s, false)),
+            exchange("GET", u"/api/v1/media/8"_s, 206, attachment(u"8"_s, false)),
+        };
+        ReplayAccount account(recording);
+        account.setTimeScale(0);
+
+        MediaUploadJob job(&account, QLatin1String(DATA_DIR "/test.png"), workingDirectory.path());
+        job.setPolling(1, 1, 3);
+        QSignalSpy processedSpy(&job, &MediaUploadJob::processed);
+        QSignalSpy failedSpy(&job, &MediaUploadJob::failed);
+        job.start();
+
+        QVERIFY(failedSpy.wait());
+        QCOMPARE(failedSpy.first().first().toString(), u"The server took too long to process the media"_s);
+        QCOMPARE(processedSpy.size(), 0);
+    }
+
+    // A video over the instance limit isn't uploaded at all
+    void testVideoSizeLimit()
+    {
+        QJsonObject instance{
+            {u"configuration"_s, QJsonObject{{u"media_attachments"_s, QJsonObject{{u"video_size_limit"_s, 1024}}}}},
+        };
+        NetworkRecording recording;
+        recording.exchanges = {
+            exchange("GET", u"/api/v2/instance"_s, 200, instance),
+            exchange("POST", u"/api/v2/media"_s, 200, attachment(u"9"_s, true)),
+        };
+        ReplayAccount account(recording);
+        account.setTimeScale(0);
+        account.fetchInstanceMetadata();
+        QCOMPARE(account.videoSizeLimit(), qint64(1024));
+
+        const QString fileName = workingDirectory.filePath(u"video.mp4"_s);
+        QFile video(fileName);
+        QVERIFY(video.open(QIODevice::WriteOnly));
+        video.write(QByteArray(4096, 'v'));
+        video.close();
+
+        MediaUploadJob job(&account, fileName, workingDirectory.path());
+        QSignalSpy uploadedSpy(&job, &MediaUploadJob::uploaded);
+        QSignalSpy failedSpy(&job, &MediaUploadJob::failed);
+        job.start();
+
+        QVERIFY(failedSpy.wait());
+        QVERIFY(failedSpy.first().first().toString().startsWith(u"The video is"_s));
+        QCOMPARE(uploadedSpy.size(), 0);
+        // Only the upload is left
+        QCOMPARE(account.unservedCount(), 1);
+    }
+
+private:
+    QTemporaryDir workingDirectory;
+};
+
+QTEST_MAIN(MediaUploadJobTest)
+#include "mediauploadjobtest.moc"
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "utils/metrics.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class MetricsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testCountersAndGauges()
+    {
+        auto &metrics = Metrics::instance();
+
+        metrics.increment(u"test.counter"_s);
+        metrics.increment(u"test.counter"_s, 4);
+        QCOMPARE(metrics.counter(u"test.counter"_s), qint64(5));
+        QCOMPARE(metrics.counter(u"test.missing"_s), qint64(0));
+
+        metrics.addToGauge(u"test.gauge"_s, 3);
+        metrics.addToGauge(u"test.gauge"_s, -1);
+        QCOMPARE(metrics.gauge(u"test.gauge"_s), qint64(2));
+
+        metrics.setSampler(u"test.sampled"_s, [this] {
+            return sampled;
+        });
+        QCOMPARE(metrics.gauge(u"test.sampled"_s), qint64(7));
+        sampled = 8;
+        QCOMPARE(metrics.gauge(u"test.sampled"_s), qint64(8));
+
+        QCOMPARE(metrics.names(u"test."_s), (QStringList{u"test.counter"_s, u"test.gauge"_s, u"test.sampled"_s}));
+    }
+
+    void testHistogram()
+    {
+        auto &metrics = Metrics::instance();
+        QCOMPARE(metrics.percentile(u"test.latency"_s, 50), 0.0);
+
+        for (int i = 1; i <= 100; i++) {
+            metrics.observe(u"test.latency"_s, i);
+        }
+        QCOMPARE(metrics.sampleCount(u"test.latency"_s), qint64(100));
+
+        // Rounded up to the bucket, which is at most a fifth more
+        const double median = metrics.percentile(u"test.latency"_s, 50);
+        QVERIFY(median >= 50 && median <= 60);
+        const double p95 = metrics.percentile(u"test.latency"_s, 95);
+        QVERIFY(p95 >= 95 && p95 <= 100);
+        QCOMPARE(metrics.percentile(u"test.latency"_s, 100), 100.0);
+
+        const auto histogram = metrics.toJson()["histograms"_L1]["test.latency"_L1].toObject();
+        QCOMPARE(histogram["count"_L1].toInteger(), qint64(100));
+        QCOMPARE(histogram["mean"_L1].toDouble(), 50.5);
+        QCOMPARE(histogram["p95"_L1].toDouble(), p95);
+        QCOMPARE(histogram["max"_L1].toDouble(), 100.0);
+    }
+
+    void testWrite()
+    {
+        QTemporaryDir dir;
+        const QString fileName = dir.filePath(u"metrics.json"_s);
+        QVERIFY(Metrics::instance().writeTo(fileName));
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const auto metrics = QJsonDocument::fromJson(file.readAll()).object();
+        QCOMPARE(metrics["counters"_L1]["test.counter"_L1].toInteger(), qint64(5));
+        QCOMPARE(metrics["gauges"_L1]["test.sampled"_L1].toInteger(), qint64(8));
+    }
+
+private:
+    qint64 sampled = 7;
+};
+
+QTEST_MAIN(MetricsTest)
+#include "metricstest.moc"
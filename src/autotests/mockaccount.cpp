@@ -45,7 +45,12 @@ void MockAccount::get(const QUrl &url,
     if (m_getReplies.contains(url)) {
         auto reply = m_getReplies[url];
         reply->open(QIODevice::ReadOnly);
-        callback(reply);
+        if (reply->error() != QNetworkReply::NoError) {
+            if (errorCallback)
+                errorCallback(reply);
+        } else {
+            callback(reply);
+        }
         reply->seek(0);
     } else {
         qWarning() << "Cannot find reply for " << url;
@@ -62,16 +67,21 @@ void MockAccount::post(const QUrl &url,
                        std::function<void(QNetworkReply *)> errorCallback,
                        QHash<QByteArray, QByteArray> headers)
 {
-    Q_UNUSED(doc)
     Q_UNUSED(authenticated)
     Q_UNUSED(parent)
-    Q_UNUSED(errorCallback)
     Q_UNUSED(headers)
 
+    Q_EMIT jsonPosted(url, doc);
+
     if (m_postReplies.contains(url)) {
         auto reply = m_postReplies[url];
         reply->open(QIODevice::ReadOnly);
-        callback(reply);
+        if (reply->error() != QNetworkReply::NoError) {
+            if (errorCallback)
+                errorCallback(reply);
+        } else {
+            callback(reply);
+        }
     }
 }
 
@@ -81,6 +81,12 @@ public:
     Q_INVOKABLE void increaseFollowRequests() override;
     Q_INVOKABLE void decreaseFollowRequests() override;
 
+Q_SIGNALS:
+    /**
+     * @brief Emitted for every JSON POST request, whether a reply is registered for it or not.
+     */
+    void jsonPosted(const QUrl &url, const QJsonDocument &doc);
+
 private:
     void readNotificationFromFile(QLatin1String filename);
 
@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "account/streamingmanager.h"
+#include "autotests/replayaccount.h"
+#include "network/networkrecorder.h"
+#include "timeline/maintimelinemodel.h"
+#include "utils/messagefiltercontainer.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class NetworkRecorderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRecording()
+    {
+        QMessageFilterContainer::self()->insert(u"secret-token"_s, u"ACCESS_TOKEN"_s);
+
+        QTemporaryDir dir;
+        const QString fileName = dir.filePath(u"recording.json"_s);
+        auto &recorder = NetworkRecorder::instance();
+        recorder.start(fileName);
+        QVERIFY(recorder.isRecording());
+
+        const QByteArray body = R"({"token": "secret-token"})";
+        ReplayReply reply(NetworkRecording::Exchange{
+                              .operation = QByteArrayLiteral("GET"),
+                              .url = QUrl(u"https://example.social/api/v1/timelines/home?access_token=secret-token"_s),
+                              .statusCode = 200,
+                              .headers = {{QByteArrayLiteral("Link"), QByteArrayLiteral("<https://example.social/api/v1/timelines/home?max_id=1>; rel=\"next\"")},
+                                          {QByteArrayLiteral("Set-Cookie"), QByteArrayLiteral("session")}},
+                              .body = body,
+                          },
+                          nullptr);
+        recorder.recordReply(&reply, 0);
+
+        // Logging in, before the account registered its token to be filtered
+        ReplayReply tokenReply(NetworkRecording::Exchange{
+                                   .operation = QByteArrayLiteral("POST"),
+                                   .url = QUrl(u"https://example.social/oauth/token?client_secret=unknown-secret&grant_type=authorization_code"_s),
+                                   .statusCode = 200,
+                                   .body = R"({"access_token": "unknown-token", "refresh_token": "unknown-refresh", "token_type": "Bearer"})",
+                               },
+                               nullptr);
+        recorder.recordReply(&tokenReply, 0);
+        recorder.recordStreamingMessage(u"{\"event\": \"delete\", \"payload\": \"1\"}"_s);
+
+        // Whoever the reply is for can still read all of it
+        QCOMPARE(reply.readAll(), body);
+
+        recorder.stop();
+        QVERIFY(!recorder.isRecording());
+
+        const auto recording = NetworkRecording::load(fileName);
+        QVERIFY(recording.has_value());
+        QCOMPARE(recording->exchanges.size(), 2);
+
+        const auto &exchange = recording->exchanges.first();
+        QCOMPARE(exchange.operation, QByteArrayLiteral("GET"));
+        QCOMPARE(exchange.url, QUrl(u"https://example.social/api/v1/timelines/home?access_token=ACCESS_TOKEN"_s));
+        QCOMPARE(exchange.statusCode, 200);
+        QCOMPARE(exchange.body, QByteArray(R"({"token": "ACCESS_TOKEN"})"));
+        QCOMPARE(exchange.headers.size(), 1);
+        QCOMPARE(exchange.headers.first().first, QByteArrayLiteral("Link"));
+
+        const auto &tokenExchange = recording->exchanges.last();
+        QCOMPARE(tokenExchange.url, QUrl(u"https://example.social/oauth/token?client_secret=CLIENT_SECRET&grant_type=authorization_code"_s));
+        const auto tokenBody = QJsonDocument::fromJson(tokenExchange.body).object();
+        QCOMPARE(tokenBody["access_token"_L1].toString(), u"ACCESS_TOKEN"_s);
+        QCOMPARE(tokenBody["refresh_token"_L1].toString(), u"REFRESH_TOKEN"_s);
+        QCOMPARE(tokenBody["token_type"_L1].toString(), u"Bearer"_s);
+        QVERIFY(!tokenExchange.body.contains("unknown"));
+
+        QCOMPARE(recording->frames.size(), 1);
+        QCOMPARE(recording->frames.first().message, u"{\"event\": \"delete\", \"payload\": \"1\"}"_s);
+    }
+
+    void testReplay()
+    {
+        NetworkRecording recording;
+        recording.exchanges = {
+            exchange(u"/api/v1/markers?timeline[]=home"_s, u"markers.json"_s, 10),
+            exchange(u"/api/v1/timelines/home"_s, u"statuses.json"_s, 50),
+        };
+
+        auto status = readJson(u"status.json"_s);
+        status["id"_L1] = u"103270115826049000"_s;
+        const QJsonObject updateMessage{
+            {u"stream"_s, QJsonArray{u"user"_s}},
+            {u"event"_s, u"update"_s},
+            {u"payload"_s, QString::fromUtf8(QJsonDocument(status).toJson())},
+        };
+        const QJsonObject deleteMessage{
+            {u"stream"_s, QJsonArray{u"user"_s}},
+            {u"event"_s, u"delete"_s},
+            {u"payload"_s, u"103270115826049000"_s},
+        };
+        recording.frames = {
+            {.time = 100, .message = QString::fromUtf8(QJsonDocument(updateMessage).toJson())},
+            {.time = 120, .message = QString::fromUtf8(QJsonDocument(deleteMessage).toJson())},
+        };
+
+        AccountManager::instance().setTestMode(true);
+        auto account = new ReplayAccount(recording);
+        AccountManager::instance().addAccount(account);
+        AccountManager::instance().selectAccount(account, false);
+
+        // The replies take as long as they were recorded with
+        MainTimelineModel timelineModel;
+        timelineModel.setName(u"home"_s);
+        QCOMPARE(timelineModel.rowCount({}), 0);
+        QTRY_COMPARE(account->unservedCount(), 0);
+        QTRY_VERIFY(timelineModel.rowCount({}) > 0);
+
+        // The streaming messages too, but twice as fast
+        account->setTimeScale(0.5);
+        QList<AbstractAccount::StreamingEventType> events;
+        QObject context;
+        connect(account->streaming(), &StreamingManager::streamEvent, &context, [&events](const QString &, const AbstractAccount::StreamingEventType eventType) {
+            events.append(eventType);
+        });
+        QSignalSpy replayedSpy(account, &ReplayAccount::streamingReplayed);
+        account->replayStreaming();
+        QCOMPARE(events, QList{AbstractAccount::UpdateEvent});
+        QVERIFY(replayedSpy.wait());
+        QCOMPARE(events, (QList{AbstractAccount::UpdateEvent, AbstractAccount::DeleteEvent}));
+    }
+
+    // Not only GET and POST requests are replayed, and those nothing was recorded for fail
+    void testReplayOtherMethods()
+    {
+        NetworkRecording recording;
+        recording.exchanges = {
+            {.operation = QByteArrayLiteral("PUT"), .url = QUrl(u"https://example.social/api/v1/media/1"_s), .statusCode = 200, .body = "{}"},
+            {.operation = QByteArrayLiteral("DELETE"), .url = QUrl(u"https://example.social/api/v1/statuses/1"_s), .statusCode = 200, .body = "{}"},
+            {.operation = QByteArrayLiteral("POST"), .url = QUrl(u"https://example.social/api/v2/media"_s), .statusCode = 202, .body = R"({"id": "1"})"},
+        };
+        ReplayAccount account(recording);
+        account.setTimeScale(0);
+
+        QStringList replied;
+        account.put(account.apiUrl(u"/api/v1/media/1"_s), QJsonDocument(), true, nullptr, [&replied](QNetworkReply *) {
+            replied.append(u"put"_s);
+        });
+        account.deleteResource(account.apiUrl(u"/api/v1/statuses/1"_s), true, nullptr, [&replied](QNetworkReply *) {
+            replied.append(u"delete"_s);
+        });
+        QCOMPARE(replied, (QStringList{u"put"_s, u"delete"_s}));
+
+        // The reply is returned before it's served, so its signals can be connected to
+        const auto reply = account.upload(QUrl::fromLocalFile(u"/tmp/image.png"_s), [&replied](QNetworkReply *reply) {
+            replied.append(QString::fromUtf8(reply->readAll()));
+        });
+        QVERIFY(reply != nullptr);
+        QSignalSpy finishedSpy(reply, &QNetworkReply::finished);
+        QVERIFY(finishedSpy.wait());
+        QCOMPARE(replied.last(), u"{\"id\": \"1\"}"_s);
+        QCOMPARE(account.unservedCount(), 0);
+
+        int errors = 0;
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(u"Nothing was recorded for.*"_s));
+        account.get(
+            account.apiUrl(u"/api/v1/unknown"_s),
+            true,
+            nullptr,
+            [](QNetworkReply *) {
+                QFAIL("Nothing was recorded for this request");
+            },
+            [&errors](QNetworkReply *reply) {
+                QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 404);
+                errors++;
+            });
+        QCOMPARE(errors, 1);
+    }
+
+private:
+    static QJsonObject readJson(const QString &fileName)
+    {
+        QFile file(QLatin1String(DATA_DIR "/%1").arg(fileName));
+        file.open(QIODevice::ReadOnly);
+        return QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    static NetworkRecording::Exchange exchange(const QString &pathAndQuery, const QString &fileName, const qint64 duration)
+    {
+        QFile file(QLatin1String(DATA_DIR "/%1").arg(fileName));
+        file.open(QIODevice::ReadOnly);
+        return {
+            .operation = QByteArrayLiteral("GET"),
+            .url = QUrl(u"https://example.social"_s + pathAndQuery),
+            .statusCode = 200,
+            .body = file.readAll(),
+            .duration = duration,
+        };
+    }
+};
+
+QTEST_MAIN(NetworkRecorderTest)
+#include "networkrecordertest.moc"
@@ -6,6 +6,7 @@
 #include "account/accountmanager.h"
 #include "autotests/mockaccount.h"
 #include "editor/posteditorbackend.h"
+#include "editor/statustextmetrics.h"
 
 class PostEditorTest : public QObject
 {
@@ -51,6 +52,65 @@ private Q_SLOTS:
         backend.setStatus(twoUrlStatus);
 
         QCOMPARE(backend.charactersLeft(), 477);
+
+        // The content warning counts too
+        backend.setSpoilerText(QStringLiteral("Spoiler"));
+        QCOMPARE(backend.charactersLeft(), 470);
+    }
+
+    void textMetricsTest_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<qsizetype>("length");
+        QTest::addColumn<qsizetype>("tokenCount");
+
+        QTest::addRow("emoji") << QStringLiteral("👍🏽 🇩🇪 é") << qsizetype(5) << qsizetype(0);
+        QTest::addRow("links") << QStringLiteral("https://kde.org and http://tokodon.org/(a). done") << qsizetype(57) << qsizetype(2);
+        QTest::addRow("no protocol") << QStringLiteral("kde.org") << qsizetype(7) << qsizetype(0);
+        QTest::addRow("mention") << QStringLiteral("@alice hi") << qsizetype(9) << qsizetype(1);
+        QTest::addRow("remote mention") << QStringLiteral("@alice@example.social hi") << qsizetype(9) << qsizetype(1);
+        QTest::addRow("email") << QStringLiteral("alice@example.social") << qsizetype(20) << qsizetype(0);
+        QTest::addRow("hashtag") << QStringLiteral("#KDE #1") << qsizetype(7) << qsizetype(1);
+    }
+
+    void textMetricsTest()
+    {
+        QFETCH(QString, text);
+        QFETCH(qsizetype, length);
+        QFETCH(qsizetype, tokenCount);
+
+        StatusTextMetrics metrics;
+        metrics.setText(text);
+        QCOMPARE(metrics.length(23), length);
+        QCOMPARE(metrics.tokens().size(), tokenCount);
+    }
+
+    void textMetricsEditTest()
+    {
+        const QString text = QStringLiteral("Hi @alice@example.social, see https://kde.org/news 👍🏽 #KDE\r\nbye");
+
+        // Typing it, and then deleting it from the middle, gives the same result as counting it all at once every time
+        StatusTextMetrics typed;
+        for (qsizetype i = 1; i <= text.size(); i++) {
+            typed.setText(text.first(i));
+
+            StatusTextMetrics counted;
+            counted.setText(text.first(i));
+            QCOMPARE(typed.length(23), counted.length(23));
+            QCOMPARE(typed.tokens(), counted.tokens());
+        }
+
+        QString edited = text;
+        while (!edited.isEmpty()) {
+            edited.remove(edited.size() / 2, 1);
+            typed.setText(edited);
+
+            StatusTextMetrics counted;
+            counted.setText(edited);
+            QCOMPARE(typed.length(23), counted.length(23));
+            QCOMPARE(typed.tokens(), counted.tokens());
+        }
+        QCOMPARE(typed.length(23), qsizetype(0));
     }
 
 private:
@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "accountmanager.h"
+
+#include <QtTest/QtTest>
+
+#include "account/poststore.h"
+#include "autotests/helperreply.h"
+#include "autotests/mockaccount.h"
+#include "timeline/maintimelinemodel.h"
+#include "timeline/threadmodel.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class PostStoreTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        AccountManager::instance().setTestMode(true);
+        account = new MockAccount();
+        AccountManager::instance().addAccount(account);
+    }
+
+    void testSharing()
+    {
+        const auto store = account->postStore();
+        QObject first;
+        QObject second;
+
+        const auto post = store->acquire(json(u"status.json"_s), &first);
+        QCOMPARE(store->acquire(json(u"status.json"_s), &second), post);
+        QCOMPARE(store->find(u"103270115826048975"_s), post);
+
+        // The post stays around until the last holder lets go of it
+        QPointer<Post> guard(post);
+        PostStore::release(post, &first);
+        QVERIFY(guard);
+        PostStore::release(post, &second);
+        QCOMPARE(store->find(u"103270115826048975"_s), nullptr);
+        QTRY_VERIFY(!guard);
+    }
+
+    void testHolderDestroyed()
+    {
+        const auto store = account->postStore();
+        QPointer<Post> guard;
+        {
+            QObject holder;
+            guard = store->acquire(json(u"status.json"_s), &holder);
+            store->acquire(json(u"status.json"_s), &holder);
+            QVERIFY(guard);
+        }
+        QTRY_VERIFY(!guard);
+    }
+
+    void testBoostsFollow()
+    {
+        const auto store = account->postStore();
+        QObject holder;
+
+        const auto status = json(u"status.json"_s);
+        const auto post = store->acquire(status, &holder);
+        const auto boost = store->acquire(QJsonObject{{u"id"_s, u"1"_s}, {u"account"_s, status["account"_L1]}, {u"reblog"_s, status}}, &holder);
+        QVERIFY(boost != post);
+        QCOMPARE(boost->postId(), post->postId());
+
+        QSignalSpy spy(store, &PostStore::postUpdated);
+
+        // Favoriting the boost favorites the boosted post
+        boost->setFavourited(true);
+        QVERIFY(post->favourited());
+        QCOMPARE(post->favouritesCount(), boost->favouritesCount());
+        QCOMPARE(spy.size(), 2);
+
+        // Edits reach the boost too
+        auto edited = status;
+        edited["content"_L1] = u"<p>EDITED</p>"_s;
+        store->update(QJsonArray{edited});
+        QCOMPARE(boost->content(), u"<p>EDITED</p>"_s);
+        QCOMPARE(boost->originalPostId(), u"1"_s);
+        QVERIFY(boost->boosted());
+    }
+
+    void testModelsShare()
+    {
+        QUrl markersUrl = account->apiUrl(u"/api/v1/markers"_s);
+        markersUrl.setQuery(u"timeline[]=home"_s);
+        account->registerGet(markersUrl, new TestReply(u"markers.json"_s, account));
+        account->registerGet(account->apiUrl(u"/api/v1/timelines/home"_s), new TestReply(u"statuses.json"_s, account));
+        account->registerGet(account->apiUrl(u"/api/v1/statuses/103270115826048975"_s), new TestReply(u"status.json"_s, account));
+        account->registerGet(account->apiUrl(u"/api/v1/statuses/103270115826048975/context"_s), new TestReply(u"context.json"_s, account));
+
+        MainTimelineModel timelineModel;
+        timelineModel.setName(u"home"_s);
+        ThreadModel threadModel;
+        threadModel.setPostId(u"103270115826048975"_s);
+
+        const auto timelineRow = timelineModel.index(2, 0);
+        const auto post = timelineRow.data(AbstractTimelineModel::PostRole).value<Post *>();
+        QCOMPARE(post->postId(), u"103270115826048975"_s);
+
+        const int threadRow = threadModel.getRootIndex();
+        QCOMPARE(threadModel.index(threadRow, 0).data(AbstractTimelineModel::PostRole).value<Post *>(), post);
+
+        // Favoriting the post in the thread refreshes it in the timeline
+        QSignalSpy spy(&timelineModel, &QAbstractItemModel::dataChanged);
+        threadModel.actionFavorite(threadModel.index(threadRow, 0));
+        QCOMPARE(spy.size(), 1);
+        QCOMPARE(spy.first().at(0).toModelIndex(), timelineRow);
+        QVERIFY(timelineRow.data(AbstractTimelineModel::FavouritedRole).toBool());
+
+        // The same status seen by another account is a different post, which doesn't refresh this timeline
+        const auto otherAccount = new MockAccount();
+        AccountManager::instance().addAccount(otherAccount);
+        QObject holder;
+        const auto otherPost = otherAccount->postStore()->acquire(json(u"status.json"_s), &holder);
+        QVERIFY(otherPost != post);
+        otherPost->setBookmarked(true);
+        QCOMPARE(spy.size(), 1);
+        QVERIFY(!timelineRow.data(AbstractTimelineModel::BookmarkedRole).toBool());
+    }
+
+private:
+    QJsonObject json(const QString &fileName) const
+    {
+        QFile file(QLatin1String(DATA_DIR) + u'/' + fileName);
+        file.open(QIODevice::ReadOnly);
+        return QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    MockAccount *account = nullptr;
+};
+
+QTEST_MAIN(PostStoreTest)
+#include "poststoretest.moc"
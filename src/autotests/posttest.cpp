@@ -6,6 +6,7 @@
 #include <QtTest/QtTest>
 
 #include "autotests/mockaccount.h"
+#include "datatypes/statusid.h"
 #include "utils/texthandler.h"
 
 using namespace Qt::Literals::StringLiterals;
@@ -33,6 +34,7 @@ private Q_SLOTS:
 
         QCOMPARE(post.spoilerText(), QStringLiteral("SPOILER"));
         QCOMPARE(post.content(), QStringLiteral("<p>LOREM</p>"));
+        QCOMPARE(post.plainContent(), QStringLiteral("LOREM"));
         QVERIFY(post.card());
         QCOMPARE(post.sensitive(), false);
         QCOMPARE(post.visibility(), Post::Visibility::Public);
@@ -95,6 +97,96 @@ private Q_SLOTS:
         QCOMPARE(post.content(), expectedContent);
     }
 
+    void testUpdateReplacesChildren()
+    {
+        MockAccount account;
+
+        QFile statusExampleApi;
+        statusExampleApi.setFileName(QLatin1String(DATA_DIR "/status.json"));
+        statusExampleApi.open(QIODevice::ReadOnly);
+
+        auto status = QJsonDocument::fromJson(statusExampleApi.readAll()).object();
+        const auto attachment = [](const QString &id, const QString &description) {
+            return QJsonObject{{u"id"_s, id}, {u"type"_s, u"image"_s}, {u"description"_s, description}};
+        };
+        status["media_attachments"_L1] = QJsonArray{attachment(u"1"_s, u"A cat"_s), attachment(u"2"_s, u"A dog"_s)};
+        auto quotedStatus = status;
+        quotedStatus["id"_L1] = u"1"_s;
+        status["quote"_L1] = QJsonObject{{u"quoted_status"_s, quotedStatus}};
+
+        Post post(&account, status);
+        QVERIFY(post.card());
+        QCOMPARE(post.attachments().size(), 2);
+        QVERIFY(post.quotedPost());
+
+        QSignalSpy quotedPostSpy(&post, &Post::quotedPostChanged);
+        QSignalSpy pollSpy(&post, &Post::pollChanged);
+
+        // Nothing changed, so the views keep the same objects
+        const auto attachments = post.attachments();
+        const QPointer<Post> quotedPost = post.quotedPost();
+        post.update(status);
+        QCOMPARE(post.attachments(), attachments);
+        QCOMPARE(post.quotedPost(), quotedPost.data());
+        QCOMPARE(quotedPostSpy.count(), 0);
+
+        // An edit that changed a description and removed the card, while the quote changed
+        status["media_attachments"_L1] = QJsonArray{attachment(u"1"_s, u"A cat"_s), attachment(u"2"_s, u"Two dogs"_s)};
+        status.remove("card"_L1);
+        quotedStatus["id"_L1] = u"2"_s;
+        status["quote"_L1] = QJsonObject{{u"quoted_status"_s, quotedStatus}};
+        post.update(status);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+        QVERIFY(!post.card());
+        QCOMPARE(post.attachments().size(), 2);
+        QCOMPARE(post.attachments()[1]->description(), u"Two dogs"_s);
+        QCOMPARE(post.findChildren<Attachment *>(Qt::FindDirectChildrenOnly).size(), 2);
+        QCOMPARE(quotedPostSpy.count(), 1);
+        QVERIFY(quotedPost.isNull());
+        QCOMPARE(post.quotedPost()->postId(), u"2"_s);
+        QCOMPARE(post.findChildren<Post *>(Qt::FindDirectChildrenOnly).size(), 1);
+        QCOMPARE(pollSpy.count(), 0);
+
+        // The poll goes away too when an edit removes it
+        QFile pollStatusFile(QLatin1String(DATA_DIR "/status-poll.json"));
+        pollStatusFile.open(QIODevice::ReadOnly);
+        status["poll"_L1] = QJsonDocument::fromJson(pollStatusFile.readAll())["poll"_L1];
+        post.update(status);
+        QVERIFY(post.poll());
+        status["poll"_L1] = QJsonValue(QJsonValue::Null);
+        post.update(status);
+        QVERIFY(!post.poll());
+        QCOMPARE(pollSpy.count(), 2);
+    }
+
+    void testStatusId()
+    {
+        const StatusId snowflake(u"103270115826048975"_s);
+        QVERIFY(snowflake.isNumeric());
+        QCOMPARE(snowflake.toString(), u"103270115826048975"_s);
+        QCOMPARE(snowflake, StatusId(u"103270115826048975"_s));
+        QVERIFY(snowflake != StatusId(u"103270115826048976"_s));
+
+        // Ids that wouldn't survive the round trip through a number are kept as they are
+        for (const auto &id : {u"9zz6qFz6Mjd4aGRsjo"_s, u"0123"_s, u"0"_s, u"18446744073709551616"_s}) {
+            const StatusId fallback(id);
+            QVERIFY(!fallback.isNumeric());
+            QCOMPARE(fallback.toString(), id);
+        }
+
+        QVERIFY(StatusId().isEmpty());
+        QVERIFY(StatusId(QString()).isEmpty());
+        QVERIFY(!snowflake.isEmpty());
+
+        // Newer ids are greater, even when they got longer, which comparing them as strings gets wrong
+        QVERIFY(StatusId(u"103270115826048976"_s) > snowflake);
+        QVERIFY(StatusId(u"99999999999999999"_s) < snowflake);
+        QVERIFY(u"99999999999999999"_s > snowflake.toString());
+        QVERIFY(StatusId(u"9zz6qFz6Mjd4aGRsjo"_s) < StatusId(u"9zz6qFz6Mjd4aGRsjp"_s));
+        QVERIFY(StatusId(u"9zz6qFz6Mjd4aGRsjo"_s) < StatusId(u"A000000000000000000"_s));
+    }
+
     // Normal case
     void testContentParsing()
     {
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "account/profileloader.h"
+#include "autotests/helperreply.h"
+#include "autotests/mockaccount.h"
+
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+
+class ProfileLoaderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        account = new MockAccount(this);
+
+        account->registerGet(account->apiUrl(QStringLiteral("/api/v1/accounts/1")), new TestReply(QStringLiteral("verify_credentials.json"), account));
+        account->registerGet(statusesUrl(), new TestReply(QStringLiteral("statuses.json"), account));
+        account->registerGet(account->apiUrl(QStringLiteral("/api/v1/accounts/1/featured_tags")),
+                             new TestReply(QStringLiteral("featured_tags.json"), account));
+
+        QUrl url = account->apiUrl(QStringLiteral("/api/v1/accounts/relationships"));
+        url.setQuery(QUrlQuery{{QStringLiteral("id[]"), QStringLiteral("1")}});
+        account->registerGet(url, new TestReply(QStringLiteral("relationships.json"), account));
+
+        url = account->apiUrl(QStringLiteral("/api/v1/accounts/familiar_followers"));
+        url.setQuery(QUrlQuery{{QStringLiteral("id"), QStringLiteral("1")}});
+        account->registerGet(url, new TestReply(QStringLiteral("socialgraphmodel_follows.json"), account));
+    }
+
+    void testLoad()
+    {
+        ProfileLoader loader(account);
+        QSignalSpy partSpy(&loader, &ProfileLoader::partLoaded);
+        QSignalSpy failedSpy(&loader, &ProfileLoader::partFailed);
+        QSignalSpy loadedSpy(&loader, &ProfileLoader::loaded);
+
+        loader.load(QStringLiteral("1"), statusesUrl(), {});
+
+        QCOMPARE(partSpy.count(), 5);
+        QCOMPARE(failedSpy.count(), 0);
+        QCOMPARE(loadedSpy.count(), 1);
+        QCOMPARE(loadedSpy.first().first().toString(), QStringLiteral("1"));
+
+        QVERIFY(loader.cached(QStringLiteral("1"), ProfileLoader::FeaturedTagsPart).has_value());
+
+        // Relationships and posts are never served from the cache
+        QVERIFY(!loader.cached(QStringLiteral("1"), ProfileLoader::RelationshipPart).has_value());
+        QVERIFY(!loader.cached(QStringLiteral("1"), ProfileLoader::StatusesPart).has_value());
+
+        // Requesting a cached part emits it right away
+        partSpy.clear();
+        loader.request(QStringLiteral("1"), ProfileLoader::FeaturedTagsPart);
+        QCOMPARE(partSpy.count(), 1);
+        QCOMPARE(partSpy.first().at(1).value<ProfileLoader::Part>(), ProfileLoader::FeaturedTagsPart);
+    }
+
+    void testFailure()
+    {
+        ProfileLoader loader(account);
+        QSignalSpy failedSpy(&loader, &ProfileLoader::partFailed);
+        QSignalSpy loadedSpy(&loader, &ProfileLoader::loaded);
+
+        // Nothing is registered for the pinned posts, the rest of the page still finishes loading
+        QUrl pinnedUrl = account->apiUrl(QStringLiteral("/api/v1/accounts/1/statuses"));
+        pinnedUrl.setQuery(QUrlQuery{{QStringLiteral("pinned"), QStringLiteral("true")}});
+        loader.load(QStringLiteral("1"), statusesUrl(), pinnedUrl);
+
+        QCOMPARE(failedSpy.count(), 1);
+        QCOMPARE(failedSpy.first().at(1).value<ProfileLoader::Part>(), ProfileLoader::PinnedPart);
+        QCOMPARE(loadedSpy.count(), 1);
+    }
+
+private:
+    QUrl statusesUrl() const
+    {
+        QUrl url = account->apiUrl(QStringLiteral("/api/v1/accounts/1/statuses"));
+        url.setQuery(QUrlQuery{{QStringLiteral("exclude_direct"), QStringLiteral("true")}});
+        return url;
+    }
+
+    MockAccount *account = nullptr;
+};
+
+QTEST_MAIN(ProfileLoaderTest)
+#include "profileloadertest.moc"
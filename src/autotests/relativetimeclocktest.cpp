@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include <QStandardItemModel>
+
+#include "utils/relativetimeclock.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class RelativeTimeClockTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFormat()
+    {
+        const QDateTime now = QDateTime::currentDateTime();
+        auto &clock = RelativeTimeClock::instance();
+
+        QCOMPARE(clock.format(now.addSecs(5), now), u"in the future"_s);
+        QCOMPARE(clock.format(now.addSecs(-5), now), u"5s"_s);
+        QCOMPARE(clock.format(now.addSecs(-90), now), u"1m"_s);
+        QCOMPARE(clock.format(now.addSecs(-2 * 60 * 60 - 5), now), u"2h"_s);
+        QCOMPARE(clock.formatDate(now.date(), now.date()), u"Today"_s);
+        QCOMPARE(clock.formatDate(now.date().addDays(-3), now.date()), u"3d"_s);
+    }
+
+    void testNextChange_data()
+    {
+        QTest::addColumn<qint64>("age");
+        QTest::addColumn<qint64>("changesAt");
+
+        QTest::addRow("future") << qint64(-5) << qint64(0);
+        QTest::addRow("seconds") << qint64(5) << qint64(6);
+        QTest::addRow("minutes") << qint64(90) << qint64(120);
+        QTest::addRow("hours") << qint64(2 * 60 * 60 + 5) << qint64(3 * 60 * 60);
+    }
+
+    void testNextChange()
+    {
+        QFETCH(qint64, age);
+        QFETCH(qint64, changesAt);
+
+        const QDateTime now = QDateTime::currentDateTime();
+        const QDateTime dateTime = now.addSecs(-age);
+
+        QCOMPARE(RelativeTimeClock::nextChange(dateTime, now), dateTime.addSecs(changesAt));
+    }
+
+    void testNextChangeDays()
+    {
+        const QDateTime now = QDateTime::currentDateTime();
+        const QDateTime midnight = now.date().addDays(1).startOfDay();
+
+        QCOMPARE(RelativeTimeClock::nextChange(now.addDays(-3), now), midnight);
+        QCOMPARE(RelativeTimeClock::nextChange(now.addSecs(-5), now, RelativeTimeClock::Date), midnight);
+    }
+
+    void testTracking()
+    {
+        static constexpr int timeRole = Qt::UserRole;
+        static constexpr int labelRole = Qt::UserRole + 1;
+
+        auto &clock = RelativeTimeClock::instance();
+        QDateTime now = QDateTime::currentDateTime();
+        clock.setTimeSource([&now] {
+            return now;
+        });
+
+        QStandardItemModel model;
+        for (const qint64 age : {3 * 60 * 60, 2, 90}) {
+            auto item = new QStandardItem;
+            item->setData(now.addSecs(-age), timeRole);
+            model.appendRow(item);
+        }
+
+        QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+        clock.track(&model, labelRole, [](const QModelIndex &index) {
+            return index.data(timeRole).toDateTime();
+        });
+
+        clock.update();
+        QCOMPARE(spy.count(), 0);
+        QCOMPARE(clock.nextUpdate(), now.addSecs(1));
+
+        // Only the recent row changes within the next second
+        now = now.addSecs(1);
+        clock.update();
+        QCOMPARE(spy.count(), 1);
+        auto arguments = spy.takeFirst();
+        QCOMPARE(arguments[0].toModelIndex().row(), 1);
+        QCOMPARE(arguments[1].toModelIndex().row(), 1);
+        QCOMPARE(arguments[2].value<QList<int>>(), QList<int>{labelRole});
+
+        // The row that goes from 1m to 2m is merged with it
+        now = now.addSecs(30);
+        clock.update();
+        QCOMPARE(spy.count(), 1);
+        arguments = spy.takeFirst();
+        QCOMPARE(arguments[0].toModelIndex().row(), 1);
+        QCOMPARE(arguments[1].toModelIndex().row(), 2);
+
+        // Rows inserted later are picked up, and the rows after them are updated at their new position
+        auto item = new QStandardItem;
+        item->setData(now.addSecs(-10), timeRole);
+        model.insertRow(0, item);
+        now = now.addSecs(1);
+        clock.update();
+        QCOMPARE(spy.count(), 2);
+        arguments = spy.takeFirst();
+        QCOMPARE(arguments[0].toModelIndex().row(), 0);
+        QCOMPARE(arguments[1].toModelIndex().row(), 0);
+        arguments = spy.takeFirst();
+        QCOMPARE(arguments[0].toModelIndex().row(), 2);
+        QCOMPARE(arguments[1].toModelIndex().row(), 2);
+
+        // Every row is updated when the labels are translated again
+        QEvent languageChange(QEvent::LanguageChange);
+        QCoreApplication::sendEvent(QCoreApplication::instance(), &languageChange);
+        QCOMPARE(spy.count(), 1);
+        arguments = spy.takeFirst();
+        QCOMPARE(arguments[0].toModelIndex().row(), 0);
+        QCOMPARE(arguments[1].toModelIndex().row(), 3);
+
+        clock.setTimeSource({});
+    }
+};
+
+QTEST_MAIN(RelativeTimeClockTest)
+#include "relativetimeclocktest.moc"
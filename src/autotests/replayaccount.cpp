@@ -0,0 +1,282 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "autotests/replayaccount.h"
+
+#include "account/streamingmanager.h"
+
+#include <QHttpMultiPart>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <cmath>
+
+static const QHash<QByteArray, QNetworkAccessManager::Operation> operations = {
+    {QByteArrayLiteral("HEAD"), QNetworkAccessManager::HeadOperation},
+    {QByteArrayLiteral("GET"), QNetworkAccessManager::GetOperation},
+    {QByteArrayLiteral("PUT"), QNetworkAccessManager::PutOperation},
+    {QByteArrayLiteral("POST"), QNetworkAccessManager::PostOperation},
+    {QByteArrayLiteral("DELETE"), QNetworkAccessManager::DeleteOperation},
+};
+
+using namespace Qt::Literals::StringLiterals;
+
+ReplayReply::ReplayReply(const NetworkRecording::Exchange &exchange, QObject *parent)
+    : QNetworkReply(parent)
+{
+    QNetworkRequest request(exchange.url);
+    request.setAttribute(QNetworkRequest::CustomVerbAttribute, exchange.operation);
+    setRequest(request);
+    setOperation(operations.value(exchange.operation, QNetworkAccessManager::CustomOperation));
+    setUrl(exchange.url);
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, exchange.statusCode);
+    for (const auto &[name, value] : exchange.headers) {
+        setRawHeader(name, value);
+    }
+    if (exchange.statusCode >= 400) {
+        setError(QNetworkReply::ProtocolFailure, QStringLiteral("HTTP %1").arg(exchange.statusCode));
+    }
+
+    m_body.setData(exchange.body);
+    m_body.open(QIODevice::ReadOnly);
+    open(QIODevice::ReadOnly);
+    setFinished(true);
+}
+
+qint64 ReplayReply::bytesAvailable() const
+{
+    return m_body.bytesAvailable() + QNetworkReply::bytesAvailable();
+}
+
+qint64 ReplayReply::readData(char *data, const qint64 maxSize)
+{
+    return m_body.read(data, maxSize);
+}
+
+bool ReplayReply::seek(const qint64 pos)
+{
+    return QNetworkReply::seek(pos) && m_body.seek(pos);
+}
+
+void ReplayReply::abort()
+{
+}
+
+ReplayAccount::ReplayAccount(const NetworkRecording &recording, QObject *parent)
+    : MockAccount(parent)
+    , m_recording(recording)
+    , m_served(recording.exchanges.size(), false)
+{
+}
+
+void ReplayAccount::setTimeScale(const double timeScale)
+{
+    m_timeScale = timeScale;
+}
+
+void ReplayAccount::replayStreaming()
+{
+    receiveFrame(0);
+}
+
+qsizetype ReplayAccount::unservedCount() const
+{
+    return m_served.count(false);
+}
+
+void ReplayAccount::get(const QUrl &url,
+                        bool authenticated,
+                        QObject *parent,
+                        std::function<void(QNetworkReply *)> callback,
+                        std::function<void(QNetworkReply *)> errorCallback,
+                        bool fallible)
+{
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+
+    serve(QByteArrayLiteral("GET"), url, std::move(callback), std::move(errorCallback), fallible);
+}
+
+void ReplayAccount::post(const QUrl &url,
+                         const QJsonDocument &doc,
+                         bool authenticated,
+                         QObject *parent,
+                         std::function<void(QNetworkReply *)> callback,
+                         std::function<void(QNetworkReply *)> errorCallback,
+                         QHash<QByteArray, QByteArray> headers)
+{
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+    Q_UNUSED(headers)
+
+    Q_EMIT jsonPosted(url, doc);
+    serve(QByteArrayLiteral("POST"), url, std::move(callback), std::move(errorCallback), false);
+}
+
+void ReplayAccount::post(const QUrl &url,
+                         const QUrlQuery &formdata,
+                         bool authenticated,
+                         QObject *parent,
+                         std::function<void(QNetworkReply *)> callback,
+                         std::function<void(QNetworkReply *)> errorCallback)
+{
+    Q_UNUSED(formdata)
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+
+    serve(QByteArrayLiteral("POST"), url, std::move(callback), std::move(errorCallback), false);
+}
+
+QNetworkReply *ReplayAccount::post(const QUrl &url, QHttpMultiPart *message, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback)
+{
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+
+    const auto reply = serve(QByteArrayLiteral("POST"), url, std::move(callback), nullptr, false, true);
+    // Like QNetworkAccessManager, the message has to live as long as the reply
+    message->setParent(reply);
+    return reply;
+}
+
+void ReplayAccount::put(const QUrl &url, const QJsonDocument &doc, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback)
+{
+    Q_UNUSED(doc)
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+
+    serve(QByteArrayLiteral("PUT"), url, std::move(callback), nullptr, false);
+}
+
+void ReplayAccount::put(const QUrl &url, const QUrlQuery &doc, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback)
+{
+    Q_UNUSED(doc)
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+
+    serve(QByteArrayLiteral("PUT"), url, std::move(callback), nullptr, false);
+}
+
+void ReplayAccount::patch(const QUrl &url, QHttpMultiPart *multiPart, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback)
+{
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+
+    const auto reply = serve(QByteArrayLiteral("PATCH"), url, std::move(callback), nullptr, false);
+    multiPart->setParent(reply);
+}
+
+void ReplayAccount::deleteResource(const QUrl &url, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback)
+{
+    Q_UNUSED(authenticated)
+    Q_UNUSED(parent)
+
+    serve(QByteArrayLiteral("DELETE"), url, std::move(callback), nullptr, false);
+}
+
+QNetworkReply *ReplayAccount::upload(const QUrl &filename, std::function<void(QNetworkReply *)> callback)
+{
+    Q_UNUSED(filename)
+
+    return serve(QByteArrayLiteral("POST"), apiUrl(u"/api/v2/media"_s), std::move(callback), nullptr, false, true);
+}
+
+void ReplayAccount::requestRemoteObject(const QUrl &url, QObject *parent, std::function<void(QNetworkReply *)> callback)
+{
+    Q_UNUSED(parent)
+
+    // The same search Account makes
+    auto searchUrl = apiUrl(u"/api/v2/search"_s);
+    searchUrl.setQuery({
+        {u"q"_s, url.toString()},
+        {u"resolve"_s, u"true"_s},
+        {u"limit"_s, u"1"_s},
+    });
+    serve(QByteArrayLiteral("GET"), searchUrl, std::move(callback), nullptr, false);
+}
+
+const NetworkRecording::Exchange *ReplayAccount::takeExchange(const QByteArray &operation, const QUrl &url)
+{
+    const auto matches = [&operation, &url](const NetworkRecording::Exchange &exchange, const bool matchQuery) {
+        return exchange.operation == operation && exchange.url.path() == url.path() && (!matchQuery || exchange.url.query() == url.query());
+    };
+
+    for (const bool matchQuery : {true, false}) {
+        qsizetype lastMatch = -1;
+        for (qsizetype i = 0; i < m_recording.exchanges.size(); i++) {
+            if (!matches(m_recording.exchanges[i], matchQuery)) {
+                continue;
+            }
+            if (!m_served[i]) {
+                m_served[i] = true;
+                return &m_recording.exchanges[i];
+            }
+            lastMatch = i;
+        }
+        if (lastMatch != -1) {
+            return &m_recording.exchanges[lastMatch];
+        }
+    }
+    return nullptr;
+}
+
+ReplayReply *ReplayAccount::serve(const QByteArray &operation,
+                                  const QUrl &url,
+                                  std::function<void(QNetworkReply *)> callback,
+                                  std::function<void(QNetworkReply *)> errorCallback,
+                                  const bool fallible,
+                                  const bool returnsReply)
+{
+    const auto recorded = takeExchange(operation, url);
+    if (recorded == nullptr) {
+        qWarning() << "Nothing was recorded for" << operation << url;
+    }
+    const NetworkRecording::Exchange exchange = recorded != nullptr
+        ? *recorded
+        : NetworkRecording::Exchange{.operation = operation, .url = url, .statusCode = 404, .body = QByteArrayLiteral(R"({"error":"Nothing was recorded"})")};
+
+    const auto reply = new ReplayReply(exchange, this);
+    const auto deliver = [reply, callback, errorCallback, fallible, statusCode = exchange.statusCode] {
+        if ((statusCode < 200 || statusCode >= 300) && !fallible) {
+            if (errorCallback) {
+                errorCallback(reply);
+            }
+        } else if (callback) {
+            callback(reply);
+        }
+        // Last, like for a real reply whose callbacks are connected first
+        Q_EMIT reply->finished();
+        reply->deleteLater();
+    };
+
+    if (m_timeScale == 0 && !returnsReply) {
+        deliver();
+    } else {
+        QTimer::singleShot(scaled(exchange.duration), reply, deliver);
+    }
+    return reply;
+}
+
+void ReplayAccount::receiveFrame(qsizetype index)
+{
+    for (; index < m_recording.frames.size(); index++) {
+        streaming()->handleMessage(m_recording.frames[index].message);
+
+        const qsizetype next = index + 1;
+        if (m_timeScale != 0 && next < m_recording.frames.size()) {
+            const qint64 gap = m_recording.frames[next].time - m_recording.frames[index].time;
+            QTimer::singleShot(scaled(gap), this, [this, next] {
+                receiveFrame(next);
+            });
+            return;
+        }
+    }
+
+    Q_EMIT streamingReplayed();
+}
+
+int ReplayAccount::scaled(const qint64 milliseconds) const
+{
+    return static_cast<int>(std::max<qint64>(0, std::llround(milliseconds * m_timeScale)));
+}
+
+#include "moc_replayaccount.cpp"
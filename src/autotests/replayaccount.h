@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "autotests/mockaccount.h"
+#include "network/networkrecorder.h"
+
+#include <QBuffer>
+#include <QNetworkReply>
+
+/**
+ * @brief A finished reply to a recorded request.
+ */
+class ReplayReply : public QNetworkReply
+{
+public:
+    ReplayReply(const NetworkRecording::Exchange &exchange, QObject *parent);
+
+    qint64 bytesAvailable() const override;
+    qint64 readData(char *data, qint64 maxSize) override;
+    bool seek(qint64 pos) override;
+    void abort() override;
+
+private:
+    QBuffer m_body;
+};
+
+/**
+ * @brief Serves a session recorded with NetworkRecorder, so models can be tested and benchmarked against real traffic offline.
+ *
+ * Requests are answered with the recorded reply with the same method and URL, ignoring the host. If there's no reply with the same
+ * query, like when a page is fetched with a different max_id, one for the same path is used. Each reply is served once in the order
+ * they were recorded, the last one again once they were all served.
+ *
+ * Every kind of request is replayed. One nothing was recorded for is warned about and answered with 404 Not Found, so it doesn't go
+ * unnoticed.
+ */
+class ReplayAccount : public MockAccount
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayAccount(const NetworkRecording &recording, QObject *parent = nullptr);
+
+    /**
+     * @brief Scales the time the replies take: 1 is as long as they were recorded with, 0.5 twice as fast. With 0 they're served
+     * right away, before the request returns, like MockAccount does. Except for the requests returning their reply, like upload(),
+     * which are served as soon as the event loop runs so the reply can be connected to first.
+     */
+    void setTimeScale(double timeScale);
+
+    /**
+     * @brief Receives the recorded streaming messages with their original timing, scaled like the replies.
+     */
+    void replayStreaming();
+
+    /**
+     * @return How many recorded replies weren't served yet.
+     */
+    [[nodiscard]] qsizetype unservedCount() const;
+
+    void get(const QUrl &url,
+             bool authenticated,
+             QObject *parent,
+             std::function<void(QNetworkReply *)> callback,
+             std::function<void(QNetworkReply *)> errorCallback = nullptr,
+             bool fallible = false) override;
+
+    void post(const QUrl &url,
+              const QJsonDocument &doc,
+              bool authenticated,
+              QObject *parent,
+              std::function<void(QNetworkReply *)> callback,
+              std::function<void(QNetworkReply *)> errorCallback,
+              QHash<QByteArray, QByteArray> headers = {}) override;
+
+    void post(const QUrl &url,
+              const QUrlQuery &formdata,
+              bool authenticated,
+              QObject *parent,
+              std::function<void(QNetworkReply *)> callback,
+              std::function<void(QNetworkReply *)> errorCallback = nullptr) override;
+
+    QNetworkReply *post(const QUrl &url, QHttpMultiPart *message, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback) override;
+
+    void put(const QUrl &url, const QJsonDocument &doc, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback) override;
+    void put(const QUrl &url, const QUrlQuery &doc, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback) override;
+
+    void patch(const QUrl &url, QHttpMultiPart *multiPart, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback) override;
+
+    void deleteResource(const QUrl &url, bool authenticated, QObject *parent, std::function<void(QNetworkReply *)> callback) override;
+
+    QNetworkReply *upload(const QUrl &filename, std::function<void(QNetworkReply *)> callback) override;
+
+    void requestRemoteObject(const QUrl &url, QObject *parent, std::function<void(QNetworkReply *)> callback) override;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted once every recorded streaming message was received.
+     */
+    void streamingReplayed();
+
+private:
+    [[nodiscard]] const NetworkRecording::Exchange *takeExchange(const QByteArray &operation, const QUrl &url);
+    ReplayReply *serve(const QByteArray &operation,
+                       const QUrl &url,
+                       std::function<void(QNetworkReply *)> callback,
+                       std::function<void(QNetworkReply *)> errorCallback,
+                       bool fallible,
+                       bool returnsReply = false);
+    void receiveFrame(qsizetype index);
+    [[nodiscard]] int scaled(qint64 milliseconds) const;
+
+    NetworkRecording m_recording;
+    QList<bool> m_served;
+    double m_timeScale = 1.0;
+};
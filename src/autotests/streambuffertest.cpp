@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "accountmanager.h"
+
+#include <QtTest/QtTest>
+
+#include "account/poststore.h"
+#include "autotests/mockaccount.h"
+#include "datatypes/post.h"
+#include "timeline/streambuffer.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class StreamBufferTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        AccountManager::instance().setTestMode(true);
+        account = new MockAccount(this);
+    }
+
+    void testBatching()
+    {
+        StreamBuffer buffer;
+        QSignalSpy spy(&buffer, &StreamBuffer::flushed);
+        QSignalSpy droppedSpy(&buffer, &StreamBuffer::dropped);
+
+        buffer.add(post(u"status.json"_s));
+        buffer.add(post(u"status-poll.json"_s));
+        buffer.add(post(u"status.json"_s));
+
+        // Everything added during the same frame is flushed at once, newest first and without duplicates
+        QVERIFY(spy.wait());
+        QCOMPARE(spy.size(), 1);
+        const auto posts = spy.first().first().value<QList<Post *>>();
+        QCOMPARE(posts.size(), 2);
+        QCOMPARE(posts[0]->postId(), u"103270115826048975"_s);
+        QCOMPARE(posts[1]->postId(), u"100000"_s);
+        QCOMPARE(droppedSpy.size(), 1);
+    }
+
+    void testDeleted()
+    {
+        StreamBuffer buffer;
+        QSignalSpy spy(&buffer, &StreamBuffer::flushed);
+        QSignalSpy droppedSpy(&buffer, &StreamBuffer::dropped);
+
+        buffer.add(post(u"status.json"_s));
+        buffer.remove(StatusId(u"103270115826048975"_s));
+        QVERIFY(buffer.isDeleted(StatusId(u"103270115826048975"_s)));
+
+        // Streaming the post again, like a backfill would, doesn't bring it back
+        buffer.add(post(u"status.json"_s));
+        QVERIFY(!spy.wait(100));
+        QCOMPARE(droppedSpy.size(), 2);
+    }
+
+    void testDeferred()
+    {
+        StreamBuffer buffer;
+        buffer.setDeferred(true);
+        QSignalSpy flushedSpy(&buffer, &StreamBuffer::flushed);
+        QSignalSpy heldSpy(&buffer, &StreamBuffer::heldCountChanged);
+
+        buffer.add(post(u"status.json"_s));
+        buffer.add(post(u"status-poll.json"_s));
+        QVERIFY(heldSpy.wait());
+        QCOMPARE(buffer.heldCount(), 2);
+        QVERIFY(flushedSpy.isEmpty());
+
+        buffer.remove(StatusId(u"100000"_s));
+        QCOMPARE(buffer.heldCount(), 1);
+
+        buffer.release();
+        QCOMPARE(buffer.heldCount(), 0);
+        QCOMPARE(flushedSpy.size(), 1);
+        const auto posts = flushedSpy.first().first().value<QList<Post *>>();
+        QCOMPARE(posts.size(), 1);
+        QCOMPARE(posts[0]->postId(), u"103270115826048975"_s);
+    }
+
+    void testHeldLimit()
+    {
+        StreamBuffer buffer;
+        buffer.setDeferred(true);
+        QSignalSpy heldSpy(&buffer, &StreamBuffer::heldCountChanged);
+        QSignalSpy droppedSpy(&buffer, &StreamBuffer::dropped);
+
+        auto status = json(u"status.json"_s);
+        for (int i = 1; i <= 1005; i++) {
+            status[u"id"_s] = QString::number(i);
+            buffer.add(account->postStore()->acquire(status, this));
+        }
+        QVERIFY(heldSpy.wait());
+        QCOMPARE(heldSpy.size(), 1);
+
+        // Only the newest posts are held back
+        QCOMPARE(buffer.heldCount(), 1000);
+        QCOMPARE(droppedSpy.size(), 5);
+        QCOMPARE(droppedSpy.first().first().value<Post *>()->postId(), u"1"_s);
+
+        // Streaming a held post again doesn't count it twice
+        status[u"id"_s] = u"1000"_s;
+        buffer.add(account->postStore()->acquire(status, this));
+        QVERIFY(!heldSpy.wait(100));
+        QCOMPARE(buffer.heldCount(), 1000);
+
+        QSignalSpy flushedSpy(&buffer, &StreamBuffer::flushed);
+        buffer.release();
+        const auto posts = flushedSpy.first().first().value<QList<Post *>>();
+        QCOMPARE(posts.size(), 1000);
+        QCOMPARE(posts.first()->postId(), u"1000"_s);
+        QCOMPARE(posts.last()->postId(), u"6"_s);
+    }
+
+private:
+    QJsonObject json(const QString &fileName) const
+    {
+        QFile file(QLatin1String(DATA_DIR) + u'/' + fileName);
+        file.open(QIODevice::ReadOnly);
+        return QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    Post *post(const QString &fileName)
+    {
+        return account->postStore()->acquire(json(fileName), this);
+    }
+
+    MockAccount *account = nullptr;
+};
+
+QTEST_MAIN(StreamBufferTest)
+#include "streambuffertest.moc"
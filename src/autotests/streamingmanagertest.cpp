@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "account/streamingmanager.h"
+#include "autotests/helperreply.h"
+#include "autotests/mockaccount.h"
+
+#include <QtTest/QtTest>
+
+using namespace Qt::Literals::StringLiterals;
+
+struct StreamedEvent {
+    QString stream;
+    AbstractAccount::StreamingEventType eventType;
+    QString id;
+};
+
+class StreamingManagerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        account = new MockAccount(this);
+    }
+
+    void testSubscriptions()
+    {
+        StreamingManager manager(account);
+
+        manager.subscribe(u"hashtag"_s, u"KDE"_s);
+        manager.subscribe(u"hashtag"_s, u"kde"_s);
+        QVERIFY(manager.isSubscribed(u"hashtag"_s, u"Kde"_s));
+
+        // Still used by the other subscriber
+        manager.unsubscribe(u"hashtag"_s, u"KDE"_s);
+        QVERIFY(manager.isSubscribed(u"hashtag"_s, u"KDE"_s));
+
+        manager.unsubscribe(u"hashtag"_s, u"kde"_s);
+        QVERIFY(!manager.isSubscribed(u"hashtag"_s, u"KDE"_s));
+
+        // Unbalanced calls are ignored
+        manager.unsubscribe(u"hashtag"_s, u"kde"_s);
+        QVERIFY(!manager.isSubscribed(u"hashtag"_s, u"KDE"_s));
+    }
+
+    void testStreamKey()
+    {
+        QCOMPARE(StreamingManager::streamKey(u"user"_s), u"user"_s);
+        QCOMPARE(StreamingManager::streamKey(u"public:local"_s), u"public:local"_s);
+        QCOMPARE(StreamingManager::streamKey(u"list"_s, u"42"_s), u"list:42"_s);
+        QCOMPARE(StreamingManager::streamKey(u"hashtag"_s, u"KDE"_s), u"hashtag:kde"_s);
+        QCOMPARE(StreamingManager::streamKey(u"hashtag:local"_s, u"KDE"_s), u"hashtag:local:kde"_s);
+    }
+
+    void testMessages()
+    {
+        StreamingManager manager(account);
+        const auto events = collect(manager);
+
+        manager.handleMessage(u"{\"stream\":[\"list\",\"42\"],\"event\":\"update\",\"payload\":\"{\\\"id\\\":\\\"5\\\"}\"}"_s);
+        manager.handleMessage(u"{\"stream\":[\"hashtag\",\"KDE\"],\"event\":\"delete\",\"payload\":\"6\"}"_s);
+
+        // Messages that aren't events, like errors, are ignored
+        manager.handleMessage(u"{\"error\":\"Missing access token\"}"_s);
+
+        QCOMPARE(events->size(), 2);
+        QCOMPARE(events->at(0).stream, u"list:42"_s);
+        QCOMPARE(events->at(0).eventType, AbstractAccount::UpdateEvent);
+        QCOMPARE(events->at(0).id, u"5"_s);
+        QCOMPARE(events->at(1).stream, u"hashtag:kde"_s);
+        QCOMPARE(events->at(1).eventType, AbstractAccount::DeleteEvent);
+    }
+
+    void testBackfill()
+    {
+        StreamingManager manager(account);
+        manager.subscribe(u"list"_s, u"42"_s);
+
+        // Nothing was streamed yet, so there's no post to catch up from
+        const auto events = collect(manager);
+        manager.backfill(u"list:42"_s);
+        QVERIFY(events->isEmpty());
+
+        manager.handleMessage(u"{\"stream\":[\"list\",\"42\"],\"event\":\"update\",\"payload\":\"{\\\"id\\\":\\\"100\\\"}\"}"_s);
+        events->clear();
+
+        QUrl url = account->apiUrl(u"/api/v1/timelines/list/42"_s);
+        url.setQuery(QUrlQuery{{u"min_id"_s, u"100"_s}, {u"limit"_s, u"40"_s}});
+        account->registerGet(url, new TestReply(u"statuses.json"_s, account));
+
+        manager.backfill(u"list:42"_s);
+
+        // Missed posts are emitted oldest first, like they would have been streamed
+        QCOMPARE(events->size(), 7);
+        QCOMPARE(events->first().stream, u"list:42"_s);
+        QCOMPARE(events->first().eventType, AbstractAccount::UpdateEvent);
+        QCOMPARE(events->first().id, u"103270115826038975"_s);
+        QCOMPARE(events->last().id, u"103270115826048977"_s);
+
+        // The next backfill continues from the newest post
+        QCOMPARE(manager.backfillUrl(manager.m_subscriptions[u"list:42"_s]).query(), u"min_id=103270115826048977&limit=40"_s);
+    }
+
+    void testBackfillPages()
+    {
+        StreamingManager manager(account);
+        manager.subscribe(u"list"_s, u"43"_s);
+        manager.handleMessage(u"{\"stream\":[\"list\",\"43\"],\"event\":\"update\",\"payload\":\"{\\\"id\\\":\\\"100\\\"}\"}"_s);
+        const auto events = collect(manager);
+
+        // 100 posts were missed, more than fit in one page
+        const auto registerPage = [this](const int minId, const int newest) {
+            QUrl url = account->apiUrl(u"/api/v1/timelines/list/43"_s);
+            url.setQuery(QUrlQuery{{u"min_id"_s, QString::number(minId)}, {u"limit"_s, u"40"_s}});
+            QJsonArray page;
+            for (int id = newest; id > minId; id--) {
+                page.append(QJsonObject{{u"id"_s, QString::number(id)}});
+            }
+            account->registerGet(url, new DataReply(QJsonDocument(page).toJson(), account));
+        };
+        registerPage(100, 140);
+        registerPage(140, 180);
+        registerPage(180, 200);
+
+        manager.backfill(u"list:43"_s);
+
+        // Every one of them is emitted, oldest first
+        QCOMPARE(events->size(), 100);
+        for (int i = 0; i < events->size(); i++) {
+            QCOMPARE(events->at(i).id, QString::number(101 + i));
+        }
+        QCOMPARE(manager.backfillUrl(manager.m_subscriptions[u"list:43"_s]).query(), u"min_id=200&limit=40"_s);
+    }
+
+private:
+    std::shared_ptr<QList<StreamedEvent>> collect(StreamingManager &manager)
+    {
+        auto events = std::make_shared<QList<StreamedEvent>>();
+        connect(&manager,
+                &StreamingManager::streamEvent,
+                this,
+                [events](const QString &stream, AbstractAccount::StreamingEventType eventType, const QByteArray &payload) {
+                    const auto doc = QJsonDocument::fromJson(payload);
+                    events->append({stream, eventType, doc.isObject() ? doc["id"_L1].toString() : QString::fromUtf8(payload)});
+                });
+        return events;
+    }
+
+    MockAccount *account = nullptr;
+};
+
+QTEST_MAIN(StreamingManagerTest)
+#include "streamingmanagertest.moc"
@@ -3,6 +3,7 @@
 
 #include <QtTest/QtTest>
 
+#include "account/streamingmanager.h"
 #include "autotests/helperreply.h"
 #include "autotests/mockaccount.h"
 #include "timeline/maintimelinemodel.h"
@@ -60,7 +61,63 @@ private Q_SLOTS:
         QCOMPARE(timelineModel.rowCount({}), 0);
 
         account->streamingEvent(AbstractAccount::StreamingEventType::UpdateEvent, statusExampleApi.readAll());
-        QCOMPARE(timelineModel.rowCount({}), 1);
+        QTRY_COMPARE(timelineModel.rowCount({}), 1);
+    }
+
+    void testStreamSubscription()
+    {
+        const auto streaming = account->streaming();
+
+        MainTimelineModel timelineModel;
+        timelineModel.setName(QStringLiteral("list"));
+        timelineModel.setListId(QStringLiteral("42"));
+        QVERIFY(streaming->isSubscribed(QStringLiteral("list"), QStringLiteral("42")));
+
+        // Hidden timelines don't stay live
+        timelineModel.setActive(false);
+        QVERIFY(!streaming->isSubscribed(QStringLiteral("list"), QStringLiteral("42")));
+        timelineModel.setActive(true);
+
+        timelineModel.setName(QStringLiteral("public"));
+        QVERIFY(!streaming->isSubscribed(QStringLiteral("list"), QStringLiteral("42")));
+        QVERIFY(streaming->isSubscribed(QStringLiteral("public:local")));
+
+        {
+            TagsTimelineModel tagModel;
+            tagModel.setHashtag(QStringLiteral("KDE"));
+            QVERIFY(streaming->isSubscribed(QStringLiteral("hashtag"), QStringLiteral("kde")));
+        }
+        QVERIFY(!streaming->isSubscribed(QStringLiteral("hashtag"), QStringLiteral("kde")));
+    }
+
+    void testStreamBatching()
+    {
+        QFile status(QLatin1String(DATA_DIR "/status.json"));
+        status.open(QIODevice::ReadOnly);
+        QFile pollStatus(QLatin1String(DATA_DIR "/status-poll.json"));
+        pollStatus.open(QIODevice::ReadOnly);
+        const QByteArray pollPayload = pollStatus.readAll();
+
+        MainTimelineModel timelineModel;
+        timelineModel.setName(QStringLiteral("public"));
+        const int rowCount = timelineModel.rowCount({});
+
+        QSignalSpy insertSpy(&timelineModel, &QAbstractItemModel::rowsInserted);
+        const auto streaming = account->streaming();
+        Q_EMIT streaming->streamEvent(QStringLiteral("public:local"), AbstractAccount::UpdateEvent, pollPayload);
+        Q_EMIT streaming->streamEvent(QStringLiteral("public:local"), AbstractAccount::UpdateEvent, status.readAll());
+        Q_EMIT streaming->streamEvent(QStringLiteral("public:local"), AbstractAccount::UpdateEvent, pollPayload);
+        // Other streams are ignored
+        Q_EMIT streaming->streamEvent(QStringLiteral("public"), AbstractAccount::UpdateEvent, pollPayload);
+
+        // Everything streamed during the same frame is inserted at once, without duplicates, newest first
+        QVERIFY(insertSpy.wait());
+        QCOMPARE(insertSpy.size(), 1);
+        QCOMPARE(insertSpy.first().at(1).toInt(), 0);
+        QCOMPARE(insertSpy.first().at(2).toInt(), 1);
+        QCOMPARE(timelineModel.rowCount({}), rowCount + 2);
+        QCOMPARE(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::IdRole).toString(), QStringLiteral("100000"));
+        QCOMPARE(timelineModel.data(timelineModel.index(1, 0), AbstractTimelineModel::IdRole).toString(), QStringLiteral("103270115826048975"));
     }
 
     void testFillTimelineMain()
@@ -89,6 +146,46 @@ private Q_SLOTS:
         QCOMPARE(timelineModel.rowCount({}), 7);
     }
 
+    void testStatusUpdate()
+    {
+        MainTimelineModel timelineModel;
+        timelineModel.setName(QStringLiteral("home"));
+        QCOMPARE(timelineModel.rowCount({}), 7);
+
+        QFile statuses(QLatin1String(DATA_DIR "/statuses.json"));
+        statuses.open(QIODevice::ReadOnly);
+        auto status = QJsonDocument::fromJson(statuses.readAll()).array().first().toObject();
+
+        QSignalSpy spy(&timelineModel, &QAbstractItemModel::dataChanged);
+
+        // Refreshed counts only touch the counts
+        status["favourites_count"_L1] = 42;
+        Q_EMIT account->statusesUpdated(QJsonArray{status});
+        QCOMPARE(spy.size(), 1);
+        QCOMPARE(spy.first().at(0).toModelIndex().row(), 0);
+        QCOMPARE(spy.first().at(1).toModelIndex().row(), 0);
+        const auto countRoles = spy.takeFirst().at(2).value<QList<int>>();
+        QVERIFY(countRoles.contains(AbstractTimelineModel::FavouritesCountRole));
+        QVERIFY(!countRoles.contains(AbstractTimelineModel::ContentRole));
+        QCOMPARE(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::FavouritesCountRole).toInt(), 42);
+
+        // Streamed edits are applied in place
+        status["content"_L1] = QStringLiteral("<p>EDITED</p>");
+        status["edited_at"_L1] = QStringLiteral("2026-01-01T00:00:00.000Z");
+        Q_EMIT account->streaming()->streamEvent(QStringLiteral("public"), AbstractAccount::StatusUpdatedEvent, QJsonDocument(status).toJson());
+        QCOMPARE(spy.size(), 1);
+        const auto editRoles = spy.takeFirst().at(2).value<QList<int>>();
+        QVERIFY(editRoles.contains(AbstractTimelineModel::ContentRole));
+        QVERIFY(!editRoles.contains(AbstractTimelineModel::FavouritesCountRole));
+        QCOMPARE(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::ContentRole).toString(), QStringLiteral("<p>EDITED</p>"));
+        QVERIFY(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::WasEditedRole).toBool());
+
+        // Nothing changes for posts that aren't shown
+        status["id"_L1] = QStringLiteral("1");
+        Q_EMIT account->statusesUpdated(QJsonArray{status});
+        QVERIFY(spy.isEmpty());
+    }
+
     void testTagModel()
     {
         auto fetchMoreUrl = account->apiUrl(QStringLiteral("/api/v1/timelines/tag/home"));
@@ -145,7 +242,7 @@ private Q_SLOTS:
         statusExampleApi.setFileName(QLatin1String(DATA_DIR "/status-poll.json"));
         statusExampleApi.open(QIODevice::ReadOnly);
         account->streamingEvent(AbstractAccount::StreamingEventType::UpdateEvent, statusExampleApi.readAll());
-        QCOMPARE(timelineModel.rowCount({}), 8);
+        QTRY_COMPARE(timelineModel.rowCount({}), 8);
 
         QCOMPARE(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::IdRole).value<QString>(), QStringLiteral("100000"));
         QCOMPARE(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::MentionsRole).value<QStringList>(), QStringList{});
@@ -213,6 +310,68 @@ private Q_SLOTS:
         QCOMPARE(timelineModel.rowCount({}), 7);
     }
 
+    void testReadMarker()
+    {
+        QUrl markersUrl = account->apiUrl(QStringLiteral("/api/v1/markers"));
+        markersUrl.setQuery(QStringLiteral("timeline[]=home"));
+        account->registerGet(markersUrl, new TestReply(QStringLiteral("markers_read.json"), account));
+        account->registerGet(account->apiUrl(QStringLiteral("/api/v1/timelines/home")), new TestReply(QStringLiteral("statuses.json"), account));
+
+        MainTimelineModel timelineModel;
+        timelineModel.setName(QStringLiteral("home"));
+        QCOMPARE(timelineModel.rowCount({}), 7);
+
+        // The marker is on the last read post, and everything older than it was read too
+        for (int row = 0; row < timelineModel.rowCount({}); row++) {
+            QCOMPARE(timelineModel.data(timelineModel.index(row, 0), AbstractTimelineModel::ShowReadMarkerRole).toBool(), row >= 2);
+        }
+
+        // Removing the last read post moves the marker to the next older one
+        QSignalSpy spy(&timelineModel, &QAbstractItemModel::dataChanged);
+        account->streamingEvent(AbstractAccount::StreamingEventType::DeleteEvent, "103270115826048975");
+        QCOMPARE(timelineModel.rowCount({}), 6);
+        QVERIFY(timelineModel.data(timelineModel.index(2, 0), AbstractTimelineModel::ShowReadMarkerRole).toBool());
+        QVERIFY(!timelineModel.data(timelineModel.index(1, 0), AbstractTimelineModel::ShowReadMarkerRole).toBool());
+        QVERIFY(spy.isEmpty());
+
+        account->registerGet(markersUrl, new TestReply(QStringLiteral("markers.json"), account));
+    }
+
+    void testShowToggles()
+    {
+        QUrl markersUrl = account->apiUrl(QStringLiteral("/api/v1/markers"));
+        markersUrl.setQuery(QStringLiteral("timeline[]=home"));
+        account->registerGet(markersUrl, new TestReply(QStringLiteral("markers.json"), account));
+        account->registerGet(account->apiUrl(QStringLiteral("/api/v1/timelines/home")), new TestReply(QStringLiteral("statuses.json"), account));
+
+        MainTimelineModel timelineModel;
+        timelineModel.setName(QStringLiteral("home"));
+        QCOMPARE(timelineModel.rowCount({}), 7);
+
+        QSignalSpy resetSpy(&timelineModel, &QAbstractItemModel::modelReset);
+        QSignalSpy removedSpy(&timelineModel, &QAbstractItemModel::rowsRemoved);
+        QSignalSpy insertedSpy(&timelineModel, &QAbstractItemModel::rowsInserted);
+
+        // The two quote posts at the top are removed together, without fetching the timeline again
+        timelineModel.setProperty("showQuotes", false);
+        QCOMPARE(timelineModel.rowCount({}), 5);
+        QCOMPARE(removedSpy.size(), 1);
+        QCOMPARE(removedSpy.first().at(1).toInt(), 0);
+        QCOMPARE(removedSpy.first().at(2).toInt(), 1);
+        QCOMPARE(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::IdRole).toString(), QStringLiteral("103270115826048975"));
+
+        // And come back where they were
+        timelineModel.setProperty("showQuotes", true);
+        QCOMPARE(timelineModel.rowCount({}), 7);
+        QCOMPARE(insertedSpy.size(), 1);
+        QCOMPARE(insertedSpy.first().at(1).toInt(), 0);
+        QCOMPARE(insertedSpy.first().at(2).toInt(), 1);
+        QCOMPARE(timelineModel.data(timelineModel.index(0, 0), AbstractTimelineModel::IdRole).toString(), QStringLiteral("103270115826048977"));
+        QCOMPARE(timelineModel.data(timelineModel.index(1, 0), AbstractTimelineModel::IdRole).toString(), QStringLiteral("103270115826048976"));
+
+        QVERIFY(resetSpy.isEmpty());
+    }
+
 private:
     MockAccount *account = nullptr;
 };
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <QtTest/QtTest>
+
+#include "utils/tracing.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+class TracingTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testNotRecording()
+    {
+        QVERIFY(!Tracing::isRecording());
+        QCOMPARE(Tracing::now(), qint64(-1));
+
+        // Nothing from before the recording ends up in it
+        {
+            const Tracing::Scope trace("test", "before");
+        }
+
+        QTemporaryDir dir;
+        const QString fileName = dir.filePath(u"trace.json"_s);
+        Tracing::start(fileName);
+        Tracing::stop();
+
+        const auto events = readEvents(fileName);
+        QVERIFY(events.isEmpty());
+    }
+
+    void testRecording()
+    {
+        QTemporaryDir dir;
+        const QString fileName = dir.filePath(u"trace.json"_s);
+        Tracing::start(fileName);
+        QVERIFY(Tracing::isRecording());
+
+        const qint64 requestStart = Tracing::now();
+        {
+            Tracing::Scope trace("test", "scope");
+            trace.setDetail(u"detail"_s);
+            Tracing::instant("test", u"instant"_s);
+        }
+        Tracing::async("test", u"request"_s, requestStart);
+
+        Tracing::stop();
+        QVERIFY(!Tracing::isRecording());
+
+        const auto events = readEvents(fileName);
+        QCOMPARE(events.size(), 4);
+
+        // Events are in the order they ended
+        QCOMPARE(events[0]["ph"_L1].toString(), u"i"_s);
+        QCOMPARE(events[0]["name"_L1].toString(), u"instant"_s);
+
+        QCOMPARE(events[1]["ph"_L1].toString(), u"X"_s);
+        QCOMPARE(events[1]["name"_L1].toString(), u"scope"_s);
+        QCOMPARE(events[1]["cat"_L1].toString(), u"test"_s);
+        QCOMPARE(events[1]["args"_L1]["detail"_L1].toString(), u"detail"_s);
+        QVERIFY(events[1]["ts"_L1].toInteger() >= requestStart);
+        QVERIFY(events[1]["dur"_L1].toInteger() >= 0);
+
+        QCOMPARE(events[2]["ph"_L1].toString(), u"b"_s);
+        QCOMPARE(events[3]["ph"_L1].toString(), u"e"_s);
+        QCOMPARE(events[2]["id"_L1], events[3]["id"_L1]);
+        QCOMPARE(events[2]["ts"_L1].toInteger(), requestStart);
+        QVERIFY(events[3]["ts"_L1].toInteger() >= events[1]["ts"_L1].toInteger() + events[1]["dur"_L1].toInteger());
+    }
+
+private:
+    static QJsonArray readEvents(const QString &fileName)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return {};
+        }
+        return QJsonDocument::fromJson(file.readAll()).object()["traceEvents"_L1].toArray();
+    }
+};
+
+QTEST_MAIN(TracingTest)
+#include "tracingtest.moc"
@@ -3,6 +3,7 @@
 
 #include "conversation/conversationmodel.h"
 
+#include "account/poststore.h"
 #include "networkcontroller.h"
 
 #include <KLocalizedString>
@@ -34,6 +35,11 @@ QHash<int, QByteArray> ConversationModel::roleNames() const
     return roles;
 }
 
+FilterEngine::Context ConversationModel::filterContext() const
+{
+    return FilterEngine::ThreadContext;
+}
+
 int ConversationModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
@@ -81,6 +87,10 @@ void ConversationModel::fetchConversation(AbstractAccount *account)
         this,
         [account, this](QNetworkReply *reply) {
             beginResetModel();
+            m_account = account;
+            for (const auto &conversation : std::as_const(m_conversations)) {
+                PostStore::release(conversation.lastPost, this);
+            }
             m_conversations.clear();
             const auto conversationArray = QJsonDocument::fromJson(reply->readAll()).array();
             for (const auto &conversation : conversationArray) {
@@ -93,7 +103,7 @@ void ConversationModel::fetchConversation(AbstractAccount *account)
                 });
                 m_conversations.append(Conversation{
                     accounts,
-                    new Post(account, obj["last_status"_L1].toObject(), this),
+                    account->postStore()->acquire(obj["last_status"_L1].toObject(), this),
                     obj["unread"_L1].toBool(),
                     obj["id"_L1].toString(),
                 });
@@ -48,6 +48,9 @@ public:
      */
     Q_INVOKABLE void markAsRead(const QString &id);
 
+protected:
+    [[nodiscard]] FilterEngine::Context filterContext() const override;
+
 private:
     void fetchConversation(AbstractAccount *account);
     QList<Conversation> m_conversations;
@@ -4,6 +4,7 @@
 
 #include "datatypes/attachment.h"
 #include "account/accountmanager.h"
+#include "utils/mediacache.h"
 
 #include <QClipboard>
 #include <QGuiApplication>
@@ -120,6 +121,11 @@ QUrl Attachment::tempSource() const
     return url;
 }
 
+QUrl Attachment::thumbnailSource() const
+{
+    return MediaCache::imageSource(m_id, m_preview_url);
+}
+
 double Attachment::focusX() const
 {
     return m_focusX;
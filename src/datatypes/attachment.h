@@ -13,7 +13,6 @@ class Post;
  * @brief Post's attachment object.
  * @see Post
  */
-// TODO: make it possible to fetch the images with a Qml image provider.
 // TODO: use getter and setter
 class Attachment : public QObject
 {
@@ -29,6 +28,7 @@ class Attachment : public QObject
     Q_PROPERTY(QString remoteUrl MEMBER m_remote_url CONSTANT)
     Q_PROPERTY(QString caption READ description CONSTANT)
     Q_PROPERTY(QUrl tempSource READ tempSource CONSTANT)
+    Q_PROPERTY(QUrl thumbnailSource READ thumbnailSource CONSTANT)
     Q_PROPERTY(int sourceWidth MEMBER m_sourceWidth CONSTANT)
     Q_PROPERTY(int sourceHeight MEMBER m_sourceHeight CONSTANT)
     Q_PROPERTY(double focusX READ focusX WRITE setFocusX NOTIFY focusXChanged)
@@ -70,6 +70,12 @@ public:
 
     [[nodiscard]] QUrl tempSource() const;
 
+    /**
+     * @brief The preview image, decoded and cached off the GUI thread.
+     * @see MediaCache
+     */
+    [[nodiscard]] QUrl thumbnailSource() const;
+
     [[nodiscard]] double focusX() const;
     void setFocusX(double value);
 
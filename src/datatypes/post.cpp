@@ -6,13 +6,22 @@
 
 #include "account/abstractaccount.h"
 #include "accountmanager.h"
+#include "config.h"
 #include "networkcontroller.h"
 #include "tokodon_debug.h"
+#include "utils/contenttransformer.h"
+#include "utils/metrics.h"
 #include "utils/texthandler.h"
+#include "utils/tracing.h"
 
 #include <KLocalizedString>
 #include <QJsonDocument>
 #include <QNetworkReply>
+#include <QSet>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -31,11 +40,34 @@ static const QMap<QString, Post::Visibility> p_stringToVisibility = {
     {QStringLiteral("local"), Post::Visibility::Local},
 };
 
+// There are only so many languages, so posts share the strings instead of each having their own copy
+static QString internLanguage(const QString &language)
+{
+    static QSet<QString> languages;
+    return *languages.insert(language);
+}
+
+// Posts come and go by the thousands, so they're counted without taking the lock of Metrics every time
+static std::atomic<qint64> alivePosts = 0;
+
+static void countNewPost()
+{
+    static const bool sampled = [] {
+        Metrics::instance().setSampler(u"posts.alive"_s, [] {
+            return alivePosts.load(std::memory_order_relaxed);
+        });
+        return true;
+    }();
+    Q_UNUSED(sampled)
+    alivePosts.fetch_add(1, std::memory_order_relaxed);
+}
+
 Post::Post(AbstractAccount *account, QObject *parent)
     : QObject(parent)
     , m_parent(account)
 {
     Q_ASSERT(account);
+    countNewPost();
     QString visibilityString = account->identity()->visibility();
     m_visibility = stringToVisibility(visibilityString);
 }
@@ -46,22 +78,38 @@ Post::Post(AbstractAccount *account, QJsonObject obj, QObject *parent)
     , m_visibility(Post::Visibility::Public)
 {
     Q_ASSERT(account);
+    countNewPost();
     fromJson(obj);
 }
 
+Post::~Post()
+{
+    alivePosts.fetch_sub(1, std::memory_order_relaxed);
+}
+
+AbstractAccount *Post::account() const
+{
+    return m_parent;
+}
+
 void Post::fromJson(QJsonObject obj)
 {
+    const Tracing::Scope trace("json", "Post::fromJson");
+
+    // This may be an update of a post that was already loaded, then what was looked up before is only looked up again if it changed
+    const bool reload = !m_postId.isEmpty();
+
     const auto accountDoc = obj["account"_L1].toObject();
     const auto accountId = accountDoc["id"_L1].toString();
 
-    m_originalPostId = obj["id"_L1].toString();
+    m_originalPostId = StatusId(obj["id"_L1].toString());
     const auto reblogObj = obj["reblog"_L1].toObject();
 
     if (!obj.contains("reblog"_L1) || reblogObj.isEmpty()) {
-        m_boosted = false;
+        m_flags.setFlag(Boosted, false);
         m_authorIdentity = m_parent->identityLookup(accountId, accountDoc);
     } else {
-        m_boosted = true;
+        m_flags.setFlag(Boosted, true);
 
         const auto reblogAccountDoc = reblogObj["account"_L1].toObject();
         const auto reblogAccountId = reblogAccountDoc["id"_L1].toString();
@@ -72,23 +120,30 @@ void Post::fromJson(QJsonObject obj)
         obj = reblogObj;
     }
 
-    m_postId = obj["id"_L1].toString();
+    m_postId = StatusId(obj["id"_L1].toString());
 
     m_spoilerText = obj["spoiler_text"_L1].toString();
 
+    const QString previousContent = m_content;
     processContent(obj);
+    const bool contentChanged = !reload || m_content != previousContent;
 
     // Check if there is a native Mastodon quote
     // TODO: unilaterally switch to this on a high enough Mastodon version
-    if (obj.contains("quote"_L1)) {
-        const auto quoteObj = obj["quote"_L1].toObject();
-        if (quoteObj.contains("quoted_status"_L1)) {
-            m_quotedPost = new Post(m_parent, quoteObj["quoted_status"_L1].toObject(), this);
+    const auto quotedStatus = obj["quote"_L1].toObject()["quoted_status"_L1].toObject();
+    if (!quotedStatus.isEmpty()) {
+        if (m_quotedPost && m_quotedPost->originalStatusId() == StatusId(quotedStatus["id"_L1].toString())) {
+            m_quotedPost->update(quotedStatus);
+        } else {
+            setQuotedPost(new Post(m_parent, quotedStatus, this));
         }
+    } else if (contentChanged) {
+        // The links may be different now
+        setQuotedPost(nullptr);
     }
 
     // Process all URLs in the body if no native quote was found
-    if (!m_quotedPost) {
+    if (!m_quotedPost && contentChanged) {
         auto matchIterator = TextRegex::url.globalMatch(m_content);
         while (matchIterator.hasNext()) {
             const QRegularExpressionMatch match = matchIterator.next();
@@ -105,8 +160,7 @@ void Post::fromJson(QJsonObject obj)
                     } else {
                         const auto status = statuses.first().toObject();
 
-                        m_quotedPost = new Post(m_parent, status, this);
-                        Q_EMIT quotedPostChanged();
+                        setQuotedPost(new Post(m_parent, status, this));
                     }
                 });
 
@@ -115,10 +169,12 @@ void Post::fromJson(QJsonObject obj)
         }
     }
 
-    m_replyTargetId = obj["in_reply_to_id"_L1].toString();
+    m_replyTargetId = StatusId(obj["in_reply_to_id"_L1].toString());
 
     if (obj.contains("in_reply_to_account_id"_L1) && obj["in_reply_to_account_id"_L1].isString()) {
-        if (m_parent->identityCached(obj["in_reply_to_account_id"_L1].toString())) {
+        if (m_replyIdentity && m_replyIdentity->id() == obj["in_reply_to_account_id"_L1].toString()) {
+            // Known since the post was loaded before
+        } else if (m_parent->identityCached(obj["in_reply_to_account_id"_L1].toString())) {
             m_replyIdentity = m_parent->identityLookup(obj["in_reply_to_account_id"_L1].toString(), {});
         } else {
             const auto accountId = obj["in_reply_to_account_id"_L1].toString();
@@ -130,9 +186,9 @@ void Post::fromJson(QJsonObject obj)
                 Q_EMIT replyIdentityChanged();
             });
         }
-    } else if (!m_replyTargetId.isEmpty()) {
+    } else if (!m_replyTargetId.isEmpty() && !m_replyIdentity) {
         // Fallback to getting the account id from the status, which is weird but this sometimes has to happen.
-        m_parent->get(m_parent->apiUrl(QStringLiteral("/api/v1/statuses/%1").arg(m_replyTargetId)), true, this, [this](QNetworkReply *reply) {
+        m_parent->get(m_parent->apiUrl(QStringLiteral("/api/v1/statuses/%1").arg(m_replyTargetId.toString())), true, this, [this](QNetworkReply *reply) {
             const auto data = reply->readAll();
             const auto doc = QJsonDocument::fromJson(data);
 
@@ -148,31 +204,15 @@ void Post::fromJson(QJsonObject obj)
     m_repliesCount = obj["replies_count"_L1].toInt();
     m_quotesCount = obj["quotes_count"_L1].toInt();
 
-    m_favourited = obj["favourited"_L1].toBool();
-    m_reblogged = obj["reblogged"_L1].toBool();
-    m_bookmarked = obj["bookmarked"_L1].toBool();
-    m_pinned = obj["pinned"_L1].toBool();
-    m_muted = obj["muted"_L1].toBool();
-
-    m_filters.clear();
-
-    const auto filters = obj["filtered"_L1].toArray();
-    for (const auto &filter : filters) {
-        const auto filterContext = filter.toObject();
-        const auto filterObj = filterContext["filter"_L1].toObject();
-        m_filters << filterObj["title"_L1].toString();
-
-        const auto filterAction = filterObj["filter_action"_L1];
-        if (filterAction == "warn"_L1) {
-            m_filtered = true;
-        } else if (filterAction == "hide"_L1) {
-            m_hidden = true;
-        }
-    }
+    m_flags.setFlag(Favourited, obj["favourited"_L1].toBool());
+    m_flags.setFlag(Reblogged, obj["reblogged"_L1].toBool());
+    m_flags.setFlag(Bookmarked, obj["bookmarked"_L1].toBool());
+    m_flags.setFlag(Pinned, obj["pinned"_L1].toBool());
+    m_flags.setFlag(Muted, obj["muted"_L1].toBool());
 
-    m_sensitive = obj["sensitive"_L1].toBool();
+    m_flags.setFlag(Sensitive, obj["sensitive"_L1].toBool());
     m_visibility = stringToVisibility(obj["visibility"_L1].toString());
-    m_language = obj["language"_L1].toString();
+    m_language = internLanguage(obj["language"_L1].toString());
 
     m_publishedAt = QDateTime::fromString(obj["created_at"_L1].toString(), Qt::ISODate).toLocalTime();
 
@@ -180,15 +220,32 @@ void Post::fromJson(QJsonObject obj)
         m_editedAt = QDateTime::fromString(obj["edited_at"_L1].toString(), Qt::ISODate).toLocalTime();
     }
 
-    m_attachments.clear();
-    addAttachments(obj["media_attachments"_L1].toArray());
+    // Views hold on to the attachments, so they are only replaced when an edit changed them
+    const QJsonArray attachments = obj["media_attachments"_L1].toArray();
+    const auto sameAttachment = [](const Attachment *attachment, const QJsonValue &value) {
+        return attachment->id() == value["id"_L1].toString() && attachment->description() == value["description"_L1].toString();
+    };
+    const bool sameAttachments =
+        m_attachments.size() == attachments.size() && std::equal(m_attachments.cbegin(), m_attachments.cend(), attachments.cbegin(), sameAttachment);
+    if (!sameAttachments) {
+        for (const auto attachment : std::as_const(m_attachments)) {
+            attachment->deleteLater();
+        }
+        m_attachments.clear();
+        addAttachments(attachments);
+    }
+
     const QJsonArray mentions = obj["mentions"_L1].toArray();
     if (obj.contains("card"_L1) && !obj["card"_L1].toObject().empty()) {
         setCard(std::make_optional<Card>(m_parent, obj["card"_L1].toObject()));
+    } else {
+        setCard(std::nullopt);
     }
 
     if (obj.contains("application"_L1) && !obj["application"_L1].toObject().empty()) {
         setApplication(std::make_optional<Application>(obj["application"_L1].toObject()));
+    } else {
+        setApplication(std::nullopt);
     }
 
     m_mentions.clear();
@@ -198,16 +255,106 @@ void Post::fromJson(QJsonObject obj)
     }
 
     if (obj.contains(QStringLiteral("poll")) && !obj[QStringLiteral("poll")].isNull()) {
-        m_poll = std::make_unique<Poll>(obj[QStringLiteral("poll")].toObject());
+        setPollJson(obj[QStringLiteral("poll")].toObject());
+    } else if (m_poll) {
+        m_poll.reset();
+        Q_EMIT pollChanged();
+    }
+
+    // Once the filters are known they are applied here, the server doesn't mark streamed posts or posts from other servers
+    const auto filterEngine = m_parent->filterEngine();
+    m_filterMatches = filterEngine->isLoaded() ? filterEngine->match(*this) : FilterEngine::fromServer(obj["filtered"_L1].toArray());
+}
+
+Post::Changes Post::update(QJsonObject status)
+{
+    // Statuses from public streams don't know about our own interactions with them
+    const auto keep = [&status](const QLatin1StringView key, const bool value) {
+        if (!status.contains(key)) {
+            status[key] = value;
+        }
+    };
+    keep("favourited"_L1, favourited());
+    keep("reblogged"_L1, reblogged());
+    keep("bookmarked"_L1, bookmarked());
+    keep("pinned"_L1, pinned());
+    keep("muted"_L1, muted());
+
+    const QString content = m_content;
+    const QString spoilerText = m_spoilerText;
+    const QDateTime editedAt = m_editedAt;
+    const std::array counts{m_repliesCount, m_reblogsCount, m_favouritesCount, m_quotesCount};
+    const Flags interactions = this->interactions();
+    const auto filterMatches = m_filterMatches;
+
+    // The status is the boosted one, which shouldn't turn a boost into the status itself
+    const StatusId originalPostId = m_originalPostId;
+    const bool wasBoosted = boosted();
+    const auto boostIdentity = m_boostIdentity;
+
+    fromJson(status);
+
+    m_originalPostId = originalPostId;
+    m_flags.setFlag(Boosted, wasBoosted);
+    m_boostIdentity = boostIdentity;
+
+    Changes changes = NoChange;
+    if (m_content != content || m_spoilerText != spoilerText || m_editedAt != editedAt) {
+        changes |= ContentChange;
+    }
+    if (counts != std::array{m_repliesCount, m_reblogsCount, m_favouritesCount, m_quotesCount}) {
+        changes |= CountsChange;
+    }
+    if (interactions != this->interactions()) {
+        changes |= InteractionsChange;
+    }
+    if (filterMatches != m_filterMatches) {
+        changes |= FiltersChange;
+    }
+
+    if (changes != NoChange) {
+        Q_EMIT updated(changes);
+    }
+    return changes;
+}
+
+void Post::syncInteractions(const Post &other)
+{
+    Changes changes = NoChange;
+    if (std::array{m_repliesCount, m_reblogsCount, m_favouritesCount, m_quotesCount}
+        != std::array{other.m_repliesCount, other.m_reblogsCount, other.m_favouritesCount, other.m_quotesCount}) {
+        m_repliesCount = other.m_repliesCount;
+        m_reblogsCount = other.m_reblogsCount;
+        m_favouritesCount = other.m_favouritesCount;
+        m_quotesCount = other.m_quotesCount;
+        changes |= CountsChange;
+    }
+    if (interactions() != other.interactions()) {
+        m_flags = (m_flags & ~interactionFlags) | other.interactions();
+        changes |= InteractionsChange;
+    }
+
+    if (changes != NoChange) {
+        Q_EMIT updated(changes);
     }
 }
 
 QString Post::postId() const
 {
-    return m_postId;
+    return m_postId.toString();
 }
 
 QString Post::originalPostId() const
+{
+    return m_originalPostId.toString();
+}
+
+StatusId Post::statusId() const
+{
+    return m_postId;
+}
+
+StatusId Post::originalStatusId() const
 {
     return m_originalPostId;
 }
@@ -237,9 +384,32 @@ QString Post::content() const
     return m_content;
 }
 
+QString Post::renderedContent() const
+{
+    const QFont font = Config::self()->defaultFont();
+    if (m_renderedContent.isNull() || m_renderedContentFont != font) {
+        m_renderedContent = TextHandler::fixBidirectionality(m_content, font);
+        m_renderedContentFont = font;
+    }
+    return m_renderedContent;
+}
+
+QString Post::plainContent() const
+{
+    if (!m_plainContent) {
+        m_plainContent = TextHandler::stripHtml(m_content);
+    }
+    return *m_plainContent;
+}
+
+QString Post::contentText() const
+{
+    return m_contentText;
+}
+
 bool Post::hasContent() const
 {
-    return m_hasContent;
+    return m_flags.testFlag(HasContent);
 }
 
 Post::Visibility Post::visibility() const
@@ -249,7 +419,7 @@ Post::Visibility Post::visibility() const
 
 bool Post::sensitive() const
 {
-    return m_sensitive;
+    return m_flags.testFlag(Sensitive);
 }
 
 QString Post::spoilerText() const
@@ -303,6 +473,11 @@ QUrl Post::url() const
 }
 
 QString Post::inReplyTo() const
+{
+    return m_replyTargetId.toString();
+}
+
+StatusId Post::inReplyToStatusId() const
 {
     return m_replyTargetId;
 }
@@ -345,7 +520,7 @@ QString Post::editedAt() const
 
 bool Post::boosted() const
 {
-    return m_boosted;
+    return m_flags.testFlag(Boosted);
 }
 
 std::shared_ptr<Identity> Post::boostIdentity() const
@@ -355,77 +530,119 @@ std::shared_ptr<Identity> Post::boostIdentity() const
 
 bool Post::favourited() const
 {
-    return m_favourited;
+    return m_flags.testFlag(Favourited);
 }
 
 void Post::setFavourited(bool favourited)
 {
-    m_favourited = favourited;
+    m_flags.setFlag(Favourited, favourited);
     if (favourited) {
         m_favouritesCount++;
     } else {
-        m_favouritesCount--;
+        m_favouritesCount = std::max(m_favouritesCount - 1, 0);
     }
+    Q_EMIT updated(InteractionsChange | CountsChange);
 }
 
 bool Post::reblogged() const
 {
-    return m_reblogged;
+    return m_flags.testFlag(Reblogged);
 }
 
 void Post::setReblogged(bool reblogged)
 {
-    m_reblogged = reblogged;
+    m_flags.setFlag(Reblogged, reblogged);
     if (reblogged) {
         m_reblogsCount++;
     } else {
-        m_reblogsCount--;
+        m_reblogsCount = std::max(m_reblogsCount - 1, 0);
     }
+    Q_EMIT updated(InteractionsChange | CountsChange);
 }
 
 bool Post::bookmarked() const
 {
-    return m_bookmarked;
+    return m_flags.testFlag(Bookmarked);
 }
 
 void Post::setBookmarked(bool bookmarked)
 {
-    m_bookmarked = bookmarked;
+    m_flags.setFlag(Bookmarked, bookmarked);
+    Q_EMIT updated(InteractionsChange);
 }
 
 bool Post::muted() const
 {
-    return m_muted;
+    return m_flags.testFlag(Muted);
 }
 
 void Post::setMuted(bool muted)
 {
-    m_muted = muted;
+    m_flags.setFlag(Muted, muted);
+    Q_EMIT updated(InteractionsChange);
 }
 
 QStringList Post::filters() const
 {
-    return m_filters;
+    QStringList titles;
+    for (const auto &match : m_filterMatches) {
+        titles.append(match.title);
+    }
+    return titles;
+}
+
+QStringList Post::filters(const FilterEngine::Context context) const
+{
+    QStringList titles;
+    for (const auto &match : m_filterMatches) {
+        if (match.contexts.testFlag(context)) {
+            titles.append(match.title);
+        }
+    }
+    return titles;
 }
 
-bool Post::hidden() const
+bool Post::hidden(const FilterEngine::Context context) const
 {
-    return m_hidden;
+    return std::ranges::any_of(m_filterMatches, [context](const FilterEngine::Match &match) {
+        return match.hide && match.contexts.testFlag(context);
+    });
 }
 
 bool Post::pinned() const
 {
-    return m_pinned;
+    return m_flags.testFlag(Pinned);
 }
 
 void Post::setPinned(bool pinned)
 {
-    m_pinned = pinned;
+    m_flags.setFlag(Pinned, pinned);
+    Q_EMIT updated(InteractionsChange);
+}
+
+bool Post::filtered(const FilterEngine::Context context) const
+{
+    return std::ranges::any_of(m_filterMatches, [context](const FilterEngine::Match &match) {
+        return !match.hide && match.contexts.testFlag(context);
+    });
 }
 
-bool Post::filtered() const
+void Post::applyFilters()
 {
-    return m_filtered;
+    const auto filterEngine = m_parent->filterEngine();
+    if (!filterEngine->isLoaded()) {
+        return;
+    }
+
+    if (m_quotedPost) {
+        m_quotedPost->applyFilters();
+    }
+
+    auto filterMatches = filterEngine->match(*this);
+    if (filterMatches != m_filterMatches) {
+        m_filterMatches = std::move(filterMatches);
+        Q_EMIT updated(FiltersChange);
+    }
 }
 
 void Post::addAttachments(const QJsonArray &attachments)
@@ -474,6 +691,20 @@ Post *Post::quotedPost() const
     return m_quotedPost;
 }
 
+void Post::setQuotedPost(Post *post)
+{
+    if (m_quotedPost == post) {
+        return;
+    }
+
+    // Views may still show the old one until they got quotedPostChanged()
+    if (m_quotedPost) {
+        m_quotedPost->deleteLater();
+    }
+    m_quotedPost = post;
+    Q_EMIT quotedPostChanged();
+}
+
 void Post::setApplication(std::optional<Application> application)
 {
     m_application = application;
@@ -483,60 +714,21 @@ void Post::processContent(const QJsonObject &obj)
 {
     const QString originalHtml = obj["content"_L1].toString();
 
-    // First, replace custom emojis with their HTML representations
-    const auto emojis = CustomEmoji::parseCustomEmojis(obj["emojis"_L1].toArray());
-    QString processedHtml = TextHandler::replaceCustomEmojis(emojis, originalHtml);
-
-    // Then turn hashtags into proper links, so they link inside Tokodon
-    const auto tags = obj["tags"_L1].toArray();
-    const QString baseUrl = m_authorIdentity->url().toDisplayString(QUrl::RemovePath);
-
-    for (const auto &tag : tags) {
-        const auto tagObj = tag.toObject();
-
-        // The "url" field in the tag object is for our own instance,
-        // but the url for the tag in the HTML we're given is for their instance. Hence, the odd search & replace done here.
-        const QList<QString> tagFormats = {
-            QStringLiteral("tags"), // Mastodon
-            QStringLiteral("tag") // Akkoma/Pleroma
-        };
-
-        for (const QString &tagFormat : tagFormats) {
-            const QString tagName = tagObj["name"_L1].toString();
-
-            processedHtml.replace(QStringLiteral("%1/%2/%3").arg(baseUrl, tagFormat, tagName), QStringLiteral("hashtag:/%1").arg(tagName), Qt::CaseInsensitive);
-        }
-    }
-
-    // Do the same for mentions
-    const auto mentions = obj["mentions"_L1].toArray();
-
-    // Go through all link tags
-    auto matchIterator = TextRegex::linkTags.globalMatch(processedHtml);
-    while (matchIterator.hasNext()) {
-        const QRegularExpressionMatch match = matchIterator.next();
-        // Check if it's actually a mention, to prevent it from overwriting post URLs for example
-        if (match.captured(0).contains(QStringLiteral("class=\"u-url mention\""))) {
-            for (const auto &mention : mentions) {
-                // Replace if the mention URL matches with an internal Tokodon account URI
-                if (mention["url"_L1].toString() == match.captured(1)) {
-                    const auto newUrl = QStringLiteral("account:/") + mention["id"_L1].toString();
-                    processedHtml.replace(match.capturedStart(1), match.capturedLength(1), newUrl);
-                    const auto difference = newUrl.size() - match.capturedLength(1);
-                    // Update matchIterator because the underlying text was changed
-                    matchIterator = TextRegex::linkTags.globalMatch(processedHtml, match.capturedEnd(0) + difference);
-                    break;
-                }
-            }
-        }
-    }
-
-    // Remove the standalone tags from the main content
-    auto [standaloneContent, standaloneTags] = TextHandler::removeStandaloneTags(processedHtml);
+    // Replace custom emojis, point hashtags and mentions inside Tokodon and take out the standalone tags, all in one go
+    const ContentTransformer transformer(CustomEmoji::parseCustomEmojis(obj["emojis"_L1].toArray()),
+                                         m_authorIdentity->url().toDisplayString(QUrl::RemovePath),
+                                         obj["tags"_L1].toArray(),
+                                         obj["mentions"_L1].toArray());
+    auto [standaloneContent, standaloneTags, plainText] = transformer.transform(originalHtml);
     m_standaloneTags = standaloneTags;
+    m_contentText = plainText;
 
-    m_hasContent = !standaloneContent.isEmpty();
+    m_flags.setFlag(HasContent, !standaloneContent.isEmpty());
     m_content = standaloneContent;
+
+    // The content can change when the post is edited
+    m_renderedContent.clear();
+    m_plainContent.reset();
 }
 
 bool Post::hasPoll() const
@@ -544,4 +736,9 @@ bool Post::hasPoll() const
     return m_poll.operator bool();
 }
 
+Post::Flags Post::interactions() const
+{
+    return m_flags & interactionFlags;
+}
+
 #include "moc_post.cpp"
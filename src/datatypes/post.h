@@ -5,11 +5,14 @@
 
 #pragma once
 
+#include "account/filterengine.h"
 #include "datatypes/application.h"
 #include "datatypes/attachment.h"
 #include "datatypes/card.h"
 #include "datatypes/poll.h"
+#include "datatypes/statusid.h"
 
+#include <QFont>
 #include <QImage>
 
 class Post;
@@ -28,6 +31,8 @@ class Post : public QObject
     Q_PROPERTY(QString postId READ postId CONSTANT)
     Q_PROPERTY(QString spoilerText READ spoilerText CONSTANT)
     Q_PROPERTY(QString content READ content CONSTANT)
+    Q_PROPERTY(QString renderedContent READ renderedContent CONSTANT)
+    Q_PROPERTY(QString plainContent READ plainContent CONSTANT)
     Q_PROPERTY(bool hasContent READ hasContent CONSTANT)
     Q_PROPERTY(bool sensitive READ sensitive CONSTANT)
     Q_PROPERTY(Visibility visibility READ visibility CONSTANT)
@@ -64,24 +69,69 @@ public:
      */
     Post(AbstractAccount *account, QJsonObject obj, QObject *parent = nullptr);
 
+    ~Post() override;
+
+    /**
+     * @return The account this post was loaded from.
+     */
+    [[nodiscard]] AbstractAccount *account() const;
+
     /**
      * @brief Loads post content from JSON @p obj.
+     * @note This can be called again on a post that was already loaded, the objects that didn't change are kept.
      */
     void fromJson(QJsonObject obj);
 
+    /**
+     * @brief What changed when updating a post with update().
+     */
+    enum Change {
+        NoChange = 0,
+        ContentChange = 1 << 0, /** The post was edited. */
+        CountsChange = 1 << 1, /** The number of replies, boosts, favorites or quotes changed. */
+        InteractionsChange = 1 << 2, /** Our own interactions with the post changed, like having favorited it. */
+        FiltersChange = 1 << 3, /** Which filters apply to the post changed. */
+    };
+    Q_DECLARE_FLAGS(Changes, Change)
+
+    /**
+     * @brief Updates the post in place from a newer version of its @p status, for example after it was edited.
+     * Unlike fromJson(), boosts stay boosts, and our own interactions are kept if @p status doesn't know about them.
+     * @return What changed.
+     * @see updated()
+     */
+    Changes update(QJsonObject status);
+
+    /**
+     * @brief Takes over the interaction counts and our own interactions with the post from @p other, a boost of the same status or the other way around.
+     */
+    void syncInteractions(const Post &other);
+
     /**
      * @return This post's id.
      * @note The id may be different because it was boosted. This is the id of the parent post.
+     * @note This builds a new string every time, compare statusId() instead.
      * @sa originalPostId()
      */
     [[nodiscard]] QString postId() const;
 
     /**
      * @return The post's original id if boosted, but identical to postId if not.
+     * @note This builds a new string every time, compare originalStatusId() instead.
      * @sa postId()
      */
     [[nodiscard]] QString originalPostId() const;
 
+    /**
+     * @return The same as postId(), but cheaper to compare.
+     */
+    [[nodiscard]] StatusId statusId() const;
+
+    /**
+     * @return The same as originalPostId(), but cheaper to compare.
+     */
+    [[nodiscard]] StatusId originalStatusId() const;
+
     /**
      * @return The published/creation time of this post.
      */
@@ -107,6 +157,25 @@ public:
      */
     [[nodiscard]] QString content() const;
 
+    /**
+     * @return The HTML text of this post, ready to be displayed with the content font.
+     * @note This is computed once and cached until the content font changes, as it's expensive to do for every delegate.
+     * @see TextHandler::fixBidirectionality()
+     */
+    [[nodiscard]] QString renderedContent() const;
+
+    /**
+     * @return The text of this post without any markup, for example for accessibility.
+     * @note This is computed once and cached.
+     */
+    [[nodiscard]] QString plainContent() const;
+
+    /**
+     * @return The text of this post without any markup, including the standalone tags.
+     * @note Unlike plainContent() this is a cheap by-product of processing the content, so use it for filtering.
+     */
+    [[nodiscard]] QString contentText() const;
+
     /**
      * @return If the post has any text content.
      * @note Use this instead of checking the length of content() because it could contain useless HTML code.
@@ -190,6 +259,11 @@ public:
      */
     [[nodiscard]] QString inReplyTo() const;
 
+    /**
+     * @return The same as inReplyTo(), but cheaper to compare.
+     */
+    [[nodiscard]] StatusId inReplyToStatusId() const;
+
     /**
      * @return The identity of who replied to this post, if someone did.
      */
@@ -283,9 +357,14 @@ public:
     [[nodiscard]] QStringList filters() const;
 
     /**
-     * @return Whether this post is supposed to be hidden by a filter.
+     * @return The filters that apply to this post in @p context.
      */
-    [[nodiscard]] bool hidden() const;
+    [[nodiscard]] QStringList filters(FilterEngine::Context context) const;
+
+    /**
+     * @return Whether this post is supposed to be hidden by a filter in @p context.
+     */
+    [[nodiscard]] bool hidden(FilterEngine::Context context) const;
 
     /**
      * @return Whether the user pinned this post.
@@ -298,9 +377,15 @@ public:
     void setPinned(bool pinned);
 
     /**
-     * @return Whether the user filtered this post.
+     * @return Whether the user filtered this post in @p context, so it's shown behind a warning.
+     */
+    [[nodiscard]] bool filtered(FilterEngine::Context context) const;
+
+    /**
+     * @brief Applies the filters of the account to this post again, after they changed.
+     * @see FilterEngine::changed()
      */
-    [[nodiscard]] bool filtered() const;
+    void applyFilters();
 
     /**
      * @brief Adds @p attachments to this post.
@@ -324,6 +409,11 @@ Q_SIGNALS:
     void replyIdentityChanged();
     void quotedPostChanged();
 
+    /**
+     * @brief Emitted when the post changed after it was created, either by update() or by setting our own interactions with it.
+     */
+    void updated(Post::Changes changes);
+
 private:
     [[nodiscard]] QString type() const;
 
@@ -337,52 +427,67 @@ private:
 
     void setApplication(std::optional<Application> application);
 
+    void setQuotedPost(Post *post);
+
     void processContent(const QJsonObject &obj);
 
+    /**
+     * @brief The boolean properties of the post, packed together.
+     */
+    enum Flag : quint16 {
+        Sensitive = 1 << 0,
+        Boosted = 1 << 1,
+        HasContent = 1 << 2,
+        Favourited = 1 << 3,
+        Reblogged = 1 << 4,
+        Muted = 1 << 5,
+        Bookmarked = 1 << 6,
+        Pinned = 1 << 7,
+    };
+    Q_DECLARE_FLAGS(Flags, Flag)
+
+    static constexpr Flags interactionFlags = Flags(Favourited) | Reblogged | Bookmarked | Pinned | Muted;
+
+    /**
+     * @return The flags of our own interactions with the post.
+     */
+    [[nodiscard]] Flags interactions() const;
+
     AbstractAccount *const m_parent;
 
+    StatusId m_postId;
+    StatusId m_originalPostId;
+    StatusId m_replyTargetId;
     QDateTime m_publishedAt;
-    QString m_postId;
-    QString m_originalPostId;
+    QDateTime m_editedAt;
     QUrl m_url;
     QString m_content;
-    bool m_hasContent;
+    mutable QString m_renderedContent;
+    mutable QFont m_renderedContentFont;
+    mutable std::optional<QString> m_plainContent;
+    QString m_contentText;
     QString m_spoilerText;
-    QString m_author;
-    QString m_reply_to_author;
-    QString m_content_type;
     QStringList m_mentions;
-    QString m_language;
-    QDateTime m_editedAt;
+    QString m_language; ///< Shared between all posts in the same language
     QVector<QString> m_standaloneTags;
     Post *m_quotedPost = nullptr;
 
-    QString m_replyTargetId;
-    QStringList m_filters;
+    QList<FilterEngine::Match> m_filterMatches;
     std::optional<Card> m_card;
     std::optional<Application> m_application;
     std::shared_ptr<Identity> m_authorIdentity;
-    QList<Attachment *> m_attachments;
-    std::unique_ptr<Poll> m_poll;
-
-    bool m_sensitive = false;
-    Visibility m_visibility;
-
-    bool m_boosted = false;
     std::shared_ptr<Identity> m_boostIdentity;
-
     std::shared_ptr<Identity> m_replyIdentity;
-
-    bool m_favourited = false;
-    bool m_reblogged = false;
-    bool m_muted = false;
-    bool m_bookmarked = false;
-    bool m_filtered = false;
-    bool m_hidden = false;
-    bool m_pinned = false;
+    QList<Attachment *> m_attachments;
+    std::unique_ptr<Poll> m_poll;
 
     int m_reblogsCount = 0;
     int m_favouritesCount = 0;
     int m_repliesCount = 0;
     int m_quotesCount = 0;
+
+    Visibility m_visibility;
+    Flags m_flags;
 };
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Post::Changes)
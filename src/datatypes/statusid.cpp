@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "datatypes/statusid.h"
+
+#include <algorithm>
+
+StatusId::StatusId(const QString &id)
+{
+    // Only ids that turn into the same string again are stored as numbers, e.g. not ones with leading zeroes
+    const bool isNumber = !id.isEmpty() && id.size() <= 20 && id.front() != u'0' && std::ranges::all_of(id, [](const QChar c) {
+                              return c >= u'0' && c <= u'9';
+                          });
+    if (isNumber) {
+        bool ok = false;
+        m_number = id.toULongLong(&ok);
+        if (ok) {
+            return;
+        }
+        m_number = 0;
+    }
+
+    m_text = id;
+}
+
+bool StatusId::isEmpty() const
+{
+    return m_number == 0 && m_text.isEmpty();
+}
+
+bool StatusId::isNumeric() const
+{
+    return m_number != 0;
+}
+
+QString StatusId::toString() const
+{
+    if (isNumeric()) {
+        return QString::number(m_number);
+    }
+    return m_text;
+}
+
+std::strong_ordering StatusId::operator<=>(const StatusId &other) const
+{
+    if (isNumeric() && other.isNumeric()) {
+        return m_number <=> other.m_number;
+    }
+
+    const QString id = toString();
+    const QString otherId = other.toString();
+    if (id.size() != otherId.size()) {
+        return id.size() <=> otherId.size();
+    }
+    return QString::compare(id, otherId) <=> 0;
+}
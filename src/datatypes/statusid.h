@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHashFunctions>
+#include <QString>
+
+#include <compare>
+
+/**
+ * @brief The id of a status.
+ *
+ * Mastodon uses 64-bit Snowflakes, which are stored as a number so they don't need an allocation of their own and compare
+ * cheaply. Other servers may use ids that aren't numbers (like the FlakeIds of Pleroma), those are kept as a string.
+ *
+ * Newer statuses have greater ids. Ids that aren't numbers are ordered by length first, and then alphabetically, which keeps
+ * the order of ids that are sortable as strings without getting confused by ids of different lengths.
+ */
+class StatusId
+{
+public:
+    StatusId() = default;
+    explicit StatusId(const QString &id);
+
+    /**
+     * @return Whether this is the id of no status.
+     */
+    [[nodiscard]] bool isEmpty() const;
+
+    /**
+     * @return Whether the id is stored as a number.
+     */
+    [[nodiscard]] bool isNumeric() const;
+
+    /**
+     * @return The id as it's used by the API.
+     */
+    [[nodiscard]] QString toString() const;
+
+    bool operator==(const StatusId &other) const = default;
+    std::strong_ordering operator<=>(const StatusId &other) const;
+
+private:
+    quint64 m_number = 0; ///< Zero if the id isn't a number
+    QString m_text; ///< Only set if the id isn't a number
+
+    friend size_t qHash(const StatusId &id, const size_t seed = 0)
+    {
+        return id.isNumeric() ? qHash(id.m_number, seed) : qHash(id.m_text, seed);
+    }
+};
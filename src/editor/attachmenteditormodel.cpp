@@ -7,6 +7,10 @@
 #include <QJsonDocument>
 
 #include "account/account.h"
+#include "editor/mediauploadjob.h"
+#include "network/networkcontroller.h"
+
+using namespace Qt::Literals::StringLiterals;
 
 AttachmentEditorModel::AttachmentEditorModel(QObject *parent, AbstractAccount *account)
     : QAbstractListModel(parent)
@@ -57,39 +61,92 @@ QHash<int, QByteArray> AttachmentEditorModel::roleNames() const
     };
 }
 
-QNetworkReply *AttachmentEditorModel::append(const QString &filename)
+void AttachmentEditorModel::append(const QString &filename)
 {
-    if (rowCount({}) >= m_account->maxMediaAttachments()) {
-        return nullptr;
+    if (rowCount({}) + m_uploads.size() >= m_account->maxMediaAttachments()) {
+        return;
     }
 
     QString localFilename = filename;
     localFilename.remove(QStringLiteral("file://"));
 
-    return m_account->upload(QUrl::fromLocalFile(localFilename), [this](QNetworkReply *reply) {
-        const auto doc = QJsonDocument::fromJson(reply->readAll());
+    startUpload(new MediaUploadJob(m_account, localFilename, m_saveDir.path(), this));
+}
 
-        if (!doc.isObject()) {
-            return;
-        }
+void AttachmentEditorModel::appendData(QVariant data)
+{
+    if (rowCount({}) + m_uploads.size() >= m_account->maxMediaAttachments()) {
+        return;
+    }
+
+    const auto image = data.value<QImage>();
+    if (image.isNull()) {
+        return;
+    }
+
+    // The image is encoded on a worker thread, depending on the instance limits
+    startUpload(new MediaUploadJob(m_account, image, m_saveDir.path(), this));
+}
+
+void AttachmentEditorModel::startUpload(MediaUploadJob *job)
+{
+    m_uploads.push_back(job);
+
+    auto finish = [this, job] {
+        m_uploads.removeOne(job);
+        job->deleteLater();
+        Q_EMIT uploadProgressChanged();
+    };
 
+    connect(job, &MediaUploadJob::progressChanged, this, &AttachmentEditorModel::uploadProgressChanged);
+    connect(job, &MediaUploadJob::uploaded, this, [this](const QJsonObject &object) {
         beginInsertRows({}, m_attachments.count(), m_attachments.count());
-        m_attachments.append(new Attachment{doc.object(), this});
+        m_attachments.append(new Attachment{object, this});
         endInsertRows();
         Q_EMIT countChanged();
     });
+    connect(job, &MediaUploadJob::processed, this, [this, finish](const QJsonObject &object) {
+        // Only the URLs change once processed, keep the description and focus the user may have set in the meantime
+        const auto id = object["id"_L1].toString();
+        for (int row = 0; row < m_attachments.size(); row++) {
+            auto attachment = m_attachments[row];
+            if (attachment->id() == id) {
+                attachment->m_url = object["url"_L1].toString();
+                attachment->m_preview_url = object["preview_url"_L1].toString();
+                attachment->m_remote_url = object["remote_url"_L1].toString();
+                Q_EMIT dataChanged(index(row, 0), index(row, 0), {PreviewRole});
+                break;
+            }
+        }
+        finish();
+    });
+    connect(job, &MediaUploadJob::failed, this, [finish](const QString &errorString) {
+        Q_EMIT NetworkController::instance().networkErrorOccurred(errorString);
+        finish();
+    });
+
+    Q_EMIT uploadProgressChanged();
+    job->start();
 }
 
-QNetworkReply *AttachmentEditorModel::appendData(QVariant data)
+bool AttachmentEditorModel::uploading() const
 {
-    const auto image = data.value<QImage>();
+    return !m_uploads.isEmpty();
+}
 
-    const QString tempPath = m_saveDir.filePath(QStringLiteral("%1.png").arg(QUuid::createUuid().toString()));
-    if (image.save(tempPath, "PNG")) {
-        return append(tempPath);
+int AttachmentEditorModel::uploadProgress() const
+{
+    qint64 sent = 0;
+    qint64 total = 0;
+    for (const auto job : std::as_const(m_uploads)) {
+        sent += job->bytesSent();
+        total += job->bytesTotal();
     }
 
-    return nullptr;
+    if (total <= 0) {
+        return 0;
+    }
+    return static_cast<int>(static_cast<double>(sent) / static_cast<double>(total) * 100.0);
 }
 
 void AttachmentEditorModel::appendExisting(Attachment *attachment)
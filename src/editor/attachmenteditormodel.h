@@ -13,18 +13,31 @@
 
 class QTimer;
 class AbstractAccount;
+class MediaUploadJob;
 
 class AttachmentEditorModel : public QAbstractListModel
 {
     Q_OBJECT
     Q_PROPERTY(int count READ count NOTIFY countChanged)
 
+    /**
+     * @brief Whether any attachment is still being prepared, uploaded or processed by the server.
+     */
+    Q_PROPERTY(bool uploading READ uploading NOTIFY uploadProgressChanged)
+
+    /**
+     * @brief The combined progress of all uploads, from 0 to 100.
+     */
+    Q_PROPERTY(int uploadProgress READ uploadProgress NOTIFY uploadProgressChanged)
+
 public:
     explicit AttachmentEditorModel(QObject *parent, AbstractAccount *account);
 
     enum ExtraRole { PreviewRole = Qt::UserRole + 1, DescriptionRole, FocalXRole, FocalYRole };
 
     [[nodiscard]] int count() const;
+    [[nodiscard]] bool uploading() const;
+    [[nodiscard]] int uploadProgress() const;
 
     Q_INVOKABLE [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
     [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
@@ -35,8 +48,8 @@ public:
     void copyFromArray(const QJsonArray &array);
 
 public Q_SLOTS:
-    QNetworkReply *append(const QString &fileName);
-    QNetworkReply *appendData(QVariant data);
+    void append(const QString &fileName);
+    void appendData(QVariant data);
     void appendExisting(Attachment *attachment);
     void removeAttachment(int row);
     void setDescription(int row, const QString &description);
@@ -50,10 +63,14 @@ public Q_SLOTS:
 Q_SIGNALS:
     void postChanged();
     void countChanged();
+    void uploadProgressChanged();
 
 private:
+    void startUpload(MediaUploadJob *job);
+
     QList<Attachment *> m_attachments;
     QHash<QString, QTimer *> m_updateTimers;
+    QList<MediaUploadJob *> m_uploads;
     AbstractAccount *m_account = nullptr;
 
     QTemporaryDir m_saveDir;
@@ -10,6 +10,7 @@
 
 #include "account/abstractaccount.h"
 #include "account/accountmanager.h"
+#include "account/filterengine.h"
 
 using namespace Qt::StringLiterals;
 
@@ -135,12 +136,15 @@ void FilterEditorBackend::submit()
     }
 
     // If the filterId is empty, then create a new list
+    // Apply the changed filter right away, without waiting for the stream to tell us about it
     if (m_filterId.isEmpty()) {
-        account->post(account->apiUrl(QStringLiteral("/api/v2/filters")), formdata, true, this, [this](QNetworkReply *) {
+        account->post(account->apiUrl(QStringLiteral("/api/v2/filters")), formdata, true, this, [this, account](QNetworkReply *) {
+            account->filterEngine()->refresh();
             Q_EMIT done();
         });
     } else {
-        account->put(account->apiUrl(QStringLiteral("/api/v2/filters/%1").arg(m_filterId)), formdata, true, this, [this](QNetworkReply *) {
+        account->put(account->apiUrl(QStringLiteral("/api/v2/filters/%1").arg(m_filterId)), formdata, true, this, [this, account](QNetworkReply *) {
+            account->filterEngine()->refresh();
             Q_EMIT done();
         });
     }
@@ -154,6 +158,7 @@ void FilterEditorBackend::deleteFilter()
 
     account->deleteResource(account->apiUrl(QStringLiteral("/api/v2/filters/%1").arg(m_filterId)), true, this, [this, account](QNetworkReply *) {
         account->removeFavoriteList(m_filterId);
+        account->filterEngine()->refresh();
         Q_EMIT done();
     });
 }
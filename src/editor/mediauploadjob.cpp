@@ -0,0 +1,347 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "editor/mediauploadjob.h"
+
+#include <cmath>
+
+#include <KLocalizedString>
+#include <QBuffer>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QJsonDocument>
+#include <QLocale>
+#include <QMimeDatabase>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QTimer>
+#include <QUuid>
+
+#include "account/abstractaccount.h"
+#include "network/networkcontroller.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+static constexpr int initialPollInterval = 1000;
+static constexpr int maxPollInterval = 8000;
+// About five minutes with the backoff, long videos can take a while
+static constexpr int maxPollAttempts = 40;
+
+static constexpr int initialJpegQuality = 90;
+static constexpr int minimumJpegQuality = 70;
+static constexpr int maxEncodeAttempts = 10;
+
+/**
+ * @brief Downscales and re-encodes an image to fit the instance limits, off the GUI thread.
+ */
+class MediaPrepareRunnable : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void done(const QString &fileName, const QString &errorString);
+
+public:
+    MediaPrepareRunnable(const QString &fileName,
+                         const QImage &image,
+                         const QString &workingDirectory,
+                         qint64 sizeLimit,
+                         qint64 matrixLimit,
+                         qint64 videoSizeLimit)
+        : m_fileName(fileName)
+        , m_image(image)
+        , m_workingDirectory(workingDirectory)
+        , m_sizeLimit(sizeLimit)
+        , m_matrixLimit(matrixLimit)
+        , m_videoSizeLimit(videoSizeLimit)
+    {
+    }
+
+    void run() override
+    {
+        QImage image = m_image;
+
+        if (image.isNull()) {
+            // Only still images are processed, animations, videos and audio are uploaded as is
+            const QMimeType mimeType = QMimeDatabase().mimeTypeForFile(m_fileName);
+
+            // Videos can't be made smaller here, and the server would only refuse them after the whole upload
+            const qint64 fileSize = QFileInfo(m_fileName).size();
+            if (mimeType.name().startsWith("video/"_L1) && m_videoSizeLimit > 0 && fileSize > m_videoSizeLimit) {
+                Q_EMIT done({},
+                            i18n("The video is %1, but the server only accepts videos up to %2",
+                                 QLocale().formattedDataSize(fileSize),
+                                 QLocale().formattedDataSize(m_videoSizeLimit)));
+                return;
+            }
+
+            if (!mimeType.name().startsWith("image/"_L1) || mimeType.name() == "image/gif"_L1) {
+                Q_EMIT done(m_fileName, {});
+                return;
+            }
+
+            QImageReader reader(m_fileName);
+            reader.setAutoTransform(true);
+
+            const QSize size = reader.size();
+            const bool animated = reader.supportsAnimation() && reader.imageCount() > 1;
+            const bool withinLimits = fileSize <= m_sizeLimit && pixelCount(size) <= m_matrixLimit;
+            if (!size.isValid() || animated || withinLimits) {
+                Q_EMIT done(m_fileName, {});
+                return;
+            }
+
+            image = reader.read();
+            if (image.isNull()) {
+                Q_EMIT done({}, i18n("Could not read the image: %1", reader.errorString()));
+                return;
+            }
+        }
+
+        const QSize targetSize = fitToMatrix(image.size());
+        if (targetSize != image.size()) {
+            image = image.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+
+        // Only keep PNG if we need the alpha channel, photos are way smaller as JPEG
+        const bool transparent = hasTransparency(image);
+        if (!transparent) {
+            image = image.convertToFormat(QImage::Format_RGB32);
+        }
+
+        int quality = initialJpegQuality;
+        for (int attempt = 0; attempt < maxEncodeAttempts; attempt++) {
+            QByteArray data;
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::WriteOnly);
+            if (!image.save(&buffer, transparent ? "PNG" : "JPEG", transparent ? -1 : quality)) {
+                break;
+            }
+
+            if (data.size() <= m_sizeLimit) {
+                const QString path = QDir(m_workingDirectory)
+                                         .filePath(QStringLiteral("%1.%2").arg(QUuid::createUuid().toString(QUuid::WithoutBraces),
+                                                                               transparent ? QStringLiteral("png") : QStringLiteral("jpg")));
+                QSaveFile file(path);
+                if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+                    Q_EMIT done({}, i18n("Could not save the image for uploading: %1", file.errorString()));
+                    return;
+                }
+
+                Q_EMIT done(path, {});
+                return;
+            }
+
+            // Lower the quality a bit first, then start shrinking the image
+            if (!transparent && quality > minimumJpegQuality) {
+                quality -= 10;
+            } else {
+                image = image.scaled(image.size() * 0.75, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
+        }
+
+        Q_EMIT done({}, i18n("The image is too large to upload"));
+    }
+
+private:
+    static qint64 pixelCount(const QSize &size)
+    {
+        return static_cast<qint64>(size.width()) * static_cast<qint64>(size.height());
+    }
+
+    QSize fitToMatrix(const QSize &size) const
+    {
+        if (m_matrixLimit <= 0 || pixelCount(size) <= m_matrixLimit) {
+            return size;
+        }
+
+        const double factor = std::sqrt(static_cast<double>(m_matrixLimit) / static_cast<double>(pixelCount(size)));
+        return {std::max(1, static_cast<int>(size.width() * factor)), std::max(1, static_cast<int>(size.height() * factor))};
+    }
+
+    static bool hasTransparency(const QImage &image)
+    {
+        if (!image.hasAlphaChannel()) {
+            return false;
+        }
+
+        // Lots of images (for example from the clipboard) have an alpha channel that is completely opaque
+        const QImage argb = image.convertToFormat(QImage::Format_ARGB32);
+        for (int y = 0; y < argb.height(); y++) {
+            const auto line = reinterpret_cast<const QRgb *>(argb.constScanLine(y));
+            for (int x = 0; x < argb.width(); x++) {
+                if (qAlpha(line[x]) != 255) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    QString m_fileName;
+    QImage m_image;
+    QString m_workingDirectory;
+    qint64 m_sizeLimit;
+    qint64 m_matrixLimit;
+    qint64 m_videoSizeLimit;
+};
+
+MediaUploadJob::MediaUploadJob(AbstractAccount *account, const QString &fileName, const QString &workingDirectory, QObject *parent)
+    : QObject(parent)
+    , m_account(account)
+    , m_fileName(fileName)
+    , m_workingDirectory(workingDirectory)
+    , m_pollInterval(initialPollInterval)
+    , m_maxPollInterval(maxPollInterval)
+    , m_pollAttemptsLeft(maxPollAttempts)
+{
+}
+
+MediaUploadJob::MediaUploadJob(AbstractAccount *account, const QImage &image, const QString &workingDirectory, QObject *parent)
+    : QObject(parent)
+    , m_account(account)
+    , m_image(image)
+    , m_workingDirectory(workingDirectory)
+    , m_pollInterval(initialPollInterval)
+    , m_maxPollInterval(maxPollInterval)
+    , m_pollAttemptsLeft(maxPollAttempts)
+{
+}
+
+QThreadPool *MediaUploadJob::pool()
+{
+    static QThreadPool pool;
+    return &pool;
+}
+
+void MediaUploadJob::start()
+{
+    const auto runnable = new MediaPrepareRunnable(m_fileName,
+                                                   m_image,
+                                                   m_workingDirectory,
+                                                   m_account->imageSizeLimit(),
+                                                   m_account->imageMatrixLimit(),
+                                                   m_account->videoSizeLimit());
+    connect(runnable, &MediaPrepareRunnable::done, this, [this](const QString &fileName, const QString &errorString) {
+        if (fileName.isEmpty()) {
+            fail(errorString);
+            return;
+        }
+        upload(fileName);
+    });
+    pool()->start(runnable);
+
+    // We don't need the image data anymore, and it can be big
+    m_image = {};
+}
+
+void MediaUploadJob::setPolling(const int interval, const int maxInterval, const int attempts)
+{
+    m_pollInterval = interval;
+    m_maxPollInterval = maxInterval;
+    m_pollAttemptsLeft = attempts;
+}
+
+qint64 MediaUploadJob::bytesSent() const
+{
+    return m_bytesSent;
+}
+
+qint64 MediaUploadJob::bytesTotal() const
+{
+    return m_bytesTotal;
+}
+
+void MediaUploadJob::upload(const QString &fileName)
+{
+    QPointer<MediaUploadJob> self(this);
+    auto reply = m_account->upload(QUrl::fromLocalFile(fileName), [self](QNetworkReply *reply) {
+        if (!self) {
+            return;
+        }
+
+        const auto doc = QJsonDocument::fromJson(reply->readAll());
+        if (!doc.isObject()) {
+            self->fail(i18n("The server sent an invalid response"));
+            return;
+        }
+
+        const auto attachment = doc.object();
+        Q_EMIT self->uploaded(attachment);
+
+        // 202 Accepted means the server is still processing the media, and it can't be attached to a post yet
+        if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 202 || attachment["url"_L1].isNull()) {
+            self->pollProcessing(attachment["id"_L1].toString());
+        } else {
+            Q_EMIT self->processed(attachment);
+        }
+    });
+
+    if (reply == nullptr) {
+        fail(i18n("Could not upload %1", QFileInfo(fileName).fileName()));
+        return;
+    }
+
+    connect(reply, &QNetworkReply::uploadProgress, this, [this](qint64 bytesSent, qint64 bytesTotal) {
+        m_bytesSent = bytesSent;
+        m_bytesTotal = bytesTotal;
+        Q_EMIT progressChanged();
+    });
+    connect(reply, &QNetworkReply::finished, this, [this, reply] {
+        // Already logged with the other network errors
+        if (reply->error() != QNetworkReply::NoError) {
+            Q_EMIT failed(reply->errorString());
+        }
+    });
+}
+
+void MediaUploadJob::pollProcessing(const QString &id)
+{
+    if (m_pollAttemptsLeft <= 0) {
+        fail(i18n("The server took too long to process the media"));
+        return;
+    }
+    m_pollAttemptsLeft--;
+
+    QTimer::singleShot(m_pollInterval, this, [this, id] {
+        QPointer<MediaUploadJob> self(this);
+        m_account->get(
+            m_account->apiUrl(QStringLiteral("/api/v1/media/%1").arg(id)),
+            true,
+            this,
+            [self, id](QNetworkReply *reply) {
+                if (!self) {
+                    return;
+                }
+
+                const auto attachment = QJsonDocument::fromJson(reply->readAll()).object();
+
+                // 206 Partial Content means the media is still being processed
+                if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 206 || attachment["url"_L1].isNull()) {
+                    self->m_pollInterval = std::min(self->m_pollInterval * 2, self->m_maxPollInterval);
+                    self->pollProcessing(id);
+                    return;
+                }
+
+                Q_EMIT self->processed(attachment);
+            },
+            [self](QNetworkReply *reply) {
+                if (self) {
+                    Q_EMIT self->failed(reply->errorString());
+                }
+            });
+    });
+}
+
+void MediaUploadJob::fail(const QString &errorString)
+{
+    NetworkController::instance().logError(m_account->apiUrl(QStringLiteral("/api/v2/media")).toString(), errorString);
+    Q_EMIT failed(errorString);
+}
+
+#include "mediauploadjob.moc"
+#include "moc_mediauploadjob.cpp"
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QImage>
+#include <QJsonObject>
+#include <QObject>
+
+class AbstractAccount;
+class QThreadPool;
+
+/**
+ * @brief Uploads a single media attachment.
+ *
+ * Still images that exceed the instance's @c media_attachments limits, as well as pasted image data, are downscaled
+ * and re-encoded on a worker thread first. The file is then uploaded to @c /api/v2/media, and if the server is still
+ * processing it (202 Accepted), the job polls the media until it can be attached to a post, giving up after a few minutes.
+ * Videos larger than the instance's @c video_size_limit are refused before uploading.
+ *
+ * Jobs are independent of each other, so several attachments are prepared and uploaded in parallel.
+ */
+class MediaUploadJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Uploads the local file @p fileName, temporary files are written to @p workingDirectory.
+     */
+    MediaUploadJob(AbstractAccount *account, const QString &fileName, const QString &workingDirectory, QObject *parent = nullptr);
+
+    /**
+     * @brief Uploads the image data @p image, for example pasted from the clipboard.
+     */
+    MediaUploadJob(AbstractAccount *account, const QImage &image, const QString &workingDirectory, QObject *parent = nullptr);
+
+    void start();
+
+    /**
+     * @brief Polls the media being processed after @p interval milliseconds, doubling up to @p maxInterval, and fails after @p attempts.
+     */
+    void setPolling(int interval, int maxInterval, int attempts);
+
+    [[nodiscard]] qint64 bytesSent() const;
+    [[nodiscard]] qint64 bytesTotal() const;
+
+Q_SIGNALS:
+    void progressChanged();
+
+    /**
+     * @brief The server received the media, but may still be processing it.
+     */
+    void uploaded(const QJsonObject &attachment);
+
+    /**
+     * @brief The media is ready to be attached to a post.
+     */
+    void processed(const QJsonObject &attachment);
+
+    /**
+     * @brief The media couldn't be uploaded, the error was already logged.
+     */
+    void failed(const QString &errorString);
+
+private:
+    void upload(const QString &fileName);
+    void pollProcessing(const QString &id);
+    // For the errors of the job itself, the network errors are logged by the account already
+    void fail(const QString &errorString);
+
+    static QThreadPool *pool();
+
+    AbstractAccount *const m_account;
+    QString m_fileName;
+    QImage m_image;
+    QString m_workingDirectory;
+    qint64 m_bytesSent = 0;
+    qint64 m_bytesTotal = 0;
+    int m_pollInterval;
+    int m_maxPollInterval;
+    int m_pollAttemptsLeft;
+};
@@ -35,16 +35,17 @@ void PostEditorBackend::setId(const QString &id)
 
 QString PostEditorBackend::status() const
 {
-    return m_status;
+    return m_statusMetrics.text();
 }
 
 void PostEditorBackend::setStatus(const QString &status)
 {
-    if (m_status == status) {
+    if (m_statusMetrics.text() == status) {
         return;
     }
-    m_status = status;
+    m_statusMetrics.setText(status);
     Q_EMIT statusChanged();
+    Q_EMIT charactersLeftChanged();
 }
 
 QString PostEditorBackend::spoilerText() const
@@ -58,7 +59,9 @@ void PostEditorBackend::setSpoilerText(const QString &spoilerText)
         return;
     }
     m_spoilerText = spoilerText;
+    m_spoilerTextLength = StatusTextMetrics::graphemeCount(spoilerText);
     Q_EMIT spoilerTextChanged();
+    Q_EMIT charactersLeftChanged();
 }
 
 QString PostEditorBackend::inReplyTo() const
@@ -162,6 +165,7 @@ void PostEditorBackend::setAccount(AbstractAccount *account)
     }
     m_account = account;
     Q_EMIT accountChanged();
+    Q_EMIT charactersLeftChanged();
 }
 
 void PostEditorBackend::setHasExistingPoll(bool hasExisting)
@@ -178,18 +182,14 @@ int PostEditorBackend::charactersLeft() const
         return 0;
     }
 
-    QRegularExpression re{QStringLiteral(R"((http|https):\/\/([\w_-]+(?:(?:\.[\w_-]+)+))([\w.,@?^=%&:\/~+#-]*[\w@?^=%&\/~+#-]))")};
-    re.setPatternOptions(QRegularExpression::DontCaptureOption);
-
-    const auto matches = re.match(m_status).capturedTexts();
-
-    // We want to accumulate each link, and then "add back" the characters you should
-    // have, taking the difference from charactersPreservedPerUrl.
-    const int sum = std::accumulate(matches.constBegin(), matches.constEnd(), 0, [this](int sum, const QString &link) {
-        return sum + link.length() - m_account->charactersReservedPerUrl();
-    });
+    // The content warning counts as well
+    const auto length = m_spoilerTextLength + m_statusMetrics.length(static_cast<qsizetype>(m_account->charactersReservedPerUrl()));
+    return static_cast<int>(static_cast<qsizetype>(m_account->maxPostLength()) - length);
+}
 
-    return m_account->maxPostLength() - m_status.length() + sum;
+const StatusTextMetrics &PostEditorBackend::statusMetrics() const
+{
+    return m_statusMetrics;
 }
 
 void PostEditorBackend::copyFromOther(PostEditorBackend *other)
@@ -228,7 +228,7 @@ QJsonDocument PostEditorBackend::toJsonDocument() const
     QJsonObject obj;
 
     obj["spoiler_text"_L1] = m_spoilerText;
-    obj["status"_L1] = m_status;
+    obj["status"_L1] = m_statusMetrics.text();
     obj["sensitive"_L1] = m_sensitive;
     obj["visibility"_L1] = Post::visibilityToString(m_visibility);
 
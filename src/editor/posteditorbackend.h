@@ -7,6 +7,7 @@
 
 #include "datatypes/post.h"
 #include "editor/polleditorbackend.h"
+#include "editor/statustextmetrics.h"
 
 class AttachmentEditorModel;
 
@@ -26,7 +27,7 @@ class PostEditorBackend : public QObject
     Q_PROPERTY(bool sensitive READ sensitive WRITE setSensitive NOTIFY sensitiveChanged)
     Q_PROPERTY(PollEditorBackend *poll MEMBER m_poll CONSTANT)
     Q_PROPERTY(bool pollEnabled MEMBER m_pollEnabled NOTIFY pollEnabledChanged)
-    Q_PROPERTY(int charactersLeft READ charactersLeft NOTIFY statusChanged)
+    Q_PROPERTY(int charactersLeft READ charactersLeft NOTIFY charactersLeftChanged)
 
     Q_PROPERTY(AbstractAccount *account READ account WRITE setAccount NOTIFY accountChanged)
 
@@ -68,8 +69,16 @@ public:
 
     void setHasExistingPoll(bool hasExisting);
 
+    /**
+     * @return How many characters are left before the status is too long, counted the same way as the server.
+     */
     [[nodiscard]] int charactersLeft() const;
 
+    /**
+     * @return The character count of the status, and its links, mentions and hashtags for highlighting them.
+     */
+    [[nodiscard]] const StatusTextMetrics &statusMetrics() const;
+
     Q_INVOKABLE void copyFromOther(PostEditorBackend *other);
 
     Q_INVOKABLE void setupReplyTo(Post *post);
@@ -105,15 +114,18 @@ Q_SIGNALS:
 
     void pollEnabledChanged();
 
+    void charactersLeftChanged();
+
     void scheduledPostLoaded();
 
 private:
     [[nodiscard]] QJsonDocument toJsonDocument() const;
 
     QString m_id;
-    QString m_status;
+    StatusTextMetrics m_statusMetrics;
     QString m_idenpotencyKey;
     QString m_spoilerText;
+    qsizetype m_spoilerTextLength = 0;
     QString m_inReplyTo;
     QString m_language;
     QDateTime m_scheduledAt;
@@ -0,0 +1,337 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "editor/statustextmetrics.h"
+
+#include <QTextBoundaryFinder>
+
+using namespace Qt::Literals::StringLiterals;
+
+static bool isWordCharacter(const QChar character)
+{
+    return character.isLetterOrNumber() || character.isMark() || character.category() == QChar::Punctuation_Connector;
+}
+
+static bool isAsciiLetterOrNumber(const QChar character)
+{
+    return character.unicode() < 128 && character.isLetterOrNumber();
+}
+
+// Whether the character at index is part of the grapheme cluster before it
+static bool continuesGrapheme(const QStringView text, const qsizetype index)
+{
+    char32_t codePoint = text[index].unicode();
+    if (text[index].isLowSurrogate()) {
+        return true;
+    }
+    if (text[index].isHighSurrogate() && index + 1 < text.size() && text[index + 1].isLowSurrogate()) {
+        codePoint = QChar::surrogateToUcs4(text[index], text[index + 1]);
+    }
+
+    // Combining marks, joiners, emoji modifiers and tags
+    return QChar::isMark(codePoint) || codePoint == 0x200D || (codePoint >= 0x1F3FB && codePoint <= 0x1F3FF)
+        || (codePoint >= 0xE0020 && codePoint <= 0xE007F);
+}
+
+// Whether a grapheme cluster starts at index and no token spans it, which is the case after whitespace
+static bool isBoundary(const QStringView text, const qsizetype index)
+{
+    if (index == 0 || index == text.size()) {
+        return true;
+    }
+    const QChar previous = text[index - 1];
+    return previous.isSpace() && previous != u'\r' && !continuesGrapheme(text, index);
+}
+
+// The same links as Mastodon, which only counts the ones with a protocol
+static qsizetype matchUrl(const QStringView text, const qsizetype index)
+{
+    if (index > 0) {
+        const QChar previous = text[index - 1];
+        if (isAsciiLetterOrNumber(previous) || u"@$#\uFF20\uFF03"_s.contains(previous)) {
+            return 0;
+        }
+    }
+
+    const auto rest = text.sliced(index);
+    qsizetype position = index;
+    if (rest.startsWith(u"https://", Qt::CaseInsensitive)) {
+        position += 8;
+    } else if (rest.startsWith(u"http://", Qt::CaseInsensitive)) {
+        position += 7;
+    } else {
+        return 0;
+    }
+
+    const auto isDomainCharacter = [](const QChar character) {
+        return character.isLetterOrNumber() || character == u'-' || character == u'_';
+    };
+
+    qsizetype end = position;
+    int labels = 0;
+    while (true) {
+        const qsizetype labelStart = position;
+        while (position < text.size() && isDomainCharacter(text[position])) {
+            position++;
+        }
+        if (position == labelStart) {
+            break;
+        }
+        labels++;
+        end = position;
+        if (position < text.size() && text[position] == u'.') {
+            position++;
+        } else {
+            break;
+        }
+    }
+    if (labels < 2) {
+        return 0;
+    }
+
+    if (end + 1 < text.size() && text[end] == u':' && text[end + 1].isDigit()) {
+        end++;
+        while (end < text.size() && text[end].isDigit()) {
+            end++;
+        }
+    }
+
+    if (end < text.size() && u"/?#"_s.contains(text[end])) {
+        const qsizetype pathStart = end;
+        int openParentheses = 0;
+        int closeParentheses = 0;
+        while (end < text.size() && !text[end].isSpace() && !u"<>\"{}\\^`"_s.contains(text[end])) {
+            if (text[end] == u'(') {
+                openParentheses++;
+            } else if (text[end] == u')') {
+                closeParentheses++;
+            }
+            end++;
+        }
+
+        // Punctuation after a link is part of the sentence, unless it closes a parenthesis of the link
+        while (end > pathStart) {
+            const QChar last = text[end - 1];
+            if (last.isLetterOrNumber() || last.isMark() || u"/=_#+-&"_s.contains(last)) {
+                break;
+            }
+            if (last == u')' && closeParentheses <= openParentheses) {
+                break;
+            }
+            if (last == u')') {
+                closeParentheses--;
+            } else if (last == u'(') {
+                openParentheses--;
+            }
+            end--;
+        }
+    }
+
+    return end - index;
+}
+
+// Like Mastodon, a mention can have a domain, and it can't be followed by something that would make it part of a longer word
+static qsizetype matchMention(const QStringView text, const qsizetype index)
+{
+    if (text[index] != u'@') {
+        return 0;
+    }
+    if (index > 0 && (text[index - 1] == u'/' || isWordCharacter(text[index - 1]))) {
+        return 0;
+    }
+
+    const auto isUsernameCharacter = [](const QChar character) {
+        return isAsciiLetterOrNumber(character) || character == u'_';
+    };
+
+    const qsizetype usernameStart = index + 1;
+    if (usernameStart >= text.size() || !isUsernameCharacter(text[usernameStart])) {
+        return 0;
+    }
+    qsizetype end = usernameStart;
+    while (end < text.size() && (isUsernameCharacter(text[end]) || text[end] == u'.' || text[end] == u'-')) {
+        end++;
+    }
+    while (!isUsernameCharacter(text[end - 1])) {
+        end--;
+    }
+
+    if (end < text.size() && text[end] == u'@') {
+        const qsizetype domainStart = end + 1;
+        qsizetype domainEnd = domainStart;
+        while (domainEnd < text.size() && (isWordCharacter(text[domainEnd]) || text[domainEnd] == u'.' || text[domainEnd] == u'-')) {
+            domainEnd++;
+        }
+        while (domainEnd > domainStart && !isWordCharacter(text[domainEnd - 1])) {
+            domainEnd--;
+        }
+        if (domainEnd - domainStart >= 2) {
+            end = domainEnd;
+        }
+    }
+
+    if (end < text.size()) {
+        const QChar next = text[end];
+        if (next == u'@' || next == u'\uFF20' || next.isLetter() || text.sliced(end).startsWith(u"://")) {
+            return 0;
+        }
+    }
+
+    return end - index;
+}
+
+static qsizetype matchHashtag(const QStringView text, const qsizetype index)
+{
+    if (text[index] != u'#') {
+        return 0;
+    }
+    if (index > 0 && (text[index - 1].isLetterOrNumber() || u"=/)"_s.contains(text[index - 1]))) {
+        return 0;
+    }
+
+    // Middle dots and zero width non-joiners may separate words in a hashtag, but can't end it
+    const auto isSeparator = [](const QChar character) {
+        return character == u'\u00B7' || character == u'\u30FB' || character == u'\u200C';
+    };
+
+    qsizetype end = index + 1;
+    bool hasLetter = false;
+    while (end < text.size() && (isWordCharacter(text[end]) || isSeparator(text[end]))) {
+        hasLetter = hasLetter || text[end].isLetter();
+        end++;
+    }
+    while (end > index + 1 && isSeparator(text[end - 1])) {
+        end--;
+    }
+
+    return hasLetter ? end - index : 0;
+}
+
+void StatusTextMetrics::setText(const QString &text)
+{
+    const qsizetype oldSize = m_text.size();
+    const qsizetype newSize = text.size();
+    const qsizetype commonSize = std::min(oldSize, newSize);
+
+    const qsizetype prefix = std::mismatch(m_text.cbegin(), m_text.cbegin() + commonSize, text.cbegin()).first - m_text.cbegin();
+    if (prefix == oldSize && prefix == newSize) {
+        return;
+    }
+    const qsizetype suffix =
+        std::mismatch(m_text.crbegin(), m_text.crbegin() + (commonSize - prefix), text.crbegin()).first - m_text.crbegin();
+
+    // Look again from the whitespace before the edit to the whitespace after it. Both are outside the edit, so they're the same in the
+    // old and new text.
+    qsizetype from = std::max<qsizetype>(prefix - 2, 0);
+    while (!isBoundary(m_text, from)) {
+        from--;
+    }
+    qsizetype tail = std::max<qsizetype>(suffix - 1, 0);
+    while (!isBoundary(text, newSize - tail)) {
+        tail--;
+    }
+    const qsizetype oldTo = oldSize - tail;
+    const qsizetype newTo = newSize - tail;
+
+    const auto byStart = [](const Token &token, const qsizetype position) {
+        return token.start < position;
+    };
+    const qsizetype first = std::lower_bound(m_tokens.cbegin(), m_tokens.cend(), from, byStart) - m_tokens.cbegin();
+    const qsizetype last = std::lower_bound(m_tokens.cbegin() + first, m_tokens.cend(), oldTo, byStart) - m_tokens.cbegin();
+
+    const auto oldCount = count(m_text, from, oldTo, m_tokens.sliced(first, last - first));
+    const auto newTokens = tokenize(text, from, newTo);
+    const auto newCount = count(text, from, newTo, newTokens);
+
+    auto after = m_tokens.sliced(last);
+    for (auto &token : after) {
+        token.start += newSize - oldSize;
+    }
+    m_tokens = m_tokens.first(first) + newTokens + after;
+
+    m_count.characters += newCount.characters - oldCount.characters;
+    m_count.urls += newCount.urls - oldCount.urls;
+    m_text = text;
+}
+
+const QString &StatusTextMetrics::text() const
+{
+    return m_text;
+}
+
+qsizetype StatusTextMetrics::length(const qsizetype charactersPerUrl) const
+{
+    return m_count.characters + m_count.urls * charactersPerUrl;
+}
+
+const QList<StatusTextMetrics::Token> &StatusTextMetrics::tokens() const
+{
+    return m_tokens;
+}
+
+qsizetype StatusTextMetrics::graphemeCount(const QStringView text)
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Grapheme, text.data(), text.size());
+    qsizetype count = 0;
+    while (finder.toNextBoundary() != -1) {
+        count++;
+    }
+    return count;
+}
+
+QList<StatusTextMetrics::Token> StatusTextMetrics::tokenize(const QString &text, const qsizetype from, const qsizetype to)
+{
+    const auto view = QStringView(text).first(to);
+
+    QList<Token> tokens;
+    qsizetype position = from;
+    while (position < to) {
+        Token token{.start = position};
+        if ((token.length = matchUrl(view, position)) > 0) {
+            token.type = Token::Url;
+        } else if ((token.length = matchMention(view, position)) > 0) {
+            token.type = Token::Mention;
+        } else if ((token.length = matchHashtag(view, position)) > 0) {
+            token.type = Token::Hashtag;
+        } else {
+            position++;
+            continue;
+        }
+
+        tokens.append(token);
+        position += token.length;
+    }
+    return tokens;
+}
+
+StatusTextMetrics::Count StatusTextMetrics::count(const QString &text, const qsizetype from, const qsizetype to, const QList<Token> &tokens)
+{
+    const auto view = QStringView(text);
+
+    Count result;
+    qsizetype position = from;
+    for (const auto &token : tokens) {
+        // Hashtags count like any other text
+        if (token.type == Token::Hashtag) {
+            continue;
+        }
+
+        result.characters += graphemeCount(view.sliced(position, token.start - position));
+        if (token.type == Token::Url) {
+            result.urls++;
+        } else {
+            // Only the username of a mention counts, with its @
+            const auto mention = view.sliced(token.start, token.length);
+            const auto domain = mention.indexOf(u'@', 1);
+            result.characters += domain == -1 ? mention.size() : domain;
+        }
+        position = token.start + token.length;
+    }
+    result.characters += graphemeCount(view.sliced(position, to - position));
+
+    return result;
+}
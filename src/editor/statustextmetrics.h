@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Counts the characters of a status the way Mastodon does, and finds its links, mentions and hashtags.
+ *
+ * Mastodon counts grapheme clusters instead of UTF-16 code units, so an emoji is one character. Every link counts as a fixed number
+ * of characters no matter how long it is, and a mention of a remote account only counts its username.
+ *
+ * Links, mentions and hashtags never contain whitespace, so the text is only looked at again from the whitespace before an edit to
+ * the whitespace after it. Typing in a long status then only costs as much as the word being typed.
+ */
+class StatusTextMetrics
+{
+public:
+    /**
+     * @brief A link, mention or hashtag in the text.
+     */
+    struct Token {
+        enum Type : quint8 {
+            Url,
+            Mention,
+            Hashtag,
+        };
+
+        Type type = Url;
+        qsizetype start = 0;
+        qsizetype length = 0;
+
+        bool operator==(const Token &other) const = default;
+    };
+
+    /**
+     * @brief Changes the text, only tokenizing and counting the part that changed.
+     */
+    void setText(const QString &text);
+
+    /**
+     * @return The text.
+     */
+    [[nodiscard]] const QString &text() const;
+
+    /**
+     * @return The number of characters the server counts, with every link counting as @p charactersPerUrl.
+     */
+    [[nodiscard]] qsizetype length(qsizetype charactersPerUrl) const;
+
+    /**
+     * @return The links, mentions and hashtags in the text, in order.
+     */
+    [[nodiscard]] const QList<Token> &tokens() const;
+
+    /**
+     * @return The number of grapheme clusters in @p text.
+     */
+    [[nodiscard]] static qsizetype graphemeCount(QStringView text);
+
+private:
+    struct Count {
+        qsizetype characters = 0; ///< Without the links
+        qsizetype urls = 0;
+    };
+
+    /**
+     * @brief Finds the tokens of @p text between @p from and @p to, which must both be whitespace boundaries.
+     */
+    [[nodiscard]] static QList<Token> tokenize(const QString &text, qsizetype from, qsizetype to);
+
+    /**
+     * @return How much the part of @p text between @p from and @p to counts for, given its @p tokens.
+     */
+    [[nodiscard]] static Count count(const QString &text, qsizetype from, qsizetype to, const QList<Token> &tokens);
+
+    QString m_text;
+    QList<Token> m_tokens;
+    Count m_count;
+};
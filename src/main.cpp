@@ -37,9 +37,14 @@
 #include "config.h"
 #include "network/networkaccessmanagerfactory.h"
 #include "network/networkcontroller.h"
+#include "network/networkrecorder.h"
 #include "tokodon_debug.h"
 #include "utils/blurhashimageprovider.h"
 #include "utils/colorschemer.h"
+#include "utils/mediaimageprovider.h"
+#include "utils/metrics.h"
+#include "utils/startuptrace.h"
+#include "utils/tracing.h"
 
 #ifdef TEST_MODE
 #include "autotests/helperreply.h"
@@ -53,6 +58,14 @@ Q_DECL_EXPORT
 #endif
 int main(int argc, char *argv[])
 {
+    StartupTrace::start();
+
+    // Set from the environment so that even the first phases are in the trace
+    if (const auto traceFileName = qEnvironmentVariable("TOKODON_TRACE"); !traceFileName.isEmpty()) {
+        Tracing::start(traceFileName);
+    }
+    const qint64 setupStart = Tracing::now();
+
     QNetworkProxyFactory::setUseSystemConfiguration(true);
 
 #ifdef HAVE_WEBVIEW
@@ -108,10 +121,42 @@ int main(int argc, char *argv[])
     notifyOption.setFlags(QCommandLineOption::Flag::HiddenFromHelp);
     parser.addOption(notifyOption);
 
+    QCommandLineOption traceOption(QStringLiteral("trace"),
+                                   i18n("Record where the time goes to a file in the Chrome trace format, which is written when quitting."),
+                                   QStringLiteral("file"));
+    parser.addOption(traceOption);
+
+    QCommandLineOption metricsOption(QStringLiteral("metrics"),
+                                     i18n("Write the runtime metrics, like request latencies, to a JSON file when quitting."),
+                                     QStringLiteral("file"));
+    parser.addOption(metricsOption);
+
+    QCommandLineOption recordNetworkOption(QStringLiteral("record-network"),
+                                           i18n("Record the network traffic to replay it in tests and benchmarks. The recording is written to the file when quitting."),
+                                           QStringLiteral("file"));
+    parser.addOption(recordNetworkOption);
+
     about.setupCommandLine(&parser);
     parser.process(app);
     about.processCommandLine(&parser);
 
+    if (parser.isSet(traceOption) && !Tracing::isRecording()) {
+        Tracing::start(parser.value(traceOption));
+    }
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, &Tracing::stop);
+    if (parser.isSet(recordNetworkOption)) {
+        NetworkRecorder::instance().start(parser.value(recordNetworkOption));
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [] {
+            NetworkRecorder::instance().stop();
+        });
+    }
+    if (parser.isSet(metricsOption)) {
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [fileName = parser.value(metricsOption)] {
+            Metrics::instance().writeTo(fileName);
+        });
+    }
+    Tracing::complete("startup", u"application setup"_s, setupStart);
+
 #ifdef HAVE_KUNIFIEDPUSH
     if (parser.isSet(notifyOption)) {
         qCInfo(TOKODON_LOG) << "Beginning to check for notifications...";
@@ -182,7 +227,10 @@ int main(int argc, char *argv[])
     NetworkAccessManagerFactory namFactory;
     engine.setNetworkAccessManagerFactory(&namFactory);
 
+    const qint64 loadStart = Tracing::now();
+
     engine.addImageProvider(QLatin1String("blurhash"), new BlurHashImageProvider);
+    engine.addImageProvider(QLatin1String("media"), new MediaImageProvider);
 
 #ifdef TEST_MODE
     AccountManager::instance().setTestMode(true);
@@ -211,6 +259,9 @@ int main(int argc, char *argv[])
     Q_UNUSED(NetworkController::instance());
 #endif
 
+    Tracing::complete("startup", u"loading accounts"_s, loadStart);
+
+    const qint64 qmlStart = Tracing::now();
     if (parser.isSet(shareOption)) {
         kapp.start("org.kde.tokodon", "StandaloneComposer", &engine);
 
@@ -223,6 +274,8 @@ int main(int argc, char *argv[])
         }
     }
 
+    Tracing::complete("startup", u"loading the interface"_s, qmlStart);
+
     if (engine.rootObjects().isEmpty()) {
         return -1;
     }
@@ -0,0 +1,304 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "network/networkrecorder.h"
+
+#include "tokodon_debug.h"
+#include "utils/messagefiltercontainer.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QNetworkReply>
+#include <QSaveFile>
+#include <QUrlQuery>
+
+using namespace Qt::Literals::StringLiterals;
+
+// Bumped when the format changes in a way older readers can't handle
+static constexpr int formatVersion = 1;
+
+// The headers the models look at, the others only make the recording bigger
+static const QList<QByteArray> recordedHeaders = {
+    QByteArrayLiteral("Content-Type"),
+    QByteArrayLiteral("Link"),
+    QByteArrayLiteral("X-RateLimit-Limit"),
+    QByteArrayLiteral("X-RateLimit-Remaining"),
+    QByteArrayLiteral("X-RateLimit-Reset"),
+};
+
+static QByteArray operationName(const QNetworkReply *reply)
+{
+    switch (reply->operation()) {
+    case QNetworkAccessManager::HeadOperation:
+        return QByteArrayLiteral("HEAD");
+    case QNetworkAccessManager::GetOperation:
+        return QByteArrayLiteral("GET");
+    case QNetworkAccessManager::PutOperation:
+        return QByteArrayLiteral("PUT");
+    case QNetworkAccessManager::PostOperation:
+        return QByteArrayLiteral("POST");
+    case QNetworkAccessManager::DeleteOperation:
+        return QByteArrayLiteral("DELETE");
+    default:
+        return reply->request().attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+    }
+}
+
+// Never recorded as is, even before the account knows them and registers them as filters, like in the reply to /oauth/token
+static const QStringList secretKeys = {
+    u"access_token"_s,
+    u"refresh_token"_s,
+    u"client_secret"_s,
+};
+
+// The credentials the client sends, in case they ever end up in recordedHeaders
+static const QList<QByteArray> secretHeaders = {
+    QByteArrayLiteral("Authorization"),
+    QByteArrayLiteral("Proxy-Authorization"),
+};
+
+// Replaces the access tokens and client secrets, which are never supposed to leave the device
+static QString scrub(const QString &text)
+{
+    return QMessageFilterContainer::self()->filter(text);
+}
+
+// Replaces the values of the secret keys, the same way the filters do
+static bool redactSecrets(QJsonValue &value)
+{
+    bool redacted = false;
+    if (value.isObject()) {
+        auto object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            if (secretKeys.contains(it.key()) && it.value().isString()) {
+                it.value() = it.key().toUpper();
+                redacted = true;
+            } else if (QJsonValue child = it.value(); redactSecrets(child)) {
+                it.value() = child;
+                redacted = true;
+            }
+        }
+        value = object;
+    } else if (value.isArray()) {
+        auto array = value.toArray();
+        for (auto it = array.begin(); it != array.end(); ++it) {
+            if (QJsonValue child = *it; redactSecrets(child)) {
+                *it = child;
+                redacted = true;
+            }
+        }
+        value = array;
+    }
+    return redacted;
+}
+
+static QByteArray scrubBody(const QByteArray &body)
+{
+    const QByteArray scrubbed = scrub(QString::fromUtf8(body)).toUtf8();
+
+    const auto document = QJsonDocument::fromJson(scrubbed);
+    if (document.isNull()) {
+        return scrubbed;
+    }
+
+    QJsonValue value = document.isObject() ? QJsonValue(document.object()) : QJsonValue(document.array());
+    if (!redactSecrets(value)) {
+        // Left as it was sent
+        return scrubbed;
+    }
+    const QJsonDocument redacted = value.isObject() ? QJsonDocument(value.toObject()) : QJsonDocument(value.toArray());
+    return redacted.toJson(QJsonDocument::Compact);
+}
+
+static QUrl scrubUrl(const QUrl &url)
+{
+    QUrl scrubbed(scrub(url.toString()));
+    scrubbed.setPassword({});
+
+    QUrlQuery query(scrubbed);
+    auto items = query.queryItems(QUrl::FullyEncoded);
+    bool redacted = false;
+    for (auto &[key, value] : items) {
+        if (secretKeys.contains(key) && value != key.toUpper()) {
+            value = key.toUpper();
+            redacted = true;
+        }
+    }
+    // Only rewritten when needed, so the query stays the same as the one the replay is matched with
+    if (redacted) {
+        query.setQueryItems(items);
+        scrubbed.setQuery(query);
+    }
+    return scrubbed;
+}
+
+std::optional<NetworkRecording> NetworkRecording::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(TOKODON_LOG) << "Couldn't read the network recording" << fileName << file.errorString();
+        return std::nullopt;
+    }
+
+    const auto object = QJsonDocument::fromJson(file.readAll()).object();
+    if (object["version"_L1].toInt() != formatVersion) {
+        qCWarning(TOKODON_LOG) << "Unsupported network recording" << fileName;
+        return std::nullopt;
+    }
+    return fromJson(object);
+}
+
+NetworkRecording NetworkRecording::fromJson(const QJsonObject &object)
+{
+    NetworkRecording recording;
+
+    const auto exchanges = object["exchanges"_L1].toArray();
+    for (const auto &value : exchanges) {
+        const auto exchangeObj = value.toObject();
+
+        Exchange exchange{
+            .operation = exchangeObj["operation"_L1].toString().toLatin1(),
+            .url = QUrl(exchangeObj["url"_L1].toString()),
+            .statusCode = exchangeObj["status"_L1].toInt(),
+            .body = exchangeObj["body"_L1].toString().toUtf8(),
+            .start = exchangeObj["start"_L1].toInteger(),
+            .duration = exchangeObj["duration"_L1].toInteger(),
+        };
+        const auto headers = exchangeObj["headers"_L1].toObject();
+        for (const auto &[name, headerValue] : headers.asKeyValueRange()) {
+            exchange.headers.append({name.toString().toLatin1(), headerValue.toString().toLatin1()});
+        }
+        recording.exchanges.append(exchange);
+    }
+
+    const auto frames = object["frames"_L1].toArray();
+    for (const auto &value : frames) {
+        recording.frames.append({
+            .time = value["time"_L1].toInteger(),
+            .message = value["message"_L1].toString(),
+        });
+    }
+
+    return recording;
+}
+
+QJsonObject NetworkRecording::toJson() const
+{
+    QJsonArray exchangesArray;
+    for (const auto &exchange : exchanges) {
+        QJsonObject headersObj;
+        for (const auto &[name, value] : exchange.headers) {
+            headersObj[QString::fromLatin1(name)] = QString::fromLatin1(value);
+        }
+
+        exchangesArray.append(QJsonObject{
+            {u"operation"_s, QString::fromLatin1(exchange.operation)},
+            {u"url"_s, exchange.url.toString()},
+            {u"status"_s, exchange.statusCode},
+            {u"headers"_s, headersObj},
+            {u"body"_s, QString::fromUtf8(exchange.body)},
+            {u"start"_s, exchange.start},
+            {u"duration"_s, exchange.duration},
+        });
+    }
+
+    QJsonArray framesArray;
+    for (const auto &frame : frames) {
+        framesArray.append(QJsonObject{
+            {u"time"_s, frame.time},
+            {u"message"_s, frame.message},
+        });
+    }
+
+    return {
+        {u"version"_s, formatVersion},
+        {u"exchanges"_s, exchangesArray},
+        {u"frames"_s, framesArray},
+    };
+}
+
+NetworkRecorder &NetworkRecorder::instance()
+{
+    static NetworkRecorder recorder;
+    return recorder;
+}
+
+void NetworkRecorder::start(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    m_fileName = fileName;
+    m_recording = {};
+    m_timer.start();
+    m_isRecording = true;
+
+    qCDebug(TOKODON_LOG) << "Recording the network traffic to" << fileName;
+}
+
+void NetworkRecorder::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_isRecording) {
+        return;
+    }
+    m_isRecording = false;
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(TOKODON_LOG) << "Couldn't write the network recording to" << m_fileName << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(m_recording.toJson()).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qCWarning(TOKODON_LOG) << "Couldn't write the network recording to" << m_fileName << file.errorString();
+    }
+    m_recording = {};
+}
+
+bool NetworkRecorder::isRecording() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_isRecording;
+}
+
+qint64 NetworkRecorder::elapsed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_isRecording ? m_timer.elapsed() : 0;
+}
+
+void NetworkRecorder::recordReply(QNetworkReply *reply, const qint64 start)
+{
+    NetworkRecording::Exchange exchange{
+        .operation = operationName(reply),
+        .url = scrubUrl(reply->url()),
+        .statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+        // Peeking leaves the body for the callbacks to read
+        .body = scrubBody(reply->peek(reply->bytesAvailable())),
+        .start = start,
+    };
+    for (const auto &header : recordedHeaders) {
+        if (reply->hasRawHeader(header)) {
+            const QByteArray value = secretHeaders.contains(header) ? QByteArrayLiteral("REDACTED") : scrub(QString::fromLatin1(reply->rawHeader(header))).toLatin1();
+            exchange.headers.append({header, value});
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_isRecording) {
+        return;
+    }
+    exchange.duration = m_timer.elapsed() - start;
+    m_recording.exchanges.append(exchange);
+}
+
+void NetworkRecorder::recordStreamingMessage(const QString &message)
+{
+    const auto scrubbedMessage = QString::fromUtf8(scrubBody(message.toUtf8()));
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_isRecording) {
+        return;
+    }
+    m_recording.frames.append({.time = m_timer.elapsed(), .message = scrubbedMessage});
+}
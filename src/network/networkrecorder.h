@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMutex>
+#include <QUrl>
+
+#include <optional>
+
+class QNetworkReply;
+
+/**
+ * @brief The requests and streaming messages of a session, as recorded by NetworkRecorder.
+ */
+struct NetworkRecording {
+    /**
+     * @brief A request and its reply.
+     */
+    struct Exchange {
+        QByteArray operation; ///< The HTTP method, like GET
+        QUrl url;
+        int statusCode = 0;
+        QList<std::pair<QByteArray, QByteArray>> headers;
+        QByteArray body;
+        qint64 start = 0; ///< When the request was made in milliseconds after the recording started
+        qint64 duration = 0; ///< How long the reply took in milliseconds
+    };
+
+    /**
+     * @brief A message received on the streaming connection.
+     */
+    struct Frame {
+        qint64 time = 0; ///< In milliseconds after the recording started
+        QString message;
+    };
+
+    QList<Exchange> exchanges;
+    QList<Frame> frames;
+
+    /**
+     * @return The recording written to @p fileName, or nothing if it can't be read.
+     */
+    [[nodiscard]] static std::optional<NetworkRecording> load(const QString &fileName);
+
+    [[nodiscard]] static NetworkRecording fromJson(const QJsonObject &object);
+    [[nodiscard]] QJsonObject toJson() const;
+};
+
+/**
+ * @brief Records the requests and streaming messages of every account, to replay them in tests and benchmarks later.
+ *
+ * Start Tokodon with --record-network and a file name, and the recording is written to it when quitting. Access tokens and client
+ * secrets are replaced in the recording, like they are in the logs. The values of the access_token, refresh_token and client_secret
+ * keys are always replaced too, even before the account registered them to be filtered.
+ * @see ReplayAccount
+ */
+class NetworkRecorder
+{
+public:
+    static NetworkRecorder &instance();
+
+    /**
+     * @brief Starts recording, the recording is written to @p fileName by stop().
+     */
+    void start(const QString &fileName);
+
+    /**
+     * @brief Stops recording and writes the recording, if it was started.
+     */
+    void stop();
+
+    [[nodiscard]] bool isRecording() const;
+
+    /**
+     * @return The time since the recording started in milliseconds.
+     */
+    [[nodiscard]] qint64 elapsed() const;
+
+    /**
+     * @brief Records the finished @p reply to a request made at @p start, as returned by elapsed(). The reply can still be read after this.
+     */
+    void recordReply(QNetworkReply *reply, qint64 start);
+
+    /**
+     * @brief Records the streaming @p message that was just received.
+     */
+    void recordStreamingMessage(const QString &message);
+
+private:
+    NetworkRecorder() = default;
+
+    mutable QMutex m_mutex;
+    bool m_isRecording = false;
+    QString m_fileName;
+    QElapsedTimer m_timer;
+    NetworkRecording m_recording;
+};
@@ -5,6 +5,8 @@
 
 #include "notification/notificationgroupingmodel.h"
 
+#include "utils/tracing.h"
+
 NotificationGroupingModel::NotificationGroupingModel(QObject *parent)
     : QAbstractProxyModel(parent)
 {
@@ -94,6 +96,8 @@ void NotificationGroupingModel::adjustMap(int anchor, int delta)
 
 void NotificationGroupingModel::rebuildMap()
 {
+    const Tracing::Scope trace("model", "NotificationGroupingModel::rebuildMap");
+
     qDeleteAll(rowMap);
     rowMap.clear();
 
@@ -110,6 +114,8 @@ void NotificationGroupingModel::rebuildMap()
 
 void NotificationGroupingModel::checkGrouping(bool silent)
 {
+    const Tracing::Scope trace("model", "NotificationGroupingModel::checkGrouping");
+
     for (int i = (rowMap.count()) - 1; i >= 0; --i) {
         if (isGroup(i)) {
             continue;
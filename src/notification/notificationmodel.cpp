@@ -5,6 +5,8 @@
 #include "notification/notificationmodel.h"
 
 #include "account/abstractaccount.h"
+#include "account/markersync.h"
+#include "account/poststore.h"
 #include "networkcontroller.h"
 #include "texthandler.h"
 
@@ -24,7 +26,7 @@ NotificationModel::NotificationModel(QObject *parent)
             m_account = account;
 
             beginResetModel();
-            m_notifications.clear();
+            clearNotifications();
             endResetModel();
 
             fillTimeline();
@@ -33,7 +35,7 @@ NotificationModel::NotificationModel(QObject *parent)
 
     connect(this, &NotificationModel::excludeTypesChanged, this, [this] {
         beginResetModel();
-        m_notifications.clear();
+        clearNotifications();
         endResetModel();
         m_next = {};
         setLoading(false);
@@ -246,6 +248,16 @@ bool NotificationModel::canFetchMore(const QModelIndex &parent) const
     return !loading() && m_next.has_value();
 }
 
+QDateTime NotificationModel::relativeTimeSource(const QModelIndex &index) const
+{
+    return m_notifications[index.row()]->createdAt();
+}
+
+FilterEngine::Context NotificationModel::filterContext() const
+{
+    return FilterEngine::NotificationsContext;
+}
+
 int NotificationModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
@@ -380,11 +392,12 @@ void NotificationModel::actionDelete(const QModelIndex &index)
     AbstractTimelineModel::actionDelete(index, p);
 
     for (auto &notification : m_notifications) {
-        if (notification->post() != nullptr && notification->post()->postId() == p->postId()) {
+        if (notification->post() != nullptr && notification->post()->statusId() == p->statusId()) {
             int row = m_notifications.indexOf(notification);
             beginRemoveRows({}, row, row);
-            m_notifications.removeOne(notification);
+            const auto removed = m_notifications.takeAt(row);
             endRemoveRows();
+            PostStore::release(removed->post(), this);
             break;
         }
     }
@@ -420,7 +433,9 @@ void NotificationModel::fetchLastReadId()
         [this](QNetworkReply *reply) {
             const auto doc = QJsonDocument::fromJson(reply->readAll());
 
-            m_lastReadId = doc.object()[QLatin1String("notifications")].toObject()[QLatin1String("last_read_id")].toString();
+            // A marker that wasn't sent yet may be newer
+            m_account->markerSync()->setServerMarkers(doc.object());
+            m_lastReadId = m_account->markerSync()->lastReadId(QStringLiteral("notifications"));
             m_fetchedLastReadId = true;
             Q_EMIT readMarkerChanged();
 
@@ -436,4 +451,12 @@ void NotificationModel::fetchLastReadId()
         });
 }
 
+void NotificationModel::clearNotifications()
+{
+    for (const auto &notification : std::as_const(m_notifications)) {
+        PostStore::release(notification->post(), this);
+    }
+    m_notifications.clear();
+}
+
 #include "moc_notificationmodel.cpp"
@@ -119,8 +119,15 @@ Q_SIGNALS:
 protected:
     void fetchMore(const QModelIndex &parent) override;
     [[nodiscard]] bool canFetchMore(const QModelIndex &parent) const override;
+    [[nodiscard]] QDateTime relativeTimeSource(const QModelIndex &index) const override;
+    [[nodiscard]] FilterEngine::Context filterContext() const override;
     void fetchLastReadId();
 
+    /**
+     * @brief Removes all notifications, and releases their posts.
+     */
+    void clearNotifications();
+
     QString m_timelineName;
     AccountManager *m_manager = nullptr;
 
@@ -172,13 +172,15 @@ Kirigami.Page {
                     model: AccountMediaTimelineModel {
                         accountId: accountInfo.accountId
                         tagged: accountInfo.selectedTag
+                        // The image provider is asked for the size in device pixels, which can fall into another cache bucket
+                        thumbnailSize: Qt.size(gridView.cellSize * Screen.devicePixelRatio, gridView.cellSize * Screen.devicePixelRatio)
                     }
 
                     delegate: Item {
                         id: imageDelegate
 
                         required property string postId
-                        required property string source
+                        required property url thumbnail
                         required property url tempSource
                         required property real focusX
                         required property real focusY
@@ -193,7 +195,8 @@ Kirigami.Page {
 
                             anchors.fill: parent
 
-                            source: imageDelegate.source
+                            source: imageDelegate.thumbnail
+                            requestedSize: Qt.size(gridView.cellSize, gridView.cellSize)
                             focusX: imageDelegate.focusX
                             focusY: imageDelegate.focusY
                         }
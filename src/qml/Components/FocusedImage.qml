@@ -15,6 +15,7 @@ Rectangle {
 
     property alias source: image.source
     property size sourceSize
+    property alias requestedSize: image.sourceSize
     property alias status: image.status
 
     property bool crop: true
@@ -31,7 +32,8 @@ Rectangle {
 
         // The aspect ratio of the image (before it's cropped).
         readonly property real aspectRatio: {
-            let size = root.sourceSize !== Qt.size(-1, -1) && root.sourceSize !== Qt.size(0, 0) ? root.sourceSize : image.sourceSize;
+            // image.sourceSize only reports the requested size once it is set, so use the size of the loaded image instead
+            let size = root.sourceSize !== Qt.size(-1, -1) && root.sourceSize !== Qt.size(0, 0) ? root.sourceSize : Qt.size(image.implicitWidth, image.implicitHeight);
             return size.width / Math.max(size.height, 1);
         }
 
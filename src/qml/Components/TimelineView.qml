@@ -82,6 +82,18 @@ ListView {
         }
     }
 
+    // Keeps the interaction counts of the posts in view up to date, they only change live for edited posts otherwise
+    Timer {
+        interval: 2 * 60 * 1000
+        repeat: true
+        running: root.isCurrentPage && Config.showPostStats && Qt.application.state === Qt.ApplicationActive
+        onTriggered: {
+            const firstRow = root.indexAt(root.width / 2, root.contentY);
+            const lastRow = root.indexAt(root.width / 2, root.contentY + root.height - 1);
+            root.model.refreshStatuses(firstRow === -1 ? 0 : firstRow, lastRow === -1 ? root.count - 1 : lastRow);
+        }
+    }
+
     readonly property Kirigami.Action postAction: Kirigami.Action {
         icon.name: "document-edit-symbolic"
         text: i18nc("@action:button", "Create Post")
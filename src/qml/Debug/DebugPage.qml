@@ -8,8 +8,24 @@ import org.kde.kirigamiaddons.formcard as FormCard
 import org.kde.tokodon
 
 MastoPage {
+    id: root
+
+    // Bumped every second while the page is shown, so the metrics are read again
+    property int metricsRevision: 0
+
+    function formatBytes(bytes: real): string {
+        return Qt.locale().formattedDataSize(bytes);
+    }
+
     title: "Debug"
 
+    Timer {
+        interval: 1000
+        repeat: true
+        running: root.visible
+        onTriggered: root.metricsRevision++
+    }
+
     FormCard.FormHeader {
         title: "Alerts"
     }
@@ -85,4 +101,101 @@ MastoPage {
             onClicked: AccountManager.selectedAccount.unknownNotification()
         }
     }
+
+    FormCard.FormHeader {
+        title: "Metrics"
+    }
+
+    FormCard.FormCard {
+        FormCard.FormTextDelegate {
+            text: "Requests"
+            description: {
+                root.metricsRevision;
+                return Metrics.counter("network.requests") + " (" + Metrics.counter("network.errors") + " failed)";
+            }
+        }
+
+        FormCard.FormTextDelegate {
+            text: "Received / sent"
+            description: {
+                root.metricsRevision;
+                return root.formatBytes(Metrics.counter("network.bytesReceived")) + " / " + root.formatBytes(Metrics.counter("network.bytesSent"));
+            }
+        }
+
+        FormCard.FormTextDelegate {
+            text: "Streaming connections"
+            description: {
+                root.metricsRevision;
+                return Metrics.gauge("streaming.connections");
+            }
+        }
+
+        FormCard.FormTextDelegate {
+            text: "Cached identities"
+            description: {
+                root.metricsRevision;
+                const lookups = Metrics.counter("identities.lookups");
+                const hitRate = lookups > 0 ? Math.round(100 * Metrics.counter("identities.hits") / lookups) : 0;
+                return Metrics.gauge("identities.cached") + " (" + hitRate + "% hit rate)";
+            }
+        }
+
+        FormCard.FormTextDelegate {
+            text: "Posts"
+            description: {
+                root.metricsRevision;
+                return Metrics.gauge("posts.alive");
+            }
+        }
+
+        FormCard.FormTextDelegate {
+            text: "Image cache"
+            description: {
+                root.metricsRevision;
+                return root.formatBytes(Metrics.gauge("media.cacheBytes")) + " (" + Metrics.gauge("media.decodeQueue") + " waiting to be decoded)";
+            }
+        }
+
+        Repeater {
+            model: {
+                root.metricsRevision;
+                return Metrics.names("rows.");
+            }
+
+            delegate: FormCard.FormTextDelegate {
+                required property string modelData
+
+                text: modelData.substring("rows.".length) + " rows"
+                description: {
+                    root.metricsRevision;
+                    return Metrics.gauge(modelData);
+                }
+            }
+        }
+    }
+
+    FormCard.FormHeader {
+        title: "Latency (p50 / p95)"
+    }
+
+    FormCard.FormCard {
+        Repeater {
+            model: {
+                root.metricsRevision;
+                return Metrics.names("network.latency");
+            }
+
+            delegate: FormCard.FormTextDelegate {
+                required property string modelData
+
+                text: modelData.substring("network.latency".length)
+                description: {
+                    root.metricsRevision;
+                    return Math.round(Metrics.percentile(modelData, 50)) + " ms / " + Math.round(Metrics.percentile(modelData, 95)) + " ms ("
+                        + Metrics.sampleCount(modelData) + " requests)";
+                }
+            }
+        }
+    }
 }
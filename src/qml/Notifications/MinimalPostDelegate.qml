@@ -29,6 +29,8 @@ QQC2.ItemDelegate {
     required property var notificationActorIdentity
 
     required property string content
+    required property string renderedContent
+    required property string plainContent
     required property string spoilerText
     required property string relativeTime
     required property var attachments
@@ -197,6 +199,8 @@ QQC2.ItemDelegate {
                 id: postContent
 
                 content: root.content
+                renderedContent: root.renderedContent
+                plainContent: root.plainContent
                 expandedPost: false
                 secondary: true
                 visible: root.spoilerText.length === 0 || AccountManager.selectedAccount.preferences.extendSpoiler
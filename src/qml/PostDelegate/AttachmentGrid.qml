@@ -155,7 +155,7 @@ Item {
                             id: img
 
                             anchors.fill: parent
-                            source: imgContainer.modelData.previewUrl
+                            source: imgContainer.modelData.thumbnailSource
 
                             onStatusChanged: {
                                 if (status === Image.Error) {
@@ -14,6 +14,9 @@ QQC2.Label {
     id: root
 
     required property string content
+    // Precomputed by the timeline models, see Post::renderedContent and Post::plainContent
+    property string renderedContent
+    property string plainContent
     required property bool expandedPost
     required property bool secondary
     required property bool shouldOpenInternalLinks
@@ -27,10 +30,10 @@ QQC2.Label {
     property string clickedUrl: ""
 
     Accessible.name: i18nc("@info", "Post content")
-    Accessible.description: TextHandler.stripHtml(root.content)
+    Accessible.description: root.plainContent.length > 0 ? root.plainContent : TextHandler.stripHtml(root.content)
 
     activeFocusOnTab: true
-    text: TextHandler.fixBidirectionality(root.content, Config.defaultFont)
+    text: root.renderedContent.length > 0 ? root.renderedContent : TextHandler.fixBidirectionality(root.content, Config.defaultFont)
     Layout.fillWidth: true
     textFormat: TextEdit.RichText
     wrapMode: TextEdit.Wrap
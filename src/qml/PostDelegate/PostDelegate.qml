@@ -48,6 +48,8 @@ QQC2.ItemDelegate {
     required property bool pinned
 
     required property string content
+    required property string renderedContent
+    required property string plainContent
     required property string spoilerText
     required property string relativeTime
     required property string absoluteTime
@@ -324,6 +326,8 @@ QQC2.ItemDelegate {
                 id: postContent
 
                 content: root.content
+                renderedContent: root.renderedContent
+                plainContent: root.plainContent
                 expandedPost: root.expandedPost
                 secondary: root.secondary
                 visible: root.spoilerText.length === 0 || AccountManager.selectedAccount.preferences.extendSpoiler
@@ -113,6 +113,8 @@ QQC2.AbstractButton {
                 id: postContent
 
                 content: root.post.content
+                renderedContent: root.post.renderedContent
+                plainContent: root.post.plainContent
                 expandedPost: false
                 secondary: false
                 visible: root.post.spoilerText.length === 0 || AccountManager.selectedAccount.preferences.extendSpoiler
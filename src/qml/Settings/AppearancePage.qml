@@ -81,6 +81,20 @@ FormCard.FormCardPage {
 
         FormCard.FormDelegateSeparator {}
 
+        FormCard.FormSwitchDelegate {
+            id: deferStreamedPostsDelegate
+            text: i18n("Wait before showing new posts")
+            description: i18n("If checked, new posts are not added to the timeline as they come in. Instead, a button shows how many are waiting.")
+            checked: Config.deferStreamedPosts
+            enabled: Config.autoUpdate && !Config.deferStreamedPostsImmutable
+            onToggled: {
+                Config.deferStreamedPosts = checked
+                Config.save()
+            }
+        }
+
+        FormCard.FormDelegateSeparator {}
+
         FormCard.FormSwitchDelegate {
             id: askBeforeBoostingDelegate
             text: i18nc("@option:check Boosting means to repost, or retweet", "Ask before boosting")
@@ -57,6 +57,8 @@ Kirigami.ScrollablePage {
             notificationActorIdentity: null
 
             spoilerText: ""
+            renderedContent: ""
+            plainContent: ""
             relativeTime: ""
             poll: null
             selected: false
@@ -33,7 +33,6 @@ Kirigami.ScrollablePage {
     property var mentions: []
     property int visibility: AccountManager.selectedAccount.preferences.defaultVisibility
     property int sensitive: AccountManager.selectedAccount.preferences.defaultSensitive
-    readonly property NetworkRequestProgress progress: NetworkRequestProgress {}
     property var previewPost: null
     property string initialText
     property bool closeApplicationWhenFinished: false
@@ -265,11 +264,11 @@ Kirigami.ScrollablePage {
     }
 
     function uploadFile(url: string): void {
-        progress.reply = backend.attachmentEditorModel.append(url);
+        backend.attachmentEditorModel.append(url);
     }
 
     function uploadData(data: var): void {
-        progress.reply = backend.attachmentEditorModel.appendData(data);
+        backend.attachmentEditorModel.appendData(data);
     }
 
     function pasteImage(): bool {
@@ -428,9 +427,10 @@ Kirigami.ScrollablePage {
                     Layout.fillWidth: true
                     from: 0
                     to: 100
-                    visible: progress.uploading
-                    value: progress.progress
-                    indeterminate: progress.progress === 100 && progress.uploading
+                    visible: root.backend.attachmentEditorModel.uploading
+                    value: root.backend.attachmentEditorModel.uploadProgress
+                    // Still being prepared, or already uploaded and processed by the server
+                    indeterminate: root.backend.attachmentEditorModel.uploadProgress === 0 || root.backend.attachmentEditorModel.uploadProgress === 100
                     Layout.leftMargin: Kirigami.Units.smallSpacing
                     Layout.rightMargin: Kirigami.Units.smallSpacing
                 }
@@ -728,7 +728,7 @@ Kirigami.ScrollablePage {
 
                 icon.name: root.purposeIconName()
                 text: root.purposeString()
-                enabled: root.isStatusValid && root.isPollValid && (!progress.uploading || backend.attachmentEditorModel.count > 0)
+                enabled: root.isStatusValid && root.isPollValid && !backend.attachmentEditorModel.uploading
                 Layout.alignment: Qt.AlignRight
                 onClicked: {
                     if (!backend.attachmentEditorModel.isAltTextComplete()) {
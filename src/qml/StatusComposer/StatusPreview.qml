@@ -39,6 +39,8 @@ ColumnLayout {
 
         sourceComponent: PostDelegate.PostContent {
             content: post.content
+            renderedContent: post.renderedContent
+            plainContent: post.plainContent
             expandedPost: false
             secondary: true
             shouldOpenInternalLinks: false
@@ -33,6 +33,13 @@ Kirigami.ScrollablePage {
 
     Keys.onPressed: event => listview.handleKeyEvent(event)
 
+    // Only keep the timeline live while it can be seen
+    Binding {
+        target: root.model
+        property: "active"
+        value: root.visible
+    }
+
     title: {
         // Show the account name if the drawer is not open, so there's no way to tell which account you're on.
         if (model.name === "home" && !applicationWindow().globalDrawer.drawerOpen) {
@@ -105,6 +112,15 @@ Kirigami.ScrollablePage {
     }
 
     actions: [
+        Kirigami.Action {
+            icon.name: "arrow-up-symbolic"
+            text: i18ncp("@action:intoolbar", "%1 New Post", "%1 New Posts", root.model.newPostsCount ?? 0)
+            visible: (root.model.newPostsCount ?? 0) > 0
+            onTriggered: {
+                root.model.showNewPosts();
+                root.returnToTop();
+            }
+        },
         Kirigami.Action {
             id: filterAction
             text: i18nc("@action:button", "Filters")
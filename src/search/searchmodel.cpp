@@ -4,6 +4,7 @@
 #include "search/searchmodel.h"
 
 #include "account/account.h"
+#include "account/poststore.h"
 #include "networkcontroller.h"
 
 #include <KLocalizedString>
@@ -63,7 +64,7 @@ void SearchModel::search(const QString &queryString, const QString &type, const
             clear();
 
             std::ranges::transform(std::as_const(statuses), std::back_inserter(m_statuses), [this](const QJsonValue &value) -> auto {
-                return new Post(m_account, value.toObject(), this);
+                return m_account->postStore()->acquire(value.toObject(), this);
             });
             const auto accounts = searchResult[QStringLiteral("accounts")].toArray();
             std::ranges::transform(std::as_const(accounts), std::back_inserter(m_accounts), [this](const QJsonValue &value) -> auto {
@@ -137,8 +138,7 @@ QVariant SearchModel::data(const QModelIndex &index, int role) const
 void SearchModel::clear()
 {
     m_accounts.clear();
-    qDeleteAll(m_statuses);
-    m_statuses.clear();
+    PostStore::release(std::exchange(m_statuses, {}), this);
     m_hashtags.clear();
     setLoading(false);
     setLoaded(false);
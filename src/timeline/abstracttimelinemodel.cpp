@@ -6,14 +6,68 @@
 #include <QJsonDocument>
 
 #include "account/abstractaccount.h"
+#include "account/poststore.h"
+#include "config.h"
 #include "editor/attachmenteditormodel.h"
 #include "editor/posteditorbackend.h"
+#include "utils/metrics.h"
+#include "utils/relativetimeclock.h"
 
 using namespace Qt::Literals::StringLiterals;
 
 AbstractTimelineModel::AbstractTimelineModel(QObject *parent)
     : QAbstractListModel(parent)
 {
+    // The rendered content depends on the content font, posts only render it again if the font actually changed
+    connect(Config::self(), &Config::configChanged, this, [this] {
+        const int rows = rowCount({});
+        if (rows > 0) {
+            Q_EMIT dataChanged(index(0, 0), index(rows - 1, 0), {RenderedContentRole});
+        }
+    });
+
+    RelativeTimeClock::instance().track(this, RelativeTimeRole, [this](const QModelIndex &index) {
+        return relativeTimeSource(index);
+    });
+
+    connect(&AccountManager::instance(), &AccountManager::postUpdated, this, &AbstractTimelineModel::refreshPost);
+
+    const auto invalidatePostRows = [this] {
+        m_postRowsValid = false;
+    };
+    connect(this, &QAbstractItemModel::rowsInserted, this, invalidatePostRows);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, invalidatePostRows);
+    connect(this, &QAbstractItemModel::rowsMoved, this, invalidatePostRows);
+    connect(this, &QAbstractItemModel::modelReset, this, invalidatePostRows);
+    connect(this, &QAbstractItemModel::layoutChanged, this, invalidatePostRows);
+    connect(this, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &, const QModelIndex &, const QList<int> &roles) {
+        if (roles.isEmpty() || roles.contains(PostRole)) {
+            m_postRowsValid = false;
+        }
+    });
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &AbstractTimelineModel::updateRowCountMetric);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &AbstractTimelineModel::updateRowCountMetric);
+    connect(this, &QAbstractItemModel::modelReset, this, &AbstractTimelineModel::updateRowCountMetric);
+}
+
+AbstractTimelineModel::~AbstractTimelineModel()
+{
+    if (m_reportedRowCount != 0) {
+        Metrics::instance().addToGauge(m_rowCountMetric, -m_reportedRowCount);
+    }
+}
+
+void AbstractTimelineModel::updateRowCountMetric()
+{
+    // Not known in the constructor yet, where the subclass isn't constructed
+    if (m_rowCountMetric.isEmpty()) {
+        m_rowCountMetric = u"rows."_s + QString::fromLatin1(metaObject()->className());
+    }
+
+    const int rows = rowCount({});
+    Metrics::instance().addToGauge(m_rowCountMetric, rows - m_reportedRowCount);
+    m_reportedRowCount = rows;
 }
 
 bool AbstractTimelineModel::loading() const
@@ -37,6 +91,8 @@ QHash<int, QByteArray> AbstractTimelineModel::roleNames() const
         {OriginalIdRole, QByteArrayLiteral("originalId")},
         {UrlRole, QByteArrayLiteral("url")},
         {ContentRole, QByteArrayLiteral("content")},
+        {RenderedContentRole, QByteArrayLiteral("renderedContent")},
+        {PlainContentRole, QByteArrayLiteral("plainContent")},
         {SpoilerTextRole, QByteArrayLiteral("spoilerText")},
         {AuthorIdentityRole, QByteArrayLiteral("authorIdentity")},
         {PublishedAtRole, QByteArrayLiteral("publishedAt")},
@@ -93,6 +149,89 @@ QHash<int, QByteArray> AbstractTimelineModel::roleNames() const
     };
 }
 
+QDateTime AbstractTimelineModel::relativeTimeSource(const QModelIndex &index) const
+{
+    return data(index, PublishedAtRole).toDateTime();
+}
+
+FilterEngine::Context AbstractTimelineModel::filterContext() const
+{
+    return FilterEngine::PublicContext;
+}
+
+void AbstractTimelineModel::refreshStatuses(const int firstRow, const int lastRow)
+{
+    if (m_account == nullptr) {
+        return;
+    }
+
+    QList<StatusId> statusIds;
+    for (int row = std::max(firstRow, 0); row <= std::min(lastRow, rowCount({}) - 1); row++) {
+        const auto post = data(index(row, 0), PostRole).value<Post *>();
+        if (post != nullptr && !statusIds.contains(post->statusId())) {
+            statusIds.append(post->statusId());
+        }
+    }
+
+    QStringList postIds;
+    std::ranges::transform(std::as_const(statusIds), std::back_inserter(postIds), [](const StatusId &id) {
+        return id.toString();
+    });
+
+    if (!postIds.isEmpty()) {
+        m_account->refreshStatuses(postIds);
+    }
+}
+
+void AbstractTimelineModel::refreshPost(Post *post, const Post::Changes changes)
+{
+    if (m_account != nullptr && post->account() != m_account) {
+        return;
+    }
+
+    // Only notify about what actually changed, refreshing counts shouldn't relayout the whole post
+    QList<int> roles;
+    if (changes.testFlag(Post::ContentChange)) {
+        roles << ContentRole << RenderedContentRole << PlainContentRole << SpoilerTextRole << SensitiveRole << WasEditedRole << EditedAtRole
+              << AttachmentsRole << CardRole << PollRole << MentionsRole << StandaloneTagsRole << HasContentRole << FiltersRole;
+    }
+    if (changes.testFlag(Post::CountsChange)) {
+        roles << ReblogsCountRole << RepliesCountRole << FavouritesCountRole << QuotesCountRole;
+    }
+    if (changes.testFlag(Post::InteractionsChange)) {
+        roles << FavouritedRole << RebloggedRole << MutedRole << BookmarkedRole << PinnedRole;
+    }
+    if (changes.testFlag(Post::FiltersChange) && !roles.contains(FiltersRole)) {
+        roles << FiltersRole;
+    }
+    if (roles.isEmpty()) {
+        return;
+    }
+
+    // A post can be shown more than once, for example in a thread and as the post a notification is about
+    const auto rows = rowsOf(post);
+    for (const int row : rows) {
+        const auto postIndex = index(row, 0);
+        Q_EMIT dataChanged(postIndex, postIndex, roles);
+    }
+}
+
+QList<int> AbstractTimelineModel::rowsOf(const Post *post)
+{
+    if (!m_postRowsValid) {
+        m_postRows.clear();
+        const int rows = rowCount({});
+        for (int row = 0; row < rows; row++) {
+            if (const auto rowPost = index(row, 0).data(PostRole).value<Post *>()) {
+                m_postRows.insert(rowPost, row);
+            }
+        }
+        m_postRowsValid = true;
+    }
+
+    return m_postRows.values(post);
+}
+
 QVariant AbstractTimelineModel::postData(Post *post, int role) const
 {
     switch (role) {
@@ -104,6 +243,10 @@ QVariant AbstractTimelineModel::postData(Post *post, int role) const
         return post->mentions();
     case ContentRole:
         return post->content();
+    case RenderedContentRole:
+        return post->renderedContent();
+    case PlainContentRole:
+        return post->plainContent();
     case AuthorIdentityRole:
         return QVariant::fromValue<Identity *>(post->authorIdentity().get());
     case IsBoostedRole:
@@ -150,7 +293,7 @@ QVariant AbstractTimelineModel::postData(Post *post, int role) const
     case EditedAtRole:
         return post->editedAt();
     case FiltersRole:
-        return post->filters();
+        return post->filters(filterContext());
     case AttachmentsRole:
         return QVariant::fromValue<QList<Attachment *>>(post->attachments());
     case CardRole:
@@ -194,6 +337,8 @@ QVariant AbstractTimelineModel::postData(Post *post, int role) const
 
 void AbstractTimelineModel::actionFavorite(const QModelIndex &index, Post *post)
 {
+    // The rows showing the post are refreshed by PostStore::postUpdated()
+    Q_UNUSED(index);
     if (!post->favourited()) {
         m_account->favorite(post);
         post->setFavourited(true);
@@ -201,12 +346,11 @@ void AbstractTimelineModel::actionFavorite(const QModelIndex &index, Post *post)
         m_account->unfavorite(post);
         post->setFavourited(false);
     }
-
-    Q_EMIT dataChanged(index, index, {FavouritedRole, FavouritesCountRole});
 }
 
 void AbstractTimelineModel::actionRepeat(const QModelIndex &index, Post *post)
 {
+    Q_UNUSED(index);
     if (!post->reblogged()) {
         m_account->repeat(post);
         post->setReblogged(true);
@@ -214,8 +358,6 @@ void AbstractTimelineModel::actionRepeat(const QModelIndex &index, Post *post)
         m_account->unrepeat(post);
         post->setReblogged(false);
     }
-
-    Q_EMIT dataChanged(index, index, {RebloggedRole, ReblogsCountRole});
 }
 
 void AbstractTimelineModel::actionRedraft(const QModelIndex &index, Post *post, bool isEdit)
@@ -249,9 +391,9 @@ void AbstractTimelineModel::actionRedraft(const QModelIndex &index, Post *post,
                        }
 
                        if (isEdit) {
-                           connect(backend, &PostEditorBackend::editComplete, this, [this, post, index](QJsonObject object) {
-                               post->fromJson(std::move(object));
-                               Q_EMIT dataChanged(index, index);
+                           connect(backend, &PostEditorBackend::editComplete, this, [this](const QJsonObject &object) {
+                               // Updates the post wherever it's shown
+                               m_account->postStore()->update(QJsonArray{object});
                            });
                        }
                    });
@@ -259,6 +401,7 @@ void AbstractTimelineModel::actionRedraft(const QModelIndex &index, Post *post,
 
 void AbstractTimelineModel::actionBookmark(const QModelIndex &index, Post *post)
 {
+    Q_UNUSED(index);
     if (!post->bookmarked()) {
         m_account->bookmark(post);
         post->setBookmarked(true);
@@ -266,12 +409,11 @@ void AbstractTimelineModel::actionBookmark(const QModelIndex &index, Post *post)
         m_account->unbookmark(post);
         post->setBookmarked(false);
     }
-
-    Q_EMIT dataChanged(index, index, {BookmarkedRole});
 }
 
 void AbstractTimelineModel::actionPin(const QModelIndex &index, Post *post)
 {
+    Q_UNUSED(index);
     if (!post->pinned()) {
         m_account->pin(post);
         post->setPinned(true);
@@ -279,8 +421,6 @@ void AbstractTimelineModel::actionPin(const QModelIndex &index, Post *post)
         m_account->unpin(post);
         post->setPinned(false);
     }
-
-    Q_EMIT dataChanged(index, index, {PinnedRole});
 }
 
 void AbstractTimelineModel::actionDelete(const QModelIndex &index, Post *post)
@@ -291,6 +431,7 @@ void AbstractTimelineModel::actionDelete(const QModelIndex &index, Post *post)
 
 void AbstractTimelineModel::actionMute(const QModelIndex &index, Post *post)
 {
+    Q_UNUSED(index);
     if (!post->muted()) {
         m_account->mute(post);
         post->setMuted(true);
@@ -298,8 +439,6 @@ void AbstractTimelineModel::actionMute(const QModelIndex &index, Post *post)
         m_account->unmute(post);
         post->setMuted(false);
     }
-
-    Q_EMIT dataChanged(index, index, {MutedRole});
 }
 
 #include "moc_abstracttimelinemodel.cpp"
@@ -5,6 +5,8 @@
 
 #include "account/accountmanager.h"
 
+#include <QMultiHash>
+
 class AbstractAccount;
 class PostEditorBackend;
 
@@ -82,10 +84,14 @@ public:
 
         ShowReadMarkerRole, /** Show the read marker above this post */
 
+        RenderedContentRole, /** Content text of the post, ready to be displayed. See Post::renderedContent. */
+        PlainContentRole, /** Content text of the post without any markup. See Post::plainContent. */
+
         ExtraRole, /** Base role for sub-class roles. */
     };
 
     explicit AbstractTimelineModel(QObject *parent = nullptr);
+    ~AbstractTimelineModel() override;
 
     [[nodiscard]] QHash<int, QByteArray> roleNames() const override;
 
@@ -150,6 +156,11 @@ public:
         return false;
     }
 
+    /**
+     * @brief Fetch the latest version of the posts from @p firstRow to @p lastRow, to keep their interaction counts up to date.
+     */
+    Q_INVOKABLE void refreshStatuses(int firstRow, int lastRow);
+
 Q_SIGNALS:
     /**
      * @brief Emitted when the timeline loading status has changed.
@@ -172,6 +183,40 @@ Q_SIGNALS:
 protected:
     QVariant postData(Post *post, int role) const;
 
+    /**
+     * @return The time RelativeTimeRole of the row at @p index is based on. Defaults to PublishedAtRole.
+     */
+    [[nodiscard]] virtual QDateTime relativeTimeSource(const QModelIndex &index) const;
+
+    /**
+     * @return Which filters apply to the posts of this model. Defaults to the public context.
+     */
+    [[nodiscard]] virtual FilterEngine::Context filterContext() const;
+
+    /**
+     * @brief Refreshes the rows showing @p post, if it's a post of this model's account.
+     * @see PostStore::postUpdated()
+     */
+    virtual void refreshPost(Post *post, Post::Changes changes);
+
+    /**
+     * @return The rows showing @p post.
+     */
+    [[nodiscard]] QList<int> rowsOf(const Post *post);
+
     AbstractAccount *m_account = nullptr;
     bool m_loading = false;
+
+private:
+    void updateRowCountMetric();
+
+    /**
+     * @brief Every post update is seen by every model, so the rows of each post are looked up instead of going over all rows.
+     * The index is built again the first time it's needed after rows were inserted, removed or moved.
+     */
+    QMultiHash<const Post *, int> m_postRows;
+    bool m_postRowsValid = false;
+
+    QString m_rowCountMetric;
+    qint64 m_reportedRowCount = 0;
 };
@@ -3,13 +3,20 @@
 
 #include "timeline/accountmediatimelinemodel.h"
 
+#include "utils/mediacache.h"
+
 #include <KLocalizedString>
 #include <QJsonDocument>
 #include <QNetworkReply>
 #include <QUrlQuery>
 
+#include <algorithm>
+
 using namespace Qt::StringLiterals;
 
+// Roughly two screens worth of grid rows
+static constexpr int prefetchDistance = 24;
+
 AccountMediaTimelineModel::AccountMediaTimelineModel(QObject *parent)
     : AbstractListModel(parent)
 {
@@ -17,6 +24,10 @@ AccountMediaTimelineModel::AccountMediaTimelineModel(QObject *parent)
         reset();
         fillTimeline();
     });
+    // Thumbnails decoded for another size are no use, so prefetch again from where the view is
+    connect(this, &AccountMediaTimelineModel::thumbnailSizeChanged, this, [this] {
+        m_prefetchedUntil = -1;
+    });
 }
 
 QString AccountMediaTimelineModel::displayName() const
@@ -116,6 +127,8 @@ void AccountMediaTimelineModel::fillTimeline(const QString &fromId)
             beginInsertRows({}, 0, attachments.size() - 1);
             m_timeline = attachments;
             endInsertRows();
+
+            prefetchFrom(-1);
         }
 
         setLoading(false);
@@ -146,6 +159,9 @@ QVariant AccountMediaTimelineModel::data(const QModelIndex &index, int role) con
         return post.sensitive;
     case AttachmentRole:
         return QVariant::fromValue(post.attachment);
+    case ThumbnailRole:
+        prefetchFrom(index.row());
+        return post.attachment->thumbnailSource();
     }
     return {};
 }
@@ -166,6 +182,7 @@ QHash<int, QByteArray> AccountMediaTimelineModel::roleNames() const
         {FocusYRole, QByteArrayLiteral("focusY")},
         {SensitiveRole, QByteArrayLiteral("sensitive")},
         {AttachmentRole, QByteArrayLiteral("attachment")},
+        {ThumbnailRole, QByteArrayLiteral("thumbnail")},
     };
 }
 
@@ -192,9 +209,29 @@ void AccountMediaTimelineModel::reset()
         item.attachment->deleteLater();
     }
     m_timeline.clear();
+    m_prefetchedUntil = -1;
     endResetModel();
 }
 
+void AccountMediaTimelineModel::prefetchFrom(const int row) const
+{
+    // Delegates evaluate their bindings often, so only prefetch the rows that came into reach since last time
+    const int last = std::min<int>(row + prefetchDistance, m_timeline.size() - 1);
+    if (last <= m_prefetchedUntil) {
+        return;
+    }
+
+    const int first = std::max(row, m_prefetchedUntil) + 1;
+    m_prefetchedUntil = last;
+    for (int i = first; i <= last; i++) {
+        const auto &item = m_timeline[i];
+        // Sensitive media stays behind its blurhash until the user asks for it
+        if (!item.sensitive) {
+            MediaCache::instance().prefetch(item.attachment, m_thumbnailSize);
+        }
+    }
+}
+
 bool AccountMediaTimelineModel::canFetchMore(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
@@ -25,6 +25,11 @@ class AccountMediaTimelineModel : public AbstractListModel
      */
     Q_PROPERTY(QString tagged MEMBER m_tagged NOTIFY filtersChanged)
 
+    /**
+     * @brief The size of a grid cell in device pixels, used to decode thumbnails ahead of time.
+     */
+    Q_PROPERTY(QSize thumbnailSize MEMBER m_thumbnailSize NOTIFY thumbnailSizeChanged)
+
 public:
     explicit AccountMediaTimelineModel(QObject *parent = nullptr);
 
@@ -43,6 +48,7 @@ public:
         FocusYRole,
         SensitiveRole,
         AttachmentRole,
+        ThumbnailRole,
     };
 
     QVariant data(const QModelIndex &index, int role) const override;
@@ -53,6 +59,7 @@ Q_SIGNALS:
     void accountIdChanged();
     void filtersChanged();
     void tabChanged();
+    void thumbnailSizeChanged();
 
 protected:
     void reset();
@@ -60,10 +67,17 @@ protected:
     void fetchMore(const QModelIndex &parent) override;
 
 private:
+    /**
+     * @brief Prefetches the thumbnails of the rows following @p row, so they are already decoded once scrolled into view.
+     */
+    void prefetchFrom(int row) const;
+
     std::shared_ptr<Identity> m_identity;
     QString m_accountId;
 
     QString m_tagged;
+    QSize m_thumbnailSize;
+    mutable int m_prefetchedUntil = -1; ///< The furthest row that was prefetched
 
     struct MediaAttachment {
         QString postId;
@@ -3,6 +3,7 @@
 
 #include "timeline/accountmodel.h"
 
+#include "account/poststore.h"
 #include "account/relationship.h"
 #include "networkcontroller.h"
 
@@ -44,6 +45,11 @@ QString AccountModel::displayName() const
     return m_identity->displayNameHtml();
 }
 
+FilterEngine::Context AccountModel::filterContext() const
+{
+    return FilterEngine::AccountContext;
+}
+
 void AccountModel::fillTimeline(const QString &fromId, bool backwards)
 {
     Q_UNUSED(backwards)
@@ -54,8 +60,47 @@ void AccountModel::fillTimeline(const QString &fromId, bool backwards)
     }
     setLoading(true);
 
-    // Fetch pinned posts if we are starting from the top
-    const auto fetchPinned = fromId.isNull() && !m_excludePinned;
+    // The first page is loaded together with the rest of the profile, see setAccountId()
+    if (fromId.isNull()) {
+        connectProfileLoader();
+
+        m_statusesUrl = statusesUrl(fromId);
+        m_pinnedUrl = m_excludePinned ? QUrl() : pinnedUrl();
+        m_statusesLoaded = false;
+        m_pinnedLoaded = false;
+        m_pendingPinned.reset();
+
+        m_profileLoader->request(m_accountId, ProfileLoader::StatusesPart, m_statusesUrl);
+        if (!m_pinnedUrl.isEmpty()) {
+            m_profileLoader->request(m_accountId, ProfileLoader::PinnedPart, m_pinnedUrl);
+        }
+        return;
+    }
+
+    const auto account = m_account;
+    const auto id = m_accountId;
+
+    m_account->get(
+        statusesUrl(fromId),
+        true,
+        this,
+        [account, id, this](QNetworkReply *reply) {
+            if (m_account != account || m_accountId != id) {
+                setLoading(false);
+                return;
+            }
+
+            fetchedTimeline(reply->readAll(), true);
+            setLoading(false);
+        },
+        [this](QNetworkReply *reply) {
+            setLoading(false);
+            NetworkController::instance().networkErrorOccurred(reply->errorString());
+        });
+}
+
+QUrl AccountModel::statusesUrl(const QString &fromId) const
+{
     auto uriStatus = m_account->apiUrl(QStringLiteral("/api/v1/accounts/%1/statuses").arg(m_accountId));
 
     auto statusQuery = QUrlQuery();
@@ -78,6 +123,11 @@ void AccountModel::fillTimeline(const QString &fromId, bool backwards)
     statusQuery.addQueryItem(QStringLiteral("exclude_direct"), QStringLiteral("true"));
     uriStatus.setQuery(statusQuery);
 
+    return uriStatus;
+}
+
+QUrl AccountModel::pinnedUrl() const
+{
     auto uriPinned = m_account->apiUrl(QStringLiteral("/api/v1/accounts/%1/statuses").arg(m_accountId));
     QUrlQuery pinnedQuery{{
                               QStringLiteral("pinned"),
@@ -93,65 +143,162 @@ void AccountModel::fillTimeline(const QString &fromId, bool backwards)
     }
     uriPinned.setQuery(pinnedQuery);
 
-    const auto account = m_account;
-    const auto id = m_accountId;
+    return uriPinned;
+}
 
-    auto handleError = [this](QNetworkReply *reply) {
-        setLoading(false);
-        NetworkController::instance().networkErrorOccurred(reply->errorString());
-    };
+void AccountModel::connectProfileLoader()
+{
+    const auto loader = m_account->profileLoader();
+    if (m_profileLoader == loader) {
+        return;
+    }
 
-    auto onFetchPinned = [this, id, account](QNetworkReply *reply) {
-        if (m_account != account || m_accountId != id) {
-            setLoading(false);
-            return;
+    if (m_profileLoader) {
+        disconnect(m_profileLoader, nullptr, this, nullptr);
+    }
+    m_profileLoader = loader;
+
+    connect(loader, &ProfileLoader::partLoaded, this, &AccountModel::handleProfilePart);
+    connect(loader, &ProfileLoader::partFailed, this, &AccountModel::handleProfilePartFailed);
+    connect(loader, &ProfileLoader::loaded, this, [this](const QString &accountId) {
+        if (accountId == m_accountId) {
+            Q_EMIT profileLoaded();
         }
-        const auto data = reply->readAll();
-        const auto doc = QJsonDocument::fromJson(data);
+    });
+}
+
+void AccountModel::handleProfilePart(const QString &accountId, const ProfileLoader::Part part, const ProfileLoader::Response &response)
+{
+    if (accountId != m_accountId) {
+        return;
+    }
+
+    switch (part) {
+    case ProfileLoader::IdentityPart:
+        m_identity = m_account->identityLookup(accountId, QJsonDocument::fromJson(response.data).object());
+        Q_EMIT identityChanged();
+        updateRelationship();
+        break;
+    case ProfileLoader::RelationshipPart: {
+        const auto doc = QJsonDocument::fromJson(response.data);
         if (!doc.isArray()) {
-            setLoading(false);
+            qWarning(TOKODON_LOG) << "Data returned from Relationship network request is not an array"
+                                  << "data: " << doc;
             return;
         }
-        const auto array = doc.array();
-        if (array.isEmpty()) {
-            setLoading(false);
+
+        // We only are requesting for a single relationship, so doc should only contain one element
+        m_pendingRelationship = doc[0].toObject();
+        updateRelationship();
+        break;
+    }
+    case ProfileLoader::StatusesPart:
+        if (response.url != m_statusesUrl || m_statusesLoaded) {
             return;
         }
 
-        QList<Post *> posts;
-        std::ranges::transform(std::as_const(array), std::back_inserter(posts), [this](const QJsonValue &value) {
-            auto post = new Post(m_account, value.toObject(), this);
-            post->setPinned(true);
-            return post;
-        });
-        std::ranges::reverse(posts);
-        beginInsertRows({}, 0, posts.size() - 1);
-        m_timeline = posts + m_timeline;
-        endInsertRows();
-        setLoading(false);
-    };
+        // Clear the previous posts, this can happen if we just entered the profile page (okay, just a no-op) or if the filters change
+        reset();
+        fetchedTimeline(response.data, true);
+        m_statusesLoaded = true;
 
-    auto onFetchAccount = [account, id, fetchPinned, uriPinned, handleError, onFetchPinned, fromId, this](QNetworkReply *reply) {
-        if (m_account != account || m_accountId != id) {
-            setLoading(false);
+        // Pinned posts that arrived first were held back, so they don't hide their copy in the timeline
+        if (m_pendingPinned) {
+            insertPinned(*m_pendingPinned);
+            m_pendingPinned.reset();
+        }
+        updateFirstPageLoading();
+        break;
+    case ProfileLoader::PinnedPart:
+        if (response.url != m_pinnedUrl || m_pinnedLoaded) {
             return;
         }
 
-        // if we just restarted the fetch (fromId is null) then we must clear the previous array
-        // this can happen if we just entered the profile page (okay, just a no-op) or if the filters change
-        if (fromId.isNull()) {
-            reset();
+        if (m_statusesLoaded) {
+            insertPinned(response.data);
+        } else {
+            m_pendingPinned = response.data;
         }
+        m_pinnedLoaded = true;
+        updateFirstPageLoading();
+        break;
+    case ProfileLoader::FeaturedTagsPart:
+    case ProfileLoader::FamiliarFollowersPart:
+        // These are shown by FeaturedTagsModel and SocialGraphModel
+        break;
+    }
+}
 
-        fetchedTimeline(reply->readAll(), true);
-        if (fetchPinned) {
-            m_account->get(uriPinned, true, this, onFetchPinned, handleError);
-        } else {
-            setLoading(false);
+void AccountModel::handleProfilePartFailed(const QString &accountId, const ProfileLoader::Part part, const QString &errorString)
+{
+    if (accountId != m_accountId) {
+        return;
+    }
+
+    switch (part) {
+    case ProfileLoader::StatusesPart:
+        m_statusesLoaded = true;
+        break;
+    case ProfileLoader::PinnedPart:
+        m_pinnedLoaded = true;
+        break;
+    default:
+        return;
+    }
+
+    NetworkController::instance().networkErrorOccurred(errorString);
+    updateFirstPageLoading();
+}
+
+void AccountModel::insertPinned(const QByteArray &data)
+{
+    const auto doc = QJsonDocument::fromJson(data);
+    if (!doc.isArray()) {
+        return;
+    }
+    const auto array = doc.array();
+    if (array.isEmpty()) {
+        return;
+    }
+
+    QList<Post *> posts;
+    std::ranges::transform(std::as_const(array), std::back_inserter(posts), [this](const QJsonValue &value) {
+        return m_account->postStore()->acquire(value.toObject(), this);
+    });
+    std::ranges::reverse(posts);
+    m_pinnedPosts = QList<const Post *>(posts.cbegin(), posts.cend());
+    insertPosts(posts, false);
+}
+
+bool AccountModel::isPinnedRow(const int row) const
+{
+    // The pinned posts that are shown are the first rows, a post that is also further down in the timeline isn't pinned there
+    int pinnedRow = 0;
+    for (const auto post : m_pinnedPosts) {
+        if (pinnedRow < m_timeline.size() && m_timeline[pinnedRow] == post) {
+            if (pinnedRow == row) {
+                return true;
+            }
+            pinnedRow++;
         }
-    };
+    }
+    return false;
+}
+
+QVariant AccountModel::data(const QModelIndex &index, const int role) const
+{
+    // Our own posts know if they are pinned, which changes when pinning them from here. Other accounts only pin them on their profile.
+    if (role == PinnedRole && index.isValid() && !isSelf()) {
+        return isPinnedRow(index.row());
+    }
+    return TimelineModel::data(index, role);
+}
 
-    m_account->get(uriStatus, true, this, onFetchAccount, handleError);
+void AccountModel::updateFirstPageLoading()
+{
+    if (m_statusesLoaded && (m_pinnedUrl.isEmpty() || m_pinnedLoaded)) {
+        setLoading(false);
+    }
 }
 
 Identity *AccountModel::identity() const
@@ -172,23 +319,29 @@ void AccountModel::setAccountId(const QString &accountId)
     m_accountId = accountId;
     Q_EMIT accountIdChanged();
 
-    if (!m_account->identityCached(accountId)) {
-        m_account->get(m_account->apiUrl(QStringLiteral("/api/v1/accounts/%1").arg(accountId)), true, this, [this, accountId](QNetworkReply *reply) {
-            const auto data = reply->readAll();
-            const auto doc = QJsonDocument::fromJson(data);
-
-            m_identity = m_account->identityLookup(accountId, doc.object());
-            Q_EMIT identityChanged();
-            updateRelationships();
-        });
-    } else {
+    m_pendingRelationship = {};
+    if (m_account->identityCached(accountId)) {
         m_identity = m_account->identityLookup(accountId, {});
         Q_EMIT identityChanged();
-        updateRelationships();
     }
 
     reset();
-    fillTimeline();
+
+    // Anything still loading belongs to the previous account
+    setLoading(false);
+
+    // Everything on the page is requested at once, and shown as soon as it arrives
+    connectProfileLoader();
+    m_statusesUrl = m_currentTab == Media ? QUrl() : statusesUrl({});
+    m_pinnedUrl = m_statusesUrl.isEmpty() || m_excludePinned ? QUrl() : pinnedUrl();
+    m_statusesLoaded = false;
+    m_pinnedLoaded = false;
+    m_pendingPinned.reset();
+    if (!m_statusesUrl.isEmpty()) {
+        setLoading(true);
+    }
+
+    m_profileLoader->load(accountId, m_statusesUrl, m_pinnedUrl);
 }
 
 AbstractAccount *AccountModel::account() const
@@ -196,30 +349,16 @@ AbstractAccount *AccountModel::account() const
     return m_account;
 }
 
-void AccountModel::updateRelationships()
+void AccountModel::updateRelationship()
 {
-    if (m_account->identity()->id() == m_identity->id()) {
+    // The relationship may arrive before the identity it belongs to
+    if (m_pendingRelationship.isEmpty() || m_identity == nullptr || m_identity->id() != m_accountId) {
         return;
     }
 
-    // Fetch relationship. Don't cache this; it's lightweight.
-    QUrl uriRelationship = m_account->apiUrl(QStringLiteral("/api/v1/accounts/relationships"));
-    uriRelationship.setQuery(QUrlQuery{
-        {QStringLiteral("id[]"), m_identity->id()},
-    });
-
-    m_account->get(uriRelationship, true, this, [this](QNetworkReply *reply) {
-        const auto doc = QJsonDocument::fromJson(reply->readAll());
-        if (!doc.isArray()) {
-            qWarning(TOKODON_LOG) << "Data returned from Relationship network request is not an array"
-                                  << "data: " << doc;
-            return;
-        }
-
-        // We only are requesting for a single relationship, so doc should only contain one element
-        m_identity->setRelationship(new Relationship(m_identity.get(), doc[0].toObject()));
-        Q_EMIT identityChanged();
-    });
+    m_identity->setRelationship(new Relationship(m_identity.get(), m_pendingRelationship));
+    m_pendingRelationship = {};
+    Q_EMIT identityChanged();
 }
 
 void AccountModel::updateTabFilters()
@@ -246,8 +385,8 @@ void AccountModel::updateTabFilters()
 void AccountModel::reset()
 {
     beginResetModel();
-    qDeleteAll(m_timeline);
-    m_timeline.clear();
+    setPosts({});
+    m_pinnedPosts.clear();
     endResetModel();
 }
 
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include "account/profileloader.h"
 #include "timeline/timelinemodel.h"
 
+#include <QPointer>
+
 class AbstractAccount;
 
 /**
@@ -82,6 +85,8 @@ public:
 
     void fillTimeline(const QString &fromId = {}, bool backwards = false) override;
 
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
 Q_SIGNALS:
     void identityChanged();
     void accountChanged();
@@ -89,16 +94,44 @@ Q_SIGNALS:
     void filtersChanged();
     void tabChanged();
 
+    /**
+     * @brief Emitted once every part of the profile finished loading.
+     */
+    void profileLoaded();
+
 protected:
     void reset() override;
+    [[nodiscard]] FilterEngine::Context filterContext() const override;
 
 private:
-    void updateRelationships();
+    void connectProfileLoader();
+    void handleProfilePart(const QString &accountId, ProfileLoader::Part part, const ProfileLoader::Response &response);
+    void handleProfilePartFailed(const QString &accountId, ProfileLoader::Part part, const QString &errorString);
+    void insertPinned(const QByteArray &data);
+
+    /**
+     * @return Whether @p row is one of the pinned posts at the top of the profile.
+     */
+    [[nodiscard]] bool isPinnedRow(int row) const;
+    void updateRelationship();
+    void updateFirstPageLoading();
     void updateTabFilters();
 
+    [[nodiscard]] QUrl statusesUrl(const QString &fromId) const;
+    [[nodiscard]] QUrl pinnedUrl() const;
+
     std::shared_ptr<Identity> m_identity;
     QString m_accountId;
 
+    QPointer<ProfileLoader> m_profileLoader;
+    QJsonObject m_pendingRelationship;
+    QUrl m_statusesUrl;
+    QUrl m_pinnedUrl;
+    bool m_statusesLoaded = false;
+    bool m_pinnedLoaded = false;
+    std::optional<QByteArray> m_pendingPinned;
+    QList<const Post *> m_pinnedPosts; ///< Pinned on this profile, at the top of m_posts in the same order. The posts are shared, so this isn't set on them.
+
     bool m_excludeReplies = false;
     bool m_excludeBoosts = false;
     bool m_excludePinned = false;
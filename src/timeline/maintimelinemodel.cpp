@@ -3,6 +3,8 @@
 
 #include "timeline/maintimelinemodel.h"
 
+#include "account/markersync.h"
+#include "account/poststore.h"
 #include "networkcontroller.h"
 #include "texthandler.h"
 
@@ -15,6 +17,11 @@
 MainTimelineModel::MainTimelineModel(QObject *parent)
     : TimelineModel(parent)
 {
+    // The read marker moves when posts are added above it, or when the post it was on is removed
+    connect(this, &QAbstractItemModel::rowsInserted, this, &MainTimelineModel::updateReadMarkerRow);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &MainTimelineModel::updateReadMarkerRow);
+    connect(this, &QAbstractItemModel::modelReset, this, &MainTimelineModel::updateReadMarkerRow);
+
     init();
 }
 
@@ -50,6 +57,14 @@ QString MainTimelineModel::displayName() const
     return {};
 }
 
+FilterEngine::Context MainTimelineModel::filterContext() const
+{
+    if (m_timelineName == QStringLiteral("home") || m_timelineName == QStringLiteral("list")) {
+        return FilterEngine::HomeContext;
+    }
+    return FilterEngine::PublicContext;
+}
+
 QString MainTimelineModel::listId() const
 {
     return m_listId;
@@ -64,6 +79,7 @@ void MainTimelineModel::setListId(const QString &id)
     m_listId = id;
     Q_EMIT listIdChanged();
 
+    updateStreamSubscription();
     fillTimeline({});
 }
 
@@ -92,6 +108,7 @@ void MainTimelineModel::setName(const QString &timelineName)
 
     m_timelineName = timelineName;
     Q_EMIT nameChanged();
+    updateStreamSubscription();
     fillTimeline({});
 }
 
@@ -242,24 +259,27 @@ void MainTimelineModel::handleEvent(AbstractAccount::StreamingEventType eventTyp
         TimelineModel::handleEvent(eventType, payload);
         if (eventType == AbstractAccount::StreamingEventType::UpdateEvent && m_timelineName == QStringLiteral("home")) {
             const auto doc = QJsonDocument::fromJson(payload);
-            const auto post = new Post(m_account, doc.object(), this);
-
-            // Make sure we aren't adding the same post we already have
-            const auto it = std::ranges::find_if(std::as_const(m_timeline), [post](const auto &timelinePost) {
-                return post->postId() == timelinePost->postId();
-            });
-            if (it == m_timeline.cend()) {
-                beginInsertRows({}, 0, 0);
-                m_timeline.push_front(post);
-                endInsertRows();
-                Q_EMIT streamedPostAdded(post->originalPostId());
-            } else {
-                delete post;
-            }
+            queueStreamedPost(m_account->postStore()->acquire(doc.object(), this));
         }
     }
 }
 
+std::pair<QString, QString> MainTimelineModel::stream() const
+{
+    // Home is kept live by the user stream, which is always subscribed to
+    if (m_timelineName == QStringLiteral("list") && !m_listId.isEmpty()) {
+        return {QStringLiteral("list"), m_listId};
+    }
+    if (m_timelineName == QStringLiteral("public")) {
+        return {QStringLiteral("public:local"), {}};
+    }
+    if (m_timelineName == QStringLiteral("federated")) {
+        return {QStringLiteral("public"), {}};
+    }
+
+    return {};
+}
+
 bool MainTimelineModel::atEnd() const
 {
     // Trending doesnt have pagination
@@ -273,9 +293,9 @@ bool MainTimelineModel::atEnd() const
 
 void MainTimelineModel::reset()
 {
+    discardPendingPosts();
     beginResetModel();
-    qDeleteAll(m_timeline);
-    m_timeline.clear();
+    setPosts({});
     endResetModel();
     m_next = {};
     m_prev = {};
@@ -307,7 +327,9 @@ void MainTimelineModel::fetchLastReadId()
         [this](QNetworkReply *reply) {
             const auto doc = QJsonDocument::fromJson(reply->readAll());
 
-            m_lastReadId = doc.object()[QLatin1String("home")].toObject()[QLatin1String("last_read_id")].toString();
+            // A marker that wasn't sent yet may be newer
+            m_account->markerSync()->setServerMarkers(doc.object());
+            m_lastReadId = StatusId(m_account->markerSync()->lastReadId(QStringLiteral("home")));
             if (m_initialLastReadId.isEmpty()) {
                 m_initialLastReadId = m_lastReadId;
             }
@@ -317,9 +339,10 @@ void MainTimelineModel::fetchLastReadId()
             Q_EMIT hasPreviousChanged();
 
             fetchedLastId = true;
+            updateReadMarkerRow();
 
             if (Config::continueReading()) {
-                fillTimeline(m_lastReadId);
+                fillTimeline(m_lastReadId.toString());
             } else {
                 fillTimeline({});
             }
@@ -331,7 +354,7 @@ void MainTimelineModel::fetchLastReadId()
             fetchedLastId = true;
 
             if (Config::continueReading()) {
-                fillTimeline(m_lastReadId);
+                fillTimeline(m_lastReadId.toString());
             } else {
                 fillTimeline({});
             }
@@ -350,18 +373,49 @@ void MainTimelineModel::updateReadMarker(const QString &postId)
     const bool isHome = m_timelineName == QStringLiteral("home");
 
     if (isHome) {
-        const auto latestPostId = findLatestPostId({postId, m_lastReadId});
-        if (latestPostId.isEmpty()) {
+        const StatusId readId(postId);
+        if (readId.isEmpty()) {
             return;
         }
 
-        if (latestPostId != m_lastReadId) {
-            m_account->saveTimelinePosition(QStringLiteral("home"), latestPostId);
-            m_lastReadId = latestPostId;
+        // Only move forward, scrolling back down to older posts doesn't make the newer ones unread
+        if (m_lastReadId.isEmpty() || readId > m_lastReadId) {
+            m_account->saveTimelinePosition(QStringLiteral("home"), postId);
+            m_lastReadId = readId;
         }
     }
 }
 
+void MainTimelineModel::updateReadMarkerRow()
+{
+    int row = -1;
+
+    // If it's empty (because the user never set it, or the server doesn't support it) don't show the read marker at all
+    // Otherwise it ends up at the top of the timeline, being completely useless.
+    if (fetchedLastId && !m_initialLastReadId.isEmpty()) {
+        // Timelines are sorted from newest to oldest, so everything from the first post that isn't newer than the marker was read
+        const auto it = std::ranges::find_if(std::as_const(m_timeline), [this](const Post *post) {
+            return post->originalStatusId() <= m_initialLastReadId;
+        });
+        if (it != m_timeline.cend()) {
+            row = static_cast<int>(std::distance(m_timeline.cbegin(), it));
+        }
+    }
+
+    const int oldRow = std::exchange(m_readMarkerRow, row);
+    if (oldRow == row) {
+        return;
+    }
+
+    // Every row below the marker shows it, so only the rows in between the old and new marker changed
+    const int lastRow = static_cast<int>(m_timeline.size()) - 1;
+    const int first = oldRow == -1 ? row : (row == -1 ? oldRow : std::min(oldRow, row));
+    const int last = oldRow == -1 || row == -1 ? lastRow : std::min(std::max(oldRow, row) - 1, lastRow);
+    if (first <= last) {
+        Q_EMIT dataChanged(index(first, 0), index(last, 0), {ShowReadMarkerRole});
+    }
+}
+
 void MainTimelineModel::refresh()
 {
     // If we have pagination data, use that to refresh. Otherwise fall back to reloading the whole thing.
@@ -385,23 +439,7 @@ QVariant MainTimelineModel::data(const QModelIndex &index, int role) const
         return TimelineModel::data(index, role);
     }
 
-    if (!fetchedLastId) {
-        return false;
-    }
-
-    // If it's empty (because the user never set it, or the server doesn't support it) don't show the read marker at all
-    // Otherwise it ends up at the top of the timeline, being completely useless.
-    if (m_initialLastReadId.isEmpty()) {
-        return false;
-    }
-
-    const auto postId = data(index, OriginalIdRole).toString();
-    const auto latestPostId = findLatestPostId({postId, m_initialLastReadId});
-    if (latestPostId == m_initialLastReadId) {
-        return true;
-    }
-
-    return false;
+    return m_readMarkerRow != -1 && index.row() >= m_readMarkerRow;
 }
 
 bool MainTimelineModel::hasPrevious() const
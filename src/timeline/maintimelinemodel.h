@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "datatypes/statusid.h"
 #include "timeline/timelinemodel.h"
 
 class AbstractAccount;
@@ -72,6 +73,10 @@ public:
 public Q_SLOTS:
     void refresh() override;
 
+protected:
+    [[nodiscard]] std::pair<QString, QString> stream() const override;
+    [[nodiscard]] FilterEngine::Context filterContext() const override;
+
 Q_SIGNALS:
     void listIdChanged();
     void hasPreviousChanged();
@@ -84,11 +89,13 @@ private:
     QString m_url;
 
     std::optional<QUrl> m_next, m_prev;
-    QString m_lastReadId, m_initialLastReadId;
+    StatusId m_lastReadId, m_initialLastReadId;
     bool fetchingLastId = false;
     bool fetchedLastId = false;
+    int m_readMarkerRow = -1; ///< The first row that was read, or -1 if the read marker isn't shown
 
     void fetchLastReadId();
+    void updateReadMarkerRow();
     QDateTime m_lastReadTime;
     bool m_userHasTakenReadAction = false;
 };
@@ -3,17 +3,22 @@
 
 #include "timeline/notification.h"
 
+#include "account/poststore.h"
 #include "tokodon_debug.h"
 
 using namespace Qt::StringLiterals;
 
 Post *Notification::createPost(AbstractAccount *account, const QJsonObject &obj, QObject *parent)
 {
-    if (!obj.empty()) {
-        return new Post(account, obj, parent);
+    if (obj.empty()) {
+        return nullptr;
     }
 
-    return nullptr;
+    // Notifications that aren't shown by a model, like the ones for desktop notifications, don't need to share their post
+    if (parent == nullptr) {
+        return new Post(account, obj);
+    }
+    return account->postStore()->acquire(obj, parent);
 }
 
 static QMap<QString, AccountWarning::Action> str_to_act_type = {
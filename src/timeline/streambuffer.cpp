@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "timeline/streambuffer.h"
+
+#include "datatypes/post.h"
+
+#include <algorithm>
+
+// Roughly one frame, busy streams would otherwise relayout the view for every single post
+static constexpr int flushInterval = 16;
+
+// Deletions are only remembered for a while, they only matter for posts that are streamed again shortly after (e.g. by a backfill)
+static constexpr qsizetype maxDeletedIds = 256;
+
+// A timeline left open on a busy stream would otherwise hold back posts without end, the oldest ones are dropped instead
+static constexpr qsizetype maxHeldPosts = 1000;
+
+StreamBuffer::StreamBuffer(QObject *parent)
+    : QObject(parent)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(flushInterval);
+    connect(&m_flushTimer, &QTimer::timeout, this, [this] {
+        flush(m_deferred);
+    });
+}
+
+void StreamBuffer::add(Post *post)
+{
+    if (isDeleted(post->originalStatusId()) || isDeleted(post->statusId())) {
+        Q_EMIT dropped(post);
+        return;
+    }
+
+    m_pending.append(post);
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void StreamBuffer::remove(const StatusId &postId)
+{
+    if (!m_deletedIds.contains(postId)) {
+        m_deletedIds.insert(postId);
+        m_deletedOrder.append(postId);
+        if (m_deletedOrder.size() > maxDeletedIds) {
+            m_deletedIds.remove(m_deletedOrder.takeFirst());
+        }
+    }
+
+    // Deleting a post removes its boosts too
+    const auto isDeletedPost = [this, &postId](Post *post) {
+        if (post->originalStatusId() == postId || post->statusId() == postId) {
+            Q_EMIT dropped(post);
+            return true;
+        }
+        return false;
+    };
+    m_pending.removeIf(isDeletedPost);
+    const auto isDeletedHeldPost = [this, &isDeletedPost](Post *post) {
+        if (isDeletedPost(post)) {
+            m_heldIds.remove(post->statusId());
+            return true;
+        }
+        return false;
+    };
+    if (m_held.removeIf(isDeletedHeldPost) > 0) {
+        Q_EMIT heldCountChanged();
+    }
+}
+
+bool StreamBuffer::isDeleted(const StatusId &postId) const
+{
+    return m_deletedIds.contains(postId);
+}
+
+void StreamBuffer::setDeferred(const bool deferred)
+{
+    m_deferred = deferred;
+}
+
+int StreamBuffer::heldCount() const
+{
+    return m_held.size();
+}
+
+void StreamBuffer::release()
+{
+    m_flushTimer.stop();
+    flush(false);
+}
+
+void StreamBuffer::clear()
+{
+    m_flushTimer.stop();
+
+    const auto pending = std::exchange(m_pending, {});
+    for (const auto post : pending) {
+        Q_EMIT dropped(post);
+    }
+
+    if (!m_held.isEmpty()) {
+        m_heldIds.clear();
+        const auto held = std::exchange(m_held, {});
+        for (const auto post : held) {
+            Q_EMIT dropped(post);
+        }
+        Q_EMIT heldCountChanged();
+    }
+}
+
+void StreamBuffer::flush(const bool hold)
+{
+    const auto heldCount = m_held.size();
+
+    // A newer copy of a post replaces the older one, so it's inserted where it was streamed last. Only the posts that came in since the
+    // last frame are looked at, the held ones are known by their id.
+    for (const auto post : std::exchange(m_pending, {})) {
+        const auto statusId = post->statusId();
+        if (m_heldIds.contains(statusId)) {
+            const auto it = std::ranges::find_if(m_held, [&statusId](const Post *held) {
+                return held->statusId() == statusId;
+            });
+            Q_EMIT dropped(*it);
+            m_held.erase(it);
+        } else {
+            m_heldIds.insert(statusId);
+        }
+        m_held.append(post);
+    }
+
+    if (hold) {
+        if (m_held.size() > maxHeldPosts) {
+            const auto excess = m_held.size() - maxHeldPosts;
+            for (qsizetype i = 0; i < excess; i++) {
+                m_heldIds.remove(m_held[i]->statusId());
+                Q_EMIT dropped(m_held[i]);
+            }
+            m_held.remove(0, excess);
+        }
+        if (m_held.size() != heldCount) {
+            Q_EMIT heldCountChanged();
+        }
+        return;
+    }
+
+    const auto posts = std::exchange(m_held, {});
+    m_heldIds.clear();
+    if (heldCount > 0) {
+        Q_EMIT heldCountChanged();
+    }
+    if (!posts.isEmpty()) {
+        Q_EMIT flushed(QList<Post *>(posts.crbegin(), posts.crend()));
+    }
+}
+
+#include "moc_streambuffer.cpp"
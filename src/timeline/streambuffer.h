@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+#include "datatypes/statusid.h"
+
+class Post;
+
+/**
+ * @brief Collects the streamed posts of a timeline, so they are inserted in batches instead of one by one.
+ *
+ * Posts added during the same frame are flushed together, newest first. Duplicates and posts deleted in the meantime are
+ * dropped. When deferred, flushed posts are held back until release() is called, so the timeline doesn't move under the user
+ * while they read it. Only the newest posts are held back, the oldest ones are dropped beyond that.
+ */
+class StreamBuffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StreamBuffer(QObject *parent = nullptr);
+
+    /**
+     * @brief Buffers a streamed post. It is either handed over in flushed(), or in dropped() if it isn't going to be shown.
+     */
+    void add(Post *post);
+
+    /**
+     * @brief Drops a deleted post, and makes sure it's dropped as well if it's streamed again later on.
+     */
+    void remove(const StatusId &postId);
+
+    /**
+     * @return Whether @p postId was deleted since it was streamed.
+     */
+    [[nodiscard]] bool isDeleted(const StatusId &postId) const;
+
+    /**
+     * @brief Set whether flushed posts are held back until release() is called.
+     */
+    void setDeferred(bool deferred);
+
+    /**
+     * @return The number of posts held back.
+     */
+    [[nodiscard]] int heldCount() const;
+
+    /**
+     * @brief Flushes everything that's buffered or held back right away.
+     */
+    void release();
+
+    /**
+     * @brief Drops everything that's buffered or held back.
+     */
+    void clear();
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted at most once per frame with the buffered posts, newest first.
+     */
+    void flushed(const QList<Post *> &posts);
+
+    /**
+     * @brief Emitted for a buffered post that is not going to be flushed, for example because it was deleted.
+     * @note Not emitted for what's still buffered when the buffer is destroyed.
+     */
+    void dropped(Post *post);
+
+    void heldCountChanged();
+
+private:
+    void flush(bool hold);
+
+    QList<Post *> m_pending; ///< Oldest first, like they were streamed
+    QList<Post *> m_held; ///< Oldest first
+    QSet<StatusId> m_heldIds; ///< The status ids of m_held
+    QSet<StatusId> m_deletedIds;
+    QList<StatusId> m_deletedOrder;
+    QTimer m_flushTimer;
+    bool m_deferred = false;
+};
@@ -8,6 +8,7 @@
 #include <QUrlQuery>
 
 #include "networkcontroller.h"
+#include "account/poststore.h"
 #include "texthandler.h"
 
 using namespace Qt::StringLiterals;
@@ -32,6 +33,7 @@ void TagsTimelineModel::setHashtag(const QString &hashtag)
     }
     m_hashtag = hashtag;
     Q_EMIT hashtagChanged();
+    updateStreamSubscription();
     fillTimeline({});
 }
 
@@ -58,6 +60,15 @@ QString TagsTimelineModel::displayName() const
     return QLatin1Char('#') + m_hashtag;
 }
 
+std::pair<QString, QString> TagsTimelineModel::stream() const
+{
+    if (m_hashtag.isEmpty()) {
+        return {};
+    }
+
+    return {QStringLiteral("hashtag"), m_hashtag};
+}
+
 bool TagsTimelineModel::canFetchMore(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
@@ -114,9 +125,9 @@ void TagsTimelineModel::fillTimeline(const QString &fromId, bool backwards)
 void TagsTimelineModel::reset()
 {
     m_next = {};
+    discardPendingPosts();
     beginResetModel();
-    qDeleteAll(m_timeline);
-    m_timeline.clear();
+    setPosts({});
     endResetModel();
 }
 
@@ -57,6 +57,9 @@ public Q_SLOTS:
      */
     void unfollow();
 
+protected:
+    [[nodiscard]] std::pair<QString, QString> stream() const override;
+
 Q_SIGNALS:
     /**
      * @brief Emitted if the hashtag is changed
@@ -4,6 +4,7 @@
 
 #include "timeline/threadmodel.h"
 
+#include "account/poststore.h"
 #include "networkcontroller.h"
 
 #include <KLocalizedString>
@@ -16,6 +17,16 @@ ThreadModel::ThreadModel(QObject *parent)
     : TimelineModel(parent)
 {
     init();
+
+    // The root row is needed for every row that is shown, so it's only looked up again once the rows changed
+    const auto invalidateRootRow = [this] {
+        m_rootRow.reset();
+    };
+    connect(this, &QAbstractItemModel::rowsInserted, this, invalidateRootRow);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, invalidateRootRow);
+    connect(this, &QAbstractItemModel::rowsMoved, this, invalidateRootRow);
+    connect(this, &QAbstractItemModel::modelReset, this, invalidateRootRow);
+    connect(this, &QAbstractItemModel::layoutChanged, this, invalidateRootRow);
 }
 
 QVariant ThreadModel::data(const QModelIndex &index, int role) const
@@ -25,11 +36,11 @@ QVariant ThreadModel::data(const QModelIndex &index, int role) const
     }
 
     if (role == SelectedRole) {
-        return m_postId == TimelineModel::data(index, IdRole).toString();
+        return m_statusId == m_timeline[index.row()]->statusId();
     } else if (role == IsThreadReplyRole) {
         // This prevents ancestors from being accidentally considered
-        const bool isReplyAfterRootPost = index.row() > m_rootPostIndex;
-        const bool isReplyToRootPost = m_postId != m_timeline[index.row()]->inReplyTo();
+        const bool isReplyAfterRootPost = index.row() > rootRow();
+        const bool isReplyToRootPost = m_statusId != m_timeline[index.row()]->inReplyToStatusId();
 
         return isReplyAfterRootPost && isReplyToRootPost;
     } else if (role == IsLastThreadReplyRole) {
@@ -44,12 +55,31 @@ QString ThreadModel::displayName() const
     if (m_timeline.isEmpty()) {
         return i18nc("@title:window", "Loading…");
     }
-    auto post = m_timeline.at(m_rootPostIndex);
+    auto post = m_posts.at(m_rootPostIndex);
 
     // FIXME: the inline page title can be HTML, but this is currently synced as the window title. hence why we're not using the HTML version here...
     return i18nc("@title", "Post by %1", post->authorIdentity()->displayName());
 }
 
+FilterEngine::Context ThreadModel::filterContext() const
+{
+    return FilterEngine::ThreadContext;
+}
+
+bool ThreadModel::isShown(const Post *post) const
+{
+    // The post the thread is about is shown even if it's filtered, it was opened on purpose
+    return post->statusId() == m_statusId || TimelineModel::isShown(post);
+}
+
+qsizetype ThreadModel::rootRow() const
+{
+    if (!m_rootRow) {
+        m_rootRow = m_timeline.indexOf(m_posts.value(m_rootPostIndex));
+    }
+    return *m_rootRow;
+}
+
 QString ThreadModel::postId() const
 {
     return m_postId;
@@ -61,6 +91,7 @@ void ThreadModel::setPostId(const QString &postId)
         return;
     }
     m_postId = postId;
+    m_statusId = StatusId(postId);
     Q_EMIT postIdChanged();
 
     fillTimeline();
@@ -119,7 +150,7 @@ void ThreadModel::fillTimeline(const QString &fromId, bool backwards)
 
         for (const auto &ancestor : ancestors) {
             if (ancestor.canConvert<QJsonObject>() || ancestor.canConvert<QVariantMap>()) {
-                thread->push_front(new Post(m_account, ancestor.toJsonObject(), this));
+                thread->push_front(m_account->postStore()->acquire(ancestor.toJsonObject(), this));
             }
         }
 
@@ -128,11 +159,11 @@ void ThreadModel::fillTimeline(const QString &fromId, bool backwards)
                 continue;
             }
 
-            thread->push_back(new Post(m_account, descendent.toObject(), this));
+            thread->push_back(m_account->postStore()->acquire(descendent.toObject(), this));
         }
 
         beginResetModel();
-        m_timeline = *thread;
+        setPosts(*thread);
         endResetModel();
         setLoading(false);
 
@@ -147,7 +178,7 @@ void ThreadModel::fillTimeline(const QString &fromId, bool backwards)
         if (!doc.isObject()) {
             return;
         }
-        thread->push_front(new Post(m_account, obj, this));
+        thread->push_front(m_account->postStore()->acquire(obj, this));
 
         m_postUrl = thread->front()->url().toString();
         Q_EMIT postUrlChanged();
@@ -178,8 +209,7 @@ int ThreadModel::getRootIndex() const
 void ThreadModel::reset()
 {
     beginResetModel();
-    qDeleteAll(m_timeline);
-    m_timeline.clear();
+    setPosts({});
     endResetModel();
 }
 
@@ -6,6 +6,8 @@
 
 #include "timeline/timelinemodel.h"
 
+#include <optional>
+
 /**
  * @brief Model for displaying and organizing post threads
  * @see TimelineModel
@@ -69,10 +71,21 @@ Q_SIGNALS:
     void postUrlChanged();
     void hasHiddenRepliesChanged();
 
+protected:
+    [[nodiscard]] FilterEngine::Context filterContext() const override;
+    [[nodiscard]] bool isShown(const Post *post) const override;
+
 private:
+    /**
+     * @return The row of the post the thread is about, the posts before it may not all be shown.
+     */
+    [[nodiscard]] qsizetype rootRow() const;
+
     QString m_postId, m_postUrl;
+    StatusId m_statusId; ///< The same as m_postId, to compare with the posts
     bool m_hasHiddenReplies = false;
-    qsizetype m_rootPostIndex = 0;
+    qsizetype m_rootPostIndex = 0; ///< In m_posts
+    mutable std::optional<qsizetype> m_rootRow; ///< Cached by rootRow() until the rows change
 
     friend class TimelineTest;
 };
@@ -4,8 +4,15 @@
 
 #include "timeline/timelinemodel.h"
 
+#include "account/poststore.h"
+#include "account/streamingmanager.h"
+#include "utils/mediacache.h"
+#include "utils/startuptrace.h"
+#include "utils/tracing.h"
+
 #include <QJsonDocument>
 #include <QNetworkReply>
+#include <config.h>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -13,6 +20,18 @@ TimelineModel::TimelineModel(QObject *parent)
     : AbstractTimelineModel(parent)
     , m_manager(&AccountManager::instance())
 {
+    connect(&m_streamBuffer, &StreamBuffer::flushed, this, &TimelineModel::insertStreamedPosts);
+    connect(&m_streamBuffer, &StreamBuffer::heldCountChanged, this, &TimelineModel::newPostsCountChanged);
+    connect(&m_streamBuffer, &StreamBuffer::dropped, this, [this](Post *post) {
+        PostStore::release(post, this);
+    });
+}
+
+TimelineModel::~TimelineModel()
+{
+    if (m_streamAccount && !m_subscribedStream.first.isEmpty()) {
+        m_streamAccount->streaming()->unsubscribe(m_subscribedStream.first, m_subscribedStream.second);
+    }
 }
 
 void TimelineModel::init()
@@ -24,17 +43,16 @@ void TimelineModel::init()
         connect(m_account, &AbstractAccount::streamingEvent, this, &TimelineModel::handleEvent);
     }
 
-    connect(this, &TimelineModel::showBoostsChanged, this, [this] {
-        reset();
-        fillTimeline();
-    });
-    connect(this, &TimelineModel::showRepliesChanged, this, [this] {
-        reset();
-        fillTimeline();
-    });
-    connect(this, &TimelineModel::showQuotesChanged, this, [this] {
-        reset();
-        fillTimeline();
+    // The posts these hide are kept, so they can be shown again without fetching them
+    connect(this, &TimelineModel::showBoostsChanged, this, &TimelineModel::updateShownPosts);
+    connect(this, &TimelineModel::showRepliesChanged, this, &TimelineModel::updateShownPosts);
+    connect(this, &TimelineModel::showQuotesChanged, this, &TimelineModel::updateShownPosts);
+
+    // Changed filters are applied to every post at once, the shown posts are worked out again once that's done
+    connect(m_manager, &AccountManager::filtersApplied, this, [this](AbstractAccount *account) {
+        if (account == m_account && std::exchange(m_shownPostsOutdated, false)) {
+            updateShownPosts();
+        }
     });
 
     connect(m_manager, &AccountManager::accountSelected, this, [this](AbstractAccount *account) {
@@ -55,14 +73,21 @@ void TimelineModel::init()
         setLoading(false);
 
         Q_EMIT nameChanged();
+        updateStreamSubscription();
         fillTimeline();
     });
 
+    updateStreamSubscription();
     fillTimeline();
 }
 
 int TimelineModel::fetchedTimeline(const QByteArray &data, bool alwaysAppendToEnd)
 {
+    Tracing::Scope trace("model", "TimelineModel::fetchedTimeline");
+    if (Tracing::isRecording()) {
+        trace.setDetail(QString::fromLatin1(metaObject()->className()));
+    }
+
     QList<Post *> posts;
 
     const auto doc = QJsonDocument::fromJson(data);
@@ -78,36 +103,14 @@ int TimelineModel::fetchedTimeline(const QByteArray &data, bool alwaysAppendToEn
     }
 
     std::ranges::transform(std::as_const(array), std::back_inserter(posts), [this](const QJsonValue &value) -> Post * {
-        auto post = new Post(m_account, value.toObject(), this);
-        if (!post->hidden()) {
-            return post;
-        }
-        return nullptr;
+        return m_account->postStore()->acquire(value.toObject(), this);
     });
 
+    // Make sure we aren't adding the same post we already have, even if it isn't shown
     posts.erase(std::ranges::remove_if(posts,
                                        [this](Post *post) {
-                                           if (post == nullptr) {
-                                               return true;
-                                           }
-
-                                           // Don't show boosts if requested
-                                           if (!m_showBoosts && post->boostIdentity()) {
-                                               return true;
-                                           }
-                                           // Don't show replies if requested
-                                           if (!m_showReplies && !post->inReplyTo().isEmpty()) {
-                                               return true;
-                                           }
-                                           // Don't show quotes if requested
-                                           if (!m_showQuotes && post->quotedPost()) {
-                                               return true;
-                                           }
-                                           // Make sure we aren't adding the same post we already have
-                                           const auto it = std::ranges::find_if(std::as_const(m_timeline), [post](const auto &timelinePost) {
-                                               return post->postId() == timelinePost->postId();
-                                           });
-                                           if (it != std::end(m_timeline)) {
+                                           if (m_postIds.contains(post->statusId())) {
+                                               PostStore::release(post, this);
                                                return true;
                                            }
 
@@ -138,44 +141,213 @@ int TimelineModel::fetchedTimeline(const QByteArray &data, bool alwaysAppendToEn
         }
     }
 
-    if (!m_timeline.isEmpty()) {
-        if (alwaysAppendToEnd) {
-            beginInsertRows({}, m_timeline.size(), m_timeline.size() + posts.size() - 1);
-            m_timeline += posts;
-            endInsertRows();
-        } else {
-            const auto postOld = m_timeline.first();
-            const auto postNew = posts.first();
-            if (postOld->originalPostId() > postNew->originalPostId()) {
-                const int row = m_timeline.size();
-                const int last = row + posts.size() - 1;
-                beginInsertRows({}, row, last);
-                m_timeline += posts;
-                endInsertRows();
-            } else {
-                beginInsertRows({}, 0, posts.size() - 1);
-                m_timeline = posts + m_timeline;
-                endInsertRows();
-            }
+    // Pages are sorted newest first, so a page older than what we have goes below it
+    const bool atEnd = m_posts.isEmpty() || alwaysAppendToEnd || m_posts.first()->originalStatusId() > posts.first()->originalStatusId();
+    const int shownCount = insertPosts(posts, atEnd);
+    if (shownCount > 0) {
+        StartupTrace::mark(QStringLiteral("first posts"));
+    }
+
+    // Fetched pages are usually just below the viewport, so decode their previews before they are scrolled to
+    for (const auto post : std::as_const(posts)) {
+        if (post->sensitive() || !isShown(post)) {
+            continue;
         }
+        for (const auto attachment : post->attachments()) {
+            MediaCache::instance().prefetch(attachment);
+        }
+    }
+
+    return shownCount;
+}
+
+int TimelineModel::insertPosts(const QList<Post *> &posts, const bool atEnd)
+{
+    QList<Post *> shownPosts;
+    QList<qsizetype> shownBefore;
+    shownBefore.reserve(posts.size());
+    const qsizetype firstRow = atEnd ? m_timeline.size() : 0;
+    for (const auto post : posts) {
+        shownBefore.append(firstRow + shownPosts.size());
+        if (isShown(post)) {
+            shownPosts.append(post);
+        }
+    }
+
+    if (atEnd) {
+        m_posts += posts;
+        m_shownBefore += shownBefore;
     } else {
-        beginInsertRows({}, 0, posts.size() - 1);
-        m_timeline = posts;
+        m_posts = posts + m_posts;
+        for (auto &count : m_shownBefore) {
+            count += shownPosts.size();
+        }
+        m_shownBefore = shownBefore + m_shownBefore;
+    }
+    countPostIds(posts, 1);
+
+    if (!shownPosts.isEmpty()) {
+        const int row = atEnd ? m_timeline.size() : 0;
+        beginInsertRows({}, row, row + shownPosts.size() - 1);
+        if (atEnd) {
+            m_timeline += shownPosts;
+        } else {
+            m_timeline = shownPosts + m_timeline;
+        }
         endInsertRows();
     }
 
-    return posts.size();
+    return shownPosts.size();
+}
+
+void TimelineModel::setPosts(const QList<Post *> &posts)
+{
+    PostStore::release(std::exchange(m_posts, posts), this);
+    m_postIds.clear();
+    countPostIds(m_posts, 1);
+    m_timeline.clear();
+    std::ranges::copy_if(m_posts, std::back_inserter(m_timeline), [this](const Post *post) {
+        return isShown(post);
+    });
+    updateShownBefore();
+}
+
+qsizetype TimelineModel::postIndex(const int row) const
+{
+    if (row < 0 || row >= m_timeline.size()) {
+        return -1;
+    }
+
+    // The post in a row is the last one with that many shown posts before it, the ones before it with the same count are hidden
+    const auto it = std::ranges::upper_bound(m_shownBefore, qsizetype(row));
+    return std::distance(m_shownBefore.cbegin(), it) - 1;
+}
+
+void TimelineModel::removePost(const qsizetype index)
+{
+    if (index < 0 || index >= m_posts.size()) {
+        return;
+    }
+
+    const auto row = m_shownBefore.takeAt(index);
+    const auto post = m_posts.takeAt(index);
+    countPostIds({post}, -1);
+    if (row < m_timeline.size() && m_timeline[row] == post) {
+        for (auto it = m_shownBefore.begin() + index; it != m_shownBefore.end(); ++it) {
+            --*it;
+        }
+        beginRemoveRows({}, row, row);
+        m_timeline.removeAt(row);
+        endRemoveRows();
+    }
+    PostStore::release(post, this);
+}
+
+void TimelineModel::updateShownBefore()
+{
+    m_shownBefore.resize(m_posts.size());
+    qsizetype row = 0;
+    for (qsizetype i = 0; i < m_posts.size(); i++) {
+        m_shownBefore[i] = row;
+        if (row < m_timeline.size() && m_timeline[row] == m_posts[i]) {
+            row++;
+        }
+    }
+}
+
+void TimelineModel::countPostIds(const QList<Post *> &posts, const int delta)
+{
+    const auto count = [this, delta](const StatusId &id) {
+        const auto it = m_postIds.insert(id, m_postIds.value(id) + delta);
+        if (*it <= 0) {
+            m_postIds.erase(it);
+        }
+    };
+    for (const auto post : posts) {
+        count(post->statusId());
+        if (post->originalStatusId() != post->statusId()) {
+            count(post->originalStatusId());
+        }
+    }
+}
+
+void TimelineModel::updateShownPosts()
+{
+    // Both lists are in the same order, so the rows to insert or remove are found in one pass over them
+    qsizetype row = 0;
+    qsizetype i = 0;
+    while (i < m_posts.size()) {
+        const auto isInView = [this, &row](const Post *post) {
+            return row < m_timeline.size() && m_timeline[row] == post;
+        };
+
+        const bool inView = isInView(m_posts[i]);
+        if (isShown(m_posts[i]) == inView) {
+            if (inView) {
+                row++;
+            }
+            i++;
+            continue;
+        }
+
+        // Neighbouring posts that changed the same way are inserted or removed together
+        if (inView) {
+            qsizetype count = 0;
+            while (i < m_posts.size() && isInView(m_posts[i]) && !isShown(m_posts[i])) {
+                count++;
+                row++;
+                i++;
+            }
+            row -= count;
+            beginRemoveRows({}, row, row + count - 1);
+            m_timeline.remove(row, count);
+            endRemoveRows();
+        } else {
+            QList<Post *> shownPosts;
+            while (i < m_posts.size() && !isInView(m_posts[i]) && isShown(m_posts[i])) {
+                shownPosts.append(m_posts[i]);
+                i++;
+            }
+            beginInsertRows({}, row, row + shownPosts.size() - 1);
+            m_timeline.insert(row, shownPosts.size(), nullptr);
+            std::ranges::copy(shownPosts, m_timeline.begin() + row);
+            endInsertRows();
+            row += shownPosts.size();
+        }
+    }
+    updateShownBefore();
+}
+
+bool TimelineModel::isShown(const Post *post) const
+{
+    if (post->hidden(filterContext())) {
+        return false;
+    }
+    // Don't show boosts if requested
+    if (!m_showBoosts && post->boostIdentity()) {
+        return false;
+    }
+    // Don't show replies if requested
+    if (!m_showReplies && !post->inReplyTo().isEmpty()) {
+        return false;
+    }
+    // Don't show quotes if requested
+    if (!m_showQuotes && post->quotedPost()) {
+        return false;
+    }
+    return true;
 }
 
 void TimelineModel::fetchMore(const QModelIndex &parent)
 {
     Q_UNUSED(parent);
 
-    if (m_timeline.empty()) {
+    if (m_posts.empty()) {
         return;
     }
 
-    const auto p = m_timeline.last();
+    // Continue after the last post, even if it isn't shown
+    const auto p = m_posts.last();
 
     if (m_shouldLoadMore) {
         fillTimeline(p->originalPostId());
@@ -189,25 +361,6 @@ void TimelineModel::setShouldLoadMore(bool shouldLoadMore)
     m_shouldLoadMore = shouldLoadMore;
 }
 
-QString TimelineModel::findLatestPostId(const QStringList &postIds) const
-{
-    if (postIds.isEmpty()) {
-        return QString();
-    }
-
-    // Mastodon API documentation claims that a server is responsible for sorting IDs before generating the API
-    // response: https://docs.joinmastodon.org/api/guidelines/#id
-    // So, we just need to find a first post ID on m_timeline.
-    for (const auto post : std::as_const(m_timeline)) {
-        if (postIds.contains(post->originalPostId())) {
-            return post->originalPostId();
-        }
-    }
-
-    qWarning() << "None of postIds found. It shouldn't happen.";
-    return QString();
-}
-
 bool TimelineModel::canFetchMore(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
@@ -314,9 +467,7 @@ void TimelineModel::actionDelete(const QModelIndex &index)
 
     AbstractTimelineModel::actionDelete(index, p);
 
-    beginRemoveRows({}, row, row);
-    m_timeline.removeAt(row);
-    endRemoveRows();
+    removePost(postIndex(row));
 }
 
 void TimelineModel::actionMute(const QModelIndex &index)
@@ -327,18 +478,149 @@ void TimelineModel::actionMute(const QModelIndex &index)
     AbstractTimelineModel::actionMute(index, p);
 }
 
+bool TimelineModel::active() const
+{
+    return m_active;
+}
+
+void TimelineModel::setActive(const bool active)
+{
+    if (m_active == active) {
+        return;
+    }
+
+    m_active = active;
+    Q_EMIT activeChanged();
+    updateStreamSubscription();
+}
+
+std::pair<QString, QString> TimelineModel::stream() const
+{
+    return {};
+}
+
+void TimelineModel::updateStreamSubscription()
+{
+    const auto wantedStream = m_active && m_account && Config::autoUpdate() ? stream() : std::pair<QString, QString>{};
+    if (wantedStream == m_subscribedStream && m_account == m_streamAccount) {
+        return;
+    }
+
+    if (m_streamAccount && !m_subscribedStream.first.isEmpty()) {
+        m_streamAccount->streaming()->unsubscribe(m_subscribedStream.first, m_subscribedStream.second);
+    }
+    disconnect(m_streamConnection);
+    discardPendingPosts();
+
+    m_subscribedStream = wantedStream;
+    m_streamAccount = m_account;
+    if (wantedStream.first.isEmpty()) {
+        return;
+    }
+
+    const auto streaming = m_account->streaming();
+    streaming->subscribe(wantedStream.first, wantedStream.second);
+    m_streamConnection = connect(streaming,
+                                 &StreamingManager::streamEvent,
+                                 this,
+                                 [this, key = StreamingManager::streamKey(wantedStream.first, wantedStream.second)](const QString &stream,
+                                                                                                                  AbstractAccount::StreamingEventType eventType,
+                                                                                                                  const QByteArray &payload) {
+                                     if (stream == key) {
+                                         handleStreamEvent(eventType, payload);
+                                     }
+                                 });
+}
+
+void TimelineModel::handleStreamEvent(AbstractAccount::StreamingEventType eventType, const QByteArray &payload)
+{
+    if (eventType == AbstractAccount::StreamingEventType::UpdateEvent) {
+        queueStreamedPost(m_account->postStore()->acquire(QJsonDocument::fromJson(payload).object(), this));
+    } else {
+        TimelineModel::handleEvent(eventType, payload);
+    }
+}
+
+void TimelineModel::queueStreamedPost(Post *post)
+{
+    if (!isShown(post)) {
+        PostStore::release(post, this);
+        return;
+    }
+
+    // Checked for every post, so changing the setting applies right away
+    m_streamBuffer.setDeferred(Config::deferStreamedPosts());
+    m_streamBuffer.add(post);
+}
+
+void TimelineModel::discardPendingPosts()
+{
+    m_streamBuffer.clear();
+}
+
+void TimelineModel::refreshPost(Post *post, const Post::Changes changes)
+{
+    if (changes.testFlag(Post::FiltersChange) && post->account() == m_account) {
+        if (m_account->postStore()->isApplyingFilters()) {
+            m_shownPostsOutdated = true;
+        } else if (m_postIds.contains(post->statusId()) && m_posts.contains(post)) {
+            // A single post, for example one that was edited
+            updateShownPosts();
+        }
+    }
+
+    AbstractTimelineModel::refreshPost(post, changes);
+}
+
+int TimelineModel::newPostsCount() const
+{
+    return m_streamBuffer.heldCount();
+}
+
+void TimelineModel::showNewPosts()
+{
+    m_streamBuffer.release();
+}
+
+void TimelineModel::insertStreamedPosts(const QList<Post *> &posts)
+{
+    // Make sure we aren't adding the same post we already have, which happens when a backfill overlaps with the stream
+    QList<Post *> newPosts;
+    newPosts.reserve(posts.size());
+    for (const auto post : posts) {
+        if (m_postIds.contains(post->statusId())) {
+            PostStore::release(post, this);
+        } else {
+            newPosts.append(post);
+        }
+    }
+
+    if (newPosts.isEmpty()) {
+        return;
+    }
+
+    // Filters may have changed while the posts were waiting, so some may not be shown after all
+    if (insertPosts(newPosts, false) > 0) {
+        Q_EMIT streamedPostAdded(m_timeline.first()->originalPostId());
+    }
+}
+
 void TimelineModel::handleEvent(AbstractAccount::StreamingEventType eventType, const QByteArray &payload)
 {
     if (eventType == AbstractAccount::StreamingEventType::DeleteEvent) {
-        int i = 0;
-        for (const auto &post : std::as_const(m_timeline)) {
-            if (post->originalPostId().toUtf8() == payload) {
-                beginRemoveRows({}, i, i);
-                m_timeline.removeAt(i);
-                endRemoveRows();
-                break;
-            }
-            i++;
+        // The post may have been deleted before it was even shown
+        const StatusId statusId(QString::fromUtf8(payload));
+        m_streamBuffer.remove(statusId);
+
+        // Most deleted posts aren't in this timeline
+        if (!m_postIds.contains(statusId)) {
+            return;
+        }
+        const auto it = std::ranges::find_if(std::as_const(m_posts), [&statusId](const Post *post) {
+            return post->originalStatusId() == statusId;
+        });
+        if (it != m_posts.cend()) {
+            removePost(std::distance(m_posts.cbegin(), it));
         }
     }
 }
@@ -6,6 +6,9 @@
 
 #include "account/abstractaccount.h"
 #include "timeline/abstracttimelinemodel.h"
+#include "timeline/streambuffer.h"
+
+#include <QPointer>
 
 /**
  * @brief Model building on top of AbstractTimelineModel, used by MainTimelineModel and ThreadModel for example.
@@ -20,9 +23,12 @@ class TimelineModel : public AbstractTimelineModel
     Q_PROPERTY(bool showReplies MEMBER m_showReplies NOTIFY showRepliesChanged)
     Q_PROPERTY(bool showBoosts MEMBER m_showBoosts NOTIFY showBoostsChanged)
     Q_PROPERTY(bool showQuotes MEMBER m_showQuotes NOTIFY showQuotesChanged)
+    Q_PROPERTY(bool active READ active WRITE setActive NOTIFY activeChanged)
+    Q_PROPERTY(int newPostsCount READ newPostsCount NOTIFY newPostsCountChanged)
 
 public:
     explicit TimelineModel(QObject *parent = nullptr);
+    ~TimelineModel() override;
 
     [[nodiscard]] int rowCount(const QModelIndex &parent) const override;
     [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
@@ -50,9 +56,26 @@ public:
     void setShouldLoadMore(bool shouldLoadMore);
 
     /**
-     * @return Returns the newest/latest post ID from @p postIds.
+     * @return Whether the timeline is currently shown. Its live stream is only subscribed to while it is.
+     * @see setActive()
+     */
+    [[nodiscard]] bool active() const;
+
+    /**
+     * @brief Set whether the timeline is currently shown, usually bound to the visibility of its page.
      */
-    [[nodiscard]] QString findLatestPostId(const QStringList &postIds) const;
+    void setActive(bool active);
+
+    /**
+     * @return The number of streamed posts waiting to be shown, when they aren't added to the timeline right away.
+     * @see showNewPosts()
+     */
+    [[nodiscard]] int newPostsCount() const;
+
+    /**
+     * @brief Add the streamed posts that are waiting to be shown to the top of the timeline.
+     */
+    Q_INVOKABLE void showNewPosts();
 
 public Q_SLOTS:
     /**
@@ -120,6 +143,9 @@ Q_SIGNALS:
     void showBoostsChanged();
     void showQuotesChanged();
 
+    void activeChanged();
+    void newPostsCountChanged();
+
     void repositionAt(int index);
     void streamedPostAdded(const QString &postId);
 
@@ -128,17 +154,103 @@ protected:
     [[nodiscard]] bool canFetchMore(const QModelIndex &parent) const override;
 
     /**
-     * @return The number of posts added to the timeline.
+     * @return The number of rows added to the timeline.
      */
     int fetchedTimeline(const QByteArray &array, bool alwaysAppendToEnd = false);
 
+    /**
+     * @brief Adds @p posts to the top, or the bottom if @p atEnd is set, and inserts the rows of the ones that are shown.
+     * @return The number of rows inserted.
+     */
+    int insertPosts(const QList<Post *> &posts, bool atEnd);
+
+    /**
+     * @brief Replaces every post with @p posts, releasing the previous ones. Call it between beginResetModel() and endResetModel().
+     */
+    void setPosts(const QList<Post *> &posts);
+
+    /**
+     * @return Whether @p post is shown, instead of being hidden by a filter or one of the show settings.
+     */
+    [[nodiscard]] virtual bool isShown(const Post *post) const;
+
+    /**
+     * @return The stream and its parameter that keep this timeline live, see StreamingManager::subscribe(). Empty if there's none.
+     */
+    [[nodiscard]] virtual std::pair<QString, QString> stream() const;
+
+    /**
+     * @brief Subscribe to stream() while the timeline is active, and release the previous subscription if it changed.
+     */
+    void updateStreamSubscription();
+
+    /**
+     * @brief Handle an incoming event of the stream from stream().
+     */
+    virtual void handleStreamEvent(AbstractAccount::StreamingEventType eventType, const QByteArray &payload);
+
+    /**
+     * @brief Queue a streamed post, to be inserted at the top together with everything else streamed during the same frame.
+     */
+    void queueStreamedPost(Post *post);
+
+    /**
+     * @brief Drop the streamed posts that weren't inserted yet, including the ones waiting to be shown.
+     */
+    void discardPendingPosts();
+
+    /**
+     * @brief Also takes out the rows of @p post once a filter hides it.
+     */
+    void refreshPost(Post *post, Post::Changes changes) override;
+
     AccountManager *m_manager = nullptr;
 
-    QList<Post *> m_timeline;
+    QList<Post *> m_posts; ///< Every post of the timeline, including the ones that aren't shown
+    QList<Post *> m_timeline; ///< The posts that are shown, one per row, in the same order as m_posts
 
     bool m_shouldLoadMore = true;
     bool m_showReplies = true;
     bool m_showBoosts = true;
     bool m_showQuotes = true;
+
+private:
+    void insertStreamedPosts(const QList<Post *> &posts);
+
+    /**
+     * @brief Sets m_shownBefore from m_posts and m_timeline again.
+     */
+    void updateShownBefore();
+
+    /**
+     * @brief Adds @p delta to the counts of the ids of @p posts in m_postIds, for posts added to or taken out of m_posts.
+     */
+    void countPostIds(const QList<Post *> &posts, int delta);
+
+    /**
+     * @return The index in m_posts of the post in @p row.
+     */
+    [[nodiscard]] qsizetype postIndex(int row) const;
+
+    /**
+     * @brief Removes the post at @p index of m_posts, and its row if it's shown.
+     */
+    void removePost(qsizetype index);
+
+    /**
+     * @brief Inserts and removes rows for the posts that are shown now, after a show setting or the filters changed.
+     */
+    void updateShownPosts();
+
+    QList<qsizetype> m_shownBefore; ///< For each post of m_posts, how many shown posts come before it. That is its row if it's shown.
+    QHash<StatusId, int> m_postIds; ///< How many posts of m_posts have each status id, or boost id for boosts
+    StreamBuffer m_streamBuffer;
+    bool m_shownPostsOutdated = false; ///< Filters changed the shown posts while they were applied, see AccountManager::filtersApplied()
+
+    bool m_active = true;
+    QPointer<AbstractAccount> m_streamAccount;
+    std::pair<QString, QString> m_subscribedStream;
+    QMetaObject::Connection m_streamConnection;
+
     friend class TimelineTest;
 };
@@ -3,6 +3,8 @@
 
 #include "blurhash.h"
 
+#include "utils/tracing.h"
+
 #include <QColorSpace>
 
 // From https://github.com/woltapp/blurhash/blob/master/Algorithm.md#base-83
@@ -13,6 +15,8 @@ const static auto fromLinearSRGB = QColorSpace(QColorSpace::SRgbLinear).transfor
 
 QImage BlurHash::decode(const QString &blurhash, const QSize &size)
 {
+    const Tracing::Scope trace("image", "BlurHash::decode");
+
     // 10 is the minimum length of a blurhash string
     if (blurhash.length() < 10) {
         return {};
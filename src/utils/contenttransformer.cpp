@@ -0,0 +1,414 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/contenttransformer.h"
+
+#include <QJsonObject>
+
+#include <algorithm>
+#include <utility>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Matches \s in the regular expressions this replaces, so &nbsp; and friends still count as text
+bool isSpace(const QChar c)
+{
+    return c == u' ' || c == u'\t' || c == u'\n' || c == u'\r' || c == u'\f' || c == u'\v';
+}
+
+bool isBlank(const QStringView text)
+{
+    return std::ranges::all_of(text, isSpace);
+}
+
+bool isShortcode(const QStringView text)
+{
+    return !text.isEmpty() && std::ranges::all_of(text, [](const QChar c) {
+        return (c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z') || (c >= u'0' && c <= u'9') || c == u'_';
+    });
+}
+
+// Where the output would end without the whitespace before @p end
+qsizetype trimmedEnd(const QString &out, qsizetype end)
+{
+    while (end > 0 && isSpace(out[end - 1])) {
+        end--;
+    }
+    return end;
+}
+
+// The index of the '>' closing the tag starting at @p from, skipping over quoted attribute values
+qsizetype findTagEnd(const QStringView html, const qsizetype from)
+{
+    QChar quote;
+    for (qsizetype i = from + 1; i < html.size(); i++) {
+        const QChar c = html[i];
+        if (!quote.isNull()) {
+            if (c == quote) {
+                quote = QChar();
+            }
+        } else if (c == u'"' || c == u'\'') {
+            quote = c;
+        } else if (c == u'>') {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// The name of @p tag, with a leading slash for closing tags
+QStringView tagName(const QStringView tag)
+{
+    qsizetype end = 1;
+    if (end < tag.size() && tag[end] == u'/') {
+        end++;
+    }
+    while (end < tag.size() && tag[end].isLetterOrNumber()) {
+        end++;
+    }
+    return tag.sliced(1, end - 1);
+}
+
+bool isTag(const QStringView name, const QLatin1StringView expected)
+{
+    return name.compare(expected, Qt::CaseInsensitive) == 0;
+}
+
+// The character the entity @p name (without '&' and ';') stands for, or 0 for unknown ones
+char32_t decodeEntity(const QStringView name)
+{
+    if (name.startsWith(u'#')) {
+        bool ok = false;
+        const bool hex = name.size() > 1 && (name[1] == u'x' || name[1] == u'X');
+        const uint code = hex ? name.sliced(2).toUInt(&ok, 16) : name.sliced(1).toUInt(&ok);
+        return ok && code > 0 && code <= 0x10FFFF ? code : 0;
+    }
+
+    static constexpr std::pair<QStringView, char32_t> entities[] = {
+        {u"amp", U'&'},
+        {u"lt", U'<'},
+        {u"gt", U'>'},
+        {u"quot", U'"'},
+        {u"apos", U'\''},
+        {u"nbsp", U'\u00A0'},
+    };
+    for (const auto &[entity, character] : entities) {
+        if (name == entity) {
+            return character;
+        }
+    }
+    return 0;
+}
+
+// Appends @p text to @p out with the character references decoded, which is all there is to plain text besides the tags
+void appendDecoded(QString &out, const QStringView text)
+{
+    qsizetype copied = 0;
+    qsizetype start = text.indexOf(u'&');
+    while (start >= 0) {
+        const qsizetype end = text.indexOf(u';', start + 1);
+        if (end < 0) {
+            break;
+        }
+
+        const char32_t character = decodeEntity(text.sliced(start + 1, end - start - 1));
+        if (character == 0) {
+            start = text.indexOf(u'&', start + 1);
+            continue;
+        }
+
+        out += text.sliced(copied, start - copied);
+        const char32_t characters[] = {character};
+        out += QString::fromUcs4(characters, 1);
+        copied = end + 1;
+        start = text.indexOf(u'&', copied);
+    }
+
+    out += text.sliced(copied);
+}
+}
+
+ContentTransformer::ContentTransformer(const QList<CustomEmoji> &emojis, const QString &baseUrl, const QJsonArray &tags, const QJsonArray &mentions)
+{
+    for (const auto &emoji : emojis) {
+        m_emojis.insert(emoji.shortcode, QStringLiteral("<img height=\"16\" align=\"middle\" width=\"16\" src=\"%1\">").arg(emoji.url));
+    }
+
+    // The "url" field in the tag object is for our own instance, but the links in the HTML point to the author's instance
+    if (!tags.isEmpty()) {
+        m_tagPrefixes = {
+            baseUrl + u"/tags/"_s, // Mastodon
+            baseUrl + u"/tag/"_s, // Akkoma/Pleroma
+        };
+    }
+    for (const auto &tag : tags) {
+        const QString name = tag["name"_L1].toString();
+        m_tags.insert(name.toLower(), name);
+    }
+
+    for (const auto &mention : mentions) {
+        const QString url = mention["url"_L1].toString();
+        if (!m_mentions.contains(url)) {
+            m_mentions.insert(url, u"account:/"_s + mention["id"_L1].toString());
+        }
+    }
+}
+
+ContentTransformer::Result ContentTransformer::transform(const QString &html) const
+{
+    enum class Segment {
+        None,
+        Paragraph,
+        Break,
+    };
+
+    struct Standalone {
+        qsizetype start;
+        qsizetype end;
+        QList<QString> tags;
+    };
+
+    const QStringView input(html);
+
+    QString out;
+    out.reserve(html.size() + html.size() / 4);
+
+    // The text without any markup, built along the way so filtering doesn't need a QTextDocument
+    QString plain;
+    plain.reserve(html.size());
+
+    // The end of the last text or element that isn't whitespace or a line break
+    qsizetype contentEnd = 0;
+    bool breakSinceContent = false;
+
+    // The paragraph that is currently open
+    qsizetype paragraphStart = -1;
+    qsizetype paragraphContentStart = 0;
+    bool paragraphHasContent = false;
+
+    // The current paragraph, or the part of it after the last line break, and the hashtags in it
+    Segment segment = Segment::None;
+    qsizetype segmentStart = 0;
+    QList<QString> segmentTags;
+    bool segmentTagsOnly = false;
+
+    std::optional<Standalone> standalone;
+
+    const auto markContent = [&](const bool hashtag) {
+        contentEnd = out.size();
+        breakSinceContent = false;
+        paragraphHasContent = true;
+        if (!hashtag) {
+            segmentTagsOnly = false;
+        }
+    };
+
+    const auto startSegment = [&](const Segment type, const qsizetype start) {
+        segment = type;
+        segmentStart = start;
+        segmentTags.clear();
+        segmentTagsOnly = true;
+        standalone.reset();
+    };
+
+    qsizetype i = 0;
+    while (i < input.size()) {
+        if (input[i] != u'<') {
+            qsizetype end = input.indexOf(u'<', i);
+            if (end < 0) {
+                end = input.size();
+            }
+
+            const QStringView text = input.sliced(i, end - i);
+            appendText(out, text);
+            appendDecoded(plain, text);
+            if (!isBlank(text)) {
+                markContent(false);
+            }
+            i = end;
+            continue;
+        }
+
+        const qsizetype tagEnd = findTagEnd(input, i);
+        if (tagEnd < 0) {
+            // Broken markup, keep the rest as is
+            out += input.sliced(i);
+            plain += input.sliced(i);
+            markContent(false);
+            break;
+        }
+
+        const QStringView tag = input.sliced(i, tagEnd - i + 1);
+        const QStringView name = tagName(tag);
+        i = tagEnd + 1;
+
+        if (isTag(name, "p"_L1)) {
+            paragraphStart = trimmedEnd(out, out.size());
+            paragraphHasContent = false;
+            out += tag;
+            paragraphContentStart = out.size();
+            if (!plain.isEmpty()) {
+                plain += "\n\n"_L1;
+            }
+            startSegment(Segment::Paragraph, paragraphStart);
+        } else if (isTag(name, "br"_L1)) {
+            startSegment(Segment::Break, std::max(contentEnd, paragraphContentStart));
+            out += tag;
+            plain += u'\n';
+            breakSinceContent = true;
+        } else if (isTag(name, "/p"_L1)) {
+            if (paragraphStart >= 0 && !paragraphHasContent) {
+                // Nothing but whitespace and line breaks, so drop the whole paragraph
+                out.truncate(paragraphStart);
+                contentEnd = std::min(contentEnd, out.size());
+                standalone.reset();
+            } else {
+                if (breakSinceContent) {
+                    out.truncate(contentEnd);
+                }
+
+                if (segment != Segment::None && segmentTagsOnly && !segmentTags.isEmpty()) {
+                    standalone = Standalone{segmentStart, out.size(), segmentTags};
+                } else {
+                    standalone.reset();
+                }
+
+                out += tag;
+
+                // A paragraph of hashtags is removed entirely, after a line break only the hashtags are
+                if (standalone && segment == Segment::Paragraph) {
+                    standalone->end = out.size();
+                }
+            }
+
+            paragraphStart = -1;
+            paragraphContentStart = out.size();
+            breakSinceContent = false;
+            segment = Segment::None;
+        } else if (isTag(name, "a"_L1)) {
+            const QString anchor = rewriteAnchor(tag);
+
+            // Hashtag links look like <a ...>#<span>name</span></a>
+            const QStringView rest = input.sliced(i);
+            static constexpr QStringView hashtagStart = u"#<span>";
+            static constexpr QStringView hashtagEnd = u"</span></a>";
+            if (rest.startsWith(hashtagStart)) {
+                const qsizetype nameStart = hashtagStart.size();
+                const qsizetype nameEnd = rest.indexOf(u'<', nameStart);
+                if (nameEnd >= 0 && rest.sliced(nameEnd).startsWith(hashtagEnd)) {
+                    const QStringView hashtag = rest.sliced(nameStart, nameEnd - nameStart);
+                    if (!std::ranges::any_of(hashtag, isSpace)) {
+                        const qsizetype length = nameEnd + hashtagEnd.size();
+                        out += anchor;
+                        out += rest.first(length);
+                        plain += u'#';
+                        appendDecoded(plain, hashtag);
+                        markContent(true);
+                        segmentTags.append(hashtag.toString());
+                        i += length;
+                        continue;
+                    }
+                }
+            }
+
+            out += anchor;
+            markContent(false);
+        } else {
+            out += tag;
+            markContent(false);
+        }
+    }
+
+    QList<QString> standaloneTags;
+    if (standalone) {
+        out.remove(standalone->start, standalone->end - standalone->start);
+        standaloneTags = standalone->tags;
+    }
+
+    return {out, standaloneTags, plain};
+}
+
+void ContentTransformer::appendText(QString &out, const QStringView text) const
+{
+    if (m_emojis.isEmpty()) {
+        out += text;
+        return;
+    }
+
+    qsizetype copied = 0;
+    qsizetype open = text.indexOf(u':');
+    while (open >= 0) {
+        const qsizetype close = text.indexOf(u':', open + 1);
+        if (close < 0) {
+            break;
+        }
+
+        const QStringView shortcode = text.sliced(open + 1, close - open - 1);
+        const auto emoji = isShortcode(shortcode) ? m_emojis.constFind(shortcode.toString()) : m_emojis.cend();
+        if (emoji == m_emojis.cend()) {
+            // The closing colon may start the next shortcode
+            open = close;
+            continue;
+        }
+
+        out += text.sliced(copied, open - copied);
+        out += *emoji;
+        copied = close + 1;
+        open = text.indexOf(u':', copied);
+    }
+
+    out += text.sliced(copied);
+}
+
+QString ContentTransformer::rewriteAnchor(const QStringView tag) const
+{
+    static constexpr QStringView hrefStart = u"href=\"";
+    const qsizetype attributeStart = tag.indexOf(hrefStart);
+    if (attributeStart < 0) {
+        return tag.toString();
+    }
+
+    const qsizetype valueStart = attributeStart + hrefStart.size();
+    const qsizetype valueEnd = tag.indexOf(u'"', valueStart);
+    if (valueEnd < 0) {
+        return tag.toString();
+    }
+
+    const QStringView href = tag.sliced(valueStart, valueEnd - valueStart);
+
+    QString replacement;
+    // Mentions don't link to account ids, so map the account URL to the one we got from the server
+    if (tag.contains(u"class=\"u-url mention\"")) {
+        replacement = m_mentions.value(href.toString());
+    }
+    if (replacement.isEmpty()) {
+        replacement = hashtagLink(href);
+    }
+    if (replacement.isEmpty()) {
+        return tag.toString();
+    }
+
+    QString anchor;
+    anchor.reserve(tag.size() - href.size() + replacement.size());
+    anchor += tag.first(valueStart);
+    anchor += replacement;
+    anchor += tag.sliced(valueEnd);
+    return anchor;
+}
+
+QString ContentTransformer::hashtagLink(const QStringView href) const
+{
+    for (const auto &prefix : m_tagPrefixes) {
+        if (!href.startsWith(prefix, Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        const auto tag = m_tags.constFind(href.sliced(prefix.size()).toString().toLower());
+        if (tag != m_tags.cend()) {
+            return u"hashtag:/"_s + *tag;
+        }
+    }
+    return {};
+}
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QString>
+
+#include "utils/customemoji.h"
+
+/**
+ * @brief Rewrites the HTML content of a post for display, in a single pass over the markup.
+ *
+ * This replaces custom emojis, points hashtag and mention links inside Tokodon and extracts the "standalone tags" at the
+ * end of the post (see Post::standaloneTags). Empty paragraphs and line breaks at the end of paragraphs are removed along
+ * the way, as they mess up the spacing of posts.
+ *
+ * Standalone tags are the hashtags making up the last paragraph, or the part of it after the last line break, as long as
+ * nothing else but whitespace is there.
+ */
+class ContentTransformer
+{
+public:
+    struct Result {
+        QString content;
+        QList<QString> standaloneTags;
+        /// The text with tags stripped and entities decoded, standalone tags included
+        QString plainText;
+    };
+
+    /**
+     * @param emojis The custom emojis used in the content.
+     * @param baseUrl The URL of the author's instance, which hashtag links point to.
+     * @param tags The hashtags used in the content, the "tags" array of a status.
+     * @param mentions The accounts mentioned in the content, the "mentions" array of a status.
+     */
+    ContentTransformer(const QList<CustomEmoji> &emojis, const QString &baseUrl, const QJsonArray &tags, const QJsonArray &mentions);
+
+    /**
+     * @return The processed @p html, the standalone tags that were removed from it and its plain text.
+     */
+    [[nodiscard]] Result transform(const QString &html) const;
+
+private:
+    void appendText(QString &out, QStringView text) const;
+    [[nodiscard]] QString rewriteAnchor(QStringView tag) const;
+    [[nodiscard]] QString hashtagLink(QStringView href) const;
+
+    QHash<QString, QString> m_emojis;
+    QList<QString> m_tagPrefixes;
+    QHash<QString, QString> m_tags;
+    QHash<QString, QString> m_mentions;
+};
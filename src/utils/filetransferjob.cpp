@@ -7,84 +7,540 @@
 #include "tokodon_http_debug.h"
 
 #include <KLocalizedString>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QNetworkReply>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <filesystem>
+
+using namespace Qt::Literals::StringLiterals;
+
+// Files larger than this are split into several ranges fetched in parallel
+static constexpr qint64 segmentThreshold = 16 * 1024 * 1024;
+static constexpr int maxSegments = 4;
+
+// How often the journal is written to disk while downloading
+static constexpr qint64 journalInterval = 1024 * 1024;
+
+static constexpr int maxRetries = 5;
+static constexpr int retryDelay = 1000;
+
+static constexpr qint64 copyChunkSize = 1024 * 1024;
+
+// The partial files being written to, so two jobs never share one
+static QSet<QString> activePartFiles;
+
+bool FileTransferJob::Segment::complete() const
+{
+    return end != -1 && written >= end - start + 1;
+}
 
 FileTransferJob::FileTransferJob(AbstractAccount *account, const QString &source, const QString &destination)
     : KJob()
     , m_account(account)
     , m_source(source)
     , m_destination(destination)
-    , m_temporaryFile(new QSaveFile(destination))
 {
-    // Enable direct write on Android, because we don't have the permissions to write anywhere where we save
-#ifdef Q_OS_ANDROID
-    m_temporaryFile->setDirectWriteFallback(true);
-#endif
+    const QString downloadDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/downloads/");
+    QDir().mkpath(downloadDir);
+
+    // Keyed by destination, so downloading the same file to two places doesn't mix them up
+    const QString name = QString::fromLatin1(QCryptographicHash::hash(destination.toUtf8(), QCryptographicHash::Sha1).toHex());
+    m_partFile.setFileName(downloadDir + name + QLatin1String(".part"));
+    m_journalPath = downloadDir + name + QLatin1String(".json");
 }
 
 void FileTransferJob::start()
 {
     if (auto account = qobject_cast<Account *>(m_account); account) {
-        auto qnam = account->qnam();
-
-        auto reply = qnam->get(QNetworkRequest(QUrl(m_source)));
+        m_qnam = account->qnam();
 
         setTotalAmount(Unit::Files, 1);
-        if (!m_temporaryFile->open(QIODevice::WriteOnly)) {
-            qCWarning(TOKODON_HTTP) << "Couldn't open the temporary file" << m_temporaryFile->fileName() << "for writing" << m_temporaryFile->errorString();
+
+        Q_EMIT description(this,
+                           i18nc("Job heading, like 'Copying'", "Downloading"),
+                           {i18nc("The URL being downloaded/uploaded", "Source"), m_source},
+                           {i18nc("The location being downloaded to", "Destination"), m_destination});
+
+        if (activePartFiles.contains(m_partFile.fileName())) {
+            qCWarning(TOKODON_HTTP) << "Already downloading to" << m_destination;
+            // Not through fail(), the partial data belongs to the other job
             setError(FileError);
-            setErrorText(i18n("Could not open the temporary download file"));
+            setErrorText(i18n("This file is already being downloaded"));
             emitResult();
             return;
         }
-        connect(reply, &QNetworkReply::downloadProgress, this, [this](qint64 bytesReceived, qint64 bytesTotal) {
-            if (bytesTotal != -1) {
-                setTotalAmount(Unit::Bytes, bytesTotal);
-            }
-            setProcessedAmount(Unit::Bytes, bytesReceived);
-        });
+        activePartFiles.insert(m_partFile.fileName());
+
+        if (loadJournal() && openPartFile(false)) {
+            qCDebug(TOKODON_HTTP) << "Resuming download of" << m_source << "from" << m_partFile.fileName();
+            updateProgress();
 
-        connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-            if (reply->error() != QNetworkReply::NoError) {
-                setError(FileError);
-                setErrorText(reply->errorString());
-                emitResult();
+            const bool complete = std::ranges::all_of(std::as_const(m_segments), [](const Segment &segment) {
+                return segment.complete();
+            });
+            if (complete) {
+                finishTransfer();
                 return;
             }
-            if (!m_temporaryFile->commit()) {
-                qCWarning(TOKODON_HTTP) << "errror when saving";
+
+            for (int i = 0; i < m_segments.size(); i++) {
+                if (!m_segments[i].complete()) {
+                    startSegment(i);
+                }
             }
-            reply->deleteLater();
-            emitResult();
-        });
+            return;
+        }
+
+        fetchMetadata();
+    }
+}
+
+bool FileTransferJob::doKill()
+{
+    abortSegments();
+
+    // Keep what we have, so the next attempt can continue from there
+    saveJournal();
+    m_partFile.close();
+    activePartFiles.remove(m_partFile.fileName());
+    return true;
+}
+
+void FileTransferJob::fetchMetadata()
+{
+    QNetworkRequest request((QUrl(m_source)));
+    // Ranges are applied to the encoded body, so make sure we always get the file as is
+    request.setRawHeader("Accept-Encoding", "identity");
+
+    auto reply = m_qnam->head(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply] {
+        reply->deleteLater();
+
+        // Some servers don't answer HEAD requests properly, in which case we fall back to a single plain request
+        if (reply->error() != QNetworkReply::NoError) {
+            qCDebug(TOKODON_HTTP) << "HEAD request for" << m_source << "failed, downloading without ranges" << reply->errorString();
+            m_totalSize = -1;
+            planSegments(false);
+            return;
+        }
+
+        const auto length = reply->header(QNetworkRequest::ContentLengthHeader);
+        m_totalSize = length.isValid() ? length.toLongLong() : -1;
+        m_etag = reply->rawHeader("ETag");
+        planSegments(reply->rawHeader("Accept-Ranges").trimmed() == "bytes");
+    });
+}
+
+void FileTransferJob::planSegments(const bool acceptRanges)
+{
+    m_segments.clear();
+    if (!openPartFile(true)) {
+        fail(i18n("Could not open the temporary download file"));
+        return;
+    }
 
-        connect(reply, &QIODevice::readyRead, this, [this, reply] {
-            auto bytes = reply->read(reply->bytesAvailable());
-            if (!bytes.isEmpty()) {
-                m_temporaryFile->write(bytes);
-            } else {
-                qCWarning(TOKODON_HTTP) << "Unexpected empty chunk when downloading from" << reply->url() << "to" << m_temporaryFile->fileName();
+    if (acceptRanges && m_totalSize >= segmentThreshold) {
+        // Writes are positional, so the file can be allocated up front
+        if (!m_partFile.resize(m_totalSize)) {
+            qCWarning(TOKODON_HTTP) << "Failed to allocate" << m_totalSize << "bytes for" << m_partFile.fileName();
+            fail(i18n("Could not reserve disk space for download"));
+            return;
+        }
+
+        const qint64 segmentSize = m_totalSize / maxSegments;
+        for (int i = 0; i < maxSegments; i++) {
+            const qint64 start = i * segmentSize;
+            const qint64 end = i == maxSegments - 1 ? m_totalSize - 1 : start + segmentSize - 1;
+            m_segments.push_back(Segment{.start = start, .end = end});
+        }
+    } else {
+        m_segments.push_back(Segment{.start = 0, .end = m_totalSize > 0 ? m_totalSize - 1 : -1});
+    }
+
+    saveJournal();
+    updateProgress();
+
+    for (int i = 0; i < m_segments.size(); i++) {
+        startSegment(i);
+    }
+}
+
+void FileTransferJob::startSegment(const int index)
+{
+    auto &segment = m_segments[index];
+
+    QNetworkRequest request((QUrl(m_source)));
+    request.setRawHeader("Accept-Encoding", "identity");
+    // Media can be huge, and the partial file already does the caching for us
+    request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, false);
+
+    const qint64 from = segment.start + segment.written;
+    if (from > 0 || m_segments.size() > 1) {
+        const QString range = segment.end != -1 ? u"bytes=%1-%2"_s.arg(from).arg(segment.end) : u"bytes=%1-"_s.arg(from);
+        request.setRawHeader("Range", range.toLatin1());
+        // If the file changed since, the server sends the whole new file instead
+        if (!m_etag.isEmpty()) {
+            request.setRawHeader("If-Range", m_etag);
+        }
+    }
+
+    auto reply = m_qnam->get(request);
+    segment.reply = reply;
+
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply, index] {
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status == 206) {
+            // A server or proxy can answer with another range than the one we asked for, which would be written at the wrong place
+            const auto &segment = m_segments[index];
+            const qint64 from = segment.start + segment.written;
+            const QByteArray contentRange = reply->rawHeader("Content-Range");
+            bool ok = false;
+            const qint64 start = contentRange.startsWith("bytes ") ? contentRange.sliced(6).split('-').constFirst().toLongLong(&ok) : -1;
+            if (!ok || start != from) {
+                qCDebug(TOKODON_HTTP) << "Asked for" << m_source << "from" << from << "but got" << contentRange << ", starting over";
+                restart();
             }
-        });
+            return;
+        }
+        if (status != 200) {
+            // This is an error we handle once the reply finished
+            return;
+        }
+
+        // We received the whole file, because the server ignores ranges or the file changed since we started
+        if (m_segments.size() > 1) {
+            restart();
+            return;
+        }
+
+        auto &segment = m_segments[index];
+        if (segment.written > 0) {
+            qCDebug(TOKODON_HTTP) << "Server sent the whole file for" << m_source << ", starting over";
+            segment.written = 0;
+            m_partFile.resize(0);
+        }
+
+        const auto length = reply->header(QNetworkRequest::ContentLengthHeader);
+        m_totalSize = length.isValid() ? length.toLongLong() : -1;
+        segment.end = m_totalSize > 0 ? m_totalSize - 1 : -1;
+        m_etag = reply->rawHeader("ETag");
+        saveJournal();
+        updateProgress();
+    });
+
+    connect(reply, &QIODevice::readyRead, this, [this, reply, index] {
+        const QByteArray bytes = reply->readAll();
+        if (bytes.isEmpty()) {
+            qCWarning(TOKODON_HTTP) << "Unexpected empty chunk when downloading from" << reply->url() << "to" << m_partFile.fileName();
+            return;
+        }
+
+        auto &segment = m_segments[index];
+
+        // Never write past the end of the segment, in case the server sends more than requested
+        qint64 length = bytes.size();
+        if (segment.end != -1) {
+            length = std::min(length, segment.end - segment.start + 1 - segment.written);
+        }
+        if (length <= 0) {
+            return;
+        }
+
+        if (!m_partFile.seek(segment.start + segment.written) || m_partFile.write(bytes.constData(), length) != length) {
+            qCWarning(TOKODON_HTTP) << "Couldn't write to" << m_partFile.fileName() << m_partFile.errorString();
+            fail(i18n("Could not write to the temporary download file"));
+            return;
+        }
+
+        segment.written += length;
+        m_unsavedBytes += length;
+        if (m_unsavedBytes >= journalInterval) {
+            saveJournal();
+        }
+        updateProgress();
+    });
+
+    connect(reply, &QNetworkReply::finished, this, [this, index] {
+        handleSegmentFinished(index);
+    });
+}
+
+void FileTransferJob::handleSegmentFinished(const int index)
+{
+    auto &segment = m_segments[index];
+    auto reply = std::exchange(segment.reply, nullptr);
+    if (reply == nullptr) {
+        return;
+    }
+    reply->deleteLater();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 416) {
+        // Range Not Satisfiable, what we have doesn't match the remote file anymore
+        restart();
+        return;
+    }
 
-        connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply] {
-            auto sizeHeader = reply->header(QNetworkRequest::ContentLengthHeader);
-            if (sizeHeader.isValid()) {
-                auto targetSize = sizeHeader.toLongLong();
-                if (targetSize != -1) {
-                    if (!m_temporaryFile->resize(targetSize)) {
-                        qCWarning(TOKODON_HTTP) << "Failed to allocate" << targetSize << "bytes for" << m_temporaryFile->fileName();
-                        setError(FileError);
-                        setErrorText(i18n("Could not reserve disk space for download"));
-                        emitResult();
-                    }
+    if (reply->error() == QNetworkReply::NoError && segment.end == -1) {
+        // The server didn't tell us the size up front, so the end of the stream is the end of the file
+        segment.end = segment.start + segment.written - 1;
+        m_totalSize = segment.written;
+
+        if (m_totalSize == 0) {
+            finishTransfer();
+            return;
+        }
+    }
+
+    if (reply->error() != QNetworkReply::NoError || !segment.complete()) {
+        saveJournal();
+
+        // Client errors won't go away by retrying
+        const bool transient = status < 400 || status >= 500;
+        if (transient && segment.retries < maxRetries) {
+            segment.retries++;
+            qCDebug(TOKODON_HTTP) << "Download of" << m_source << "interrupted at" << segment.start + segment.written << ", retrying"
+                                  << reply->errorString();
+            QTimer::singleShot(retryDelay * segment.retries, this, [this, index] {
+                // Killed in the meantime
+                if (!isFinished()) {
+                    startSegment(index);
                 }
-            }
+            });
+            return;
+        }
+
+        fail(reply->error() != QNetworkReply::NoError ? reply->errorString() : i18n("The connection was closed before the download finished"));
+        return;
+    }
+
+    segment.retries = 0;
+
+    const bool complete = std::ranges::all_of(std::as_const(m_segments), [](const Segment &segment) {
+        return segment.complete();
+    });
+    if (complete) {
+        finishTransfer();
+    }
+}
+
+void FileTransferJob::restart()
+{
+    if (m_restarted) {
+        removePartialData();
+        fail(i18n("The file changed on the server while downloading"));
+        return;
+    }
+    m_restarted = true;
+
+    qCDebug(TOKODON_HTTP) << "Partial download of" << m_source << "is outdated, starting over";
+
+    abortSegments();
+
+    m_segments.clear();
+    m_etag.clear();
+    m_totalSize = -1;
+    fetchMetadata();
+}
+
+void FileTransferJob::finishTransfer()
+{
+    m_partFile.flush();
+
+    qint64 received = 0;
+    for (const auto &segment : std::as_const(m_segments)) {
+        received += segment.written;
+    }
+
+    if (received != m_totalSize || m_partFile.size() != m_totalSize) {
+        qCWarning(TOKODON_HTTP) << "Downloaded" << received << "bytes into a file of" << m_partFile.size() << "bytes, expected" << m_totalSize;
+        removePartialData();
+        fail(i18n("The downloaded file does not have the expected size"));
+        return;
+    }
+
+    m_partFile.close();
+
+    // Replaces the destination at once, but only works on the same file system
+    std::error_code renameError;
+    std::filesystem::rename(m_partFile.filesystemFileName(), QFileInfo(m_destination).filesystemFilePath(), renameError);
+    if (renameError) {
+        qCDebug(TOKODON_HTTP) << "Couldn't move" << m_partFile.fileName() << "to" << m_destination << ", copying it instead"
+                              << QString::fromStdString(renameError.message());
+        if (!copyToDestination()) {
+            return;
+        }
+    }
+
+    removePartialData();
+    setProcessedAmount(Unit::Files, 1);
+    emitResult();
+}
+
+bool FileTransferJob::copyToDestination()
+{
+    QSaveFile destination(m_destination);
+    // Enable direct write on Android, because we don't have the permissions to write anywhere where we save
+#ifdef Q_OS_ANDROID
+    destination.setDirectWriteFallback(true);
+#endif
+    if (!destination.open(QIODevice::WriteOnly) || !m_partFile.open(QIODevice::ReadOnly)) {
+        qCWarning(TOKODON_HTTP) << "Couldn't copy" << m_partFile.fileName() << "to" << destination.fileName() << m_partFile.errorString()
+                                << destination.errorString();
+        fail(i18n("Could not open the download destination"));
+        return false;
+    }
+
+    while (!m_partFile.atEnd()) {
+        const QByteArray chunk = m_partFile.read(copyChunkSize);
+        if (chunk.isEmpty() || destination.write(chunk) != chunk.size()) {
+            destination.cancelWriting();
+            break;
+        }
+    }
+    m_partFile.close();
+
+    if (!destination.commit()) {
+        qCWarning(TOKODON_HTTP) << "Couldn't save" << destination.fileName() << destination.errorString();
+        fail(i18n("Could not save the downloaded file"));
+        return false;
+    }
+    return true;
+}
+
+void FileTransferJob::abortSegments()
+{
+    for (auto &segment : m_segments) {
+        if (auto reply = std::exchange(segment.reply, nullptr); reply) {
+            reply->disconnect(this);
+            reply->abort();
+            reply->deleteLater();
+        }
+    }
+}
+
+void FileTransferJob::fail(const QString &errorText)
+{
+    abortSegments();
+
+    saveJournal();
+    m_partFile.close();
+
+    activePartFiles.remove(m_partFile.fileName());
+
+    setError(FileError);
+    setErrorText(errorText);
+    emitResult();
+}
+
+bool FileTransferJob::openPartFile(const bool truncate)
+{
+    m_partFile.close();
+    const auto mode = truncate ? QIODevice::ReadWrite | QIODevice::Truncate : QIODevice::ReadWrite;
+    if (!m_partFile.open(mode)) {
+        qCWarning(TOKODON_HTTP) << "Couldn't open the temporary file" << m_partFile.fileName() << "for writing" << m_partFile.errorString();
+        return false;
+    }
+
+    // Make sure the journal doesn't claim more data than what actually made it to the disk
+    return std::ranges::all_of(std::as_const(m_segments), [this](const Segment &segment) {
+        return segment.start + segment.written <= m_partFile.size();
+    });
+}
+
+bool FileTransferJob::loadJournal()
+{
+    QFile file(m_journalPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const auto journal = QJsonDocument::fromJson(file.readAll()).object();
+    if (journal["source"_L1].toString() != m_source) {
+        return false;
+    }
+
+    // Without an ETag we can't tell whether the remote file changed since, so the partial data can't be trusted
+    m_etag = journal["etag"_L1].toString().toUtf8();
+    m_totalSize = journal["size"_L1].toInteger(-1);
+    if (m_etag.isEmpty() || m_totalSize <= 0) {
+        return false;
+    }
+
+    m_segments.clear();
+    for (const auto &value : journal["segments"_L1].toArray()) {
+        const auto object = value.toObject();
+        m_segments.push_back(Segment{
+            .start = object["start"_L1].toInteger(),
+            .end = object["end"_L1].toInteger(-1),
+            .written = object["written"_L1].toInteger(),
         });
+    }
 
-        Q_EMIT description(this,
-                           i18nc("Job heading, like 'Copying'", "Downloading"),
-                           {i18nc("The URL being downloaded/uploaded", "Source"), m_source},
-                           {i18nc("The location being downloaded to", "Destination"), m_destination});
+    return !m_segments.isEmpty();
+}
+
+void FileTransferJob::saveJournal()
+{
+    m_unsavedBytes = 0;
+    if (m_segments.isEmpty()) {
+        return;
+    }
+
+    m_partFile.flush();
+
+    QJsonArray segments;
+    for (const auto &segment : std::as_const(m_segments)) {
+        segments.push_back(QJsonObject{
+            {"start"_L1, segment.start},
+            {"end"_L1, segment.end},
+            {"written"_L1, segment.written},
+        });
+    }
+
+    const QJsonObject journal{
+        {"source"_L1, m_source},
+        {"etag"_L1, QString::fromUtf8(m_etag)},
+        {"size"_L1, m_totalSize},
+        {"segments"_L1, segments},
+    };
+
+    QSaveFile file(m_journalPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(TOKODON_HTTP) << "Couldn't write the download journal" << m_journalPath << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(journal).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+void FileTransferJob::removePartialData()
+{
+    m_partFile.close();
+    m_partFile.remove();
+    QFile::remove(m_journalPath);
+    m_segments.clear();
+    activePartFiles.remove(m_partFile.fileName());
+}
+
+void FileTransferJob::updateProgress()
+{
+    if (m_totalSize != -1) {
+        setTotalAmount(Unit::Bytes, m_totalSize);
+    }
+
+    qint64 received = 0;
+    for (const auto &segment : std::as_const(m_segments)) {
+        received += segment.written;
     }
+    setProcessedAmount(Unit::Bytes, received);
 }
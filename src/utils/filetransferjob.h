@@ -4,10 +4,22 @@
 #pragma once
 
 #include <KJob>
-#include <QSaveFile>
+#include <QFile>
 
 class AbstractAccount;
+class QNetworkAccessManager;
+class QNetworkReply;
 
+/**
+ * @brief Downloads a remote file to a local destination.
+ *
+ * The data is first written to a partial file in the cache directory, together with a small journal recording how much
+ * of each segment was already received. If the connection drops, the job retries the missing ranges with HTTP Range
+ * requests, and a new job for the same source and destination continues where the previous one stopped as long as the
+ * ETag is unchanged. Only one job at a time can download to a given destination.
+ * Large files on servers accepting ranges are fetched in several parallel segments. Once every segment is complete,
+ * the size is verified and the partial file is renamed to the destination.
+ */
 class FileTransferJob final : public KJob
 {
 public:
@@ -18,9 +30,46 @@ public:
         FileError = UserDefinedError,
     };
 
+protected:
+    bool doKill() override;
+
 private:
+    struct Segment {
+        qint64 start = 0;
+        qint64 end = -1; ///< Inclusive, -1 if the size of the file is unknown
+        qint64 written = 0;
+        int retries = 0;
+        QNetworkReply *reply = nullptr;
+
+        [[nodiscard]] bool complete() const;
+    };
+
+    void fetchMetadata();
+    void planSegments(bool acceptRanges);
+    void startSegment(int index);
+    void handleSegmentFinished(int index);
+    void restart();
+    void abortSegments();
+    void finishTransfer();
+    [[nodiscard]] bool copyToDestination();
+    void fail(const QString &errorText);
+
+    [[nodiscard]] bool openPartFile(bool truncate);
+    [[nodiscard]] bool loadJournal();
+    void saveJournal();
+    void removePartialData();
+    void updateProgress();
+
     AbstractAccount *const m_account;
+    QNetworkAccessManager *m_qnam = nullptr;
     QString m_source;
     QString m_destination;
-    QScopedPointer<QSaveFile> m_temporaryFile;
+
+    QFile m_partFile;
+    QString m_journalPath;
+    QByteArray m_etag;
+    qint64 m_totalSize = -1;
+    qint64 m_unsavedBytes = 0;
+    bool m_restarted = false;
+    QList<Segment> m_segments;
 };
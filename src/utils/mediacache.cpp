@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/mediacache.h"
+
+#include <array>
+
+#include <QBuffer>
+#include <QImageReader>
+#include <QNetworkReply>
+#include <QThread>
+
+#include "datatypes/attachment.h"
+#include "network/networkaccessmanagerfactory.h"
+#include "tokodon_debug.h"
+#include "utils/metrics.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// Size buckets for the longest edge of decoded images, sized after Mastodon's own preview dimensions
+static constexpr std::array<int, 5> sizeBuckets = {160, 320, 640, 1280, 2560};
+
+// Enough for a few screens of attachment grids on a HiDPI display
+static constexpr qsizetype defaultMemoryBudget = 128 * 1024 * 1024;
+
+class MediaDecodeRunnable : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void done(QImage image);
+
+public:
+    MediaDecodeRunnable(const QByteArray &data, const QSize &size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    void run() override
+    {
+        QBuffer buffer(&m_data);
+        buffer.open(QIODevice::ReadOnly);
+
+        QImageReader reader(&buffer);
+        reader.setAutoTransform(true);
+
+        // Scale the image so it covers the bucket (attachment grids crop), but never upscale it
+        const QSize originalSize = reader.size();
+        if (originalSize.isValid() && (originalSize.width() > m_size.width() || originalSize.height() > m_size.height())) {
+            reader.setScaledSize(originalSize.scaled(m_size, Qt::KeepAspectRatioByExpanding).boundedTo(originalSize));
+        }
+
+        Q_EMIT done(reader.read());
+    }
+
+private:
+    QByteArray m_data;
+    QSize m_size;
+};
+
+MediaCache::MediaCache(QObject *parent)
+    : QObject(parent)
+{
+    m_images.setMaxCost(defaultMemoryBudget);
+    m_pool.setMaxThreadCount(std::max(2, QThread::idealThreadCount() / 2));
+
+    Metrics::instance().setSampler(u"media.cacheBytes"_s, [this] {
+        QMutexLocker locker(&m_mutex);
+        return m_images.totalCost();
+    });
+}
+
+MediaCache &MediaCache::instance()
+{
+    static MediaCache _instance;
+    return _instance;
+}
+
+QSize MediaCache::bucketSize(const QSize &size)
+{
+    if (!size.isValid() || size.isEmpty()) {
+        return {defaultBucket, defaultBucket};
+    }
+
+    const int longestEdge = std::max(size.width(), size.height());
+    const auto it = std::ranges::find_if(sizeBuckets, [longestEdge](const int bucket) {
+        return bucket >= longestEdge;
+    });
+    const int bucket = it != sizeBuckets.end() ? *it : sizeBuckets.back();
+    return {bucket, bucket};
+}
+
+QString MediaCache::cacheKey(const QString &attachmentId, const QSize &size)
+{
+    return u"%1@%2"_s.arg(attachmentId, QString::number(bucketSize(size).width()));
+}
+
+QUrl MediaCache::imageSource(const QString &attachmentId, const QString &url)
+{
+    if (attachmentId.isEmpty() || url.isEmpty()) {
+        return {};
+    }
+
+    // The preview URL is encoded so QML doesn't mangle it, see the note in BlurHashImageProvider
+    QUrl source;
+    source.setScheme(QStringLiteral("image"));
+    source.setHost(QStringLiteral("media"));
+    source.setPath(QLatin1Char('/') + attachmentId + QLatin1Char('/')
+                   + QString::fromLatin1(url.toUtf8().toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals)));
+    return source;
+}
+
+QImage MediaCache::find(const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+    if (const auto image = m_images.object(key)) {
+        return *image;
+    }
+    return {};
+}
+
+void MediaCache::request(const QString &attachmentId, const QUrl &url, const QSize &size)
+{
+    if (attachmentId.isEmpty() || !url.isValid()) {
+        return;
+    }
+
+    const QString key = cacheKey(attachmentId, size);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_images.contains(key) || m_pending.contains(key)) {
+            return;
+        }
+        m_pending.insert(key);
+    }
+
+    const QSize bucket = bucketSize(size);
+    QMetaObject::invokeMethod(this, [this, key, url, bucket] {
+        startRequest(key, url, bucket);
+    });
+}
+
+void MediaCache::prefetch(const Attachment *attachment, const QSize &size)
+{
+    if (attachment == nullptr || attachment->m_preview_url.isEmpty()) {
+        return;
+    }
+
+    request(attachment->m_id, QUrl(attachment->m_preview_url), size);
+}
+
+void MediaCache::setMemoryBudget(const qsizetype bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.setMaxCost(bytes);
+}
+
+void MediaCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.clear();
+}
+
+void MediaCache::startRequest(const QString &key, const QUrl &url, const QSize &size)
+{
+    if (m_qnam == nullptr) {
+        m_qnam = NetworkAccessManagerFactory().create(this);
+    }
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+
+    auto reply = m_qnam->get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, key, size] {
+        reply->deleteLater();
+
+        if (reply->error() != QNetworkReply::NoError) {
+            qCDebug(TOKODON_LOG) << "Failed to fetch media" << reply->url() << reply->errorString();
+            {
+                QMutexLocker locker(&m_mutex);
+                m_pending.remove(key);
+            }
+            Q_EMIT imageFailed(key, reply->errorString());
+            return;
+        }
+
+        const auto runnable = new MediaDecodeRunnable(reply->readAll(), size);
+        connect(runnable, &MediaDecodeRunnable::done, this, [this, key](const QImage &image) {
+            Metrics::instance().addToGauge(u"media.decodeQueue"_s, -1);
+
+            if (image.isNull()) {
+                {
+                    QMutexLocker locker(&m_mutex);
+                    m_pending.remove(key);
+                }
+                Q_EMIT imageFailed(key, QStringLiteral("Failed to decode image"));
+                return;
+            }
+
+            insert(key, image);
+            Q_EMIT imageReady(key, image);
+        });
+        Metrics::instance().addToGauge(u"media.decodeQueue"_s, 1);
+        m_pool.start(runnable);
+    });
+}
+
+void MediaCache::insert(const QString &key, const QImage &image)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pending.remove(key);
+    m_images.insert(key, new QImage(image), image.sizeInBytes());
+}
+
+#include "mediacache.moc"
+#include "moc_mediacache.cpp"
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QUrl>
+
+class Attachment;
+class QNetworkAccessManager;
+
+/**
+ * @brief Fetches, decodes and caches downscaled attachment previews.
+ *
+ * Images are keyed by attachment id and a size bucket, decoded on a dedicated thread pool and kept in a
+ * least-recently-used cache bounded by a memory budget. Models call prefetch() for rows that are about to
+ * become visible, and MediaImageProvider serves the decoded images to QML.
+ *
+ * @see MediaImageProvider
+ */
+class MediaCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MediaCache &instance();
+
+    /**
+     * @brief The size bucket used when the caller doesn't request a specific size.
+     */
+    static constexpr int defaultBucket = 640;
+
+    /**
+     * @brief Rounds @p size up to the nearest size bucket, so delegates of slightly different sizes share decoded images.
+     * @note An invalid or empty @p size maps to defaultBucket.
+     */
+    [[nodiscard]] static QSize bucketSize(const QSize &size);
+
+    /**
+     * @return The cache key for the attachment @p attachmentId decoded for @p size.
+     */
+    [[nodiscard]] static QString cacheKey(const QString &attachmentId, const QSize &size);
+
+    /**
+     * @return The image provider URL for the preview @p url of the attachment @p attachmentId.
+     */
+    [[nodiscard]] static QUrl imageSource(const QString &attachmentId, const QString &url);
+
+    /**
+     * @return The decoded image for @p key, or a null image if it isn't cached yet.
+     * @note This is safe to call from any thread.
+     */
+    [[nodiscard]] QImage find(const QString &key);
+
+    /**
+     * @brief Fetches and decodes @p url for the attachment @p attachmentId in the background.
+     *
+     * Does nothing if the image is already cached or in flight. Either imageReady() or imageFailed() is emitted once done.
+     * @note This is safe to call from any thread, the request is always started from the thread the cache lives in.
+     */
+    void request(const QString &attachmentId, const QUrl &url, const QSize &size);
+
+    /**
+     * @brief Prefetches the preview of @p attachment for @p size.
+     * @note Sensitive attachments should not be prefetched, they are only loaded once the user chooses to show them.
+     */
+    void prefetch(const Attachment *attachment, const QSize &size = {});
+
+    /**
+     * @brief Sets the maximum amount of memory in bytes that decoded images are allowed to use.
+     */
+    void setMemoryBudget(qsizetype bytes);
+
+    /**
+     * @brief Drops all decoded images.
+     */
+    void clear();
+
+Q_SIGNALS:
+    void imageReady(const QString &key, const QImage &image);
+    void imageFailed(const QString &key, const QString &errorString);
+
+private:
+    explicit MediaCache(QObject *parent = nullptr);
+
+    void startRequest(const QString &key, const QUrl &url, const QSize &size);
+    void insert(const QString &key, const QImage &image);
+
+    QMutex m_mutex;
+    QCache<QString, QImage> m_images;
+    QSet<QString> m_pending;
+    QThreadPool m_pool;
+    QNetworkAccessManager *m_qnam = nullptr;
+};
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/mediaimageprovider.h"
+
+#include "utils/mediacache.h"
+
+MediaImageResponse::MediaImageResponse(const QString &id, const QSize &requestedSize)
+{
+    const qsizetype separator = id.indexOf(QLatin1Char('/'));
+    if (separator <= 0) {
+        m_errorString = QStringLiteral("Invalid media id %1").arg(id);
+        QMetaObject::invokeMethod(this, &MediaImageResponse::finished, Qt::QueuedConnection);
+        return;
+    }
+
+    const QString attachmentId = id.left(separator);
+    const QUrl url = QUrl(QString::fromUtf8(QByteArray::fromBase64(id.mid(separator + 1).toLatin1(), QByteArray::Base64UrlEncoding)));
+
+    auto &cache = MediaCache::instance();
+    m_key = MediaCache::cacheKey(attachmentId, requestedSize);
+
+    // Connect before looking up the cache, so we can't miss an image that finishes decoding in between
+    connect(&cache, &MediaCache::imageReady, this, [this](const QString &key, const QImage &image) {
+        if (key == m_key) {
+            handleDone(image);
+        }
+    });
+    connect(&cache, &MediaCache::imageFailed, this, [this](const QString &key, const QString &errorString) {
+        if (key == m_key) {
+            handleError(errorString);
+        }
+    });
+
+    if (const QImage image = cache.find(m_key); !image.isNull()) {
+        QMetaObject::invokeMethod(
+            this,
+            [this, image] {
+                handleDone(image);
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    cache.request(attachmentId, url, requestedSize);
+}
+
+void MediaImageResponse::handleDone(const QImage &image)
+{
+    if (!m_image.isNull() || !m_errorString.isEmpty()) {
+        return;
+    }
+
+    disconnect(&MediaCache::instance(), nullptr, this, nullptr);
+    m_image = image;
+    Q_EMIT finished();
+}
+
+void MediaImageResponse::handleError(const QString &errorString)
+{
+    if (!m_image.isNull() || !m_errorString.isEmpty()) {
+        return;
+    }
+
+    disconnect(&MediaCache::instance(), nullptr, this, nullptr);
+    m_errorString = errorString;
+    Q_EMIT finished();
+}
+
+QQuickTextureFactory *MediaImageResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+QString MediaImageResponse::errorString() const
+{
+    return m_errorString;
+}
+
+QQuickImageResponse *MediaImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    return new MediaImageResponse(id, requestedSize);
+}
@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QQuickAsyncImageProvider>
+
+class MediaImageResponse final : public QQuickImageResponse
+{
+public:
+    MediaImageResponse(const QString &id, const QSize &requestedSize);
+    [[nodiscard]] QQuickTextureFactory *textureFactory() const override;
+    [[nodiscard]] QString errorString() const override;
+
+private:
+    void handleDone(const QImage &image);
+    void handleError(const QString &errorString);
+
+    QString m_key;
+    QImage m_image;
+    QString m_errorString;
+};
+
+/**
+ * @brief Serves attachment previews decoded off the GUI thread by MediaCache.
+ *
+ * Image ids are built by MediaCache::imageSource() in the form @c <attachment id>/<base64url encoded preview URL>.
+ * The requested size is rounded to a MediaCache size bucket, so delegates of similar sizes share one decoded image.
+ */
+class MediaImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+};
@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "utils/metrics.h"
+
+#include "tokodon_debug.h"
+
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Qt::Literals::StringLiterals;
+
+Metrics::Metrics(QObject *parent)
+    : QObject(parent)
+{
+}
+
+Metrics &Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+int Metrics::bucketIndex(const double value)
+{
+    if (value <= 1) {
+        return 0;
+    }
+    return std::min(static_cast<int>(std::ceil(4 * std::log2(value))), bucketCount - 1);
+}
+
+double Metrics::bucketUpperBound(const int index)
+{
+    return std::exp2(index / 4.0);
+}
+
+void Metrics::increment(const QString &name, const qint64 amount)
+{
+    QMutexLocker locker(&m_mutex);
+    m_counters[name] += amount;
+}
+
+void Metrics::addToGauge(const QString &name, const qint64 delta)
+{
+    QMutexLocker locker(&m_mutex);
+    m_gauges[name] += delta;
+}
+
+void Metrics::setSampler(const QString &name, std::function<qint64()> sampler)
+{
+    QMutexLocker locker(&m_mutex);
+    m_samplers.insert(name, std::move(sampler));
+}
+
+void Metrics::observe(const QString &name, const double value)
+{
+    QMutexLocker locker(&m_mutex);
+    auto &histogram = m_histograms[name];
+    histogram.buckets[bucketIndex(value)]++;
+    histogram.count++;
+    histogram.sum += value;
+    histogram.max = std::max(histogram.max, value);
+}
+
+qint64 Metrics::counter(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_counters.value(name);
+}
+
+qint64 Metrics::gauge(const QString &name) const
+{
+    // Samplers lock their own data, so they're called without holding ours
+    std::function<qint64()> sampler;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const auto it = m_gauges.constFind(name); it != m_gauges.cend()) {
+            return *it;
+        }
+        sampler = m_samplers.value(name);
+    }
+    return sampler ? sampler() : 0;
+}
+
+qint64 Metrics::sampleCount(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_histograms.value(name).count;
+}
+
+double Metrics::percentile(const QString &name, const double percentile) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (const auto it = m_histograms.constFind(name); it != m_histograms.cend()) {
+        return percentileLocked(*it, percentile);
+    }
+    return 0;
+}
+
+double Metrics::percentileLocked(const Histogram &histogram, const double percentile)
+{
+    if (histogram.count == 0) {
+        return 0;
+    }
+
+    const auto rank = static_cast<qint64>(std::ceil(histogram.count * std::clamp(percentile, 0.0, 100.0) / 100.0));
+    qint64 seen = 0;
+    for (int i = 0; i < bucketCount; i++) {
+        seen += histogram.buckets[i];
+        if (seen >= std::max<qint64>(rank, 1)) {
+            return std::min(bucketUpperBound(i), histogram.max);
+        }
+    }
+    return histogram.max;
+}
+
+QStringList Metrics::names(const QString &prefix) const
+{
+    QStringList names;
+    {
+        QMutexLocker locker(&m_mutex);
+        names.append(m_counters.keys());
+        names.append(m_gauges.keys());
+        names.append(m_samplers.keys());
+        names.append(m_histograms.keys());
+    }
+
+    names.removeIf([&prefix](const QString &name) {
+        return !name.startsWith(prefix);
+    });
+    names.sort();
+    names.removeDuplicates();
+    return names;
+}
+
+QJsonObject Metrics::toJson() const
+{
+    QStringList sampledGauges;
+    {
+        QMutexLocker locker(&m_mutex);
+        sampledGauges = m_samplers.keys();
+    }
+    QJsonObject gauges;
+    for (const auto &name : std::as_const(sampledGauges)) {
+        gauges[name] = gauge(name);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    QJsonObject counters;
+    for (const auto &[name, value] : m_counters.asKeyValueRange()) {
+        counters[name] = value;
+    }
+    for (const auto &[name, value] : m_gauges.asKeyValueRange()) {
+        gauges[name] = value;
+    }
+
+    QJsonObject histograms;
+    for (const auto &[name, histogram] : m_histograms.asKeyValueRange()) {
+        histograms[name] = QJsonObject{
+            {u"count"_s, histogram.count},
+            {u"mean"_s, histogram.sum / histogram.count},
+            {u"p50"_s, percentileLocked(histogram, 50)},
+            {u"p95"_s, percentileLocked(histogram, 95)},
+            {u"max"_s, histogram.max},
+        };
+    }
+
+    return {
+        {u"counters"_s, counters},
+        {u"gauges"_s, gauges},
+        {u"histograms"_s, histograms},
+    };
+}
+
+bool Metrics::writeTo(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(TOKODON_LOG) << "Couldn't write the metrics to" << fileName << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    if (!file.commit()) {
+        qCWarning(TOKODON_LOG) << "Couldn't write the metrics to" << fileName << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+#include "moc_metrics.cpp"
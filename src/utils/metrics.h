@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QQmlEngine>
+
+#include <array>
+#include <functional>
+
+/**
+ * @brief Keeps the numbers that tell how Tokodon is doing while it runs, like how long requests take and how many posts are alive.
+ *
+ * There are three kinds of metrics:
+ * - Counters only go up, like the number of requests.
+ * - Gauges are a current value, like the number of rows of the timelines. Gauges that are easier to read than to keep up to date can be
+ *   sampled instead, see setSampler().
+ * - Histograms collect values to tell their percentiles, like the latency of an endpoint.
+ *
+ * The Debug page shows them, and they're written to the file passed with --metrics when quitting.
+ * @note This is safe to use from any thread.
+ */
+class Metrics : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+public:
+    static Metrics *create(QQmlEngine *, QJSEngine *)
+    {
+        auto inst = &instance();
+        QJSEngine::setObjectOwnership(inst, QJSEngine::ObjectOwnership::CppOwnership);
+        return inst;
+    }
+
+    static Metrics &instance();
+
+    /**
+     * @brief Adds @p amount to the counter @p name.
+     */
+    void increment(const QString &name, qint64 amount = 1);
+
+    /**
+     * @brief Adds @p delta, which may be negative, to the gauge @p name.
+     */
+    void addToGauge(const QString &name, qint64 delta);
+
+    /**
+     * @brief Makes the gauge @p name read its value from @p sampler whenever it's asked for.
+     */
+    void setSampler(const QString &name, std::function<qint64()> sampler);
+
+    /**
+     * @brief Adds @p value to the histogram @p name.
+     */
+    void observe(const QString &name, double value);
+
+    /**
+     * @return The value of the counter @p name.
+     */
+    Q_INVOKABLE [[nodiscard]] qint64 counter(const QString &name) const;
+
+    /**
+     * @return The value of the gauge @p name.
+     */
+    Q_INVOKABLE [[nodiscard]] qint64 gauge(const QString &name) const;
+
+    /**
+     * @return How many values were added to the histogram @p name.
+     */
+    Q_INVOKABLE [[nodiscard]] qint64 sampleCount(const QString &name) const;
+
+    /**
+     * @return The value that @p percentile percent of the values of the histogram @p name are below. The percentiles are rounded up
+     * to the next of the buckets, which are about 20% apart.
+     */
+    Q_INVOKABLE [[nodiscard]] double percentile(const QString &name, double percentile) const;
+
+    /**
+     * @return The names of the metrics starting with @p prefix, sorted.
+     */
+    Q_INVOKABLE [[nodiscard]] QStringList names(const QString &prefix = {}) const;
+
+    /**
+     * @return All the metrics, to be written to a file.
+     */
+    [[nodiscard]] QJsonObject toJson() const;
+
+    /**
+     * @brief Writes the metrics to @p fileName.
+     */
+    bool writeTo(const QString &fileName) const;
+
+private:
+    explicit Metrics(QObject *parent = nullptr);
+
+    // Buckets go up by a fourth of a power of two, up to about 17 minutes when measuring milliseconds
+    static constexpr int bucketCount = 81;
+
+    struct Histogram {
+        std::array<qint64, bucketCount> buckets{};
+        qint64 count = 0;
+        double sum = 0;
+        double max = 0;
+    };
+
+    [[nodiscard]] static int bucketIndex(double value);
+    [[nodiscard]] static double bucketUpperBound(int index);
+    [[nodiscard]] static double percentileLocked(const Histogram &histogram, double percentile);
+
+    mutable QMutex m_mutex;
+    QHash<QString, qint64> m_counters;
+    QHash<QString, qint64> m_gauges;
+    QHash<QString, std::function<qint64()>> m_samplers;
+    QHash<QString, Histogram> m_histograms;
+};
@@ -0,0 +1,330 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/relativetimeclock.h"
+
+#include <KLocalizedString>
+#include <QEvent>
+#include <QGuiApplication>
+
+#include <algorithm>
+
+static constexpr qint64 secondsPerMinute = 60;
+static constexpr qint64 secondsPerHour = 60 * 60;
+static constexpr qint64 secondsPerDay = 60 * 60 * 24;
+
+RelativeTimeClock::RelativeTimeClock(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &RelativeTimeClock::update);
+
+    if (const auto app = qobject_cast<QGuiApplication *>(QCoreApplication::instance())) {
+        connect(app, &QGuiApplication::applicationStateChanged, this, [this] {
+            if (isActive()) {
+                // Catch up with everything that changed while we were away
+                update();
+            } else {
+                m_timer.stop();
+            }
+        });
+    }
+
+    // The application gets LanguageChange when a translator is installed, this object doesn't
+    if (const auto app = QCoreApplication::instance()) {
+        app->installEventFilter(this);
+    }
+}
+
+RelativeTimeClock &RelativeTimeClock::instance()
+{
+    static RelativeTimeClock clock;
+    return clock;
+}
+
+void RelativeTimeClock::track(QAbstractItemModel *model, const int role, const TimeGetter &time, const Precision precision)
+{
+    Q_ASSERT(model != nullptr);
+
+    if (!m_lastTick.isValid()) {
+        m_lastTick = currentDateTime();
+    }
+
+    m_tracked.push_back(std::make_unique<Tracked>(Tracked{model, role, time, precision}));
+    const auto tracked = m_tracked.back().get();
+
+    // Row numbers in the heap are only valid until rows move, and new rows may change sooner than anything we're waiting for
+    const auto invalidate = [this, tracked] {
+        tracked->dirty = true;
+        scheduleReschedule();
+    };
+    connect(model, &QAbstractItemModel::rowsInserted, this, invalidate);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, invalidate);
+    connect(model, &QAbstractItemModel::rowsMoved, this, invalidate);
+    connect(model, &QAbstractItemModel::modelReset, this, invalidate);
+    connect(model, &QAbstractItemModel::layoutChanged, this, invalidate);
+    connect(model, &QObject::destroyed, this, &RelativeTimeClock::scheduleReschedule);
+
+    scheduleReschedule();
+}
+
+void RelativeTimeClock::setTimeSource(const TimeSource &source)
+{
+    m_timeSource = source;
+    m_lastTick = currentDateTime();
+    for (const auto &tracked : m_tracked) {
+        tracked->dirty = true;
+    }
+    reschedule();
+}
+
+QDateTime RelativeTimeClock::nextUpdate() const
+{
+    return m_nextUpdate;
+}
+
+QString RelativeTimeClock::format(const QDateTime &dateTime, const QDateTime &now)
+{
+    return label(bucket(dateTime, now.isValid() ? now : currentDateTime(), DateTime));
+}
+
+QString RelativeTimeClock::formatDate(const QDate &date, const QDate &today)
+{
+    return label({DayUnit, date.daysTo(today.isValid() ? today : currentDateTime().date())});
+}
+
+QDateTime RelativeTimeClock::nextChange(const QDateTime &dateTime, const QDateTime &now, const Precision precision)
+{
+    const QDateTime nextDay = now.date().addDays(1).startOfDay();
+    if (precision == Date) {
+        return nextDay;
+    }
+
+    const qint64 secsTo = dateTime.secsTo(now);
+    if (secsTo < 0) {
+        return dateTime;
+    } else if (secsTo < secondsPerMinute) {
+        return dateTime.addSecs(secsTo + 1);
+    } else if (secsTo < secondsPerHour) {
+        return dateTime.addSecs((secsTo / secondsPerMinute + 1) * secondsPerMinute);
+    } else if (secsTo < secondsPerDay) {
+        return dateTime.addSecs((secsTo / secondsPerHour + 1) * secondsPerHour);
+    } else {
+        return nextDay;
+    }
+}
+
+RelativeTimeClock::Bucket RelativeTimeClock::bucket(const QDateTime &dateTime, const QDateTime &now, const Precision precision)
+{
+    if (precision == Date) {
+        return {DayUnit, dateTime.date().daysTo(now.date())};
+    }
+
+    const qint64 secsTo = dateTime.secsTo(now);
+    if (secsTo < 0) {
+        return {FutureUnit, 0};
+    } else if (secsTo < secondsPerMinute) {
+        return {SecondUnit, secsTo};
+    } else if (secsTo < secondsPerHour) {
+        return {MinuteUnit, secsTo / secondsPerMinute};
+    } else if (secsTo < secondsPerDay) {
+        return {HourUnit, secsTo / secondsPerHour};
+    } else {
+        return {DayUnit, dateTime.date().daysTo(now.date())};
+    }
+}
+
+QString RelativeTimeClock::label(const Bucket &bucket)
+{
+    const auto it = m_labels.constFind(bucket);
+    if (it != m_labels.cend()) {
+        return *it;
+    }
+
+    QString label;
+    switch (bucket.unit) {
+    case FutureUnit:
+        label = i18n("in the future");
+        break;
+    case SecondUnit:
+        label = i18n("%1s", bucket.count);
+        break;
+    case MinuteUnit:
+        label = i18n("%1m", bucket.count);
+        break;
+    case HourUnit:
+        label = i18n("%1h", bucket.count);
+        break;
+    case DayUnit: {
+        const qint64 daysTo = bucket.count;
+        if (daysTo == 0) {
+            label = i18n("Today");
+        } else if (daysTo < 7) {
+            label = i18n("%1d", daysTo);
+        } else if (daysTo < 365) {
+            const qint64 weeksTo = daysTo / 7;
+            if (weeksTo < 5) {
+                label = i18np("1 week ago", "%1 weeks ago", weeksTo);
+            } else {
+                label = i18np("1 month ago", "%1 months ago", daysTo / 30);
+            }
+        } else {
+            label = i18np("1 year ago", "%1 years ago", daysTo / 365);
+        }
+        break;
+    }
+    }
+
+    m_labels.insert(bucket, label);
+    return label;
+}
+
+void RelativeTimeClock::scheduleReschedule()
+{
+    // Models tend to insert rows in bursts, only look at them once they're done
+    if (m_rescheduleQueued) {
+        return;
+    }
+    m_rescheduleQueued = true;
+    QMetaObject::invokeMethod(this, &RelativeTimeClock::reschedule, Qt::QueuedConnection);
+}
+
+void RelativeTimeClock::reschedule()
+{
+    m_rescheduleQueued = false;
+
+    std::erase_if(m_tracked, [](const auto &tracked) {
+        return tracked->model.isNull();
+    });
+
+    if (!isActive()) {
+        m_timer.stop();
+        return;
+    }
+
+    // Only the front of each heap needs to be looked at
+    QDateTime next;
+    for (const auto &tracked : m_tracked) {
+        if (tracked->dirty) {
+            rebuild(*tracked);
+        }
+        if (!tracked->rows.empty() && (!next.isValid() || tracked->rows.front().next < next)) {
+            next = tracked->rows.front().next;
+        }
+    }
+
+    m_nextUpdate = next;
+    if (!next.isValid()) {
+        m_timer.stop();
+        return;
+    }
+
+    const QDateTime now = currentDateTime();
+    m_timer.start(static_cast<int>(std::clamp(now.msecsTo(next), qint64(0), secondsPerDay * 1000)));
+}
+
+// Turns the max-heap algorithms into a min-heap on the next change
+static constexpr auto changesLater = [](const auto &a, const auto &b) {
+    return a.next > b.next;
+};
+
+void RelativeTimeClock::rebuild(Tracked &tracked)
+{
+    tracked.dirty = false;
+    tracked.rows.clear();
+
+    // Every row shows the label from the last tick, anything that changed since then is picked up by the next one
+    const int rows = tracked.model->rowCount();
+    tracked.rows.reserve(rows);
+    for (int row = 0; row < rows; row++) {
+        const QDateTime time = tracked.time(tracked.model->index(row, 0));
+        if (time.isValid()) {
+            tracked.rows.push_back({nextChange(time, m_lastTick, tracked.precision), time, bucket(time, m_lastTick, tracked.precision), row});
+        }
+    }
+    std::make_heap(tracked.rows.begin(), tracked.rows.end(), changesLater);
+}
+
+void RelativeTimeClock::update()
+{
+    const QDateTime now = currentDateTime();
+    // Views may create new models in response to dataChanged(), which are tracked right away
+    const size_t count = m_tracked.size();
+    for (size_t i = 0; i < count; i++) {
+        const auto tracked = m_tracked[i].get();
+        if (tracked->model.isNull()) {
+            continue;
+        }
+        if (tracked->dirty) {
+            rebuild(*tracked);
+        }
+        updateModel(*tracked, now);
+    }
+    m_lastTick = now;
+
+    reschedule();
+}
+
+void RelativeTimeClock::updateModel(Tracked &tracked, const QDateTime &now)
+{
+    auto &heap = tracked.rows;
+
+    // The next change is always after now, so every row is taken out at most once
+    QList<int> changed;
+    while (!heap.empty() && heap.front().next <= now) {
+        std::pop_heap(heap.begin(), heap.end(), changesLater);
+        Row &row = heap.back();
+
+        const Bucket after = bucket(row.time, now, tracked.precision);
+        if (row.shown != after && label(row.shown) != label(after)) {
+            changed.append(row.row);
+        }
+        row.shown = after;
+        row.next = nextChange(row.time, now, tracked.precision);
+
+        std::push_heap(heap.begin(), heap.end(), changesLater);
+    }
+
+    std::sort(changed.begin(), changed.end());
+    const auto model = tracked.model.data();
+    for (qsizetype i = 0; i < changed.size();) {
+        qsizetype last = i;
+        while (last + 1 < changed.size() && changed[last + 1] == changed[last] + 1) {
+            last++;
+        }
+        Q_EMIT model->dataChanged(model->index(changed[i], 0), model->index(changed[last], 0), {tracked.role});
+        i = last + 1;
+    }
+}
+
+bool RelativeTimeClock::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == QCoreApplication::instance() && event->type() == QEvent::LanguageChange) {
+        m_labels.clear();
+        for (const auto &tracked : m_tracked) {
+            const auto model = tracked->model.data();
+            if (model != nullptr && model->rowCount() > 0) {
+                Q_EMIT model->dataChanged(model->index(0, 0), model->index(model->rowCount() - 1, 0), {tracked->role});
+            }
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+QDateTime RelativeTimeClock::currentDateTime() const
+{
+    return m_timeSource ? m_timeSource() : QDateTime::currentDateTime();
+}
+
+bool RelativeTimeClock::isActive() const
+{
+    const auto app = qobject_cast<QGuiApplication *>(QCoreApplication::instance());
+    if (app == nullptr) {
+        return true;
+    }
+
+    const auto state = QGuiApplication::applicationState();
+    return state != Qt::ApplicationHidden && state != Qt::ApplicationSuspended;
+}
+
+#include "moc_relativetimeclock.cpp"
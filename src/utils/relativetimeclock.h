@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Keeps the relative timestamps ("5m", "2h") shown in models up to date.
+ *
+ * Labels only change when a timestamp crosses into the next bucket (seconds, minutes, hours, days), so instead of
+ * refreshing every row on an interval, the clock keeps the rows of each tracked model ordered by when their label
+ * changes next, and sleeps until the earliest one. When it wakes up, it only looks at the rows that are due, and only the
+ * ones whose label actually changed get a dataChanged(), with neighboring rows merged into a single range. The order is
+ * rebuilt when rows are inserted, removed or moved. While the application is hidden or suspended the clock stops
+ * entirely, and catches up once it's shown again.
+ *
+ * Formatted labels are cached per bucket, so rows that share one (e.g. "3h") don't format the same string again. The
+ * cache is dropped when the application language changes.
+ */
+class RelativeTimeClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Precision {
+        DateTime, /**< Labels go from seconds to minutes, hours and days. See TextHandler::getRelativeDateTime(). */
+        Date, /**< Labels only count days. See TextHandler::getRelativeDate(). */
+    };
+
+    /**
+     * @brief Returns the time a row's label is computed from, or an invalid QDateTime if it doesn't have one.
+     */
+    using TimeGetter = std::function<QDateTime(const QModelIndex &index)>;
+
+    /**
+     * @brief Returns the current time.
+     */
+    using TimeSource = std::function<QDateTime()>;
+
+    static RelativeTimeClock &instance();
+
+    /**
+     * @brief Keeps @p role of every row in @p model up to date, until the model is destroyed.
+     */
+    void track(QAbstractItemModel *model, int role, const TimeGetter &time, Precision precision = DateTime);
+
+    /**
+     * @brief Computes the labels against @p source instead of the system time, for tests. An empty function goes back to the system time.
+     *
+     * The timer keeps running on the system time, call update() after moving @p source forward.
+     */
+    void setTimeSource(const TimeSource &source);
+
+    /**
+     * @brief Updates the rows whose label changed since the last update.
+     *
+     * This runs by itself whenever the next label changes.
+     */
+    void update();
+
+    /**
+     * @return When the next label in any tracked model changes, or an invalid QDateTime if none will.
+     */
+    [[nodiscard]] QDateTime nextUpdate() const;
+
+    /**
+     * @return The label for @p dateTime, as seen at @p now, or at the current time if it's invalid.
+     */
+    [[nodiscard]] QString format(const QDateTime &dateTime, const QDateTime &now = {});
+
+    /**
+     * @return The label for @p date, as seen on @p today, or on the current date if it's invalid.
+     */
+    [[nodiscard]] QString formatDate(const QDate &date, const QDate &today = {});
+
+    /**
+     * @return When the label for @p dateTime changes next, after @p now.
+     */
+    [[nodiscard]] static QDateTime nextChange(const QDateTime &dateTime, const QDateTime &now, Precision precision = DateTime);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    explicit RelativeTimeClock(QObject *parent = nullptr);
+
+    enum Unit : quint8 {
+        FutureUnit,
+        SecondUnit,
+        MinuteUnit,
+        HourUnit,
+        DayUnit,
+    };
+
+    struct Bucket {
+        Unit unit;
+        qint64 count;
+
+        bool operator==(const Bucket &other) const = default;
+    };
+
+    friend size_t qHash(const Bucket &bucket, size_t seed = 0)
+    {
+        return qHashMulti(seed, static_cast<int>(bucket.unit), bucket.count);
+    }
+
+    struct Row {
+        QDateTime next; /**< When the label changes next. */
+        QDateTime time;
+        Bucket shown;
+        int row;
+    };
+
+    struct Tracked {
+        QPointer<QAbstractItemModel> model;
+        int role;
+        TimeGetter time;
+        Precision precision;
+        std::vector<Row> rows; /**< A heap with the row that changes first in front. */
+        bool dirty = true; /**< Rows were inserted, removed or moved since the heap was built. */
+    };
+
+    [[nodiscard]] static Bucket bucket(const QDateTime &dateTime, const QDateTime &now, Precision precision);
+    [[nodiscard]] QString label(const Bucket &bucket);
+    [[nodiscard]] QDateTime currentDateTime() const;
+
+    void scheduleReschedule();
+    void reschedule();
+    void rebuild(Tracked &tracked);
+    void updateModel(Tracked &tracked, const QDateTime &now);
+    [[nodiscard]] bool isActive() const;
+
+    std::vector<std::unique_ptr<Tracked>> m_tracked;
+    QHash<Bucket, QString> m_labels;
+    TimeSource m_timeSource;
+    QDateTime m_lastTick;
+    QDateTime m_nextUpdate;
+    QTimer m_timer;
+    bool m_rescheduleQueued = false;
+};
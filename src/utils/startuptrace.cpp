@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "utils/startuptrace.h"
+
+#include "tokodon_startup_debug.h"
+#include "utils/tracing.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+
+Q_GLOBAL_STATIC(QElapsedTimer, startupTimer)
+Q_GLOBAL_STATIC(QSet<QString>, reachedPhases)
+
+void StartupTrace::start()
+{
+    startupTimer->start();
+}
+
+void StartupTrace::mark(const QString &phase, const QString &detail)
+{
+    if (!startupTimer->isValid()) {
+        return;
+    }
+
+    const QString key = detail.isEmpty() ? phase : phase + u' ' + detail;
+    if (reachedPhases->contains(key)) {
+        return;
+    }
+    reachedPhases->insert(key);
+
+    Tracing::instant("startup", phase, detail);
+
+    qCDebug(TOKODON_STARTUP).noquote() << key << "after" << startupTimer->elapsed() << "ms";
+}
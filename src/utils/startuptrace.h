@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QString>
+
+/**
+ * @brief Logs how long after the start each phase of the startup was reached.
+ *
+ * Enable the org.kde.tokodon.startup logging category to see them, for example to compare the time until the first posts are
+ * shown before and after a change. Each phase is only logged the first time it's reached.
+ */
+namespace StartupTrace
+{
+/**
+ * @brief Starts measuring, this is called as early as possible in main().
+ */
+void start();
+
+/**
+ * @brief Logs that @p phase was reached, optionally for the account or object named @p detail.
+ */
+void mark(const QString &phase, const QString &detail = {});
+}
@@ -10,6 +10,9 @@
 #include <QTextCursor>
 #include <QTextDocument>
 
+#include "utils/contenttransformer.h"
+#include "utils/relativetimeclock.h"
+
 using namespace Qt::StringLiterals;
 
 static const auto fsi = QStringLiteral("\u2068");
@@ -59,62 +62,10 @@ QString TextHandler::fixBidirectionality(const QString &html, const QFont &font)
     return doc.toHtml();
 }
 
-QPair<QString, QList<QString>> TextHandler::removeStandaloneTags(QString contentHtml)
+QPair<QString, QList<QString>> TextHandler::removeStandaloneTags(const QString &contentHtml)
 {
-    // Finally, find the "standalone tags" for the post, so we can display them separately.
-    // These usually appear in the last paragraph or so. We also do some extra processing to ensure there aren't blank lines left over.
-    QList<QString> standaloneTags;
-
-    // Find the last <p> or <br>
-    const qsizetype lastBreak = contentHtml.lastIndexOf(QStringLiteral("<br>"));
-    qsizetype lastParagraphBegin = contentHtml.lastIndexOf(QStringLiteral("<p>"));
-    if (lastBreak > lastParagraphBegin) {
-        lastParagraphBegin = lastBreak;
-    }
-
-    // Catch all the tags in the last paragraph of the post, but only if they are not surrounded by text
-    {
-        const qsizetype lastParagraphEnd = contentHtml.lastIndexOf(QStringLiteral("</p>"));
-        const QString lastParagraph = contentHtml.mid(lastParagraphBegin, lastParagraphEnd - contentHtml.length());
-        QList<QString> possibleTags;
-        QString possibleLastParagraph = lastParagraph;
-
-        auto matchIterator = TextRegex::hashtagExp.globalMatch(possibleLastParagraph);
-        while (matchIterator.hasNext()) {
-            const QRegularExpressionMatch match = matchIterator.next();
-            possibleTags.push_back(match.captured(1));
-            possibleLastParagraph.replace(match.captured(0), QStringLiteral(""));
-        }
-
-        // If this paragraph is truly extraneous, then we can take its tags, otherwise skip.
-        const auto extraneousIterator = TextRegex::extraneousParagraphExp.globalMatch(possibleLastParagraph);
-        if (extraneousIterator.hasNext()) {
-            contentHtml.replace(lastParagraph, possibleLastParagraph);
-            standaloneTags = possibleTags;
-        }
-    }
-
-    // Ensure we remove any remaining <br>'s which will mess up the spacing in a post.
-    // Example: "<p>Yosemite Valley reflections with rock<br />    </p>"
-    {
-        auto matchIterator = TextRegex::extraneousBreakExp.globalMatch(contentHtml);
-        while (matchIterator.hasNext()) {
-            const QRegularExpressionMatch match = matchIterator.next();
-            contentHtml.replace(match.captured(1), QStringLiteral(""));
-        }
-    }
-
-    // Ensure we remove any empty <p>'s which will mess up the spacing in a post.
-    // Example: "<p>Boris Karloff (again) as Imhotep</p><p>  </p>"
-    {
-        auto matchIterator = TextRegex::extraneousParagraphExp.globalMatch(contentHtml);
-        while (matchIterator.hasNext()) {
-            const QRegularExpressionMatch match = matchIterator.next();
-            contentHtml.replace(match.captured(1), QStringLiteral(""));
-        }
-    }
-
-    return {contentHtml, standaloneTags};
+    auto result = ContentTransformer({}, {}, {}, {}).transform(contentHtml);
+    return {result.content, result.standaloneTags};
 }
 
 QString TextHandler::replaceCustomEmojis(const QList<CustomEmoji> &emojis, const QString &source)
@@ -168,41 +119,12 @@ bool TextHandler::isPostUrl(const QString &url)
 
 QString TextHandler::getRelativeDateTime(const QDateTime &dateTime)
 {
-    const auto current = QDateTime::currentDateTime();
-    const auto secsTo = dateTime.secsTo(current);
-    if (secsTo < 0) {
-        return i18n("in the future");
-    } else if (secsTo < 60) {
-        return i18n("%1s", qCeil(secsTo));
-    } else if (secsTo < 60 * 60) {
-        return i18n("%1m", qCeil(secsTo / 60));
-    } else if (secsTo < 60 * 60 * 24) {
-        return i18n("%1h", qCeil(secsTo / (60 * 60)));
-    } else {
-        return getRelativeDate(dateTime.date());
-    }
+    return RelativeTimeClock::instance().format(dateTime);
 }
 
 QString TextHandler::getRelativeDate(const QDate &dateTime)
 {
-    const auto current = QDate::currentDate();
-    const auto daysTo = dateTime.daysTo(current);
-    if (daysTo == 0) {
-        return i18n("Today");
-    } else if (daysTo < 7) {
-        return i18n("%1d", qCeil(daysTo));
-    } else if (daysTo < 365) {
-        const auto weeksTo = qCeil(daysTo / 7);
-        if (weeksTo < 5) {
-            return i18np("1 week ago", "%1 weeks ago", weeksTo);
-        } else {
-            const auto monthsTo = qCeil(daysTo / 30);
-            return i18np("1 month ago", "%1 months ago", monthsTo);
-        }
-    } else {
-        const auto yearsTo = qCeil(daysTo / 365);
-        return i18np("1 year ago", "%1 years ago", yearsTo);
-    }
+    return RelativeTimeClock::instance().formatDate(dateTime);
 }
 
 std::optional<QUrl> TextHandler::getNextLink(const QString &linkText)
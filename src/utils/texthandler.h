@@ -35,10 +35,11 @@ public:
 
     /**
      * @brief Parses a HTML body and returns a processed body and a list of tags respectively.
+     * @note This only handles the standalone tags, posts go through ContentTransformer which also takes care of emojis and links.
      * @param contentHtml The HTML to process.
      * @return The processed HTML as the first item in the pair, and the list of standalone tags (if any) as the second item.
      */
-    static QPair<QString, QList<QString>> removeStandaloneTags(QString contentHtml);
+    static QPair<QString, QList<QString>> removeStandaloneTags(const QString &contentHtml);
 
     /**
      * @brief Replaces parts of a plaintext string that contain an existing custom emoji.
@@ -90,10 +91,6 @@ namespace TextRegex
 static const QRegularExpression
     url(QStringLiteral(R"(\b((www\.(?!\.)(?!(\w|\.|-)+@)|https?:(//)?\w)(&(?![lg]t;)|[^&\s<>'"])+(&(?![lg]t;)|[^&!,.\s<>'"\]):])))"),
         QRegularExpression::CaseInsensitiveOption | QRegularExpression::UseUnicodePropertiesOption);
-static const QRegularExpression hashtagExp(QStringLiteral("(?:<a\\b[^>]*>#<span>(\\S*)<\\/span><\\/a>)"));
-static const QRegularExpression extraneousParagraphExp(QStringLiteral("(\\s*(?:<(?:p|br)\\s*\\/?>)+\\s*<\\/p>)"));
-static const QRegularExpression extraneousBreakExp(QStringLiteral("(\\s*(?:<br\\s*\\/?>)+\\s*)<\\/p>"));
 static const QRegularExpression nextLink(QStringLiteral("<(.*)>; rel=\"next\""));
 static const QRegularExpression prevLink(QStringLiteral(".*<(.*)>; rel=\"prev\""));
-static const QRegularExpression linkTags(QStringLiteral("<a[^>]+href=\"([^\"]+)\"[^>]+>"));
 }
@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "utils/tracing.h"
+
+#include "tokodon_debug.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+
+using namespace Qt::Literals::StringLiterals;
+
+// About a hundred megabytes, which is plenty for a session and keeps a forgotten recording from growing without end
+static constexpr qsizetype maximumEventCount = 1000000;
+
+namespace
+{
+struct Event {
+    char phase;
+    const char *category;
+    QString name;
+    QString detail;
+    qint64 timestamp;
+    qint64 duration = 0;
+    int thread = 0;
+    int id = 0;
+};
+
+struct Recording {
+    QMutex mutex;
+    QElapsedTimer timer;
+    QString fileName;
+    QList<Event> events;
+    qsizetype droppedCount = 0;
+    int nextId = 1;
+    std::atomic_int nextThread = 1;
+};
+}
+
+Q_GLOBAL_STATIC(Recording, traceRecording)
+
+// Small numbers are easier to tell apart in the trace viewers than the thread ids of the system
+static int currentThread()
+{
+    thread_local const int thread = traceRecording->nextThread++;
+    return thread;
+}
+
+static void record(Event event)
+{
+    event.thread = currentThread();
+
+    QMutexLocker locker(&traceRecording->mutex);
+    if (!Tracing::isRecording()) {
+        return;
+    }
+    if (traceRecording->events.size() >= maximumEventCount) {
+        traceRecording->droppedCount++;
+        return;
+    }
+    if (event.phase == 'b') {
+        event.id = traceRecording->nextId++;
+    }
+    traceRecording->events.append(std::move(event));
+}
+
+void Tracing::start(const QString &fileName)
+{
+    QMutexLocker locker(&traceRecording->mutex);
+    traceRecording->fileName = fileName;
+    traceRecording->events.clear();
+    traceRecording->droppedCount = 0;
+    traceRecording->timer.start();
+    Detail::recording = true;
+
+    qCDebug(TOKODON_LOG) << "Recording a trace to" << fileName;
+}
+
+void Tracing::stop()
+{
+    QMutexLocker locker(&traceRecording->mutex);
+    if (!isRecording()) {
+        return;
+    }
+    Detail::recording = false;
+
+    const auto pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    for (const auto &event : std::as_const(traceRecording->events)) {
+        QJsonObject object{
+            {u"ph"_s, QString(QLatin1Char(event.phase))},
+            {u"cat"_s, QString::fromLatin1(event.category)},
+            {u"name"_s, event.name},
+            {u"ts"_s, event.timestamp},
+            {u"pid"_s, pid},
+            {u"tid"_s, event.thread},
+        };
+        if (event.phase == 'X') {
+            object[u"dur"_s] = event.duration;
+        } else if (event.phase == 'i') {
+            object[u"s"_s] = u"t"_s;
+        }
+        if (!event.detail.isEmpty()) {
+            object[u"args"_s] = QJsonObject{{u"detail"_s, event.detail}};
+        }
+
+        if (event.phase == 'b') {
+            // Async events are a pair of a begin and an end event with the same id
+            object[u"id"_s] = event.id;
+            traceEvents.append(object);
+
+            object[u"ph"_s] = u"e"_s;
+            object[u"ts"_s] = event.timestamp + event.duration;
+            object.remove(u"args"_s);
+        }
+        traceEvents.append(object);
+    }
+
+    QJsonObject metadata{{u"droppedEvents"_s, qint64(traceRecording->droppedCount)}};
+    const QJsonObject trace{
+        {u"traceEvents"_s, traceEvents},
+        {u"displayTimeUnit"_s, u"ms"_s},
+        {u"metadata"_s, metadata},
+    };
+    traceRecording->events.clear();
+
+    QSaveFile file(traceRecording->fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(TOKODON_LOG) << "Couldn't write the trace to" << traceRecording->fileName << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qCWarning(TOKODON_LOG) << "Couldn't write the trace to" << traceRecording->fileName << file.errorString();
+    }
+}
+
+qint64 Tracing::now()
+{
+    if (!isRecording()) {
+        return -1;
+    }
+    return traceRecording->timer.nsecsElapsed() / 1000;
+}
+
+void Tracing::complete(const char *category, const QString &name, const qint64 start, const QString &detail)
+{
+    if (!isRecording() || start < 0) {
+        return;
+    }
+    record({.phase = 'X', .category = category, .name = name, .detail = detail, .timestamp = start, .duration = now() - start});
+}
+
+void Tracing::async(const char *category, const QString &name, const qint64 start, const QString &detail)
+{
+    if (!isRecording() || start < 0) {
+        return;
+    }
+    record({.phase = 'b', .category = category, .name = name, .detail = detail, .timestamp = start, .duration = now() - start});
+}
+
+void Tracing::instant(const char *category, const QString &name, const QString &detail)
+{
+    if (!isRecording()) {
+        return;
+    }
+    record({.phase = 'i', .category = category, .name = name, .detail = detail, .timestamp = now()});
+}
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2026 Tokodon Contributors
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+
+/**
+ * @brief Records where the time goes, in the Chrome trace format.
+ *
+ * Start Tokodon with the TOKODON_TRACE environment variable or the --trace option set to a file name, and the trace is written to
+ * it when quitting. Open it in https://ui.perfetto.dev or chrome://tracing.
+ *
+ * While not recording, a trace point only checks a flag, so they can be put in code that runs often.
+ */
+namespace Tracing
+{
+namespace Detail
+{
+inline std::atomic_bool recording = false;
+}
+
+/**
+ * @brief Starts recording, the trace is written to @p fileName by stop().
+ */
+void start(const QString &fileName);
+
+/**
+ * @brief Stops recording and writes the trace, if it was started.
+ */
+void stop();
+
+/**
+ * @return Whether a trace is being recorded.
+ */
+[[nodiscard]] inline bool isRecording()
+{
+    return Detail::recording.load(std::memory_order_acquire);
+}
+
+/**
+ * @return The time since the recording started in microseconds, or -1 if it isn't recording.
+ */
+[[nodiscard]] qint64 now();
+
+/**
+ * @brief Records that @p name in @p category ran on this thread from @p start, as returned by now(), until now.
+ */
+void complete(const char *category, const QString &name, qint64 start, const QString &detail = {});
+
+/**
+ * @brief Records something that started at @p start and ended now, which may overlap with other events on the same thread,
+ * like a network request.
+ */
+void async(const char *category, const QString &name, qint64 start, const QString &detail = {});
+
+/**
+ * @brief Records that @p name happened now.
+ */
+void instant(const char *category, const QString &name, const QString &detail = {});
+
+/**
+ * @brief Records the time from its construction until it goes out of scope.
+ */
+class Scope
+{
+public:
+    Scope(const char *category, const char *name)
+        : m_category(category)
+        , m_name(name)
+        , m_start(isRecording() ? now() : -1)
+    {
+    }
+
+    ~Scope()
+    {
+        if (m_start >= 0) {
+            complete(m_category, QString::fromLatin1(m_name), m_start, m_detail);
+        }
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    /**
+     * @brief Adds @p detail to the event, like the name of what it's about. Only call this while recording.
+     */
+    void setDetail(const QString &detail)
+    {
+        m_detail = detail;
+    }
+
+private:
+    const char *m_category;
+    const char *m_name;
+    qint64 m_start;
+    QString m_detail;
+};
+}